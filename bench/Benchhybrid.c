@@ -0,0 +1,739 @@
+/**
+ * @file Benchhybrid.c
+ * @brief Micro-benchmarks des opérations du Trie Hybride sur les mots de test/Shakespeare
+ *
+ * Lancé par `make bench`. Benchhybrid_slab mesure les mêmes opérations avec le moteur à slab (`HYBRID_SLAB`) et
+ * Benchhybrid_rec avec les versions récursives des opérations (`HYBRID_RECURSIF`). La ligne `memoire` donne la
+ * croissance du pic de mémoire résidente due à la construction du trie. Un argument optionnel
+ * restreint les mesures à celles dont le nom le contient (`./build/Benchhybrid recherche`).
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L /* for `clock_gettime()` */
+#include "hybrid.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PATH_MAX 1024
+#define ROUNDS 10 /* Le meilleur des tours est retenu pour limiter le bruit */
+#define MOTS_GRAND 4000000 /* La taille du dictionnaire de la mesure `completeTH_grand` */
+#ifndef BENCH_NOM
+#define BENCH_NOM "Benchhybrid" /* Redéfini par les variantes qui incluent ce fichier */
+#endif
+
+typedef struct words
+{
+    char **tab;
+    size_t sz;
+    size_t cap;
+    char **bufs;
+    size_t nbufs;
+} Words;
+
+/* Charge tous les mots (un par ligne) des fichiers .txt de test/Shakespeare */
+static Words load_shakespeare(void)
+{
+    const char *const dir_path = "test/Shakespeare/";
+    Words w = {NULL, 0, 0, NULL, 0};
+    DIR *dir = opendir(dir_path);
+    if (!dir)
+    {
+        perror("Erreur, opendir dans load_shakespeare");
+        exit(1);
+    }
+    struct dirent *dirent;
+    char path_buf[PATH_MAX];
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        if (strstr(dirent->d_name, ".txt") == NULL)
+            continue;
+        snprintf(path_buf, PATH_MAX, "%s%s", dir_path, dirent->d_name);
+
+        int fd = open(path_buf, O_RDONLY);
+        struct stat stat_buf;
+        if (fd == -1 || fstat(fd, &stat_buf) == -1)
+        {
+            perror("Erreur, open dans load_shakespeare");
+            exit(1);
+        }
+        char *buf = malloc(stat_buf.st_size + 1);
+        w.bufs = realloc(w.bufs, (w.nbufs + 1) * sizeof(*w.bufs));
+        if (!buf || !w.bufs || read(fd, buf, stat_buf.st_size) < stat_buf.st_size)
+        {
+            fprintf(stderr, "Erreur, lecture dans load_shakespeare");
+            exit(1);
+        }
+        buf[stat_buf.st_size] = '\0';
+        w.bufs[w.nbufs++] = buf;
+        close(fd);
+
+        for (char *curr = strtok(buf, "\n"); curr; curr = strtok(NULL, "\n"))
+        {
+            if (w.sz == w.cap)
+            {
+                w.cap = w.cap ? 2 * w.cap : 1024;
+                w.tab = realloc(w.tab, w.cap * sizeof(*w.tab));
+                if (!w.tab)
+                {
+                    fprintf(stderr, "Erreur, realloc dans load_shakespeare");
+                    exit(1);
+                }
+            }
+            w.tab[w.sz++] = curr;
+        }
+    }
+    closedir(dir);
+    return w;
+}
+
+static void free_words(Words w)
+{
+    for (size_t i = 0; i < w.nbufs; i++)
+        free(w.bufs[i]);
+    free(w.bufs);
+    free(w.tab);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Vrai si la mesure nommée doit être lancée selon le filtre optionnel donné en argument */
+static bool selected(const char *name, int argc, char *argv[])
+{
+    return argc < 2 || strstr(name, argv[1]) != NULL;
+}
+
+/* Construit des clés longues de 100 à 1000 octets, façon chemins de fichiers : un long préfixe commun parmi 10 suivi
+ * d'un mot, le trie reste petit et le coût par clé suit surtout sa longueur */
+static char **long_keys(Words w, size_t n)
+{
+    const char *const motif = "/srv/data/shakespeare/archives/";
+    char **keys = malloc(n * sizeof(*keys));
+    if (!keys)
+    {
+        fprintf(stderr, "Erreur, malloc dans long_keys");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t target = 100 + (i % 10) * 100;
+        const char *mot = w.tab[(i * 7) % w.sz];
+        size_t lmot = strlen(mot);
+        keys[i] = malloc(target + lmot + 1);
+        if (!keys[i])
+        {
+            fprintf(stderr, "Erreur, malloc dans long_keys");
+            exit(1);
+        }
+        for (size_t j = 0; j < target; j++)
+            keys[i][j] = motif[j % strlen(motif)];
+        memcpy(keys[i] + target, mot, lmot + 1);
+    }
+    return keys;
+}
+
+/* Construit les n premiers bigrammes du texte (un mot, une espace, le mot suivant) : un trie bien plus gros que celui
+ * des mots, qui ne tient plus dans le cache */
+static char **bigrammes(Words w, size_t n)
+{
+    char **keys = malloc(n * sizeof(*keys));
+    if (!keys)
+    {
+        fprintf(stderr, "Erreur, malloc dans bigrammes");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t len = strlen(w.tab[i]) + strlen(w.tab[i + 1]) + 2;
+        keys[i] = malloc(len);
+        if (!keys[i])
+        {
+            fprintf(stderr, "Erreur, malloc dans bigrammes");
+            exit(1);
+        }
+        snprintf(keys[i], len, "%s %s", w.tab[i], w.tab[i + 1]);
+    }
+    return keys;
+}
+
+static void report(const char *name, size_t ops, double secs, long check)
+{
+    printf("%-24s %10.2f Mops/s  (%zu ops, %.3f s, check %ld)\n", name, ops / secs / 1e6, ops, secs, check);
+}
+
+/* Ordre croissant des durées pour `qsort()` */
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Construit n clés à partir des mots distincts donnés : le mot d'indice i % nd, suivi de i / nd en décimal au delà du
+ * premier tour, pour un dictionnaire de plusieurs millions de mots aux préfixes de vrais mots. Les clés sont rangées
+ * dans un seul bloc, libéré avec le tableau par `free_mots_grands()` */
+static char **mots_grands(char *const *distincts, size_t nd, size_t n)
+{
+    size_t taille = 0;
+    for (size_t i = 0; i < n; i++)
+        taille += strlen(distincts[i % nd]) + 21;
+    char **keys = malloc(n * sizeof(*keys));
+    char *bloc = malloc(taille);
+    if (!keys || !bloc)
+    {
+        fprintf(stderr, "Erreur, malloc dans mots_grands");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        keys[i] = bloc;
+        if (i < nd)
+            bloc += sprintf(bloc, "%s", distincts[i]) + 1;
+        else
+            bloc += sprintf(bloc, "%s%zu", distincts[i % nd], i / nd) + 1;
+    }
+    return keys;
+}
+
+static void free_mots_grands(char **keys)
+{
+    free(keys[0]);
+    free(keys);
+}
+
+/* Mesure `completeTH()` pour les 10 meilleurs mots des préfixes de 1 à 3 caractères d'une clé sur pas, et le 99e
+ * centile de la latence d'une requête */
+static void bench_complete(const char *name, const TrieHybride *sc, char *const *keys, size_t n, size_t pas)
+{
+    size_t nreq = (n + pas - 1) / pas, r = 0;
+    double *lat = malloc(nreq * sizeof(*lat));
+    if (!lat)
+    {
+        fprintf(stderr, "Erreur, malloc dans bench_complete");
+        exit(1);
+    }
+    char prefixe[4];
+    long count = 0;
+    double t = now();
+    for (size_t i = 0; i < n; i += pas, r++)
+    {
+        snprintf(prefixe, sizeof(prefixe) - r % 3, "%s", keys[i]);
+        double d = now();
+        char **l = completeTH(sc, prefixe, 10);
+        lat[r] = now() - d;
+        for (char **m = l; *m; m++)
+            count++;
+        deleteListeMotsTH(l);
+    }
+    report(name, nreq, now() - t, count);
+
+    char p99[32];
+    snprintf(p99, sizeof(p99), "%s_p99", name);
+    qsort(lat, nreq, sizeof(*lat), cmp_double);
+    printf("%-24s %10.2f us\n", p99, lat[nreq * 99 / 100] * 1e6);
+    free(lat);
+}
+
+/* Rappel de `fuzzySearchTH()` qui ne garde rien, seul le nombre de mots rendu compte */
+static void compte_distance(const char *mot, int distance, void *ctx)
+{
+    (void)mot;
+    (void)distance;
+    (void)ctx;
+}
+
+/* Rappel de `rechercheMotifTH()` qui ne garde rien, seul le nombre de mots rendu compte */
+static void compte_mot(const char *mot, void *ctx)
+{
+    (void)mot;
+    (void)ctx;
+}
+
+/* Pic de mémoire résidente du processus en kio */
+static long max_rss(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+int main(int argc, char *argv[])
+{
+    Words w = load_shakespeare();
+    printf("%s: %zu mots\n", BENCH_NOM, w.sz);
+
+    long rss = max_rss();
+    double t = now();
+    TrieHybride *th = newTH();
+    for (size_t i = 0; i < w.sz; i++)
+        th = ajoutTH(th, w.tab[i], VALFIN);
+    report("ajoutTH", w.sz, now() - t, comptageMotsTH(th));
+    printf("%-24s %10ld kio\n", "memoire", max_rss() - rss);
+    size_t noeuds = (comptageNilTH(th) - 1) / 2; /* 3 liens par noeud dont n - 1 non nuls */
+
+    if (selected("rechercheTH", argc, argv))
+    {
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i++)
+                found += rechercheTH(th, w.tab[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("rechercheTH", w.sz, best, found);
+    }
+
+    if (selected("rechercheBatchTH", argc, argv))
+    {
+        /* Les mêmes recherches qu'au-dessus, menées de front par lot */
+        bool *res = malloc(w.sz * sizeof(*res));
+        if (!res)
+        {
+            fprintf(stderr, "Erreur, malloc dans main");
+            exit(1);
+        }
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            rechercheBatchTH(th, (const char *const *)w.tab, w.sz, res);
+            for (size_t i = 0; i < w.sz; i++)
+                found += res[i];
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("rechercheBatchTH", w.sz, best, found);
+        free(res);
+    }
+
+    if (selected("longestPrefixTH", argc, argv))
+    {
+        /* Découpage en jetons : le plus long mot au début de chaque mot suivi du mot suivant */
+        char texte[PATH_MAX];
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i + 1 < w.sz; i++)
+        {
+            snprintf(texte, sizeof(texte), "%s%s", w.tab[i], w.tab[i + 1]);
+            count += longestPrefixTH(th, texte, NULL);
+        }
+        report("longestPrefixTH", w.sz - 1, now() - t, count);
+    }
+
+    if (selected("ajoutReequilibreTH", argc, argv))
+    {
+        TrieHybride *eq = newTH();
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+            eq = ajoutReequilibreTH(eq, w.tab[i], VALFIN);
+        report("ajoutReequilibreTH", w.sz, now() - t, hauteurTH(eq));
+        deleteTH(&eq);
+    }
+
+    if (selected("construitTH", argc, argv))
+    {
+        char **mots = malloc(w.sz * sizeof(*mots));
+        if (!mots)
+        {
+            fprintf(stderr, "Erreur, malloc dans main");
+            exit(1);
+        }
+        memcpy(mots, w.tab, w.sz * sizeof(*mots));
+        t = now();
+        TrieHybride *bloc = construitTH(mots, w.sz, VALFIN);
+        report("construitTH", w.sz, now() - t, hauteurTH(bloc));
+
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i++)
+                found += rechercheTH(bloc, w.tab[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("rechercheTH_construitTH", w.sz, best, found);
+        deleteTH(&bloc);
+        free(mots);
+    }
+
+    if (selected("comptageMotsTH", argc, argv))
+    {
+        long count = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            t = now();
+            count = comptageMotsTH(th) + hauteurTH(th);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("comptageMotsTH+hauteurTH", 2 * noeuds, best, count);
+    }
+
+    if (selected("listeMotsTH", argc, argv))
+    {
+        t = now();
+        char **l = listeMotsTH(th);
+        report("listeMotsTH", noeuds, now() - t, l[0] != NULL);
+        deleteListeMotsTH(l);
+    }
+
+    if (selected("curseurTH", argc, argv))
+    {
+        long count = 0;
+        t = now();
+        CurseurTH *c = newCurseurTH(th);
+        for (const char *mot = suivantCurseurTH(c); mot; mot = suivantCurseurTH(c))
+            count += mot[0];
+        report("curseurTH", noeuds, now() - t, count);
+
+        /* Les 20 mots qui suivent un mot sur 8, sans construire la liste de tous les mots */
+        count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i += 8)
+        {
+            const char *mot = seekCurseurTH(c, w.tab[i]);
+            for (int k = 0; mot && k < 20; k++, mot = suivantCurseurTH(c))
+                count += mot[0];
+        }
+        report("curseurTH_seek+20", (w.sz + 7) / 8, now() - t, count);
+        deleteCurseurTH(&c);
+    }
+
+    if (selected("completeTH", argc, argv))
+    {
+        /* Scores variés : le premier ajout d'un mot fixe sa valeur */
+        TrieHybride *sc = newTH();
+        for (size_t i = 0; i < w.sz; i++)
+            sc = ajoutTH(sc, w.tab[i], (int)(i % 997) + 1);
+
+        bench_complete("completeTH_k10", sc, w.tab, w.sz, 8);
+        deleteTH(&sc);
+    }
+
+    if (selected("completeTH_grand", argc, argv))
+    {
+        /* La même mesure sur un dictionnaire de MOTS_GRAND mots, bien au delà du cache, aux scores très étalés */
+        char **distincts = listeMotsTH(th);
+        size_t nd = 0;
+        while (distincts[nd])
+            nd++;
+        char **keys = mots_grands(distincts, nd, MOTS_GRAND);
+        deleteListeMotsTH(distincts);
+        TrieHybride *sc = newTH();
+        for (size_t i = 0; i < MOTS_GRAND; i++)
+            sc = ajoutTH(sc, keys[i], (int)((i * 2654435761u) % 1000000) + 1);
+        printf("%-24s %10zu mots\n", "completeTH_grand", comptageMotsTH(sc));
+        /* Une clé sur 40, interrogées dans le désordre (7919 est premier avec MOTS_GRAND / 40) */
+        char **q = malloc(MOTS_GRAND / 40 * sizeof(*q));
+        if (!q)
+        {
+            fprintf(stderr, "Erreur, malloc dans main");
+            exit(1);
+        }
+        for (size_t i = 0; i < MOTS_GRAND / 40; i++)
+            q[i] = keys[(i * 40 * 7919) % MOTS_GRAND];
+        bench_complete("completeTH_grand_k10", sc, q, MOTS_GRAND / 40, 1);
+        free(q);
+        free_mots_grands(keys);
+        deleteTH(&sc);
+    }
+
+    if (selected("fuzzySearchTH", argc, argv))
+    {
+        /* Correction orthographique d'un mot sur 64, à 1 puis 2 erreurs près */
+        for (int e = 1; e <= 2; e++)
+        {
+            long count = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i += 64)
+                count += fuzzySearchTH(th, w.tab[i], e, compte_distance, NULL);
+            report(e == 1 ? "fuzzySearchTH_1" : "fuzzySearchTH_2", (w.sz + 63) / 64, now() - t, count);
+        }
+    }
+
+    if (selected("rechercheMotifTH", argc, argv))
+    {
+        /* Un mot sur 64, son deuxième caractère remplacé par `?`, puis ses deux premiers et son dernier autour
+         * d'une `*` */
+        char motif[PATH_MAX];
+        for (int e = 0; e < 2; e++)
+        {
+            long count = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i += 64)
+            {
+                size_t lg = strlen(w.tab[i]);
+                if (e == 0)
+                    snprintf(motif, sizeof(motif), "%c%s%s", w.tab[i][0], lg > 1 ? "?" : "",
+                             lg > 1 ? w.tab[i] + 2 : "");
+                else
+                    snprintf(motif, sizeof(motif), "%.2s*%c", w.tab[i], w.tab[i][lg - 1]);
+                count += rechercheMotifTH(th, motif, compte_mot, NULL);
+            }
+            report(e == 0 ? "rechercheMotifTH_?" : "rechercheMotifTH_*", (w.sz + 63) / 64, now() - t, count);
+        }
+    }
+
+    if (selected("fusionTH", argc, argv))
+    {
+        TrieHybride *moitie = newTH();
+        for (size_t i = 0; i < w.sz; i += 2)
+            moitie = ajoutTH(moitie, w.tab[i], VALFIN);
+        t = now();
+        moitie = fusionTH(&moitie, th);
+        report("fusionTH", noeuds, now() - t, comptageMotsTH(moitie));
+        deleteTH(&moitie);
+    }
+
+    if (selected("prefixeTH", argc, argv))
+    {
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+            count += prefixeTH(th, w.tab[i]);
+        report("prefixeTH", w.sz, now() - t, count);
+    }
+
+    if (selected("rankTH", argc, argv))
+    {
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+            count += rankTH(th, w.tab[i]);
+        report("rankTH", w.sz, now() - t, count);
+    }
+
+    if (selected("selectTH", argc, argv))
+    {
+        size_t nmots = comptageMotsTH(th);
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+        {
+            char *mot = selectTH(th, i % nmots);
+            count += mot[0];
+            free(mot);
+        }
+        report("selectTH", w.sz, now() - t, count);
+    }
+
+    if (selected("supprTH", argc, argv))
+    {
+        TrieHybride *copie = fusionCopieTH(th, NULL);
+        t = now();
+        for (size_t i = 0; i < w.sz; i += 2)
+            copie = supprTH(copie, w.tab[i]);
+        report("supprTH", (w.sz + 1) / 2, now() - t, comptageMotsTH(copie));
+        deleteTH(&copie);
+    }
+
+    if (selected("rechercheTH_long", argc, argv))
+    {
+        const size_t n = 20000;
+        char **keys = long_keys(w, n);
+        TrieHybride *lt = newTH();
+        t = now();
+        for (size_t i = 0; i < n; i++)
+            lt = ajoutTH(lt, keys[i], VALFIN);
+        report("ajoutTH_long", n, now() - t, comptageMotsTH(lt));
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < n; i++)
+                found += rechercheTH(lt, keys[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("rechercheTH_long", n, best, found);
+        t = now();
+        for (size_t i = 0; i < n; i++)
+            lt = supprTH(lt, keys[i]);
+        report("supprTH_long", n, now() - t, lt == NULL);
+        for (size_t i = 0; i < n; i++)
+            free(keys[i]);
+        free(keys);
+    }
+
+    if (selected("rechercheBatchTH_bigrammes", argc, argv))
+    {
+        /* Les recherches une à une puis par lot sur un trie qui déborde du cache, où le recouvrement des défauts de
+         * cache paie */
+        const size_t n = w.sz < 200000 ? w.sz - 1 : 200000;
+        char **keys = bigrammes(w, n);
+        TrieHybride *bt = newTH();
+        for (size_t i = 0; i < n; i++)
+            bt = ajoutTH(bt, keys[i], VALFIN);
+        /* Interrogés dans le désordre (7919 est premier avec n), comme une vérification en masse */
+        const char **q = malloc(n * sizeof(*q));
+        bool *res = malloc(n * sizeof(*res));
+        if (!q || !res)
+        {
+            fprintf(stderr, "Erreur, malloc dans main");
+            exit(1);
+        }
+        for (size_t i = 0; i < n; i++)
+            q[i] = keys[(i * 7919) % n];
+        long found = 0;
+        double best = 1e9, best_batch = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < n; i++)
+                found += rechercheTH(bt, q[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+            t = now();
+            rechercheBatchTH(bt, q, n, res);
+            t = now() - t;
+            best_batch = t < best_batch ? t : best_batch;
+        }
+        report("rechercheTH_bigrammes", n, best, found);
+        found = 0;
+        for (size_t i = 0; i < n; i++)
+            found += res[i];
+        report("rechercheBatchTH_bigrammes", n, best_batch, found);
+        free(res);
+        free(q);
+        deleteTH(&bt);
+        for (size_t i = 0; i < n; i++)
+            free(keys[i]);
+        free(keys);
+    }
+
+    if (selected("fusionTH_long", argc, argv))
+    {
+        /* Un dictionnaire partiel fusionné dans un dictionnaire maître qui partage ses longs préfixes */
+        const size_t n = 20000;
+        char **keys = long_keys(w, n);
+        TrieHybride *maitre = newTH(), *partiel = newTH();
+        for (size_t i = 0; i < n; i++)
+            if (i % 10)
+                maitre = ajoutTH(maitre, keys[i], VALFIN);
+            else
+                partiel = ajoutTH(partiel, keys[i], VALFIN);
+        long count = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            TrieHybride *copie = fusionCopieTH(maitre, NULL);
+            t = now();
+            copie = fusionTH(&copie, partiel);
+            t = now() - t;
+            best = t < best ? t : best;
+            count = comptageMotsTH(copie);
+            deleteTH(&copie);
+        }
+        report("fusionTH_long", n / 10, best, count);
+        deleteTH(&maitre);
+        deleteTH(&partiel);
+        for (size_t i = 0; i < n; i++)
+            free(keys[i]);
+        free(keys);
+    }
+
+    if (selected("snapshotTH", argc, argv))
+    {
+        /* Le coût de démarrage d'un outil : relire le JSON, ou vérifier un snapshot pour y chercher en place. Les
+         * écritures sont chronométrées comme les recherches : le premier tour, à froid, ne l'emporte pas */
+        char *json = NULL;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            free(json);
+            t = now();
+            json = printJSONTH(th);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("printJSONTH", noeuds, best, (long)strlen(json));
+        t = now();
+        TrieHybride *relu = parseJSONTH(json, strlen(json));
+        report("parseJSONTH", noeuds, now() - t, comptageMotsTH(relu));
+        deleteTH(&relu);
+        FILE *fichier = tmpfile();
+        if (!fichier)
+        {
+            perror("tmpfile");
+            return EXIT_FAILURE;
+        }
+        /* Le même texte, écrit au fil de l'eau dans le fichier, réécrit depuis le début à chaque tour */
+        bool ecrit = false;
+        best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            rewind(fichier);
+            t = now();
+            SortieJSON sortie;
+            ouvreFichierSortieJSON(&sortie, fichier, false);
+            ecritJSONTH(th, &sortie);
+            ecrit = fermeSortieJSON(&sortie);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("ecritJSONTH", noeuds, best, ecrit);
+        rewind(fichier);
+        t = now();
+        relu = chargeJSONTH(fileno(fichier));
+        report("chargeJSONTH", noeuds, now() - t, comptageMotsTH(relu));
+        fclose(fichier);
+        deleteTH(&relu);
+        free(json);
+
+        size_t sz;
+        t = now();
+        void *snap = printSnapshotTH(th, &sz);
+        report("printSnapshotTH", noeuds, now() - t, (long)sz);
+        t = now();
+        bool ok = verifieSnapshotTH(snap, sz);
+        report("verifieSnapshotTH", noeuds, now() - t, ok);
+        t = now();
+        relu = parseSnapshotTH(snap, sz);
+        report("parseSnapshotTH", noeuds, now() - t, comptageMotsTH(relu));
+        deleteTH(&relu);
+
+        long found = 0;
+        best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i++)
+                found += rechercheSnapshotTH(snap, w.tab[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("rechercheSnapshotTH", w.sz, best, found);
+        free(snap);
+    }
+
+    t = now();
+    deleteTH(&th);
+    report("deleteTH", noeuds, now() - t, th == NULL);
+    free_words(w);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,8 @@
+/**
+ * @file Benchhybrid_rec.c
+ * @brief Les micro-benchmarks de Benchhybrid.c avec les versions récursives des opérations du Trie Hybride
+ *
+ */
+
+#define BENCH_NOM "Benchhybrid_rec"
+#include "Benchhybrid.c"
@@ -0,0 +1,9 @@
+/**
+ * @file Benchhybrid_slab.c
+ * @brief Les micro-benchmarks de Benchhybrid.c avec le moteur à slab du Trie Hybride
+ *
+ */
+
+#define HYBRID_SLAB
+#define BENCH_NOM "Benchhybrid_slab"
+#include "Benchhybrid.c"
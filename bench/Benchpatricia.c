@@ -0,0 +1,457 @@
+/**
+ * @file Benchpatricia.c
+ * @brief Micro-benchmarks des opérations du Patricia-Trie sur les mots de test/Shakespeare
+ *
+ * Lancé par `make bench`. Comparer avec `make SIMD=0 bench` (après `make cleanall`) pour mesurer le gain des chemins
+ * SIMD. Un argument optionnel restreint les mesures à celles dont le nom le contient (`./build/Benchpatricia recherche`).
+ *
+ */
+
+#define _POSIX_C_SOURCE 200809L /* for `clock_gettime()` */
+#include "patricia.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PATH_MAX 1024
+#define ROUNDS 10 /* Le meilleur des tours est retenu pour limiter le bruit */
+
+typedef struct words
+{
+    char **tab;
+    size_t sz;
+    size_t cap;
+    char **bufs;
+    size_t nbufs;
+} Words;
+
+/* Charge tous les mots (un par ligne) des fichiers .txt de test/Shakespeare */
+static Words load_shakespeare(void)
+{
+    const char *const dir_path = "test/Shakespeare/";
+    Words w = {NULL, 0, 0, NULL, 0};
+    DIR *dir = opendir(dir_path);
+    if (!dir)
+    {
+        perror("Erreur, opendir dans load_shakespeare");
+        exit(1);
+    }
+    struct dirent *dirent;
+    char path_buf[PATH_MAX];
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        if (strstr(dirent->d_name, ".txt") == NULL)
+            continue;
+        snprintf(path_buf, PATH_MAX, "%s%s", dir_path, dirent->d_name);
+
+        int fd = open(path_buf, O_RDONLY);
+        struct stat stat_buf;
+        if (fd == -1 || fstat(fd, &stat_buf) == -1)
+        {
+            perror("Erreur, open dans load_shakespeare");
+            exit(1);
+        }
+        char *buf = malloc(stat_buf.st_size + 1);
+        w.bufs = realloc(w.bufs, (w.nbufs + 1) * sizeof(*w.bufs));
+        if (!buf || !w.bufs || read(fd, buf, stat_buf.st_size) < stat_buf.st_size)
+        {
+            fprintf(stderr, "Erreur, lecture dans load_shakespeare");
+            exit(1);
+        }
+        buf[stat_buf.st_size] = '\0';
+        w.bufs[w.nbufs++] = buf;
+        close(fd);
+
+        for (char *curr = strtok(buf, "\n"); curr; curr = strtok(NULL, "\n"))
+        {
+            if (w.sz == w.cap)
+            {
+                w.cap = w.cap ? 2 * w.cap : 1024;
+                w.tab = realloc(w.tab, w.cap * sizeof(*w.tab));
+                if (!w.tab)
+                {
+                    fprintf(stderr, "Erreur, realloc dans load_shakespeare");
+                    exit(1);
+                }
+            }
+            w.tab[w.sz++] = curr;
+        }
+    }
+    closedir(dir);
+    return w;
+}
+
+static void free_words(Words w)
+{
+    for (size_t i = 0; i < w.nbufs; i++)
+        free(w.bufs[i]);
+    free(w.bufs);
+    free(w.tab);
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Vrai si la mesure nommée doit être lancée selon le filtre optionnel donné en argument */
+static bool selected(const char *name, int argc, char *argv[])
+{
+    return argc < 2 || strstr(name, argv[1]) != NULL;
+}
+
+/* Construit des clés longues, façon chemins de fichiers, à partir des mots : longs préfixes communs et longues arêtes */
+static char **long_keys(Words w)
+{
+    char **keys = malloc(w.sz * sizeof(*keys));
+    if (!keys)
+    {
+        fprintf(stderr, "Erreur, malloc dans long_keys");
+        exit(1);
+    }
+    for (size_t i = 0; i < w.sz; i++)
+    {
+        const char *a = w.tab[i], *b = w.tab[(i * 7) % w.sz];
+        size_t len = strlen("/srv/data/shakespeare/") + strlen(a) + strlen(b) + strlen("//index.html") + 1;
+        keys[i] = malloc(len);
+        if (!keys[i])
+        {
+            fprintf(stderr, "Erreur, malloc dans long_keys");
+            exit(1);
+        }
+        snprintf(keys[i], len, "/srv/data/shakespeare/%s/%s/index.html", a, b);
+    }
+    return keys;
+}
+
+static void report(const char *name, size_t ops, double secs, long check)
+{
+    printf("%-24s %10.2f Mops/s  (%zu ops, %.3f s, check %ld)\n", name, ops / secs / 1e6, ops, secs, check);
+}
+
+/* Rappel de fuzzy_search_patricia qui ne garde rien, seul le nombre de mots rendu compte */
+static void compte_distance(const char *word, int distance, void *ctx)
+{
+    (void)word;
+    (void)distance;
+    (void)ctx;
+}
+
+/* Rappel de glob_patricia qui ne garde rien, seul le nombre de mots rendu compte */
+static void compte_mot(const char *word, void *ctx)
+{
+    (void)word;
+    (void)ctx;
+}
+
+int main(int argc, char *argv[])
+{
+    Words w = load_shakespeare();
+    printf("Benchpatricia: %zu mots\n", w.sz);
+
+    double t = now();
+    PatriciaNode *pt = create_patricia_node();
+    for (size_t i = 0; i < w.sz; i++)
+        insert_patricia(pt, w.tab[i]);
+    report("insert_patricia", w.sz, now() - t, comptage_mots_patricia(pt));
+
+    if (selected("recherche_patricia", argc, argv))
+    {
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i++)
+                found += recherche_patricia(pt, w.tab[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("recherche_patricia", w.sz, best, found);
+    }
+
+    if (selected("recherche_batch_patricia", argc, argv))
+    {
+        /* Les mêmes recherches qu'au-dessus, menées de front par lot */
+        int *results = malloc(w.sz * sizeof(*results));
+        if (!results)
+        {
+            fprintf(stderr, "Erreur, malloc dans main");
+            exit(1);
+        }
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            recherche_batch_patricia(pt, (const char *const *)w.tab, w.sz, results);
+            for (size_t i = 0; i < w.sz; i++)
+                found += results[i];
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("recherche_batch_patricia", w.sz, best, found);
+        free(results);
+    }
+
+    if (selected("longest_prefix_patricia", argc, argv))
+    {
+        /* Découpage en jetons : le plus long mot au début de chaque mot suivi du mot suivant */
+        char text[PATH_MAX];
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i + 1 < w.sz; i++)
+        {
+            snprintf(text, sizeof(text), "%s%s", w.tab[i], w.tab[i + 1]);
+            count += longest_prefix_patricia(pt, text);
+        }
+        report("longest_prefix_patricia", w.sz - 1, now() - t, count);
+    }
+
+    if (selected("nb_prefixe_patricia", argc, argv))
+    {
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+            count += nb_prefixe_patricia(pt, w.tab[i]);
+        report("nb_prefixe_patricia", w.sz, now() - t, count);
+    }
+
+    if (selected("rank_patricia", argc, argv))
+    {
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+            count += rank_patricia(pt, w.tab[i]);
+        report("rank_patricia", w.sz, now() - t, count);
+    }
+
+    if (selected("select_patricia", argc, argv))
+    {
+        int nmots = comptage_mots_patricia(pt);
+        long count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i++)
+        {
+            char *mot = select_patricia(pt, (int)(i % nmots));
+            count += mot[0];
+            free(mot);
+        }
+        report("select_patricia", w.sz, now() - t, count);
+    }
+
+    if (selected("cursor_patricia", argc, argv))
+    {
+        long count = 0;
+        t = now();
+        PatriciaCursor *cursor = cursor_open_patricia(pt);
+        for (const char *mot = cursor_next_patricia(cursor); mot; mot = cursor_next_patricia(cursor))
+            count += mot[0];
+        report("cursor_patricia", comptage_mots_patricia(pt), now() - t, count);
+
+        /* Les 20 mots qui suivent un mot sur 8, sans construire la liste de tous les mots */
+        count = 0;
+        t = now();
+        for (size_t i = 0; i < w.sz; i += 8)
+        {
+            const char *mot = cursor_seek_patricia(cursor, w.tab[i]);
+            for (int k = 0; mot && k < 20; k++, mot = cursor_next_patricia(cursor))
+                count += mot[0];
+        }
+        report("cursor_patricia_seek+20", (w.sz + 7) / 8, now() - t, count);
+        cursor_close_patricia(cursor);
+    }
+
+    if (selected("fuzzy_search_patricia", argc, argv))
+    {
+        /* Correction orthographique d'un mot sur 64, à 1 puis 2 erreurs près */
+        for (int e = 1; e <= 2; e++)
+        {
+            long count = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i += 64)
+                count += fuzzy_search_patricia(pt, w.tab[i], e, compte_distance, NULL);
+            report(e == 1 ? "fuzzy_search_patricia_1" : "fuzzy_search_patricia_2", (w.sz + 63) / 64, now() - t, count);
+        }
+    }
+
+    if (selected("glob_patricia", argc, argv))
+    {
+        /* Un mot sur 64, son deuxième caractère remplacé par `?`, puis ses deux premiers et son dernier autour
+         * d'une `*` */
+        char pattern[PATH_MAX];
+        for (int e = 0; e < 2; e++)
+        {
+            long count = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i += 64)
+            {
+                size_t len = strlen(w.tab[i]);
+                if (e == 0)
+                    snprintf(pattern, sizeof(pattern), "%c%s%s", w.tab[i][0], len > 1 ? "?" : "",
+                             len > 1 ? w.tab[i] + 2 : "");
+                else
+                    snprintf(pattern, sizeof(pattern), "%.2s*%c", w.tab[i], w.tab[i][len - 1]);
+                count += glob_patricia(pt, pattern, compte_mot, NULL);
+            }
+            report(e == 0 ? "glob_patricia_?" : "glob_patricia_*", (w.sz + 63) / 64, now() - t, count);
+        }
+    }
+
+    if (selected("recherche_patricia_long", argc, argv))
+    {
+        char **keys = long_keys(w);
+        PatriciaNode *lt = create_patricia_node();
+        for (size_t i = 0; i < w.sz; i++)
+            insert_patricia(lt, keys[i]);
+        long found = 0;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i++)
+                found += recherche_patricia(lt, keys[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("recherche_patricia_long", w.sz, best, found);
+
+        /* Le même trie, qui déborde du cache : les recherches par lot recouvrent leurs défauts de cache */
+        int *results = malloc(w.sz * sizeof(*results));
+        if (!results)
+        {
+            fprintf(stderr, "Erreur, malloc dans main");
+            exit(1);
+        }
+        best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            t = now();
+            recherche_batch_patricia(lt, (const char *const *)keys, w.sz, results);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        found = 0;
+        for (size_t i = 0; i < w.sz; i++)
+            found += results[i];
+        report("recherche_batch_patricia_long", w.sz, best, found);
+        free(results);
+        free_patricia_node(lt);
+        for (size_t i = 0; i < w.sz; i++)
+            free(keys[i]);
+        free(keys);
+    }
+
+    if (selected("snapshot_patricia", argc, argv))
+    {
+        /* Le coût de démarrage d'un outil : relire le JSON, ou vérifier un snapshot pour y chercher en place. Les
+         * écritures comparées sont chronométrées comme les recherches : le premier tour, à froid, ne l'emporte pas */
+        char *json = NULL;
+        double best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            free(json);
+            t = now();
+            json = printJSONPT(pt);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("printJSONPT", w.sz, best, (long)strlen(json));
+        /* L'ancien chemin, qui construit tout l'arbre cJSON avant le texte */
+        char *ancien = NULL;
+        best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            free(ancien);
+            t = now();
+            cJSON *arbre = constructJSONPT(pt, "");
+            ancien = cJSON_Print(arbre);
+            cJSON_Delete(arbre);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("printJSONPT_cJSON", w.sz, best, strcmp(json, ancien) == 0);
+        free(ancien);
+        t = now();
+        PatriciaNode *relu = parseJSONPT(json, strlen(json));
+        report("parseJSONPT", w.sz, now() - t, comptage_mots_patricia(relu));
+        free_patricia_node(relu);
+        /* L'ancien chemin, qui construit tout l'arbre cJSON avant le trie */
+        t = now();
+        cJSON *dom = cJSON_ParseWithLength(json, strlen(json));
+        relu = create_patricia_node();
+        parseJSONPT_rec(dom, relu);
+        cJSON_Delete(dom);
+        report("parseJSONPT_cJSON", w.sz, now() - t, comptage_mots_patricia(relu));
+        free_patricia_node(relu);
+        FILE *file = tmpfile();
+        if (file == NULL)
+        {
+            perror("tmpfile");
+            return EXIT_FAILURE;
+        }
+        /* Le même texte, écrit au fil de l'eau dans le fichier, réécrit depuis le début à chaque tour */
+        bool written = false;
+        best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            rewind(file);
+            t = now();
+            SortieJSON out;
+            ouvreFichierSortieJSON(&out, file, false);
+            ecritJSONPT(pt, &out);
+            written = fermeSortieJSON(&out);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("ecritJSONPT", w.sz, best, written);
+        rewind(file);
+        t = now();
+        relu = chargeJSONPT(fileno(file));
+        report("chargeJSONPT", w.sz, now() - t, comptage_mots_patricia(relu));
+        fclose(file);
+        free_patricia_node(relu);
+        free(json);
+
+        size_t sz;
+        t = now();
+        void *snap = printSnapshotPT(pt, &sz);
+        report("printSnapshotPT", w.sz, now() - t, (long)sz);
+        t = now();
+        bool ok = verifieSnapshotPT(snap, sz);
+        report("verifieSnapshotPT", w.sz, now() - t, ok);
+        t = now();
+        relu = parseSnapshotPT(snap, sz);
+        report("parseSnapshotPT", w.sz, now() - t, comptage_mots_patricia(relu));
+        free_patricia_node(relu);
+
+        long found = 0;
+        best = 1e9;
+        for (int r = 0; r < ROUNDS; r++)
+        {
+            found = 0;
+            t = now();
+            for (size_t i = 0; i < w.sz; i++)
+                found += recherche_snapshot_patricia(snap, w.tab[i]);
+            t = now() - t;
+            best = t < best ? t : best;
+        }
+        report("recherche_snapshot_patricia", w.sz, best, found);
+        free(snap);
+    }
+
+    free_patricia_node(pt);
+    free_words(w);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,248 @@
+#ifndef FLUXJSON_H
+#define FLUXJSON_H
+/**
+ * @file fluxjson.h
+ * @author Efe ERKEN (efe.erken@etu.sorbonne-universite.fr)
+ * @brief Fichier d'entête contenant les déclaration des fonctions pour lire et écrire un JSON au fil de l'eau
+ * @version 0.1
+ * @date 2024-12-18
+ *
+ * @copyright Copyright (C) 2024 Efe ERKEN
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @def TAILLE_FLUX_JSON
+ *
+ * @brief La taille en octets des blocs lus depuis un descripteur de fichier, ou écrits vers une sortie
+ *
+ */
+#define TAILLE_FLUX_JSON 65536
+
+/**
+ * @brief Les jetons rendus par `jetonFluxJSON()`
+ *
+ */
+typedef enum jeton_json
+{
+    JSON_FIN,           /**< Plus rien à lire */
+    JSON_ERREUR,        /**< Entrée qui n'est pas du JSON, ou erreur de lecture */
+    JSON_DEBUT_OBJET,   /**< `{` */
+    JSON_FIN_OBJET,     /**< `}` */
+    JSON_DEBUT_TABLEAU, /**< `[` */
+    JSON_FIN_TABLEAU,   /**< `]` */
+    JSON_DEUX_POINTS,   /**< `:` */
+    JSON_VIRGULE,       /**< `,` */
+    JSON_CHAINE,        /**< Une chaine, décodée dans le champ @c chaine du flux */
+    JSON_NOMBRE,        /**< Un nombre, dont le texte est dans le champ @c chaine du flux */
+    JSON_VRAI,          /**< `true` */
+    JSON_FAUX,          /**< `false` */
+    JSON_NUL            /**< `null` */
+} JetonJSON;
+
+/**
+ * @brief Un flux de jetons JSON, lu depuis un descripteur de fichier ou depuis la mémoire
+ *
+ * Seul le dernier bloc lu est gardé en mémoire, ainsi que la dernière chaine décodée : lire un JSON de plusieurs
+ * centaines de mégaoctets demande toujours la même mémoire.
+ *
+ */
+typedef struct flux_json
+{
+    int fd;          /**< Le descripteur lu, -1 pour un flux en mémoire */
+    const char *buf; /**< Les octets disponibles, le bloc lu ou la mémoire donnée */
+    size_t pos;      /**< La position du prochain octet dans @c buf */
+    size_t fin;      /**< Le nombre d'octets disponibles dans @c buf */
+    size_t lus;      /**< Le nombre d'octets consommés avant @c buf, pour situer les erreurs */
+    char *bloc;      /**< Le bloc de @c TAILLE_FLUX_JSON octets, NULL pour un flux en mémoire */
+    char *chaine;    /**< La dernière chaine ou le dernier nombre lu, nul terminé */
+    size_t lg;       /**< La longueur de @c chaine, sans le caractère nul */
+    size_t cap;      /**< La capacité de @c chaine */
+} FluxJSON;
+
+/**
+ * @brief Ouvre un flux de jetons sur le descripteur de fichier donné
+ *
+ * @param [out] f Un pointeur vers le flux à initialiser
+ * @param [in] fd Un descripteur de fichier ouvert en lecture, qui n'est jamais fermé par le flux
+ *
+ * @post C'est à l'appellant de refermer le flux avec `fermeFluxJSON()`
+ *
+ * Le descripteur peut être un tube : il est lu bloc par bloc, sans jamais revenir en arrière.
+ *
+ */
+void ouvreFluxJSON(FluxJSON *f, int fd);
+
+/**
+ * @brief Ouvre un flux de jetons sur les octets donnés
+ *
+ * @param [out] f Un pointeur vers le flux à initialiser
+ * @param [in] buf Les octets à lire, qui doivent rester valides jusqu'à la fermeture du flux
+ * @param [in] sz Le nombre d'octets de @p buf
+ *
+ * @post C'est à l'appellant de refermer le flux avec `fermeFluxJSON()`
+ *
+ */
+void ouvreMemoireFluxJSON(FluxJSON *f, const char *buf, size_t sz);
+
+/**
+ * @brief Lit le jeton suivant du flux donné
+ *
+ * @param [in,out] f Un pointeur vers le flux à lire
+ * @return Le jeton lu, @c JSON_FIN à la fin de l'entrée
+ *
+ * Pour @c JSON_CHAINE, la chaine décodée (échappements `\uXXXX` convertis en UTF-8) est dans @c f->chaine et
+ * @c f->lg, jusqu'au prochain appel.
+ *
+ */
+JetonJSON jetonFluxJSON(FluxJSON *f);
+
+/**
+ * @brief Saute la valeur JSON qui commence par le jeton donné, objets et tableaux imbriqués compris
+ *
+ * @param [in,out] f Un pointeur vers le flux à lire
+ * @param [in] premier Le premier jeton de la valeur, déjà lu
+ * @return true si une valeur complète a été sautée, false sinon
+ *
+ * Seule la profondeur est suivie : la grammaire à l'intérieur de la valeur sautée n'est pas vérifiée.
+ *
+ */
+bool sauteValeurFluxJSON(FluxJSON *f, JetonJSON premier);
+
+/**
+ * @brief Renvoie la position dans l'entrée du prochain octet à lire, pour situer une erreur
+ *
+ * @param [in] f Un pointeur vers le flux
+ * @return Le nombre d'octets consommés depuis l'ouverture du flux
+ *
+ */
+size_t positionFluxJSON(const FluxJSON *f);
+
+/**
+ * @brief Libère la mémoire du flux donné, sans fermer son descripteur
+ *
+ * @param [in,out] f Un pointeur vers le flux à refermer
+ *
+ */
+void fermeFluxJSON(FluxJSON *f);
+
+/**
+ * @brief Une sortie JSON écrite au fil de l'eau vers un descripteur, un @c FILE ou la mémoire
+ *
+ * Le texte produit est celui de `cJSON_Print()`, ou de `cJSON_PrintUnformatted()` en mode compact, octet pour octet.
+ * Vers un descripteur ou un @c FILE, seul un bloc de @c TAILLE_FLUX_JSON octets est gardé en mémoire. Les erreurs
+ * d'écriture sont retenues et rendues par `fermeSortieJSON()`.
+ *
+ */
+typedef struct sortie_json
+{
+    int fd;       /**< Le descripteur écrit, -1 sinon */
+    FILE *f;      /**< Le fichier écrit, NULL sinon */
+    char *buf;    /**< Le bloc en attente d'écriture, ou toute la sortie en mémoire */
+    size_t pos;   /**< Le nombre d'octets en attente dans @c buf */
+    size_t cap;   /**< La capacité de @c buf */
+    size_t prof;  /**< Le nombre d'objets ouverts */
+    bool compact; /**< Sans retours à la ligne ni indentation */
+    bool vide;    /**< L'objet ouvert le plus profond n'a encore aucun membre */
+    bool erreur;  /**< Une écriture a échoué */
+} SortieJSON;
+
+/**
+ * @brief Ouvre une sortie JSON vers le descripteur de fichier donné, qui n'est jamais fermé par la sortie
+ *
+ * @param [out] s Un pointeur vers la sortie à initialiser
+ * @param [in] fd Un descripteur ouvert en écriture
+ * @param [in] compact Vrai pour une sortie sans retours à la ligne ni indentation
+ *
+ * @post C'est à l'appellant de refermer la sortie avec `fermeSortieJSON()`
+ *
+ */
+void ouvreSortieJSON(SortieJSON *s, int fd, bool compact);
+
+/**
+ * @brief Comme `ouvreSortieJSON()`, vers le @c FILE donné, qui n'est pas fermé mais vidé à la fermeture de la sortie
+ *
+ */
+void ouvreFichierSortieJSON(SortieJSON *s, FILE *f, bool compact);
+
+/**
+ * @brief Comme `ouvreSortieJSON()`, vers une chaine en mémoire rendue par `rendMemoireSortieJSON()`
+ *
+ */
+void ouvreMemoireSortieJSON(SortieJSON *s, bool compact);
+
+/**
+ * @brief Écrit l'accolade ouvrante d'un objet, en valeur de la racine ou du dernier membre écrit
+ *
+ */
+void debutObjetSortieJSON(SortieJSON *s);
+
+/**
+ * @brief Écrit l'accolade fermante de l'objet ouvert le plus profond
+ *
+ */
+void finObjetSortieJSON(SortieJSON *s);
+
+/**
+ * @brief Écrit la clé d'un nouveau membre de l'objet ouvert le plus profond, séparateur compris
+ *
+ * @param [in,out] s Un pointeur vers la sortie
+ * @param [in] cle Les octets de la clé, qui peuvent contenir des caractères nuls
+ * @param [in] lg Le nombre d'octets de @p cle
+ *
+ */
+void cleSortieJSON(SortieJSON *s, const char *cle, size_t lg);
+
+/**
+ * @brief Écrit une chaine en valeur, échappée comme par cJSON
+ *
+ * @param [in,out] s Un pointeur vers la sortie
+ * @param [in] str Les octets de la chaine, qui peuvent contenir des caractères nuls
+ * @param [in] lg Le nombre d'octets de @p str
+ *
+ */
+void chaineSortieJSON(SortieJSON *s, const char *str, size_t lg);
+
+/**
+ * @brief Écrit `true` ou `false` en valeur
+ *
+ */
+void boolSortieJSON(SortieJSON *s, bool b);
+
+/**
+ * @brief Écrit un nombre entier en valeur, comme cJSON
+ *
+ */
+void entierSortieJSON(SortieJSON *s, long n);
+
+/**
+ * @brief Écrit `null` en valeur
+ *
+ */
+void nulSortieJSON(SortieJSON *s);
+
+/**
+ * @brief Vide et referme la sortie donnée, sans fermer son descripteur ni son @c FILE
+ *
+ * @param [in,out] s Un pointeur vers la sortie à refermer
+ * @return true si toutes les écritures ont réussi, false sinon
+ *
+ */
+bool fermeSortieJSON(SortieJSON *s);
+
+/**
+ * @brief Referme une sortie en mémoire et rend le texte écrit
+ *
+ * @param [in,out] s Un pointeur vers la sortie ouverte par `ouvreMemoireSortieJSON()`
+ * @return La chaine écrite, nul terminée
+ *
+ * @post C'est à l'appellant de désallouer la chaine retournée
+ *
+ */
+char *rendMemoireSortieJSON(SortieJSON *s);
+
+#endif
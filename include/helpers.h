@@ -34,7 +34,8 @@ void insererPT(void);
  * @pre Les mots sont composés des caractères ASCII (128 possibilités) encodé sur 8 bits
  *
  * La liste de mots donné dans l'entrée standard doit être sous forme d'un mot par ligne. La sortie standard contiendra
- * le Trie Hybride correspondant (construit par ajouts successifs des mots donnés) sous format JSON.
+ * le Trie Hybride correspondant sous format JSON. Sans rééquilibrage il est construit par ajouts successifs des mots
+ * donnés, avec rééquilibrage il est construit d'un coup par `construitTH()` une fois toute l'entrée lue.
  *
  */
 void insererTH(bool isRebalanced);
@@ -49,6 +50,11 @@ void insererTH(bool isRebalanced);
  *
  * La liste de mots donné dans l'entrée standard doit être sous forme d'un mot par ligne.
  *
+ * Si la variable d'environnement @c TRIES_JOURNAL est donnée (à une valeur autre que vide ou "0"), ou si le fichier a
+ * déjà un journal (le même chemin suivi de `.journal`), le fichier n'est ni lu ni réécrit : une ligne `S mot` est
+ * ajoutée au journal pour chaque mot, et le coût ne dépend plus que du nombre de mots supprimés. Toutes les commandes
+ * rejouent le journal après avoir lu le fichier, jusqu'à ce que `compactionMainPT()` l'y replie.
+ *
  */
 void suppressionPT(const char *path);
 
@@ -60,11 +66,42 @@ void suppressionPT(const char *path);
  *
  * @pre Les mots sont composés des caractères ASCII (128 possibilités) encodé sur 8 bits
  *
- * La liste de mots donné dans l'entrée standard doit être sous forme d'un mot par ligne.
+ * La liste de mots donné dans l'entrée standard doit être sous forme d'un mot par ligne. Le journal est celui de
+ * `suppressionPT()`.
  *
  */
 void suppressionTH(const char *path);
 
+/**
+ * @brief Lit le Patricia-Trie depuis le fichier donné en argument, y ajoute les mots lus depuis l'entrée standard et
+ * le réécrit sous la même forme, JSON ou snapshot binaire
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON (ou un snapshot)
+ * d'un Patricia-Trie
+ *
+ * @pre Les mots sont composés des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * La liste de mots donné dans l'entrée standard doit être sous forme d'un mot par ligne. Avec un journal (voir
+ * `suppressionPT()`), le fichier n'est ni lu ni réécrit et une ligne `A mot` est ajoutée au journal pour chaque mot.
+ *
+ */
+void insererFichierPT(const char *path);
+
+/**
+ * @brief Lit le Trie Hybride depuis le fichier donné en argument, y ajoute les mots lus depuis l'entrée standard et le
+ * réécrit sous la même forme, JSON ou snapshot binaire
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON (ou un snapshot)
+ * d'un Trie Hybride
+ *
+ * @pre Les mots sont composés des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * Voir `insererFichierPT()`. Comme pour la requête `A` du serveur, les mots sont ajoutés sans rééquilibrage, ce qui
+ * donne le même trie qu'ils passent par le journal ou non.
+ *
+ */
+void insererFichierTH(const char *path);
+
 /**
  * @brief Lit le Patricia-Trie depuis le fichier JSON donné en argument, liste les mots qu'il contient sur la sortie
  * standard
@@ -116,7 +153,9 @@ void profondeurMoyenneMainTH(const char *path);
  * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON d'un Patricia-Trie
  * @param [in] cle Une chaine de caractères (nul terminé) constituant une clé/mot, caractères ASCII (128 possibilités)
  *
- * Le nombre de préfixe écrit est un entier et ne contient pas de retour à la ligne.
+ * Le nombre de préfixe écrit est un entier et ne contient pas de retour à la ligne. Le fichier peut aussi être un
+ * snapshot binaire (voir `snapshotMainPT()`) : il est alors projeté en mémoire et le mot y est cherché directement,
+ * sans désérialiser le trie.
  *
  */
 void prefixeMainPT(const char *path, const char *cle);
@@ -128,11 +167,65 @@ void prefixeMainPT(const char *path, const char *cle);
  * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON d'un Trie Hybride
  * @param [in] cle Une chaine de caractères (nul terminé) constituant une clé/mot, caractères ASCII (128 possibilités)
  *
- * Le nombre de préfixe écrit est un entier et ne contient pas de retour à la ligne.
+ * Le nombre de préfixe écrit est un entier et ne contient pas de retour à la ligne. Le fichier peut aussi être un
+ * snapshot binaire, voir `prefixeMainPT()`.
  *
  */
 void prefixeMainTH(const char *path, const char *cle);
 
+/**
+ * @brief Lit le Patricia-Trie depuis le fichier donné en argument et l'écrit sous forme de snapshot binaire
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON (ou un snapshot)
+ * d'un Patricia-Trie
+ * @param [in] sortie Une chaine de caractères (nul terminé) constituant le chemin du snapshot à écrire
+ *
+ * Le snapshot est fait de tableaux plats reliés par des indices, avec une version et une somme de contrôle. Les outils
+ * qui l'acceptent à la place du JSON le projettent en mémoire avec `mmap()` et y répondent aux recherches sans le
+ * désérialiser : leur démarrage ne dépend plus de la taille du dictionnaire que par la vérification de la somme.
+ *
+ */
+void snapshotMainPT(const char *path, const char *sortie);
+
+/**
+ * @brief Lit le Trie Hybride depuis le fichier donné en argument et l'écrit sous forme de snapshot binaire
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON (ou un snapshot)
+ * d'un Trie Hybride
+ * @param [in] sortie Une chaine de caractères (nul terminé) constituant le chemin du snapshot à écrire
+ *
+ * Voir `snapshotMainPT()`. Contrairement au JSON, le snapshot garde aussi les valeurs de fin de mot.
+ *
+ */
+void snapshotMainTH(const char *path, const char *sortie);
+
+/**
+ * @brief Replie le journal du fichier de Patricia-Trie donné en argument dans le fichier, puis supprime le journal
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON (ou un snapshot)
+ * d'un Patricia-Trie
+ *
+ * Le fichier est lu, le journal rejoué, et le fichier réécrit sous la même forme, jusque sur le disque, avant que le
+ * journal ne soit supprimé. Un arrêt entre les deux laisse un journal qui, rejoué sur le fichier à jour, ne change
+ * rien. Sans journal, ou avec un journal vide, le fichier n'est pas touché.
+ *
+ * Les écrivains tiennent le journal sous un verrou partagé (`flock()`) le temps de leurs ajouts, et le serveur de sa
+ * première modification à son arrêt. La compaction prend le verrou exclusif sans attendre : si un écrivain le tient,
+ * elle s'arrête en erreur sans rien toucher, plutôt que de supprimer un journal où il écrit encore. Un écrivain qui
+ * obtient son verrou sur un journal déjà supprimé le rouvre.
+ *
+ */
+void compactionMainPT(const char *path);
+
+/**
+ * @brief Comme `compactionMainPT()`, pour un Trie Hybride
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON (ou un snapshot)
+ * d'un Trie Hybride
+ *
+ */
+void compactionMainTH(const char *path);
+
 /**
  * @brief Lit les deux Patricia-Trie depuis les fichiers JSON donnés en argument, écrit le trie résultant de leur
  * fusion sur la sortie standard
@@ -155,4 +248,85 @@ void fusionMainPT(const char *path1, const char *path2);
  */
 void fusionMainTH(const char *path1, const char *path2);
 
+/**
+ * @brief Lit le Patricia-Trie depuis le fichier JSON donné en argument et répond aux requêtes reçues sur une socket
+ * Unix jusqu'à une requête d'arrêt, le trie restant en mémoire entre les requêtes
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON d'un Patricia-Trie
+ * @param [in] chemin Une chaine de caractères (nul terminé) constituant le chemin de la socket Unix à créer
+ *
+ * Le protocole est fait de lignes : une requête par ligne, une lettre d'opération suivie d'une espace et d'un mot si
+ * l'opération en prend un, et une réponse par requête.
+ *
+ * - `R mot` : 1 si le mot est dans le trie, 0 sinon
+ * - `P mot` : le nombre de mots dont le mot est préfixe
+ * - `A mot` : ajoute le mot, répond OK
+ * - `S mot` : supprime le mot, répond OK
+ * - `L` : le nombre de mots sur une ligne puis les mots dans l'ordre alphabétique, un par ligne
+ * - `Q` : arrête le serveur, répond OK, après avoir réécrit le fichier JSON si le trie a changé
+ *
+ * @c SIGINT et @c SIGTERM arrêtent le serveur comme `Q` : le trie est sauvegardé et la socket supprimée.
+ *
+ * Une requête mal formée ou dont le mot n'est pas ASCII reçoit ERR. Plusieurs clients peuvent être connectés à la
+ * fois : leurs requêtes sont servies au fil de leur arrivée, et un client inactif ne retient pas les autres.
+ *
+ * Le fichier peut aussi être un snapshot binaire (voir `snapshotMainPT()`) : `R` et `P` sont alors servies directement
+ * sur le fichier projeté en mémoire, et le trie n'est désérialisé qu'à la première requête `A`, `S` ou `L`. Il est
+ * réécrit sous forme de snapshot s'il a changé.
+ *
+ * Avec un journal (voir `suppressionPT()`), les requêtes `A` et `S` y sont ajoutées au lieu de réécrire le fichier, et
+ * écrites sur le disque avant l'envoi de leurs réponses : une modification confirmée survit à un plantage. Un snapshot
+ * dont le journal n'est pas vide est désérialisé dès le chargement, pour rejouer le journal.
+ *
+ */
+void serveurMainPT(const char *path, const char *chemin);
+
+/**
+ * @brief Lit le Trie Hybride depuis le fichier JSON donné en argument et répond aux requêtes reçues sur une socket Unix
+ * jusqu'à une requête d'arrêt, le trie restant en mémoire entre les requêtes
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON d'un Trie Hybride
+ * @param [in] chemin Une chaine de caractères (nul terminé) constituant le chemin de la socket Unix à créer
+ *
+ * Le protocole est celui de `serveurMainPT()`.
+ *
+ */
+void serveurMainTH(const char *path, const char *chemin);
+
+/**
+ * @brief Lit le Patricia-Trie depuis le fichier JSON donné en argument et répond aux requêtes lues depuis l'entrée
+ * standard sur la sortie standard
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON d'un Patricia-Trie
+ *
+ * Les requêtes et les réponses sont celles de `serveurMainPT()`, une par ligne. L'entrée est lue par gros blocs et les
+ * réponses écrites d'un coup pour chaque bloc, le trie n'est lu qu'une fois pour toutes les requêtes. Le fichier JSON
+ * est réécrit à la fin de l'entrée ou à une requête `Q` si le trie a changé.
+ *
+ */
+void lotMainPT(const char *path);
+
+/**
+ * @brief Lit le Trie Hybride depuis le fichier JSON donné en argument et répond aux requêtes lues depuis l'entrée
+ * standard sur la sortie standard
+ *
+ * @param [in] path Une chaine de caractères (nul terminé) constituant le chemin vers un fichier JSON d'un Trie Hybride
+ *
+ * Voir `lotMainPT()`.
+ *
+ */
+void lotMainTH(const char *path);
+
+/**
+ * @brief Envoie les requêtes lues depuis l'entrée standard au serveur de la socket Unix donnée et écrit ses réponses
+ * sur la sortie standard
+ *
+ * @param [in] chemin Une chaine de caractères (nul terminé) constituant le chemin de la socket Unix d'un serveur
+ *
+ * Les requêtes partent sans attendre les réponses, au fil de la lecture, et le client se termine quand le serveur a
+ * répondu à toute l'entrée. Voir `serveurMainPT()` pour le protocole.
+ *
+ */
+void clientMain(const char *chemin);
+
 #endif
@@ -11,8 +11,10 @@
  *
  */
 
+#include "fluxjson.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 /**
@@ -31,13 +33,69 @@
  */
 #define VALFIN 1
 
+/**
+ * @def FINMOT
+ *
+ * @brief Le bit du label d'un noeud de la slab ou d'un snapshot pour indiquer qu'il constitue une fin de mot
+ *
+ * Les clés étant en ASCII (7 bits), le bit de poids fort du label est libre pour servir d'indicateur.
+ *
+ */
+#define FINMOT 0x80
+
+/**
+ * @brief Un noeud du Trie Hybride stocké dans une slab ou dans un snapshot binaire, 16 octets
+ *
+ * Les enfants sont désignés par leur indice dans la slab (ou le snapshot), l'indice 0 étant réservé pour indiquer un
+ * enfant nul.
+ *
+ */
+typedef struct noeud_hybride
+{
+    uint32_t inf, eq, sup; /**< Indices des enfants, 0 si nul */
+    unsigned char label;   /**< Un caractère d'une clé, le bit @c FINMOT est mis si le noeud est une fin de mot */
+    unsigned char h;       /**< Hauteur du noeud dans l'arbre binaire Inf/Sup de son niveau, 1 sans Inf ni Sup */
+} NoeudHybride;
+
+#ifdef HYBRID_SLAB
+
+/**
+ * @brief Un Trie Hybride dont les noeuds sont stockés dans une zone mémoire contiguë (slab)
+ *
+ * Moteur optionnel, choisi à la compilation avec `-DHYBRID_SLAB` (`make SLAB=1`). Toutes les fonctions gardent la même
+ * signature. Un trie vide est toujours représenté par un pointeur nul. La slab est libérée d'un coup par `deleteTH()`,
+ * et les noeuds libérés par `supprTH()` sont chaînés dans une liste de cases libres pour être réutilisés. Les nombres
+ * de mots et les valeurs sont gardés à côté dans des tableaux parallèles pour que les noeuds restent sur 16 octets :
+ * les parcours ne touchent que ces 16 octets, mais un noeud coûte en tout 28 octets (16 pour le noeud, puis 4 pour
+ * chacun de @c mots, @c valeurs et @c meilleurs), contre 40 pour un noeud du moteur à pointeurs.
+ *
+ */
+typedef struct trie_hybride
+{
+    NoeudHybride *noeuds; /**< La slab des noeuds, la case 0 n'est pas utilisée */
+    uint32_t *mots;       /**< Nombre de mots du sous arbre de chaque noeud (Inf, Eq et Sup compris), même indice */
+    int *valeurs;         /**< Valeur de fin de mot de chaque noeud, même indice */
+    int *meilleurs;       /**< Plus grande valeur de fin de mot du sous arbre de chaque noeud, même indice */
+    uint32_t taille;      /**< Nombre de cases de la slab déjà entamées, case 0 comprise */
+    uint32_t cap;         /**< Nombre de cases allouées dans la slab */
+    uint32_t libre;       /**< Indice de la première case libre, chaînées par le champ @c inf, 0 si aucune */
+    uint32_t racine;      /**< Indice du noeud racine */
+} TrieHybride;
+
+#else
+
 typedef struct trie_hybride
 {
-    long value; /**< Indicateur de fin de mot si non nul */
-    char label; /**< Un caractère d'une clé stocké dans le trie */
+    int value;       /**< Indicateur de fin de mot si non nul, c'est aussi le score du mot pour `completeTH()` */
+    int meilleur;    /**< Plus grande valeur de fin de mot du sous arbre du noeud, enfants Inf, Eq et Sup compris */
+    char label;      /**< Un caractère d'une clé stocké dans le trie */
+    unsigned char h; /**< Hauteur du noeud dans l'arbre binaire Inf/Sup de son niveau, 1 sans Inf ni Sup */
+    uint32_t mots;   /**< Nombre de mots du sous arbre du noeud, enfants Inf, Eq et Sup compris */
     struct trie_hybride *inf, *eq, *sup;
 } TrieHybride;
 
+#endif
+
 /**
  * @brief Renvoie le premier caractère de la clé
  *
@@ -104,7 +162,7 @@ TrieHybride *newTH(void);
  * @param [in,out] th Un pointeur vers le Trie Hybride à insérer la clé
  * @param [in] cle Une chaine de caractères constituant une clé
  * @param [in] v Une valeur non nul pour indiquer la fin du mot, peut être le numéro d'insértion, le constant @c VALFIN
- * peut être utilisé
+ * peut être utilisé. C'est aussi le score du mot pour `completeTH()`, un mot déjà présent garde sa valeur
  * @return Un pointeur vers le Trie Hybride avec la clé ajouté
  *
  * @pre La clé est terminé par un caractère nul
@@ -125,9 +183,33 @@ TrieHybride *ajoutTH(TrieHybride *th, const char *restrict cle, int v);
  * @pre La clé est terminé par un caractère nul
  * @pre La clé est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
  *
+ * Chaque niveau du trie (les noeuds reliés par @c inf et @c sup) est gardé équilibré comme un arbre AVL. La hauteur
+ * gardée dans chaque noeud est mise à jour en O(1) par les rotations, le rééquilibrage coûte donc O(1) par noeud
+ * traversé au lieu de parcourir les sous arbres, et un niveau de σ caractères se traverse en O(log σ).
+ *
  */
 TrieHybride *ajoutReequilibreTH(TrieHybride *th, const char *restrict cle, int v);
 
+/**
+ * @brief Construit en une fois un Trie Hybride équilibré à partir d'un tableau de mots
+ *
+ * @param [in,out] mots Un tableau de mots, trié sur place
+ * @param [in] n Le nombre de mots du tableau
+ * @param [in] v Une valeur non nul pour indiquer la fin du mot, le constant @c VALFIN peut être utilisé
+ * @return Un pointeur vers le Trie Hybride construit, nul s'il n'y a aucun mot non vide
+ *
+ * @pre Les mots sont terminés par un caractère nul
+ * @pre Les mots sont composés des caractères ASCII (128 possibilités) encodés sur 8 bits
+ * @post Les mots sont triés dans l'ordre du trie, les doublons et les mots vides sont permis
+ *
+ * Après le tri, chaque niveau est construit en prenant comme racine le caractère médian parmi les caractères distincts
+ * des mots à cette profondeur, puis de même pour chaque moitié. Le trie obtenu est parfaitement équilibré sans aucune
+ * rotation, en un seul passage sur les caractères des mots, contrairement à une suite d'appels à `ajoutTH()` qui
+ * donne des niveaux en forme de liste sur une entrée triée.
+ *
+ */
+TrieHybride *construitTH(char **mots, size_t n, int v);
+
 /**
  * @brief Supprime une clé du Trie Hybride donné
  *
@@ -143,6 +225,22 @@ TrieHybride *ajoutReequilibreTH(TrieHybride *th, const char *restrict cle, int v
  */
 TrieHybride *supprTH(TrieHybride *th, const char *restrict cle);
 
+/**
+ * @brief Supprime une clé du Trie Hybride donné, et effectue un rééquilibrage si nécessaire
+ *
+ * @param [in,out] th Un pointeur vers le Trie Hybride à supprimer la clé
+ * @param [in] cle Une chaine de caractères constituant une clé
+ * @return Un pointeur vers le Trie Hybride avec la clé supprimé
+ *
+ * @pre La clé est terminé par un caractère nul
+ * @pre La clé est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * Pendant de `ajoutReequilibreTH()` : un noeud supprimé qui a deux enfants Inf et Sup est remplacé par son successeur,
+ * et les noeuds traversés sont rééquilibrés en remontant, ce qui garde les niveaux équilibrés après des suppressions.
+ *
+ */
+TrieHybride *supprReequilibreTH(TrieHybride *th, const char *restrict cle);
+
 /**
  * @brief Libère l'espace occupé par le Trie Hybride donné
  *
@@ -167,12 +265,51 @@ void deleteTH(TrieHybride **th);
  */
 bool rechercheTH(const TrieHybride *th, const char *restrict cle);
 
+/**
+ * @brief Recherche un lot de clés dans le Trie Hybride donné
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride recherché
+ * @param [in] cles Un tableau de @a n clés
+ * @param [in] n Le nombre de clés
+ * @param [out] resultats Un tableau de @a n booléens, @a resultats[i] reçoit `rechercheTH(th, cles[i])`
+ *
+ * @pre Les clés sont terminées par un caractère nul
+ * @pre Les clés sont composées des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * Plusieurs recherches sont menées de front, chacune avançant d'un noeud à tour de rôle après avoir demandé le noeud
+ * suivant à la mémoire (`__builtin_prefetch`) : sur un trie qui ne tient pas dans le cache, les attentes mémoire des
+ * différentes clés se recouvrent au lieu de s'additionner. Sur un trie qui tient dans le cache, `rechercheTH()` en
+ * boucle reste aussi rapide.
+ *
+ */
+void rechercheBatchTH(const TrieHybride *th, const char *const *cles, size_t n, bool *resultats);
+
+/**
+ * @brief Cherche le plus long mot du Trie Hybride qui est préfixe du texte donné
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in] texte Une chaine de caractères, par exemple une adresse ou une phrase à découper en jetons
+ * @param [out] valeur Reçoit la valeur du mot trouvé, @c VALVIDE s'il n'y en a pas, peut être nul
+ * @return La longueur du plus long mot préfixe du texte, 0 si aucun mot n'est préfixe du texte
+ *
+ * @pre Le texte est terminé par un caractère nul
+ * @pre Le texte est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * Le mot trouvé est le début du texte : il n'est pas recopié. Une seule descente suffit, le dernier noeud de fin de
+ * mot rencontré sur le chemin du texte donne la réponse, en O(|texte| log σ) sur un trie équilibré.
+ *
+ */
+size_t longestPrefixTH(const TrieHybride *th, const char *restrict texte, int *valeur);
+
 /**
  * @brief Compte le nombre de mots dans le Trie Hybride donné
  *
  * @param [in] th Un pointeur vers le Trie Hybride à parcourir
  * @return Un entier non signé indiquant le nombre de clés/mots trouvés
  *
+ * Chaque noeud garde le nombre de mots de son sous arbre, mis à jour par les ajouts, suppressions, rotations et
+ * fusions. Le compte est lu à la racine en O(1).
+ *
  */
 size_t comptageMotsTH(const TrieHybride *th);
 
@@ -247,9 +384,209 @@ double profondeurMoyenneTH(const TrieHybride *th);
  * @pre La clé est terminé par un caractère nul
  * @pre La clé est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
  *
+ * Seule la descente sur la clé est faite, en O(|cle| log σ) sur un trie équilibré. Le compte est ensuite lu dans le
+ * nombre de mots gardé par l'enfant Eq du dernier noeud, sans parcourir les mots qui suivent le préfixe.
+ *
  */
 int prefixeTH(const TrieHybride *th, const char *cle);
 
+/**
+ * @brief Compte les mots du trie qui précèdent la clé donnée dans l'ordre alphabétique
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in] cle Une chaine de caractères constituant une clé, présente ou non dans le trie
+ * @return Le nombre de mots strictement inférieurs à la clé, c'est à dire sa position dans `listeMotsTH()` si elle
+ * est présente
+ *
+ * @pre La clé est terminé par un caractère nul
+ * @pre La clé est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * Seule la descente sur la clé est faite, en O(|cle| log σ) sur un trie équilibré : à chaque noeud quitté par Sup, le
+ * nombre de mots gardé par ses enfants Inf et Eq est ajouté sans les parcourir.
+ *
+ */
+size_t rankTH(const TrieHybride *th, const char *cle);
+
+/**
+ * @brief Renvoie le mot de rang donné dans l'ordre alphabétique
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in] k Le rang du mot, à partir de 0
+ * @return Une copie du k-ième mot à libérer avec `free()`, pointeur nul si le trie a au plus @a k mots
+ *
+ * C'est l'inverse de `rankTH()` : `selectTH(th, rankTH(th, mot))` redonne tout mot présent. Le chemin du mot est
+ * trouvé en comparant @a k aux nombres de mots gardés dans les noeuds, en O(|mot| log σ) sur un trie équilibré, sans
+ * construire la liste de tous les mots comme `listeMotsTH()`.
+ *
+ */
+char *selectTH(const TrieHybride *th, size_t k);
+
+/**
+ * @brief Un curseur qui parcourt les mots d'un Trie Hybride dans l'ordre alphabétique, dans les deux sens
+ *
+ * Le curseur garde le chemin du mot courant et ce mot dans un tampon réutilisé : se déplacer d'un mot à l'autre ne
+ * fait aucune allocation une fois le tampon à la taille du plus long mot rencontré. Le curseur est invalidé par toute
+ * modification du trie.
+ *
+ */
+typedef struct curseur_hybride CurseurTH;
+
+/**
+ * @brief Ouvre un curseur sur le Trie Hybride donné
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir, éventuellement nul (vide)
+ * @return Un curseur hors du trie : `suivantCurseurTH()` donne alors le premier mot, `precedentCurseurTH()` le dernier
+ *
+ * @post C'est à l'appellant de désallouer le curseur avec `deleteCurseurTH()`
+ *
+ * L'ouverture ne parcourt pas le trie, son coût ne dépend pas de sa taille.
+ *
+ */
+CurseurTH *newCurseurTH(const TrieHybride *th);
+
+/**
+ * @brief Désalloue le curseur donné
+ *
+ * @param [in,out] c Un pointeur de pointeur vers le curseur à désallouer
+ *
+ * @post @a c pointe sur nul
+ *
+ */
+void deleteCurseurTH(CurseurTH **c);
+
+/**
+ * @brief Place le curseur sur le premier mot supérieur ou égal à la clé donnée
+ *
+ * @param [in,out] c Le curseur à déplacer
+ * @param [in] cle Une chaine de caractères constituant une clé, présente ou non dans le trie
+ * @return Le mot atteint, pointeur nul s'il n'y en a pas dans les bornes du curseur
+ *
+ * @pre La clé est terminé par un caractère nul
+ * @pre La clé est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * Le mot rendu est emprunté au curseur : il reste valable jusqu'au prochain déplacement du curseur. Seule la descente
+ * sur la clé est faite, en O(|cle| log σ) sur un trie équilibré.
+ *
+ */
+const char *seekCurseurTH(CurseurTH *c, const char *cle);
+
+/**
+ * @brief Restreint le curseur aux mots de l'intervalle [@a lo, @a hi[ et le place sur le premier d'entre eux
+ *
+ * @param [in,out] c Le curseur à déplacer
+ * @param [in] lo La borne inférieure incluse, nulle pour partir du premier mot
+ * @param [in] hi La borne supérieure exclue, nulle pour aller jusqu'au dernier mot
+ * @return Le premier mot de l'intervalle, pointeur nul s'il est vide
+ *
+ * Les bornes ne sont pas copiées et doivent rester valables tant que le curseur s'en sert. `suivantCurseurTH()` et
+ * `precedentCurseurTH()` rendent un pointeur nul en sortant de l'intervalle.
+ *
+ */
+const char *plageCurseurTH(CurseurTH *c, const char *lo, const char *hi);
+
+/**
+ * @brief Avance le curseur au mot suivant
+ *
+ * @param [in,out] c Le curseur à déplacer
+ * @return Le mot suivant, emprunté au curseur, pointeur nul après le dernier mot
+ *
+ * Un curseur sorti par le début repart du premier mot. Le coût amorti d'un pas est constant.
+ *
+ */
+const char *suivantCurseurTH(CurseurTH *c);
+
+/**
+ * @brief Recule le curseur au mot précédent
+ *
+ * @param [in,out] c Le curseur à déplacer
+ * @return Le mot précédent, emprunté au curseur, pointeur nul avant le premier mot
+ *
+ * Un curseur sorti par la fin repart du dernier mot. Le coût amorti d'un pas est constant.
+ *
+ */
+const char *precedentCurseurTH(CurseurTH *c);
+
+/**
+ * @brief Renvoie les mots de plus grandes valeurs qui commencent par le préfixe donné
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in] prefixe Une chaine de caractères, vide pour considérer tous les mots
+ * @param [in] k Le nombre de mots voulus
+ * @return Un tableau terminé par un pointeur nul d'au plus @a k mots, par valeur décroissante
+ *
+ * @pre Le préfixe est terminé par un caractère nul
+ * @pre Le préfixe est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * @post C'est à l'appellant de désallouer le tableau retourné avec `deleteListeMotsTH()`
+ *
+ * La valeur d'un mot est celle donnée à son insertion, qui sert de score. Chaque noeud garde la plus grande valeur de
+ * son sous arbre : après la descente sur le préfixe, les sous arbres sont ouverts du meilleur d'abord avec une file
+ * de priorité, et ceux dont la plus grande valeur ne peut plus entrer dans les @a k premiers ne sont jamais
+ * parcourus. À valeur égale, l'ordre des mots n'est pas spécifié.
+ *
+ */
+char **completeTH(const TrieHybride *th, const char *prefixe, size_t k);
+
+/**
+ * @brief Une fonction appelée sur chaque mot trouvé par `fuzzySearchTH()`
+ *
+ * @param [in] mot Le mot trouvé, emprunté : il n'est valable que pendant l'appel
+ * @param [in] distance La distance d'édition entre ce mot et le mot cherché
+ * @param [in,out] ctx Le contexte donné à `fuzzySearchTH()`
+ *
+ */
+typedef void (*RappelDistanceTH)(const char *mot, int distance, void *ctx);
+
+/**
+ * @brief Cherche les mots du Trie Hybride à une distance d'édition au plus @a maxEdits du mot donné
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in] mot Une chaine de caractères, présente ou non dans le trie
+ * @param [in] maxEdits Le nombre maximal d'insertions, suppressions et substitutions d'un caractère
+ * @param [in] rappel La fonction appelée sur chaque mot trouvé, dans l'ordre alphabétique
+ * @param [in,out] ctx Un pointeur passé tel quel à @a rappel
+ * @return Le nombre de mots trouvés
+ *
+ * @pre Le mot est terminé par un caractère nul
+ * @pre Le mot est composé des caractères ASCII (128 possibilités) encodé sur 8 bits
+ *
+ * La distance de Levenshtein est calculée une ligne par caractère en descendant le trie, les mots partageant un
+ * préfixe partagent ses lignes. Un sous arbre Eq n'est pas ouvert dès que toute la ligne dépasse @a maxEdits : avec un
+ * seuil de 1 ou 2 seule une petite partie du trie est parcourue.
+ *
+ */
+size_t fuzzySearchTH(const TrieHybride *th, const char *mot, int maxEdits, RappelDistanceTH rappel, void *ctx);
+
+/**
+ * @brief Une fonction appelée sur chaque mot trouvé par `rechercheMotifTH()`
+ *
+ * @param [in] mot Le mot trouvé, emprunté : il n'est valable que pendant l'appel
+ * @param [in,out] ctx Le contexte donné à `rechercheMotifTH()`
+ *
+ */
+typedef void (*RappelMotTH)(const char *mot, void *ctx);
+
+/**
+ * @brief Cherche les mots du Trie Hybride reconnus par le motif donné
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in] motif Un motif façon glob : `?` pour un caractère quelconque, `*` pour une suite quelconque de
+ * caractères éventuellement vide, `[bc]` pour un caractère parmi ceux entre crochets (intervalles `[a-z]`, complément
+ * `[!bc]` ou `[^bc]`), `\` pour prendre le caractère suivant littéralement
+ * @param [in] rappel La fonction appelée sur chaque mot reconnu, dans l'ordre alphabétique
+ * @param [in,out] ctx Un pointeur passé tel quel à @a rappel
+ * @return Le nombre de mots reconnus
+ *
+ * @pre Le motif est terminé par un caractère nul
+ *
+ * Le motif est suivi par un automate dont l'ensemble des états est calculé une fois par caractère en descendant le
+ * trie : une `*` ne fait jamais repartir le parcours en arrière. À chaque niveau, seules les branches Inf et Sup qui
+ * peuvent contenir un caractère accepté sont ouvertes, et une branche Eq est abandonnée dès que plus aucun état n'est
+ * actif.
+ *
+ */
+size_t rechercheMotifTH(const TrieHybride *th, const char *motif, RappelMotTH rappel, void *ctx);
+
 /**
  * @brief Sérialise le Trie Hybride donné sous format JSON
  *
@@ -258,9 +595,29 @@ int prefixeTH(const TrieHybride *th, const char *cle);
  *
  * @post C'est à l'appellant de désallouer la chaine retourné
  *
+ * Le texte est celui que donnait `cJSON_Print()`, écrit par `ecritJSONTH()` dans une sortie en mémoire, au membre
+ * `"value"` près (voir `ecritJSONTH()`).
+ *
  */
 char *printJSONTH(const TrieHybride *th);
 
+/**
+ * @brief Écrit le Trie Hybride donné sous format JSON dans la sortie donnée
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [in,out] s Une sortie JSON ouverte, compacte ou non
+ *
+ * Le trie est parcouru itérativement et chaque noeud est écrit dès qu'il est atteint, sans arbre cJSON intermédiaire :
+ * vers un descripteur ou un @c FILE, la mémoire utilisée ne dépend que de la hauteur du trie. Les erreurs d'écriture
+ * sont rendues par `fermeSortieJSON()`.
+ *
+ * Un noeud de fin de mot dont la valeur n'est pas @c VALFIN, le score donné à `ajoutTH()` par exemple, a un membre
+ * `"value"` de plus après `"is_end_of_word"`, pour que `completeTH()` retrouve ses scores après relecture. Un trie
+ * construit avec @c VALFIN s'écrit comme avant.
+ *
+ */
+void ecritJSONTH(const TrieHybride *th, SortieJSON *s);
+
 /**
  * @brief Désérialise le JSON en Trie Hybride
  *
@@ -275,9 +632,118 @@ char *printJSONTH(const TrieHybride *th);
  * création d'un arbre différent dû à la reconstruction. Le Trie Hybride créé correspond exactement à la disposition
  * donné en JSON.
  *
+ * Les noeuds sont construits au fil des jetons, sans arbre cJSON intermédiaire. Un JSON invalide arrête le programme en
+ * indiquant l'octet fautif.
+ *
+ * Le membre `"value"`, un entier non nul, donne la valeur de fin de mot du noeud, @c VALFIN sans lui. Les clés
+ * inconnues étant ignorées, un fichier écrit avant ce membre se relit tel quel.
+ *
  */
 TrieHybride *parseJSONTH(const char *json, size_t sz);
 
+/**
+ * @brief Désérialise en Trie Hybride le JSON lu depuis le descripteur de fichier donné
+ *
+ * @param [in] fd Un descripteur de fichier ouvert en lecture, qui n'est pas refermé
+ * @return Un pointeur vers le Trie Hybride créé
+ *
+ * @post C'est à l'appellant de désallouer le Trie Hybride retourné
+ *
+ * Même désérialisation que `parseJSONTH()`, mais le JSON est lu par blocs de @c TAILLE_FLUX_JSON octets : en dehors
+ * du trie construit, la mémoire utilisée ne dépend que de sa profondeur, pas de la taille du fichier. Le descripteur
+ * peut être un tube.
+ *
+ */
+TrieHybride *chargeJSONTH(int fd);
+
+/**
+ * @def SNAPSHOT_TH_MAGIE
+ *
+ * @brief Les 8 premiers octets d'un snapshot binaire de Trie Hybride, caractère nul compris
+ *
+ */
+#define SNAPSHOT_TH_MAGIE "TRIEHYB"
+
+/**
+ * @def SNAPSHOT_TH_VERSION
+ *
+ * @brief La version du format écrit par `printSnapshotTH()`, à augmenter à chaque changement de disposition
+ *
+ */
+#define SNAPSHOT_TH_VERSION 1
+
+/**
+ * @brief Sérialise le Trie Hybride donné sous forme de snapshot binaire
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à parcourir
+ * @param [out] sz La taille en octets du snapshot
+ * @return Une zone mémoire contenant le snapshot, à écrire telle quelle dans un fichier
+ *
+ * @post C'est à l'appellant de désallouer la zone retournée
+ *
+ * Le snapshot est fait d'une entête de 32 octets (@c SNAPSHOT_TH_MAGIE, version, nombre de noeuds, indice de la
+ * racine et somme de contrôle des octets qui suivent) puis de quatre tableaux plats indicés par noeud : les
+ * @c NoeudHybride, les nombres de mots (`uint32_t`), les valeurs et les plus grandes valeurs (`int32_t`). Les
+ * enfants sont désignés par leur indice et les noeuds sont numérotés en largeur à partir de 1, l'indice 0 valant nul.
+ * Tout est écrit dans l'ordre des octets de la machine.
+ *
+ */
+void *printSnapshotTH(const TrieHybride *th, size_t *sz);
+
+/**
+ * @brief Vérifie qu'une zone mémoire contient un snapshot de Trie Hybride intègre
+ *
+ * @param [in] snap La zone mémoire, par exemple un fichier projeté avec `mmap()`
+ * @param [in] sz La taille en octets de la zone
+ * @return Vrai si l'entête, la taille, la somme de contrôle, les indices des enfants et les compteurs des noeuds sont
+ * cohérents
+ *
+ * @pre @a snap est aligné sur 8 octets
+ *
+ * Les enfants doivent être numérotés dans l'ordre où `printSnapshotTH()` les écrit, chacun après son parent : les
+ * recherches sur un snapshot vérifié restent dans la zone et terminent toujours, et aucun noeud n'a deux parents. Le
+ * nombre de mots et la plus grande valeur de chaque sous arbre doivent correspondre à ceux de ses enfants.
+ *
+ */
+bool verifieSnapshotTH(const void *snap, size_t sz);
+
+/**
+ * @brief Désérialise un snapshot binaire en Trie Hybride modifiable
+ *
+ * @param [in] snap La zone mémoire contenant le snapshot
+ * @param [in] sz La taille en octets de la zone
+ * @return Un pointeur vers le Trie Hybride créé, nul si le snapshot est celui d'un trie vide
+ *
+ * @pre @a snap est aligné sur 8 octets
+ *
+ * @post C'est à l'appellant de désallouer le Trie Hybride retourné
+ *
+ * Comme `parseJSONTH()`, la disposition des noeuds est reprise telle quelle, valeurs de fin de mot comprises. Un
+ * snapshot qui ne passe pas `verifieSnapshotTH()` arrête le programme.
+ *
+ */
+TrieHybride *parseSnapshotTH(const void *snap, size_t sz);
+
+/**
+ * @brief Recherche une clé directement dans un snapshot binaire, sans le désérialiser
+ *
+ * @param [in] snap Un snapshot qui a passé `verifieSnapshotTH()`
+ * @param [in] cle La clé à rechercher
+ * @return Le même résultat que `rechercheTH()` sur le trie du snapshot
+ *
+ */
+bool rechercheSnapshotTH(const void *snap, const char *cle);
+
+/**
+ * @brief Compte les mots ayant la clé donnée pour préfixe directement dans un snapshot binaire
+ *
+ * @param [in] snap Un snapshot qui a passé `verifieSnapshotTH()`
+ * @param [in] cle Le préfixe
+ * @return Le même résultat que `prefixeTH()` sur le trie du snapshot
+ *
+ */
+int prefixeSnapshotTH(const void *snap, const char *cle);
+
 /**
  * @brief Fusionne deux Tries Hybrides donnés (semi "in place")
  *
@@ -297,6 +763,11 @@ TrieHybride *parseJSONTH(const char *json, size_t sz);
  * cette fonction. @a th2 reste identique et n'est accédé qu'en lecture. Le trie pointé par @a th2 est donc à désallouer
  * par l'appellant avec @c deleteTH contrairement à @a th1.
  *
+ * La fusion est structurelle : les deux tries sont parcourus ensemble niveau par niveau. Chaque noeud de @a th2 est
+ * retrouvé, ou ajouté, dans le niveau correspondant de @a th1, et un niveau de @a th2 sans équivalent dans @a th1 est
+ * copié d'un coup avec tous ses descendants. Le travail est donc proportionnel à la partie commune des deux tries
+ * plus la taille de ce qui est copié, au lieu de réinsérer chaque mot de @a th2 depuis la racine.
+ *
  */
 TrieHybride *fusionTH(TrieHybride **restrict th1, const TrieHybride *restrict th2);
 
@@ -323,12 +794,13 @@ TrieHybride *fusionCopieTH(const TrieHybride *restrict th1, const TrieHybride *r
  *
  * @pre Le Trie Hybride donné est non vide (non nul)
  *
- * Si les pointeurs d'indirection (aiguillage : @c inf et @c sup) qui se suivent directement l'un après l'autre sont en
- * nombre supérieur d'un côté que l'autre, alors le rééquilibrage est effectué pour minimiser le nombre d'indirections
- * causant la plus grande raison de perte du temps dans une multitude d'opérations. En effet, au lieu d'avancer vers le
- * but (avancer dans les caractères d'une clé donné), c'est à cause de ces indirections qu'on perd du temps à retrouver
- * le bon endroit pour déjà commencer à avancer vers notre but. Ce rééquilibrage diminue aussi la profondeur moyenne qui
- * contribue à l'optimisation du complexité.
+ * Si la hauteur des pointeurs d'indirection (aiguillage : @c inf et @c sup) qui se suivent directement l'un après
+ * l'autre diffère de plus d'un entre les deux côtés, alors le rééquilibrage est effectué pour minimiser le nombre
+ * d'indirections causant la plus grande raison de perte du temps dans une multitude d'opérations. En effet, au lieu
+ * d'avancer vers le but (avancer dans les caractères d'une clé donné), c'est à cause de ces indirections qu'on perd du
+ * temps à retrouver le bon endroit pour déjà commencer à avancer vers notre but. Ce rééquilibrage diminue aussi la
+ * profondeur moyenne qui contribue à l'optimisation du complexité. Les hauteurs sont lues dans les noeuds, le calcul
+ * du facteur se fait en O(1).
  *
  */
 TrieHybride *rebalance(TrieHybride *th);
@@ -11,18 +11,104 @@
  *
  */
 #define ASCII_SIZE 128
-#define EOE_INDEX 0
 #define EOE_CHAR '\x01'
 #define MAX_WORDS 1##000##000L
 #define MAX_WORD_LENGTH 100
+#define NODE_KEYS 16
+#define EDGE_INLINE 4
+#define SNAPSHOT_PT_MAGIE "TRIEPAT"
+#define SNAPSHOT_PT_VERSION 1
 #include "cJSON.h"
+#include "fluxjson.h"
 #include <stdbool.h>
+#include <stdint.h>
 
+/**
+ * @brief Les différentes tailles de noeud Patricia, choisies selon le nombre d'arêtes sortantes
+ *
+ * Un noeud commence en @c NODE4 et grandit (ou rétrécit) automatiquement au fil des insertions, suppressions et
+ * fusions. @c NODE4 et @c NODE16 gardent leurs clés triées dans @c keys, @c NODE48 passe par une table d'index sur
+ * les 128 caractères et @c NODE128 indexe directement ses arêtes par caractère.
+ */
+typedef enum PatriciaNodeType{
+    NODE4 = 0,
+    NODE16 = 1,
+    NODE48 = 2,
+    NODE128 = 3
+} PatriciaNodeType;
+
+/**
+ * @brief L'arène qui contient les préfixes de toutes les arêtes d'un même Patricia-Trie
+ *
+ * Les préfixes trop longs pour tenir dans leur arête y sont rangés bout à bout, sans caractère nul. Couper une arête
+ * en deux ne fait que créer deux tranches de la même zone et recoller deux tranches voisines ne copie rien. Les octets
+ * qui ne sont plus référencés sont comptés dans @c dead et l'arène est compactée lorsqu'ils deviennent majoritaires.
+ */
+typedef struct PatriciaArena{
+    char *buf;
+    uint32_t size;                /**< Nombre d'octets utilisés dans @c buf */
+    uint32_t cap;                 /**< Capacité de @c buf */
+    uint32_t dead;                /**< Nombre d'octets de @c buf qui n'appartiennent plus à aucune arête */
+    struct PatriciaNode *root;    /**< La racine du trie, qui possède l'arène */
+} PatriciaArena;
+
+/**
+ * @brief Une arête sortante d'un noeud Patricia : son préfixe et le noeud enfant (nul pour une feuille)
+ *
+ * Un préfixe d'au plus @c EDGE_INLINE octets, la grande majorité sur des mots d'une langue naturelle, est rangé dans
+ * l'arête même à la place de sa position dans l'arène. Sinon le préfixe est la tranche [@c off, @c off + @c len[ de
+ * l'arène du noeud. Dans les deux cas il se lit avec @c label_patricia.
+ */
+typedef struct PatriciaEdge{
+    union {
+        char inl[EDGE_INLINE];     /**< Le préfixe, si @c len <= @c EDGE_INLINE */
+        uint32_t off;              /**< La position du préfixe dans l'arène, sinon */
+    };
+    uint32_t len;
+    struct PatriciaNode *child;
+} PatriciaEdge;
+_Static_assert(EDGE_INLINE >= sizeof(uint32_t), "Un préfixe en ligne occupe au moins la place de sa position");
+
+/**
+ * @brief Un noeud Patricia à taille adaptative
+ *
+ * L'entête du noeud ne bouge jamais en mémoire, seul le tableau d'arêtes est réalloué lors d'un changement de type.
+ * Un NODE4, le cas de loin le plus fréquent, garde ses arêtes dans l'entête même et ne coûte qu'une allocation.
+ * Les pointeurs vers les arêtes (@c PatriciaEdge) sont donc invalidés par tout ajout ou retrait d'arête sur ce même
+ * noeud, mais pas les pointeurs vers les noeuds eux-mêmes.
+ */
 typedef struct PatriciaNode{
-    char *prefixes[ASCII_SIZE];
-    struct PatriciaNode *children[ASCII_SIZE];
+    unsigned char keys[NODE_KEYS]; /**< NODE4/NODE16 : clés triées, @c keys[i] correspond à @c edges[i], comparées
+                                        en une fois par SSE2 quand disponible (@c PATRICIA_NO_SIMD pour désactiver) */
+    unsigned char type;            /**< Un @c PatriciaNodeType */
+    unsigned char count;           /**< Nombre d'arêtes présentes */
+    bool end;                      /**< Un mot se termine sur ce noeud */
+    uint32_t words;                /**< Nombre de mots du sous-arbre, fin de mot du noeud et feuilles comprises */
+    PatriciaArena *arena;          /**< L'arène des préfixes, partagée par tous les noeuds du trie */
+    PatriciaEdge *edges;           /**< Tableau d'arêtes, de taille la capacité du type */
+    unsigned char *index;          /**< NODE48 : @c index[c] vaut l'emplacement de l'arête + 1, 0 si absente */
+    PatriciaEdge inline_edges[4];  /**< NODE4 : les arêtes sont stockées ici, @c edges pointe dessus */
 } PatriciaNode;
 
+/**
+ * @brief Un curseur qui parcourt les mots d'un Patricia-Trie dans l'ordre alphabétique, dans les deux sens
+ *
+ * Le curseur garde le chemin du mot courant et ce mot dans un tampon réutilisé, sans allocation par mot, et peut être
+ * restreint à un intervalle de mots. Plusieurs curseurs peuvent parcourir le même trie en même temps.
+ */
+typedef struct PatriciaCursor PatriciaCursor;
+
+/**
+ * @brief Une fonction appelée sur chaque mot trouvé par @c fuzzy_search_patricia, avec sa distance d'édition au mot
+ * cherché. Le mot n'est valable que pendant l'appel.
+ */
+typedef void (*PatriciaFuzzyCallback)(const char* word, int distance, void* ctx);
+
+/**
+ * @brief Une fonction appelée sur chaque mot trouvé par @c glob_patricia. Le mot n'est valable que pendant l'appel.
+ */
+typedef void (*PatriciaWordCallback)(const char* word, void* ctx);
+
 //FONCTION AUXILIAIRES
 
 const char* suffixe(const char* s1, const char* s2);
@@ -36,6 +122,13 @@ void prefixe_fusion(const char* s1, const char* s2, char* x, char* y, char* z);
 PatriciaNode* pat_cons(PatriciaNode* node, const char* word);
 void free_list_patricia(char** list, int size);
 
+//NOEUDS ADAPTATIFS
+PatriciaEdge *edge_patricia(const PatriciaNode *node, unsigned char c);
+PatriciaEdge *add_edge_patricia(PatriciaNode *node, unsigned char c);
+void remove_edge_patricia(PatriciaNode *node, unsigned char c);
+PatriciaEdge *next_edge_patricia(const PatriciaNode *node, int *key);
+const char *label_patricia(const PatriciaNode *node, const PatriciaEdge *edge);
+
 //FONCTIONS PRINCIPALES
 PatriciaNode *create_patricia_node(void);
 
@@ -43,8 +136,33 @@ void insert_patricia(PatriciaNode *root, const char *mot);
 
 int recherche_patricia(PatriciaNode* patricia, const char* word);
 
+int longest_prefix_patricia(const PatriciaNode* node, const char* text);
+
+void recherche_batch_patricia(const PatriciaNode* node, const char* const* words, size_t n, int* results);
+
 int nb_prefixe_patricia(PatriciaNode* node, const char* word);
 
+int rank_patricia(PatriciaNode* node, const char* word);
+
+char* select_patricia(PatriciaNode* node, int k);
+
+PatriciaCursor* cursor_open_patricia(const PatriciaNode* root);
+
+void cursor_close_patricia(PatriciaCursor* cursor);
+
+const char* cursor_seek_patricia(PatriciaCursor* cursor, const char* word);
+
+const char* cursor_range_patricia(PatriciaCursor* cursor, const char* lo, const char* hi);
+
+const char* cursor_next_patricia(PatriciaCursor* cursor);
+
+const char* cursor_prev_patricia(PatriciaCursor* cursor);
+
+int fuzzy_search_patricia(const PatriciaNode* node, const char* word, int max_edits, PatriciaFuzzyCallback callback,
+                          void* ctx);
+
+int glob_patricia(const PatriciaNode* node, const char* pattern, PatriciaWordCallback callback, void* ctx);
+
 int delete_word(PatriciaNode* node, const char* word);
 
 int comptage_mots_patricia(PatriciaNode* node);
@@ -68,6 +186,16 @@ void liste_mots_patricia_recursive(PatriciaNode* node, const char* prefix, char*
 
 cJSON *constructJSONPT(const PatriciaNode *node, const char *label);
 char *printJSONPT(const PatriciaNode *node);
-PatriciaNode *parseJSONPT_rec(const cJSON *json, char **label);
+void ecritJSONPT(const PatriciaNode *node, SortieJSON *s);
+void parseJSONPT_rec(const cJSON *json, PatriciaNode *node);
 PatriciaNode *parseJSONPT(const char *json, size_t sz);
+PatriciaNode *chargeJSONPT(int fd);
+
+//SNAPSHOT BINAIRE
+
+void *printSnapshotPT(const PatriciaNode *node, size_t *sz);
+bool verifieSnapshotPT(const void *snap, size_t sz);
+PatriciaNode *parseSnapshotPT(const void *snap, size_t sz);
+int recherche_snapshot_patricia(const void *snap, const char *word);
+int nb_prefixe_snapshot_patricia(const void *snap, const char *word);
 #endif
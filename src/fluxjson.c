@@ -0,0 +1,617 @@
+/**
+ * @file fluxjson.c
+ * @author Efe ERKEN (efe.erken@etu.sorbonne-universite.fr)
+ * @brief Fichier source contenant les corps des fonctions pour lire et écrire un JSON au fil de l'eau
+ * @version 0.1
+ * @date 2024-12-18
+ *
+ * @copyright Copyright (C) 2024 Efe ERKEN
+ *
+ */
+
+#include "fluxjson.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+void ouvreFluxJSON(FluxJSON *f, int fd)
+{
+    *f = (FluxJSON){.fd = fd};
+    f->bloc = malloc(TAILLE_FLUX_JSON);
+    if (!f->bloc)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    f->buf = f->bloc;
+}
+
+void ouvreMemoireFluxJSON(FluxJSON *f, const char *buf, size_t sz)
+{
+    *f = (FluxJSON){.fd = -1, .buf = buf, .fin = sz};
+}
+
+void fermeFluxJSON(FluxJSON *f)
+{
+    free(f->bloc);
+    free(f->chaine);
+    *f = (FluxJSON){.fd = -1};
+}
+
+size_t positionFluxJSON(const FluxJSON *f)
+{
+    return f->lus + f->pos;
+}
+
+/**
+ * @private
+ *
+ * @brief S'assure qu'au moins un octet est disponible dans le flux, en lisant le bloc suivant au besoin
+ *
+ * @param [in,out] f Un pointeur vers le flux
+ * @return true si un octet est disponible, false à la fin de l'entrée
+ *
+ * Une erreur de lecture est signalée sur la sortie d'erreur et se comporte comme la fin de l'entrée : le JSON coupé
+ * est alors rejeté par l'appellant.
+ *
+ */
+static bool remplitFluxJSON(FluxJSON *f)
+{
+    if (f->pos < f->fin)
+        return true;
+    if (f->fd < 0)
+        return false;
+    ssize_t n;
+    do
+        n = read(f->fd, f->bloc, TAILLE_FLUX_JSON);
+    while (n < 0 && errno == EINTR);
+    if (n < 0)
+        perror("read");
+    if (n <= 0)
+    {
+        f->fd = -1;
+        return false;
+    }
+    f->lus += f->fin;
+    f->pos = 0;
+    f->fin = (size_t)n;
+    return true;
+}
+
+/**
+ * @private
+ *
+ * @brief Consomme l'octet suivant du flux
+ *
+ * @param [in,out] f Un pointeur vers le flux
+ * @return L'octet lu, ou -1 à la fin de l'entrée
+ *
+ */
+static inline int octetFluxJSON(FluxJSON *f)
+{
+    return remplitFluxJSON(f) ? (unsigned char)f->buf[f->pos++] : -1;
+}
+
+/**
+ * @private
+ *
+ * @brief Ajoute des octets à la fin de la chaine courante du flux, en gardant le caractère nul final
+ *
+ */
+static void ajouteFluxJSON(FluxJSON *f, const char *s, size_t n)
+{
+    if (f->lg + n + 1 > f->cap)
+    {
+        size_t cap = f->cap ? f->cap : 64;
+        while (f->lg + n + 1 > cap)
+            cap *= 2;
+        char *tmp = realloc(f->chaine, cap);
+        if (!tmp)
+        {
+            perror("realloc");
+            exit(1);
+        }
+        f->chaine = tmp;
+        f->cap = cap;
+    }
+    memcpy(f->chaine + f->lg, s, n);
+    f->lg += n;
+    f->chaine[f->lg] = '\0';
+}
+
+/**
+ * @private
+ *
+ * @brief Lit les 4 chiffres hexadécimaux d'un échappement `\uXXXX`
+ *
+ * @return Le point de code lu, ou -1 si les chiffres ne sont pas valides
+ *
+ */
+static long hexFluxJSON(FluxJSON *f)
+{
+    long v = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int c = octetFluxJSON(f);
+        if (c >= '0' && c <= '9')
+            v = v * 16 + (c - '0');
+        else if (c >= 'a' && c <= 'f')
+            v = v * 16 + (c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            v = v * 16 + (c - 'A' + 10);
+        else
+            return -1;
+    }
+    return v;
+}
+
+/**
+ * @private
+ *
+ * @brief Décode un échappement `\uXXXX`, paire de substitution comprise, et ajoute son encodage UTF-8 à la chaine
+ *
+ * @return true si l'échappement est valide, false sinon
+ *
+ */
+static bool unicodeFluxJSON(FluxJSON *f)
+{
+    long cp = hexFluxJSON(f);
+    if (cp < 0 || (cp >= 0xDC00 && cp <= 0xDFFF))
+        return false;
+    if (cp >= 0xD800 && cp <= 0xDBFF)
+    {
+        if (octetFluxJSON(f) != '\\' || octetFluxJSON(f) != 'u')
+            return false;
+        long bas = hexFluxJSON(f);
+        if (bas < 0xDC00 || bas > 0xDFFF)
+            return false;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (bas - 0xDC00);
+    }
+    char u[4];
+    size_t n;
+    if (cp < 0x80)
+    {
+        u[0] = (char)cp;
+        n = 1;
+    }
+    else if (cp < 0x800)
+    {
+        u[0] = (char)(0xC0 | (cp >> 6));
+        u[1] = (char)(0x80 | (cp & 0x3F));
+        n = 2;
+    }
+    else if (cp < 0x10000)
+    {
+        u[0] = (char)(0xE0 | (cp >> 12));
+        u[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        u[2] = (char)(0x80 | (cp & 0x3F));
+        n = 3;
+    }
+    else
+    {
+        u[0] = (char)(0xF0 | (cp >> 18));
+        u[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        u[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        u[3] = (char)(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    ajouteFluxJSON(f, u, n);
+    return true;
+}
+
+/**
+ * @private
+ *
+ * @brief Lit une chaine dont le guillemet ouvrant est déjà consommé
+ *
+ * Les suites d'octets sans échappement sont copiées d'un bloc, sans passer octet par octet.
+ *
+ */
+static JetonJSON chaineFluxJSON(FluxJSON *f)
+{
+    f->lg = 0;
+    ajouteFluxJSON(f, "", 0);
+    for (;;)
+    {
+        if (!remplitFluxJSON(f))
+            return JSON_ERREUR;
+        const char *deb = f->buf + f->pos;
+        const char *p = deb;
+        const char *fin = f->buf + f->fin;
+        while (p < fin && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20)
+            p++;
+        ajouteFluxJSON(f, deb, (size_t)(p - deb));
+        f->pos += (size_t)(p - deb);
+        if (p == fin)
+            continue;
+        int c = octetFluxJSON(f);
+        if (c == '"')
+            return JSON_CHAINE;
+        if (c != '\\')
+            return JSON_ERREUR;
+        char e;
+        switch (octetFluxJSON(f))
+        {
+        case '"':
+            e = '"';
+            break;
+        case '\\':
+            e = '\\';
+            break;
+        case '/':
+            e = '/';
+            break;
+        case 'b':
+            e = '\b';
+            break;
+        case 'f':
+            e = '\f';
+            break;
+        case 'n':
+            e = '\n';
+            break;
+        case 'r':
+            e = '\r';
+            break;
+        case 't':
+            e = '\t';
+            break;
+        case 'u':
+            if (!unicodeFluxJSON(f))
+                return JSON_ERREUR;
+            continue;
+        default:
+            return JSON_ERREUR;
+        }
+        ajouteFluxJSON(f, &e, 1);
+    }
+}
+
+/**
+ * @private
+ *
+ * @brief Vérifie que le flux continue par le mot donné, pour les littéraux `true`, `false` et `null`
+ *
+ */
+static bool motFluxJSON(FluxJSON *f, const char *mot)
+{
+    for (; *mot; mot++)
+        if (octetFluxJSON(f) != (unsigned char)*mot)
+            return false;
+    return true;
+}
+
+/**
+ * @private
+ *
+ * @brief Lit un nombre dont le premier caractère est déjà consommé, son texte est gardé dans la chaine du flux
+ *
+ */
+static JetonJSON nombreFluxJSON(FluxJSON *f, char premier)
+{
+    f->lg = 0;
+    ajouteFluxJSON(f, &premier, 1);
+    while (remplitFluxJSON(f))
+    {
+        char c = f->buf[f->pos];
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'))
+            break;
+        ajouteFluxJSON(f, &c, 1);
+        f->pos++;
+    }
+    char *fin;
+    strtod(f->chaine, &fin);
+    return *fin ? JSON_ERREUR : JSON_NOMBRE;
+}
+
+JetonJSON jetonFluxJSON(FluxJSON *f)
+{
+    int c;
+    do
+        c = octetFluxJSON(f);
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+    switch (c)
+    {
+    case -1:
+        return JSON_FIN;
+    case '{':
+        return JSON_DEBUT_OBJET;
+    case '}':
+        return JSON_FIN_OBJET;
+    case '[':
+        return JSON_DEBUT_TABLEAU;
+    case ']':
+        return JSON_FIN_TABLEAU;
+    case ':':
+        return JSON_DEUX_POINTS;
+    case ',':
+        return JSON_VIRGULE;
+    case '"':
+        return chaineFluxJSON(f);
+    case 't':
+        return motFluxJSON(f, "rue") ? JSON_VRAI : JSON_ERREUR;
+    case 'f':
+        return motFluxJSON(f, "alse") ? JSON_FAUX : JSON_ERREUR;
+    case 'n':
+        return motFluxJSON(f, "ull") ? JSON_NUL : JSON_ERREUR;
+    default:
+        if (c == '-' || (c >= '0' && c <= '9'))
+            return nombreFluxJSON(f, (char)c);
+        return JSON_ERREUR;
+    }
+}
+
+bool sauteValeurFluxJSON(FluxJSON *f, JetonJSON premier)
+{
+    size_t prof = 0;
+    JetonJSON j = premier;
+    for (;;)
+    {
+        switch (j)
+        {
+        case JSON_DEBUT_OBJET:
+        case JSON_DEBUT_TABLEAU:
+            prof++;
+            break;
+        case JSON_FIN_OBJET:
+        case JSON_FIN_TABLEAU:
+            if (!prof)
+                return false;
+            prof--;
+            break;
+        case JSON_FIN:
+        case JSON_ERREUR:
+            return false;
+        default:
+            break;
+        }
+        if (!prof)
+            return j != JSON_DEUX_POINTS && j != JSON_VIRGULE;
+        j = jetonFluxJSON(f);
+    }
+}
+
+/**
+ * @private
+ *
+ * @brief Ouvre une sortie vers le descripteur ou le fichier donné, ou vers la mémoire si les deux sont absents
+ *
+ */
+static void ouvreToutSortieJSON(SortieJSON *s, int fd, FILE *f, bool compact)
+{
+    *s = (SortieJSON){.fd = fd, .f = f, .cap = TAILLE_FLUX_JSON, .compact = compact};
+    s->buf = malloc(s->cap);
+    if (!s->buf)
+    {
+        perror("malloc");
+        exit(1);
+    }
+}
+
+void ouvreSortieJSON(SortieJSON *s, int fd, bool compact)
+{
+    ouvreToutSortieJSON(s, fd, NULL, compact);
+}
+
+void ouvreFichierSortieJSON(SortieJSON *s, FILE *f, bool compact)
+{
+    ouvreToutSortieJSON(s, -1, f, compact);
+}
+
+void ouvreMemoireSortieJSON(SortieJSON *s, bool compact)
+{
+    ouvreToutSortieJSON(s, -1, NULL, compact);
+}
+
+/**
+ * @private
+ *
+ * @brief Écrit les octets en attente vers le descripteur ou le fichier de la sortie, écritures partielles comprises
+ *
+ */
+static void videSortieJSON(SortieJSON *s)
+{
+    if (s->f)
+    {
+        if (fwrite(s->buf, 1, s->pos, s->f) < s->pos)
+            s->erreur = true;
+    }
+    else
+    {
+        for (size_t fait = 0; fait < s->pos;)
+        {
+            ssize_t n = write(s->fd, s->buf + fait, s->pos - fait);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+            {
+                s->erreur = true;
+                break;
+            }
+            fait += (size_t)n;
+        }
+    }
+    s->pos = 0;
+}
+
+/**
+ * @private
+ *
+ * @brief Ajoute des octets à la sortie, en vidant le bloc ou en agrandissant la mémoire au besoin
+ *
+ */
+static void ecritSortieJSON(SortieJSON *s, const char *p, size_t n)
+{
+    if (s->pos + n > s->cap)
+    {
+        if (s->fd >= 0 || s->f)
+        {
+            videSortieJSON(s);
+            if (n > s->cap)
+            {
+                /* Un morceau plus grand que le bloc est écrit directement, sans copie */
+                char *buf = s->buf;
+                s->buf = (char *)p;
+                s->pos = n;
+                videSortieJSON(s);
+                s->buf = buf;
+                return;
+            }
+        }
+        else
+        {
+            size_t cap = s->cap;
+            while (s->pos + n > cap)
+                cap *= 2;
+            char *tmp = realloc(s->buf, cap);
+            if (!tmp)
+            {
+                perror("realloc");
+                exit(1);
+            }
+            s->buf = tmp;
+            s->cap = cap;
+        }
+    }
+    memcpy(s->buf + s->pos, p, n);
+    s->pos += n;
+}
+
+/**
+ * @private
+ *
+ * @brief Va à la ligne et indente d'autant de tabulations que la profondeur donnée, sauf en mode compact
+ *
+ */
+static void ligneSortieJSON(SortieJSON *s, size_t prof)
+{
+    static const char tabs[] = "\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+    if (s->compact)
+        return;
+    size_t n = prof < sizeof(tabs) - 2 ? prof : sizeof(tabs) - 2;
+    ecritSortieJSON(s, tabs, n + 1);
+    for (prof -= n; prof; prof -= n)
+    {
+        n = prof < sizeof(tabs) - 2 ? prof : sizeof(tabs) - 2;
+        ecritSortieJSON(s, tabs + 1, n);
+    }
+}
+
+void debutObjetSortieJSON(SortieJSON *s)
+{
+    ecritSortieJSON(s, "{", 1);
+    s->prof++;
+    s->vide = true;
+}
+
+void finObjetSortieJSON(SortieJSON *s)
+{
+    /* cJSON va à la ligne après le dernier membre, et juste après l'accolade ouvrante d'un objet vide */
+    s->prof--;
+    ligneSortieJSON(s, s->prof);
+    ecritSortieJSON(s, "}", 1);
+    s->vide = false;
+}
+
+void cleSortieJSON(SortieJSON *s, const char *cle, size_t lg)
+{
+    if (!s->vide)
+        ecritSortieJSON(s, ",", 1);
+    s->vide = false;
+    ligneSortieJSON(s, s->prof);
+    chaineSortieJSON(s, cle, lg);
+    ecritSortieJSON(s, ":\t", s->compact ? 1 : 2);
+}
+
+void chaineSortieJSON(SortieJSON *s, const char *str, size_t lg)
+{
+    ecritSortieJSON(s, "\"", 1);
+    const char *fin = str + lg;
+    while (str < fin)
+    {
+        /* Les suites sans caractère à échapper sont écrites d'un coup */
+        const char *p = str;
+        while (p < fin && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20)
+            p++;
+        ecritSortieJSON(s, str, (size_t)(p - str));
+        if (p == fin)
+            break;
+        char e[7] = {'\\', 0};
+        size_t n = 2;
+        switch (*p)
+        {
+        case '"':
+        case '\\':
+            e[1] = *p;
+            break;
+        case '\b':
+            e[1] = 'b';
+            break;
+        case '\f':
+            e[1] = 'f';
+            break;
+        case '\n':
+            e[1] = 'n';
+            break;
+        case '\r':
+            e[1] = 'r';
+            break;
+        case '\t':
+            e[1] = 't';
+            break;
+        default:
+            snprintf(e + 1, sizeof(e) - 1, "u%04x", (unsigned char)*p);
+            n = 6;
+            break;
+        }
+        ecritSortieJSON(s, e, n);
+        str = p + 1;
+    }
+    ecritSortieJSON(s, "\"", 1);
+}
+
+void boolSortieJSON(SortieJSON *s, bool b)
+{
+    if (b)
+        ecritSortieJSON(s, "true", 4);
+    else
+        ecritSortieJSON(s, "false", 5);
+}
+
+void entierSortieJSON(SortieJSON *s, long n)
+{
+    char texte[24];
+    int lg = snprintf(texte, sizeof(texte), "%ld", n);
+    ecritSortieJSON(s, texte, (size_t)lg);
+}
+
+void nulSortieJSON(SortieJSON *s)
+{
+    ecritSortieJSON(s, "null", 4);
+}
+
+bool fermeSortieJSON(SortieJSON *s)
+{
+    if (s->fd >= 0 || s->f)
+        videSortieJSON(s);
+    if (s->f && fflush(s->f) == EOF)
+        s->erreur = true;
+    bool ok = !s->erreur;
+    free(s->buf);
+    *s = (SortieJSON){.fd = -1};
+    return ok;
+}
+
+char *rendMemoireSortieJSON(SortieJSON *s)
+{
+    ecritSortieJSON(s, "", 1);
+    char *str = s->buf;
+    *s = (SortieJSON){.fd = -1};
+    return str;
+}
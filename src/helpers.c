@@ -13,43 +13,88 @@
 #include "helpers.h"
 #include "hybrid.h"
 #include "patricia.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
 #include <unistd.h>
 
-void insererPT(void)
+/**
+ * @private
+ *
+ * @brief Vrai si les JSON doivent être écrits sans retours à la ligne ni indentation
+ *
+ * Choisi par la variable d'environnement @c TRIES_JSON_COMPACT, à une valeur autre que vide ou "0". Les lecteurs
+ * acceptent les deux formes.
+ *
+ */
+static bool jsonCompact(void)
 {
-    PatriciaNode *pt = create_patricia_node();
-    ssize_t sz;
-    size_t cap = 0;
-    char *s = NULL;
-    while ((sz = getline(&s, &cap, stdin)) > 0)
+    const char *v = getenv("TRIES_JSON_COMPACT");
+    return v && *v && strcmp(v, "0") != 0;
+}
+
+/**
+ * @private
+ *
+ * @brief Écrit le Patricia-Trie donné sous format JSON dans le fichier donné, au fil de l'eau
+ *
+ */
+static void ecritFichierPT(const PatriciaNode *pt, FILE *f)
+{
+    SortieJSON s;
+    ouvreFichierSortieJSON(&s, f, jsonCompact());
+    ecritJSONPT(pt, &s);
+    if (!fermeSortieJSON(&s))
     {
-        if (!feof(stdin))
-            s[sz - 1] = '\0';
-        insert_patricia(pt, s);
+        perror("Erreur, écriture dans ecritFichierPT");
+        exit(1);
     }
-    if (sz == -1 && ferror(stdin))
+}
+
+/**
+ * @private
+ *
+ * @brief Comme `ecritFichierPT()`, pour un Trie Hybride
+ *
+ */
+static void ecritFichierTH(const TrieHybride *th, FILE *f)
+{
+    SortieJSON s;
+    ouvreFichierSortieJSON(&s, f, jsonCompact());
+    ecritJSONTH(th, &s);
+    if (!fermeSortieJSON(&s))
     {
-        fprintf(stderr, "Erreur, getline dans insererPT");
+        perror("Erreur, écriture dans ecritFichierTH");
         exit(1);
     }
-    free(s);
-    char *json = printJSONPT(pt);
-    printf("%s", json);
-    free(json);
-    free_patricia_node(pt);
 }
 
-void insererTH(bool isRebalanced)
+/**
+ * @private
+ *
+ * @brief Une opération d'ajout (`A`) ou de suppression (`S`) d'un mot, appliquée à un trie ou à un journal
+ *
+ */
+typedef void (*AppliqueMot)(void *ctx, char op, const char *mot);
+
+/**
+ * @private
+ *
+ * @brief Applique l'opération donnée à chaque mot lu depuis l'entrée standard, un par ligne
+ *
+ */
+static void lisMots(AppliqueMot applique, void *ctx, char op)
 {
-    TrieHybride *(*ajout)(TrieHybride *th, const char *restrict cle, int v);
-    if (isRebalanced)
-        ajout = ajoutReequilibreTH;
-    else
-        ajout = ajoutTH;
-    TrieHybride *th = newTH();
-    long count = 1;
     ssize_t sz;
     size_t cap = 0;
     char *s = NULL;
@@ -57,422 +102,1944 @@ void insererTH(bool isRebalanced)
     {
         if (!feof(stdin))
             s[sz - 1] = '\0';
-        th = ajout(th, s, count++);
+        applique(ctx, op, s);
     }
     if (sz == -1 && ferror(stdin))
     {
-        fprintf(stderr, "Erreur, getline dans insererTH");
+        fprintf(stderr, "Erreur, getline dans lisMots");
         exit(1);
     }
     free(s);
-    s = printJSONTH(th);
-    printf("%s", s);
-    free(s);
-    deleteTH(&th);
 }
 
 /**
  * @private
  *
- * @brief Lit un fichier JSON dans son ensemble dans un buffer
- *
- * @param [in] f Un pointeur de fichier auparavant ouvert au moins en lecture
- * @param [out] sz Un entier contenant la taille en octets du buffer renvoyé à la fin
- * @return Une chaine de caractères contenant la version sérialisé en JSON du Trie Hybride
+ * @brief Renvoie le chemin du journal du fichier de trie donné : le même chemin suivi de ".journal"
  *
- * @pre @a f doit supporter les déplacements de curseur
- * @pre @a sz n'est pas nul
- * @post C'est à l'appellant de désallouer la chaine retourné
- *
- * Détermine la taille du fichier en question et alloue un buffer de cette taille exactement en une fois. Puis, lit tout
- * le fichier vers le buffer en une fois. Retourne un pointeur vers le buffer qui contient le contenu de tout le
- * fichier. @a sz contient la taille du buffer renvoyé à la fin. Le buffer renvoyé n'est pas forcément nul terminé. Le
- * curseur du fichier est déplacé au début pour lire tout le fichier mais il est remis à sa place d'origine à la sortie
- * de fonction. Les erreurs du flux sont donc forcément effacées dûs à ces déplacements. Il peut donc continuer à être
- * utilisé comme normal après appel à cette fonction.
+ * @post C'est à l'appellant de désallouer la chaine retournée
  *
  */
-char *readJSON(FILE *f, size_t *sz)
+static char *cheminJournal(const char *path)
 {
-    const long fpos = ftell(f);
-    if (fpos == -1)
-    {
-        perror("Erreur, ftell dans readJSON");
-        exit(1);
-    }
-    if (fseek(f, 0, SEEK_END) == -1)
-    {
-        perror("Erreur, fseek dans readJSON");
-        exit(1);
-    }
-    const long fsize = ftell(f);
-    if (fsize == -1)
+    size_t lg = strlen(path) + sizeof(".journal");
+    char *chemin = malloc(lg);
+    if (!chemin)
     {
-        perror("Erreur, ftell dans readJSON");
+        fprintf(stderr, "Erreur, malloc dans cheminJournal");
         exit(1);
     }
-    rewind(f);
+    snprintf(chemin, lg, "%s.journal", path);
+    return chemin;
+}
 
-    char *s = malloc(fsize * sizeof(*s));
-    if (!s)
-    {
-        fprintf(stderr, "Erreur, malloc dans readJSON");
-        exit(1);
-    }
-    if (fread(s, fsize, 1, f) < 1)
+/**
+ * @private
+ *
+ * @brief Vrai si les modifications du fichier de trie donné doivent être ajoutées à son journal plutôt que de le
+ * réécrire en entier
+ *
+ * Choisi par la variable d'environnement @c TRIES_JOURNAL, à une valeur autre que vide ou "0", ou par l'existence du
+ * journal : une fois créé, il reçoit toutes les modifications jusqu'à sa compaction.
+ *
+ */
+static bool modeJournal(const char *path)
+{
+    const char *v = getenv("TRIES_JOURNAL");
+    if (v && *v && strcmp(v, "0") != 0)
+        return true;
+    char *chemin = cheminJournal(path);
+    bool existe = access(chemin, F_OK) == 0;
+    free(chemin);
+    return existe;
+}
+
+/**
+ * @private
+ *
+ * @brief Vrai si le fichier de trie donné n'a pas de journal, ou un journal vide
+ *
+ */
+static bool journalVide(const char *path)
+{
+    char *chemin = cheminJournal(path);
+    struct stat st;
+    bool vide = stat(chemin, &st) == -1 || st.st_size == 0;
+    free(chemin);
+    return vide;
+}
+
+/**
+ * @private
+ *
+ * @brief Supprime le journal du fichier de trie donné, s'il existe, une fois ses enregistrements dans le fichier
+ *
+ */
+static void supprimeJournal(const char *path)
+{
+    char *chemin = cheminJournal(path);
+    if (unlink(chemin) == -1 && errno != ENOENT)
     {
-        fprintf(stderr, "Erreur, fread dans readJSON");
+        perror("Erreur, unlink dans supprimeJournal");
         exit(1);
     }
-    if (fseek(f, fpos, SEEK_SET) == -1)
+    free(chemin);
+}
+
+/**
+ * @private
+ *
+ * @brief Indique si le descripteur donné est bien celui du journal au bout du chemin donné, et non un journal déjà
+ * supprimé par une compaction
+ *
+ */
+static bool estJournal(int fd, const char *chemin)
+{
+    struct stat ouvert, actuel;
+    if (fstat(fd, &ouvert) == -1)
     {
-        perror("Erreur, fseek dans readJSON");
+        perror("Erreur, fstat dans estJournal");
         exit(1);
     }
-    clearerr(f);
-    *sz = fsize;
-    return s;
+    return stat(chemin, &actuel) == 0 && actuel.st_dev == ouvert.st_dev && actuel.st_ino == ouvert.st_ino;
 }
 
-void suppressionPT(const char *path)
+/**
+ * @private
+ *
+ * @brief Renvoie la position qui suit le dernier retour à la ligne des @a taille premiers octets du journal donné
+ *
+ */
+static off_t finJournal(int fd, off_t taille)
 {
-    FILE *f = fopen(path, "r+");
-    if (!f)
+    /* Recule jusqu'au dernier retour à la ligne, en général le dernier octet */
+    off_t fin = taille;
+    char bloc[4096];
+    while (fin > 0)
     {
-        perror("Erreur, fopen dans suppressionPT");
-        exit(1);
+        size_t n = fin < (off_t)sizeof(bloc) ? (size_t)fin : sizeof(bloc);
+        if (pread(fd, bloc, n, fin - n) != (ssize_t)n)
+        {
+            perror("Erreur, pread dans finJournal");
+            exit(1);
+        }
+        size_t i = n;
+        while (i > 0 && bloc[i - 1] != '\n')
+            i--;
+        fin -= n - i;
+        if (i > 0)
+            break;
     }
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    PatriciaNode *pt = parseJSONPT(s, fsize);
-    free(s);
+    return fin;
+}
 
-    ssize_t sz;
-    size_t cap = 0;
-    s = NULL;
-    while ((sz = getline(&s, &cap, stdin)) > 0)
+/**
+ * @private
+ *
+ * @brief Ouvre le journal du fichier de trie donné et le verrouille avec `flock()`
+ *
+ * @param [in] path Le chemin du fichier de trie
+ * @param [in] options Les options de `open()`
+ * @param [in] verrou @c LOCK_SH pour ajouter des enregistrements, @c LOCK_EX pour compacter, avec @c LOCK_NB pour ne
+ * pas attendre
+ * @return Le descripteur du journal verrouillé, -1 si le journal n'existe pas (sans @c O_CREAT) ou si le verrou est
+ * pris (avec @c LOCK_NB, @c errno vaut alors @c EWOULDBLOCK)
+ *
+ * Une compaction supprime le journal en gardant son verrou : un écrivain qui l'attendait tient alors un journal qui
+ * n'est plus au bout du chemin, et où ses enregistrements seraient perdus. Il rouvre donc le journal tant que le
+ * descripteur verrouillé n'est pas celui du chemin.
+ *
+ */
+static int verrouilleJournal(const char *path, int options, int verrou)
+{
+    char *chemin = cheminJournal(path);
+    for (;;)
     {
-        if (!feof(stdin))
-            s[sz - 1] = '\0';
-        int i = delete_word(pt, s);
-        if (!(i == 0 || i == 1))
+        int fd = open(chemin, options, 0644);
+        if (fd == -1 && errno == ENOENT && !(options & O_CREAT))
+            break;
+        if (fd == -1)
+        {
+            perror("Erreur, open dans verrouilleJournal");
+            exit(1);
+        }
+        if (flock(fd, verrou) == -1)
         {
-            fprintf(stderr, "Erreur, suppressionPT");
+            if (errno == EWOULDBLOCK)
+            {
+                close(fd);
+                free(chemin);
+                errno = EWOULDBLOCK;
+                return -1;
+            }
+            perror("Erreur, flock dans verrouilleJournal");
             exit(1);
         }
+        if (estJournal(fd, chemin))
+        {
+            free(chemin);
+            return fd;
+        }
+        close(fd);
     }
-    if (sz == -1 && ferror(stdin))
+    free(chemin);
+    errno = ENOENT;
+    return -1;
+}
+
+/**
+ * @private
+ *
+ * @brief Ouvre en ajout le journal du fichier de trie donné, en le créant au besoin, sous un verrou partagé gardé
+ * jusqu'à sa fermeture
+ *
+ * Un enregistrement est une ligne : la lettre de la requête du serveur (`A` ou `S`), une espace et le mot. Un arrêt
+ * brutal pendant une écriture peut laisser une dernière ligne sans retour à la ligne, jamais confirmée : elle est
+ * ignorée à la relecture, et tronquée ici pour que le prochain enregistrement ne s'y colle pas. La troncature
+ * demande le verrou exclusif : tant qu'un autre écrivain tient le journal, la ligne incomplète peut être la sienne.
+ *
+ * Le verrou partagé empêche `compactionMainPT()` de supprimer le journal sous l'écrivain.
+ *
+ */
+static FILE *ouvreJournal(const char *path)
+{
+    int fd = verrouilleJournal(path, O_RDWR | O_CREAT | O_APPEND, LOCK_SH);
+    struct stat st;
+    if (fstat(fd, &st) == -1)
     {
-        fprintf(stderr, "Erreur, getline dans suppressionPT");
+        perror("Erreur, fstat dans ouvreJournal");
         exit(1);
     }
-
-    free(s);
-    rewind(f);
-    if (ftruncate(fileno(f), 0) == -1)
+    if (finJournal(fd, st.st_size) < st.st_size)
     {
-        perror("Erreur, ftruncate dans suppressionPT");
-        exit(1);
+        /* Sous le verrou exclusif, la ligne incomplète ne peut plus être celle d'un écrivain encore en cours */
+        if (flock(fd, LOCK_EX | LOCK_NB) == 0)
+        {
+            if (fstat(fd, &st) == -1 || ftruncate(fd, finJournal(fd, st.st_size)) == -1)
+            {
+                perror("Erreur, ftruncate dans ouvreJournal");
+                exit(1);
+            }
+        }
+        /* La conversion du verrou n'est pas atomique, il a pu être perdu, et le journal compacté entre-temps */
+        if (flock(fd, LOCK_SH) == -1)
+        {
+            perror("Erreur, flock dans ouvreJournal");
+            exit(1);
+        }
+        char *chemin = cheminJournal(path);
+        bool meme = estJournal(fd, chemin);
+        free(chemin);
+        if (!meme)
+        {
+            close(fd);
+            return ouvreJournal(path);
+        }
     }
-    s = printJSONPT(pt);
-    fprintf(f, "%s", s);
 
-    if (fclose(f) == EOF)
+    FILE *j = fdopen(fd, "a");
+    if (!j)
     {
-        perror("Erreur, fclose dans suppressionPT");
+        perror("Erreur, fdopen dans ouvreJournal");
         exit(1);
     }
-    free(s);
-    free_patricia_node(pt);
+    return j;
 }
 
-void suppressionTH(const char *path)
+/**
+ * @private
+ *
+ * @brief Ajoute un enregistrement au journal ouvert donné, voir `ouvreJournal()` et `AppliqueMot`
+ *
+ */
+static void ecritJournal(void *journal, char op, const char *mot)
 {
-    FILE *f = fopen(path, "r+");
-    if (!f)
+    if (fprintf(journal, "%c %s\n", op, mot) < 0)
     {
-        perror("Erreur, fopen dans suppressionTH");
+        perror("Erreur, fprintf dans ecritJournal");
         exit(1);
     }
+}
 
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    TrieHybride *th = parseJSONTH(s, fsize);
-    free(s);
-
-    ssize_t sz;
-    size_t cap = 0;
-    s = NULL;
-    while ((sz = getline(&s, &cap, stdin)) > 0)
-    {
-        if (!feof(stdin))
-            s[sz - 1] = '\0';
-        th = supprTH(th, s);
-    }
-    if (sz == -1 && ferror(stdin))
+/**
+ * @private
+ *
+ * @brief Écrit les enregistrements en attente du journal donné jusque sur le disque
+ *
+ */
+static void synchroniseJournal(FILE *j)
+{
+    if (fflush(j) == EOF || fsync(fileno(j)) == -1)
     {
-        fprintf(stderr, "Erreur, getline dans suppressionTH");
+        perror("Erreur, fsync dans synchroniseJournal");
         exit(1);
     }
-    free(s);
+}
 
-    rewind(f);
-    if (ftruncate(fileno(f), 0) == -1)
+/**
+ * @private
+ *
+ * @brief Écrit les enregistrements en attente du journal donné jusque sur le disque et le referme
+ *
+ */
+static void fermeJournal(FILE *j)
+{
+    synchroniseJournal(j);
+    if (fclose(j) == EOF)
     {
-        perror("Erreur, ftruncate dans suppressionTH");
+        perror("Erreur, fclose dans fermeJournal");
         exit(1);
     }
-    s = printJSONTH(th);
-    fprintf(f, "%s", s);
+}
 
-    if (fclose(f) == EOF)
+/**
+ * @private
+ *
+ * @brief Ajoute l'opération donnée au journal du fichier de trie donné pour chaque mot lu depuis l'entrée standard,
+ * sans lire le trie
+ *
+ */
+static void journaliseMots(const char *path, char op)
+{
+    if (access(path, F_OK) == -1)
     {
-        perror("Erreur, fclose dans suppressionTH");
+        perror("Erreur, access dans journaliseMots");
         exit(1);
     }
-    free(s);
-    deleteTH(&th);
+    FILE *j = ouvreJournal(path);
+    lisMots(ecritJournal, j, op);
+    fermeJournal(j);
 }
 
-void fusionMainPT(const char *path1, const char *path2)
+/**
+ * @private
+ *
+ * @brief Rejoue sur le trie donné les enregistrements du journal du fichier donné, s'il en a un
+ *
+ */
+static void rejoueJournal(const char *path, AppliqueMot applique, void *trie)
 {
-    FILE *f1 = fopen(path1, "r");
-    if (!f1)
+    char *chemin = cheminJournal(path);
+    FILE *j = fopen(chemin, "r");
+    free(chemin);
+    if (!j)
     {
-        perror("Erreur, fopen dans fusionMainPT");
+        if (errno == ENOENT)
+            return;
+        perror("Erreur, fopen dans rejoueJournal");
         exit(1);
     }
-    FILE *f2 = fopen(path2, "r");
-    if (!f2)
+    ssize_t sz;
+    size_t cap = 0;
+    char *s = NULL;
+    while ((sz = getline(&s, &cap, j)) > 0)
+    {
+        /* Une dernière ligne incomplète est une écriture interrompue, voir `ouvreJournal()` */
+        if (s[sz - 1] != '\n')
+            break;
+        s[sz - 1] = '\0';
+        if (sz < 3 || s[1] != ' ' || (s[0] != 'A' && s[0] != 'S'))
+        {
+            fprintf(stderr, "Erreur, enregistrement invalide dans rejoueJournal");
+            exit(1);
+        }
+        applique(trie, s[0], s + 2);
+    }
+    if (sz == -1 && ferror(j))
     {
-        perror("Erreur, fopen dans fusionMainPT");
+        fprintf(stderr, "Erreur, getline dans rejoueJournal");
         exit(1);
     }
-    size_t fsize;
-    char *s;
-    s = readJSON(f1, &fsize);
-    PatriciaNode *pt1 = parseJSONPT(s, fsize);
-    free(s);
-    s = readJSON(f2, &fsize);
-    PatriciaNode *pt2 = parseJSONPT(s, fsize);
     free(s);
+    fclose(j);
+}
 
-    pt1 = pat_fusion(pt1, pt2);
-    s = printJSONPT(pt1);
-    printf("%s", s);
-    free(s);
+/**
+ * @private
+ *
+ * @brief Applique une opération à un Patricia-Trie, voir `AppliqueMot`
+ *
+ */
+static void appliquePT(void *pt, char op, const char *mot)
+{
+    if (op == 'A')
+        insert_patricia(pt, mot);
+    else
+        delete_word(pt, mot);
+}
 
-    if (fclose(f1) == EOF)
-    {
-        perror("Erreur, fclose dans profondeurMoyenneMainTH");
-        exit(1);
-    }
-    if (fclose(f2) == EOF)
-    {
-        perror("Erreur, fclose dans profondeurMoyenneMainTH");
-        exit(1);
-    }
-    free_patricia_node(pt1);
+/**
+ * @private
+ *
+ * @brief Applique une opération au Trie Hybride dont l'adresse de la racine est donnée, voir `AppliqueMot`
+ *
+ */
+static void appliqueTH(void *th, char op, const char *mot)
+{
+    TrieHybride **racine = th;
+    if (op == 'A')
+        *racine = ajoutTH(*racine, mot, VALFIN);
+    else
+        *racine = supprTH(*racine, mot);
 }
 
-void fusionMainTH(const char *path1, const char *path2)
+void insererPT(void)
 {
-    FILE *f1 = fopen(path1, "r");
-    if (!f1)
+    PatriciaNode *pt = create_patricia_node();
+    ssize_t sz;
+    size_t cap = 0;
+    char *s = NULL;
+    while ((sz = getline(&s, &cap, stdin)) > 0)
     {
-        perror("Erreur, fopen dans profondeurMoyenneMainTH");
-        exit(1);
+        if (!feof(stdin))
+            s[sz - 1] = '\0';
+        insert_patricia(pt, s);
     }
-    FILE *f2 = fopen(path2, "r");
-    if (!f2)
+    if (sz == -1 && ferror(stdin))
     {
-        perror("Erreur, fopen dans profondeurMoyenneMainTH");
+        fprintf(stderr, "Erreur, getline dans insererPT");
         exit(1);
     }
-
-    size_t fsize;
-    char *s;
-    s = readJSON(f1, &fsize);
-    TrieHybride *th1 = parseJSONTH(s, fsize);
-    free(s);
-    s = readJSON(f2, &fsize);
-    TrieHybride *th2 = parseJSONTH(s, fsize);
-    free(s);
-
-    th1 = fusionTH(&th1, th2);
-    s = printJSONTH(th1);
-    printf("%s", s);
     free(s);
+    ecritFichierPT(pt, stdout);
+    free_patricia_node(pt);
+}
 
-    if (fclose(f1) == EOF)
-    {
-        perror("Erreur, fclose dans profondeurMoyenneMainTH");
-        exit(1);
+/**
+ * @private
+ *
+ * @brief Lit toutes les lignes de l'entrée standard, sans leur fin de ligne
+ *
+ * @param [out] n Le nombre de lignes lues
+ * @return Un tableau des lignes, chacune allouée à part
+ *
+ * @post C'est à l'appellant de désallouer les lignes et le tableau
+ *
+ */
+static char **lisLignes(size_t *n)
+{
+    char **lignes = NULL;
+    size_t nb = 0, capLignes = 0;
+    ssize_t sz;
+    size_t cap = 0;
+    char *s = NULL;
+    while ((sz = getline(&s, &cap, stdin)) > 0)
+    {
+        if (!feof(stdin))
+            s[sz - 1] = '\0';
+        if (nb == capLignes)
+        {
+            capLignes = capLignes ? 2 * capLignes : 1024;
+            lignes = realloc(lignes, capLignes * sizeof(*lignes));
+            if (!lignes)
+            {
+                fprintf(stderr, "Erreur, realloc dans lisLignes");
+                exit(1);
+            }
+        }
+        lignes[nb++] = s;
+        s = NULL;
+        cap = 0;
     }
-    if (fclose(f2) == EOF)
+    if (sz == -1 && ferror(stdin))
     {
-        perror("Erreur, fclose dans profondeurMoyenneMainTH");
+        fprintf(stderr, "Erreur, getline dans lisLignes");
         exit(1);
     }
-    deleteTH(&th1);
-    deleteTH(&th2);
+    free(s);
+    *n = nb;
+    return lignes;
 }
 
-void listeMotsMainPT(const char *path)
+void insererTH(bool isRebalanced)
 {
-    FILE *f = fopen(path, "r");
-    if (!f)
+    TrieHybride *th = newTH();
+    if (isRebalanced)
     {
-        perror("Erreur, fopen dans listeMotsMainPT");
-        exit(1);
+        /* Le fichier entier est disponible, le trie équilibré est construit d'un coup sans rotation */
+        size_t n;
+        char **lignes = lisLignes(&n);
+        th = construitTH(lignes, n, VALFIN);
+        for (size_t i = 0; i < n; i++)
+            free(lignes[i]);
+        free(lignes);
     }
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    PatriciaNode *pt = parseJSONPT(s, fsize);
-    free(s);
-    char **liste = liste_mots_patricia(pt);
-    if (liste)
+    else
     {
-        for (char **i = liste; *i; i++)
+        long count = 1;
+        ssize_t sz;
+        size_t cap = 0;
+        char *s = NULL;
+        while ((sz = getline(&s, &cap, stdin)) > 0)
         {
-            printf("%s\n", *i);
+            if (!feof(stdin))
+                s[sz - 1] = '\0';
+            th = ajoutTH(th, s, count++);
+        }
+        if (sz == -1 && ferror(stdin))
+        {
+            fprintf(stderr, "Erreur, getline dans insererTH");
+            exit(1);
         }
+        free(s);
     }
+    ecritFichierTH(th, stdout);
+    deleteTH(&th);
+}
 
-    if (fclose(f) == EOF)
+/**
+ * @private
+ *
+ * @brief Ouvre en écriture le fichier temporaire qui remplacera le fichier donné
+ *
+ * @param [in] path Le chemin du fichier à remplacer
+ * @param [out] tmp Le chemin du fichier temporaire, à rendre à `remplaceFichier()`
+ * @return Le fichier temporaire ouvert
+ *
+ */
+static FILE *ouvreTemporaire(const char *path, char **tmp)
+{
+    size_t lg = strlen(path) + sizeof(".tmp");
+    *tmp = malloc(lg);
+    if (!*tmp)
     {
-        perror("Erreur, fclose dans listeMotsMainPT");
+        fprintf(stderr, "Erreur, malloc dans ouvreTemporaire");
         exit(1);
     }
-    int size = comptage_mots_patricia(pt);
-    free_patricia_node(pt);
-    free_list_patricia(liste, size);
+    snprintf(*tmp, lg, "%s.tmp", path);
+    FILE *f = fopen(*tmp, "w");
+    if (!f)
+    {
+        perror("Erreur, fopen dans ouvreTemporaire");
+        exit(1);
+    }
+    return f;
 }
 
-void listeMotsMainTH(const char *path)
+/**
+ * @private
+ *
+ * @brief Écrit sur le disque l'entrée du dossier contenant le fichier donné, pour qu'un renommage y survive à un
+ * plantage
+ *
+ */
+static void synchroniseDossier(const char *path)
 {
-    FILE *f = fopen(path, "r");
-    if (!f)
+    const char *slash = strrchr(path, '/');
+    char *dossier = slash ? strndup(path, slash == path ? 1 : (size_t)(slash - path)) : strdup(".");
+    if (!dossier)
     {
-        perror("Erreur, fopen dans listeMotsMainTH");
+        fprintf(stderr, "Erreur, malloc dans synchroniseDossier");
         exit(1);
     }
-
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    TrieHybride *th = parseJSONTH(s, fsize);
-    free(s);
-
-    char **tab = listeMotsTH(th);
-    if (tab)
+    int fd = open(dossier, O_RDONLY);
+    /* Certains systèmes de fichiers ne savent pas synchroniser un dossier, le renommage reste alors au mieux */
+    if (fd == -1 || (fsync(fd) == -1 && errno != EINVAL))
     {
-        for (char **i = tab; *i; i++)
-        {
-            printf("%s\n", *i);
-        }
+        perror("Erreur, fsync dans synchroniseDossier");
+        exit(1);
     }
+    close(fd);
+    free(dossier);
+}
 
+/**
+ * @private
+ *
+ * @brief Referme le fichier temporaire ouvert par `ouvreTemporaire()` et le renomme en le fichier donné
+ *
+ * Un autre processus qui a projeté l'ancien fichier en mémoire garde l'ancienne version intacte au lieu de la voir
+ * tronquée sous lui. Le fichier temporaire est écrit sur le disque avant le renommage, et le dossier après : au retour,
+ * un plantage laisse le nouveau fichier en entier, jamais un fichier vide ou l'ancien.
+ *
+ */
+static void remplaceFichier(FILE *f, char *tmp, const char *path)
+{
+    if (fflush(f) == EOF || fsync(fileno(f)) == -1)
+    {
+        perror("Erreur, fsync dans remplaceFichier");
+        exit(1);
+    }
     if (fclose(f) == EOF)
     {
-        perror("Erreur, fclose dans listeMotsMainTH");
+        perror("Erreur, fclose dans remplaceFichier");
         exit(1);
     }
-    deleteListeMotsTH(tab);
-    deleteTH(&th);
+    if (rename(tmp, path) == -1)
+    {
+        perror("Erreur, rename dans remplaceFichier");
+        exit(1);
+    }
+    synchroniseDossier(path);
+    free(tmp);
 }
 
-void profondeurMoyenneMainPT(const char *path)
+/**
+ * @private
+ *
+ * @brief Remplace le contenu du fichier donné par les octets donnés, voir `remplaceFichier()`
+ *
+ */
+static void sauveFichier(const char *path, const void *buf, size_t sz)
 {
-    FILE *f = fopen(path, "r");
-    if (!f)
+    char *tmp;
+    FILE *f = ouvreTemporaire(path, &tmp);
+    if (fwrite(buf, 1, sz, f) < sz)
     {
-        perror("Erreur, fopen dans profondeurMoyenneMainPT");
+        fprintf(stderr, "Erreur, fwrite dans sauveFichier");
         exit(1);
     }
+    remplaceFichier(f, tmp, path);
+}
 
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    PatriciaNode *pt = parseJSONPT(s, fsize);
-    free(s);
-
-    printf("%f", profondeur_moyenne_patricia_feuille(pt));
+/**
+ * @private
+ *
+ * @brief Un fichier de trie projeté en mémoire en lecture seule
+ *
+ */
+typedef struct projection
+{
+    void *buf; /**< Le début du fichier, nul s'il est vide ou n'est plus projeté */
+    size_t sz;
+} Projection;
 
-    if (fclose(f) == EOF)
+/**
+ * @private
+ *
+ * @brief Projette en mémoire le fichier ouvert donné, sans le lire : seules les pages touchées seront chargées
+ *
+ */
+static Projection projette(int fd)
+{
+    Projection p = {NULL, 0};
+    struct stat st;
+    if (fstat(fd, &st) == -1)
     {
-        perror("Erreur, fclose dans profondeurMoyenneMainPT");
+        perror("Erreur, fstat dans projette");
         exit(1);
     }
-    free_patricia_node(pt);
+    p.sz = st.st_size;
+    if (p.sz)
+    {
+        p.buf = mmap(NULL, p.sz, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p.buf == MAP_FAILED)
+        {
+            perror("Erreur, mmap dans projette");
+            exit(1);
+        }
+    }
+    return p;
 }
 
-void profondeurMoyenneMainTH(const char *path)
+/**
+ * @private
+ *
+ * @brief Libère la projection donnée, sans effet si elle est déjà libérée
+ *
+ */
+static void libereProjection(Projection *p)
 {
-    FILE *f = fopen(path, "r");
-    if (!f)
+    if (p->buf && munmap(p->buf, p->sz) == -1)
     {
-        perror("Erreur, fopen dans profondeurMoyenneMainTH");
+        perror("Erreur, munmap dans libereProjection");
         exit(1);
     }
+    p->buf = NULL;
+    p->sz = 0;
+}
 
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    TrieHybride *th = parseJSONTH(s, fsize);
-    free(s);
-
-    printf("%f", profondeurMoyenneTH(th));
+/**
+ * @private
+ *
+ * @brief Vrai si le fichier ouvert donné commence par la signature de snapshot donnée, caractère nul compris
+ *
+ */
+static bool estSnapshot(int fd, const char *magie)
+{
+    char buf[16];
+    size_t n = strlen(magie) + 1;
+    return pread(fd, buf, n, 0) == (ssize_t)n && memcmp(buf, magie, n) == 0;
+}
 
-    if (fclose(f) == EOF)
+/**
+ * @private
+ *
+ * @brief Ouvre le fichier donné, le projette si c'est un snapshot binaire valide de Patricia-Trie et sinon le lit
+ * comme un JSON, par blocs, puis rejoue son journal
+ *
+ * @param [in] path Le chemin du fichier
+ * @param [out] pt Le trie lu du JSON, nul pour un snapshot projeté
+ * @param [out] binaire Si non nul, reçoit vrai si le fichier est un snapshot binaire
+ * @return La projection du snapshot, vide pour un JSON ou si le journal n'est pas vide
+ *
+ * Les recherches sur un snapshot projeté ignoreraient le journal : s'il n'est pas vide, le trie est désérialisé pour
+ * le rejouer.
+ *
+ */
+static Projection chargePT(const char *path, PatriciaNode **pt, bool *binaire)
+{
+    Projection p = {NULL, 0};
+    *pt = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
     {
-        perror("Erreur, fclose dans profondeurMoyenneMainTH");
+        perror("Erreur, open dans chargePT");
         exit(1);
     }
-    deleteTH(&th);
+    bool snap = estSnapshot(fd, SNAPSHOT_PT_MAGIE);
+    if (binaire)
+        *binaire = snap;
+    if (snap)
+    {
+        p = projette(fd);
+        if (!verifieSnapshotPT(p.buf, p.sz))
+        {
+            fprintf(stderr, "Erreur, snapshot invalide dans chargePT");
+            exit(1);
+        }
+        if (!journalVide(path))
+        {
+            *pt = parseSnapshotPT(p.buf, p.sz);
+            libereProjection(&p);
+        }
+    }
+    else
+        *pt = chargeJSONPT(fd);
+    close(fd);
+    if (!p.buf)
+        rejoueJournal(path, appliquePT, *pt);
+    return p;
 }
 
-void prefixeMainPT(const char *path, const char *cle)
+/**
+ * @private
+ *
+ * @brief Comme `chargePT()`, pour un Trie Hybride
+ *
+ * @param [in] path Le chemin du fichier
+ * @param [out] th Le trie lu du JSON, nul pour un snapshot projeté
+ * @param [out] binaire Si non nul, reçoit vrai si le fichier est un snapshot binaire
+ * @return La projection du snapshot, vide pour un JSON ou si le journal n'est pas vide
+ *
+ */
+static Projection chargeTH(const char *path, TrieHybride **th, bool *binaire)
 {
-    FILE *f = fopen(path, "r");
-    if (!f)
+    Projection p = {NULL, 0};
+    *th = NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
     {
-        perror("Erreur, fopen dans prefixeMainPT");
+        perror("Erreur, open dans chargeTH");
         exit(1);
     }
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    PatriciaNode *pt = parseJSONPT(s, fsize);
-    free(s);
+    bool snap = estSnapshot(fd, SNAPSHOT_TH_MAGIE);
+    if (binaire)
+        *binaire = snap;
+    if (snap)
+    {
+        p = projette(fd);
+        if (!verifieSnapshotTH(p.buf, p.sz))
+        {
+            fprintf(stderr, "Erreur, snapshot invalide dans chargeTH");
+            exit(1);
+        }
+        if (!journalVide(path))
+        {
+            *th = parseSnapshotTH(p.buf, p.sz);
+            libereProjection(&p);
+        }
+    }
+    else
+        *th = chargeJSONTH(fd);
+    close(fd);
+    if (!p.buf)
+        rejoueJournal(path, appliqueTH, th);
+    return p;
+}
 
-    printf("%d", nb_prefixe_patricia(pt, cle));
+/**
+ * @private
+ *
+ * @brief Réécrit en entier le fichier de Patricia-Trie donné, sous sa forme d'origine, voir `remplaceFichier()`
+ *
+ * @param [in] path Le chemin du fichier
+ * @param [in] pt Le trie à écrire
+ * @param [in] binaire Vrai pour écrire un snapshot binaire, faux pour un JSON
+ *
+ */
+static void sauveTriePT(const char *path, const PatriciaNode *pt, bool binaire)
+{
+    if (binaire)
+    {
+        size_t sz;
+        void *buf = printSnapshotPT(pt, &sz);
+        sauveFichier(path, buf, sz);
+        free(buf);
+    }
+    else
+    {
+        char *tmp;
+        FILE *f = ouvreTemporaire(path, &tmp);
+        ecritFichierPT(pt, f);
+        remplaceFichier(f, tmp, path);
+    }
+}
 
-    if (fclose(f) == EOF)
+/**
+ * @private
+ *
+ * @brief Comme `sauveTriePT()`, pour un Trie Hybride
+ *
+ */
+static void sauveTrieTH(const char *path, const TrieHybride *th, bool binaire)
+{
+    if (binaire)
     {
-        perror("Erreur, fclose dans prefixeMainPT");
-        exit(1);
+        size_t sz;
+        void *buf = printSnapshotTH(th, &sz);
+        sauveFichier(path, buf, sz);
+        free(buf);
+    }
+    else
+    {
+        char *tmp;
+        FILE *f = ouvreTemporaire(path, &tmp);
+        ecritFichierTH(th, f);
+        remplaceFichier(f, tmp, path);
     }
+}
 
-    free_patricia_node(pt);
+/**
+ * @private
+ *
+ * @brief Charge le fichier de Patricia-Trie donné comme `chargePT()`, en désérialisant un snapshot projeté
+ *
+ * @param [in] path Le chemin du fichier
+ * @param [out] binaire Si non nul, reçoit vrai si le fichier est un snapshot binaire
+ * @return Le trie, journal rejoué
+ *
+ */
+static PatriciaNode *chargeArbrePT(const char *path, bool *binaire)
+{
+    PatriciaNode *pt;
+    Projection snap = chargePT(path, &pt, binaire);
+    if (snap.buf)
+        pt = parseSnapshotPT(snap.buf, snap.sz);
+    libereProjection(&snap);
+    return pt;
+}
+
+/**
+ * @private
+ *
+ * @brief Comme `chargeArbrePT()`, pour un Trie Hybride
+ *
+ */
+static TrieHybride *chargeArbreTH(const char *path, bool *binaire)
+{
+    TrieHybride *th;
+    Projection snap = chargeTH(path, &th, binaire);
+    if (snap.buf)
+        th = parseSnapshotTH(snap.buf, snap.sz);
+    libereProjection(&snap);
+    return th;
+}
+
+void prefixeMainPT(const char *path, const char *cle)
+{
+    PatriciaNode *pt;
+    Projection snap = chargePT(path, &pt, NULL);
+    if (snap.buf)
+        printf("%d", nb_prefixe_snapshot_patricia(snap.buf, cle));
+    else
+        printf("%d", nb_prefixe_patricia(pt, cle));
+    libereProjection(&snap);
+    if (pt)
+        free_patricia_node(pt);
 }
 
 void prefixeMainTH(const char *path, const char *cle)
 {
-    FILE *f = fopen(path, "r");
-    if (!f)
+    TrieHybride *th;
+    Projection snap = chargeTH(path, &th, NULL);
+    if (snap.buf)
+        printf("%d", prefixeSnapshotTH(snap.buf, cle));
+    else
+        printf("%d", prefixeTH(th, cle));
+    libereProjection(&snap);
+    deleteTH(&th);
+}
+
+void snapshotMainPT(const char *path, const char *sortie)
+{
+    PatriciaNode *pt = chargeArbrePT(path, NULL);
+    size_t sz;
+    void *buf = printSnapshotPT(pt, &sz);
+    sauveFichier(sortie, buf, sz);
+    supprimeJournal(sortie);
+    free(buf);
+    free_patricia_node(pt);
+}
+
+void snapshotMainTH(const char *path, const char *sortie)
+{
+    TrieHybride *th = chargeArbreTH(path, NULL);
+    size_t sz;
+    void *buf = printSnapshotTH(th, &sz);
+    sauveFichier(sortie, buf, sz);
+    supprimeJournal(sortie);
+    free(buf);
+    deleteTH(&th);
+}
+
+void insererFichierPT(const char *path)
+{
+    if (modeJournal(path))
     {
-        perror("Erreur, fopen dans profondeurMoyenneMainTH");
-        exit(1);
+        journaliseMots(path, 'A');
+        return;
     }
+    bool binaire;
+    PatriciaNode *pt = chargeArbrePT(path, &binaire);
+    lisMots(appliquePT, pt, 'A');
+    sauveTriePT(path, pt, binaire);
+    free_patricia_node(pt);
+}
 
-    size_t fsize;
-    char *s = readJSON(f, &fsize);
-    TrieHybride *th = parseJSONTH(s, fsize);
-    free(s);
-
-    printf("%d", prefixeTH(th, cle));
+void insererFichierTH(const char *path)
+{
+    if (modeJournal(path))
+    {
+        journaliseMots(path, 'A');
+        return;
+    }
+    bool binaire;
+    TrieHybride *th = chargeArbreTH(path, &binaire);
+    lisMots(appliqueTH, &th, 'A');
+    sauveTrieTH(path, th, binaire);
+    deleteTH(&th);
+}
 
-    if (fclose(f) == EOF)
+/**
+ * @private
+ *
+ * @brief Verrouille en exclusivité le journal du fichier de trie donné pour le compacter
+ *
+ * @return Le descripteur du journal verrouillé, à refermer une fois le journal supprimé, -1 s'il n'y a pas de journal
+ *
+ * Un écrivain qui tient le journal, un serveur en mode journal par exemple, pourrait y ajouter des enregistrements
+ * après sa relecture : la compaction est alors refusée plutôt que d'attendre.
+ *
+ */
+static int verrouilleCompaction(const char *path)
+{
+    int fd = verrouilleJournal(path, O_RDONLY, LOCK_EX | LOCK_NB);
+    if (fd == -1 && errno == EWOULDBLOCK)
     {
-        perror("Erreur, fclose dans profondeurMoyenneMainTH");
+        fprintf(stderr, "Erreur, journal en cours d'écriture dans verrouilleCompaction");
         exit(1);
     }
-    deleteTH(&th);
+    return fd;
+}
+
+void compactionMainPT(const char *path)
+{
+    int verrou = verrouilleCompaction(path);
+    if (verrou == -1)
+        return;
+    if (journalVide(path))
+    {
+        supprimeJournal(path);
+        close(verrou);
+        return;
+    }
+    PatriciaNode *pt;
+    bool binaire;
+    chargePT(path, &pt, &binaire);
+    /* Le fichier d'abord, synchronisé : un arrêt entre les deux rejouera le journal sur le fichier à jour */
+    sauveTriePT(path, pt, binaire);
+    supprimeJournal(path);
+    close(verrou);
+    free_patricia_node(pt);
+}
+
+void compactionMainTH(const char *path)
+{
+    int verrou = verrouilleCompaction(path);
+    if (verrou == -1)
+        return;
+    if (journalVide(path))
+    {
+        supprimeJournal(path);
+        close(verrou);
+        return;
+    }
+    TrieHybride *th;
+    bool binaire;
+    chargeTH(path, &th, &binaire);
+    sauveTrieTH(path, th, binaire);
+    supprimeJournal(path);
+    close(verrou);
+    deleteTH(&th);
+}
+
+void suppressionPT(const char *path)
+{
+    if (modeJournal(path))
+    {
+        journaliseMots(path, 'S');
+        return;
+    }
+    bool binaire;
+    PatriciaNode *pt = chargeArbrePT(path, &binaire);
+    lisMots(appliquePT, pt, 'S');
+    sauveTriePT(path, pt, binaire);
+    free_patricia_node(pt);
+}
+
+void suppressionTH(const char *path)
+{
+    if (modeJournal(path))
+    {
+        journaliseMots(path, 'S');
+        return;
+    }
+    bool binaire;
+    TrieHybride *th = chargeArbreTH(path, &binaire);
+    lisMots(appliqueTH, &th, 'S');
+    sauveTrieTH(path, th, binaire);
+    deleteTH(&th);
+}
+
+void fusionMainPT(const char *path1, const char *path2)
+{
+    PatriciaNode *pt1 = chargeArbrePT(path1, NULL);
+    PatriciaNode *pt2 = chargeArbrePT(path2, NULL);
+    pt1 = pat_fusion(pt1, pt2);
+    ecritFichierPT(pt1, stdout);
+    free_patricia_node(pt1);
+}
+
+void fusionMainTH(const char *path1, const char *path2)
+{
+    TrieHybride *th1 = chargeArbreTH(path1, NULL);
+    TrieHybride *th2 = chargeArbreTH(path2, NULL);
+    th1 = fusionTH(&th1, th2);
+    ecritFichierTH(th1, stdout);
+    deleteTH(&th1);
+    deleteTH(&th2);
+}
+
+void listeMotsMainPT(const char *path)
+{
+    PatriciaNode *pt = chargeArbrePT(path, NULL);
+    char **liste = liste_mots_patricia(pt);
+    if (liste)
+    {
+        for (char **i = liste; *i; i++)
+        {
+            printf("%s\n", *i);
+        }
+    }
+    int size = comptage_mots_patricia(pt);
+    free_patricia_node(pt);
+    free_list_patricia(liste, size);
+}
+
+void listeMotsMainTH(const char *path)
+{
+    TrieHybride *th = chargeArbreTH(path, NULL);
+    char **tab = listeMotsTH(th);
+    if (tab)
+    {
+        for (char **i = tab; *i; i++)
+        {
+            printf("%s\n", *i);
+        }
+    }
+    deleteListeMotsTH(tab);
+    deleteTH(&th);
+}
+
+void profondeurMoyenneMainPT(const char *path)
+{
+    PatriciaNode *pt = chargeArbrePT(path, NULL);
+    printf("%f", profondeur_moyenne_patricia_feuille(pt));
+    free_patricia_node(pt);
+}
+
+void profondeurMoyenneMainTH(const char *path)
+{
+    TrieHybride *th = chargeArbreTH(path, NULL);
+    printf("%f", profondeurMoyenneTH(th));
+    deleteTH(&th);
+}
+
+/**
+ * @private
+ *
+ * @def TAILLE_LECTURE
+ *
+ * @brief La taille des lectures sur les sockets du serveur et du client
+ *
+ */
+#define TAILLE_LECTURE 65536
+
+/**
+ * @private
+ *
+ * @brief Un tampon d'octets qui grandit à la demande
+ *
+ */
+typedef struct tampon
+{
+    char *buf;  /**< Les octets, non nul terminés */
+    size_t sz;  /**< Nombre d'octets utilisés */
+    size_t cap; /**< Capacité de @c buf */
+} Tampon;
+
+/**
+ * @private
+ *
+ * @brief Agrandit le tampon pour qu'il puisse recevoir @a n octets de plus
+ *
+ */
+static void reserveTampon(Tampon *t, size_t n)
+{
+    if (t->sz + n <= t->cap)
+        return;
+    while (t->sz + n > t->cap)
+        t->cap = t->cap ? 2 * t->cap : TAILLE_LECTURE;
+    t->buf = realloc(t->buf, t->cap);
+    if (!t->buf)
+    {
+        fprintf(stderr, "Erreur, realloc dans reserveTampon");
+        exit(1);
+    }
+}
+
+/**
+ * @private
+ *
+ * @brief Ajoute une ligne au tampon, son retour à la ligne compris
+ *
+ */
+static void ajouteLigneTampon(Tampon *t, const char *s)
+{
+    size_t n = strlen(s);
+    reserveTampon(t, n + 1);
+    memcpy(t->buf + t->sz, s, n);
+    t->buf[t->sz + n] = '\n';
+    t->sz += n + 1;
+}
+
+/**
+ * @private
+ *
+ * @brief Ajoute un entier suivi d'un retour à la ligne au tampon
+ *
+ */
+static void ajouteEntierTampon(Tampon *t, long v)
+{
+    char nombre[32];
+    snprintf(nombre, sizeof(nombre), "%ld", v);
+    ajouteLigneTampon(t, nombre);
+}
+
+/**
+ * @private
+ *
+ * @brief Écrit les @a n octets donnés sur le descripteur de fichier
+ *
+ * @return false si l'écriture échoue, par exemple parce que le client est parti
+ *
+ */
+static bool envoieTout(int fd, const char *buf, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t ecrit = write(fd, buf, n);
+        if (ecrit == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        buf += ecrit;
+        n -= ecrit;
+    }
+    return true;
+}
+
+/**
+ * @private
+ *
+ * @brief Remplit l'adresse de la socket Unix au chemin donné
+ *
+ */
+static void adresseSocket(struct sockaddr_un *adr, const char *chemin)
+{
+    memset(adr, 0, sizeof(*adr));
+    adr->sun_family = AF_UNIX;
+    if (strlen(chemin) >= sizeof(adr->sun_path))
+    {
+        fprintf(stderr, "Erreur, chemin de socket trop long dans adresseSocket");
+        exit(1);
+    }
+    strcpy(adr->sun_path, chemin);
+}
+
+/**
+ * @private
+ *
+ * @brief Découpe une requête du protocole du serveur en son opération et son mot
+ *
+ * @param [in] requete Une ligne reçue, sans son retour à la ligne
+ * @param [out] mot Reçoit le mot de la requête, vide s'il n'y en a pas
+ * @return La lettre de l'opération, 0 si la requête est mal formée
+ *
+ * Une requête est une lettre, éventuellement suivie d'une espace et d'un mot qui court jusqu'à la fin de la ligne. Le
+ * mot est refusé s'il n'est pas ASCII, les tries ne savent pas le ranger.
+ *
+ */
+static char decoupeRequete(const char *requete, const char **mot)
+{
+    if (requete[0] == '\0' || (requete[1] != '\0' && requete[1] != ' '))
+        return 0;
+    *mot = requete[1] ? requete + 2 : requete + 1;
+    for (const char *c = *mot; *c; c++)
+        if ((unsigned char)*c >= 128)
+            return 0;
+    return requete[0];
+}
+
+/**
+ * @private
+ *
+ * @brief Une fonction qui répond à une requête du serveur sur un trie
+ *
+ * @param [in, out] ctx L'état du serveur : son trie et le fichier JSON d'où il vient
+ * @param [in] requete Une ligne reçue, sans son retour à la ligne
+ * @param [out] sortie Le tampon où écrire la réponse
+ * @return false si le serveur doit s'arrêter
+ *
+ */
+typedef bool (*TraiteRequete)(void *ctx, const char *requete, Tampon *sortie);
+
+/**
+ * @private
+ *
+ * @brief Une fonction appelée après les requêtes d'un bloc, avant l'envoi de leurs réponses, pour rendre durables les
+ * modifications qu'elles ont faites
+ *
+ * @param [in, out] ctx L'état du serveur, celui donné à `TraiteRequete`
+ *
+ */
+typedef void (*SynchroniseServeur)(void *ctx);
+
+/**
+ * @private
+ *
+ * @def DELAI_ENVOI
+ *
+ * @brief Le temps en secondes au bout duquel le serveur abandonne un client qui ne lit plus ses réponses
+ *
+ */
+#define DELAI_ENVOI 5
+
+/**
+ * @private
+ *
+ * @brief Lit un bloc sur un descripteur et répond aux requêtes complètes qu'il contient, les réponses étant écrites
+ * sur un autre
+ *
+ * @param [in] in Le descripteur des requêtes : la socket d'un client ou l'entrée standard
+ * @param [in] out Le descripteur des réponses : la même socket ou la sortie standard
+ * @param [in, out] entree Les octets reçus dont la ligne n'est pas encore complète, gardés pour le bloc suivant
+ * @param [out] ouvert Reçoit false à la fin de l'entrée ou si les réponses ne peuvent plus être écrites
+ * @return false si une requête a demandé l'arrêt
+ *
+ * Toutes les réponses d'un bloc sont envoyées d'une seule écriture, un client qui envoie ses requêtes à la suite sans
+ * attendre les réponses ne paie donc pas un appel système par requête. `synchronise` est appelée avant cette écriture :
+ * un OK reçu par le client vaut une modification sur le disque. Une dernière requête sans retour à la ligne est
+ * traitée à la fin de l'entrée.
+ *
+ */
+static bool traiteBloc(int in, int out, Tampon *entree, bool *ouvert, TraiteRequete traite,
+                       SynchroniseServeur synchronise, void *ctx)
+{
+    reserveTampon(entree, TAILLE_LECTURE + 1);
+    ssize_t lu = read(in, entree->buf + entree->sz, TAILLE_LECTURE);
+    if (lu == -1 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+        return true;
+    if (lu <= 0)
+    {
+        *ouvert = false;
+        if (entree->sz > 0)
+            entree->buf[entree->sz++] = '\n';
+    }
+    else
+        entree->sz += lu;
+
+    Tampon sortie = {NULL, 0, 0};
+    bool continuer = true;
+    size_t debut = 0;
+    char *fin;
+    while (continuer && (fin = memchr(entree->buf + debut, '\n', entree->sz - debut)) != NULL)
+    {
+        *fin = '\0';
+        continuer = traite(ctx, entree->buf + debut, &sortie);
+        debut = fin - entree->buf + 1;
+    }
+    memmove(entree->buf, entree->buf + debut, entree->sz - debut);
+    entree->sz -= debut;
+    synchronise(ctx);
+    if (!envoieTout(out, sortie.buf, sortie.sz))
+        *ouvert = false;
+    free(sortie.buf);
+    return continuer;
+}
+
+/**
+ * @private
+ *
+ * @brief Répond à toutes les requêtes lues sur un descripteur jusqu'à sa fin, voir `traiteBloc()`
+ *
+ * @return false si une requête a demandé l'arrêt
+ *
+ */
+static bool traiteFlux(int in, int out, TraiteRequete traite, SynchroniseServeur synchronise, void *ctx)
+{
+    Tampon entree = {NULL, 0, 0};
+    bool continuer = true, ouvert = true;
+    while (continuer && ouvert)
+        continuer = traiteBloc(in, out, &entree, &ouvert, traite, synchronise, ctx);
+    free(entree.buf);
+    return continuer;
+}
+
+/**
+ * @private
+ *
+ * @brief Accepte un client sur la socket d'écoute et l'ajoute aux descripteurs surveillés
+ *
+ * @param [in] ecoute La socket d'écoute, non bloquante
+ * @param [in, out] fds Les descripteurs surveillés, la socket d'écoute et le tube d'arrêt en premier
+ * @param [in, out] entrees Les lignes incomplètes de chaque client, au même indice que son descripteur
+ * @param [in, out] n Le nombre de descripteurs surveillés
+ * @param [in, out] cap La capacité de @a fds et @a entrees
+ *
+ */
+static void accepteClient(int ecoute, struct pollfd **fds, Tampon **entrees, nfds_t *n, nfds_t *cap)
+{
+    int fd = accept(ecoute, NULL, NULL);
+    if (fd == -1)
+    {
+        if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK)
+            return;
+        perror("Erreur, accept dans accepteClient");
+        exit(1);
+    }
+    /* Une écriture bloquée par un client qui ne lit pas ses réponses ne doit pas retenir les autres indéfiniment */
+    struct timeval delai = {DELAI_ENVOI, 0};
+    if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &delai, sizeof(delai)) == -1)
+    {
+        perror("Erreur, setsockopt dans accepteClient");
+        exit(1);
+    }
+    if (*n == *cap)
+    {
+        *cap *= 2;
+        *fds = realloc(*fds, *cap * sizeof(**fds));
+        *entrees = realloc(*entrees, *cap * sizeof(**entrees));
+        if (!*fds || !*entrees)
+        {
+            fprintf(stderr, "Erreur, realloc dans accepteClient");
+            exit(1);
+        }
+    }
+    (*fds)[*n] = (struct pollfd){fd, POLLIN, 0};
+    (*entrees)[*n] = (Tampon){NULL, 0, 0};
+    (*n)++;
+}
+
+/**
+ * @private
+ *
+ * @brief Le côté écriture du tube par lequel `signalArret()` réveille `boucleServeur()`, -1 hors du serveur
+ *
+ */
+static int tubeArret = -1;
+
+/**
+ * @private
+ *
+ * @brief Gestionnaire de @c SIGINT et @c SIGTERM : demande l'arrêt du serveur en écrivant un octet dans son tube
+ *
+ * Un drapeau seul pourrait être levé juste avant que le serveur n'entre dans `poll()`, où il attendrait le client
+ * suivant. L'octet écrit rend le tube lisible, `poll()` rend donc la main quel que soit le moment du signal.
+ *
+ */
+static void signalArret(int sig)
+{
+    (void)sig;
+    int e = errno;
+    ssize_t ecrit = write(tubeArret, "", 1);
+    (void)ecrit;
+    errno = e;
+}
+
+/**
+ * @private
+ *
+ * @brief Écoute sur la socket Unix donnée et sert les clients connectés jusqu'à une requête d'arrêt
+ *
+ * Les clients sont servis ensemble : `poll()` surveille la socket d'écoute et celles des clients, et chaque bloc reçu
+ * est traité dès son arrivée, un client inactif ne retient donc pas les autres. Un client qui ne lit plus ses réponses
+ * est déconnecté au bout de `DELAI_ENVOI` secondes d'écriture bloquée.
+ *
+ * Un fichier déjà présent au chemin de la socket, reste d'un serveur précédent, est remplacé. Il est supprimé à
+ * l'arrêt. Un client qui part sans lire ses réponses ne doit pas arrêter le serveur, @c SIGPIPE est donc ignoré.
+ * @c SIGINT et @c SIGTERM arrêtent le serveur comme une requête d'arrêt, mais sans sauvegarder le trie : c'est à
+ * l'appelant de le faire au retour.
+ *
+ */
+static void boucleServeur(const char *chemin, TraiteRequete traite, SynchroniseServeur synchronise, void *ctx)
+{
+    signal(SIGPIPE, SIG_IGN);
+    struct sockaddr_un adr;
+    adresseSocket(&adr, chemin);
+    int ecoute = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ecoute == -1)
+    {
+        perror("Erreur, socket dans boucleServeur");
+        exit(1);
+    }
+    if (unlink(chemin) == -1 && errno != ENOENT)
+    {
+        perror("Erreur, unlink dans boucleServeur");
+        exit(1);
+    }
+    if (bind(ecoute, (struct sockaddr *)&adr, sizeof(adr)) == -1 || listen(ecoute, SOMAXCONN) == -1)
+    {
+        perror("Erreur, bind dans boucleServeur");
+        exit(1);
+    }
+    /* Un client parti entre `poll()` et `accept()` ne doit pas bloquer le serveur */
+    if (fcntl(ecoute, F_SETFL, fcntl(ecoute, F_GETFL) | O_NONBLOCK) == -1)
+    {
+        perror("Erreur, fcntl dans boucleServeur");
+        exit(1);
+    }
+
+    int tube[2];
+    if (pipe(tube) == -1 || fcntl(tube[1], F_SETFL, fcntl(tube[1], F_GETFL) | O_NONBLOCK) == -1)
+    {
+        perror("Erreur, pipe dans boucleServeur");
+        exit(1);
+    }
+    tubeArret = tube[1];
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalArret;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGINT, &action, NULL) == -1 || sigaction(SIGTERM, &action, NULL) == -1)
+    {
+        perror("Erreur, sigaction dans boucleServeur");
+        exit(1);
+    }
+
+    nfds_t n = 2, cap = 16;
+    struct pollfd *fds = malloc(cap * sizeof(*fds));
+    Tampon *entrees = malloc(cap * sizeof(*entrees));
+    if (!fds || !entrees)
+    {
+        fprintf(stderr, "Erreur, malloc dans boucleServeur");
+        exit(1);
+    }
+    /* La socket d'écoute et le tube d'arrêt d'abord, puis les clients */
+    fds[0] = (struct pollfd){ecoute, POLLIN, 0};
+    fds[1] = (struct pollfd){tube[0], POLLIN, 0};
+
+    bool continuer = true;
+    while (continuer)
+    {
+        if (poll(fds, n, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Erreur, poll dans boucleServeur");
+            exit(1);
+        }
+        if (fds[1].revents)
+            break;
+        /* À rebours : le dernier client, déjà traité, prend la place de celui qui part */
+        for (nfds_t i = n - 1; continuer && i >= 2; i--)
+        {
+            if (!fds[i].revents)
+                continue;
+            bool ouvert = true;
+            continuer = traiteBloc(fds[i].fd, fds[i].fd, &entrees[i], &ouvert, traite, synchronise, ctx);
+            if (!ouvert)
+            {
+                close(fds[i].fd);
+                free(entrees[i].buf);
+                fds[i] = fds[--n];
+                entrees[i] = entrees[n];
+            }
+        }
+        if (continuer && (fds[0].revents & POLLIN))
+            accepteClient(ecoute, &fds, &entrees, &n, &cap);
+    }
+
+    for (nfds_t i = 2; i < n; i++)
+    {
+        close(fds[i].fd);
+        free(entrees[i].buf);
+    }
+    free(fds);
+    free(entrees);
+    close(ecoute);
+    unlink(chemin);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    tubeArret = -1;
+    close(tube[0]);
+    close(tube[1]);
+}
+
+/**
+ * @private
+ *
+ * @brief L'état d'un serveur de Patricia-Trie, ou d'un lot de requêtes
+ *
+ */
+typedef struct serveur_pt
+{
+    PatriciaNode *pt;  /**< Le trie, nul tant que les requêtes sont servies par le snapshot */
+    const char *path;  /**< Le fichier d'où vient le trie, réécrit sous la même forme à l'arrêt s'il a changé */
+    bool modifie;
+    Projection snap;   /**< Le snapshot binaire projeté, jusqu'à la première requête qui a besoin du trie entier */
+    bool binaire;      /**< Le fichier est un snapshot binaire plutôt qu'un JSON */
+    bool journalise;   /**< Les modifications vont au journal du fichier au lieu de le réécrire */
+    FILE *journal;     /**< Le journal, ouvert à la première modification et refermé à chaque sauvegarde */
+} ServeurPT;
+
+/**
+ * @private
+ *
+ * @brief Réécrit le fichier du serveur si son trie a changé depuis le chargement ou la dernière sauvegarde, ou écrit
+ * sur le disque les enregistrements en attente de son journal
+ *
+ */
+static void sauveServeurPT(ServeurPT *s)
+{
+    if (!s->modifie)
+        return;
+    if (s->journal)
+    {
+        fermeJournal(s->journal);
+        s->journal = NULL;
+    }
+    else
+        sauveTriePT(s->path, s->pt, s->binaire);
+    s->modifie = false;
+}
+
+/**
+ * @private
+ *
+ * @brief Note que le trie du serveur a changé, et ajoute l'opération donnée à son journal s'il en tient un
+ *
+ */
+static void modifieServeurPT(ServeurPT *s, char op, const char *mot)
+{
+    s->modifie = true;
+    if (!s->journalise)
+        return;
+    if (!s->journal)
+        s->journal = ouvreJournal(s->path);
+    ecritJournal(s->journal, op, mot);
+}
+
+/**
+ * @private
+ *
+ * @brief Écrit sur le disque les enregistrements du journal du serveur, voir `SynchroniseServeur`
+ *
+ */
+static void synchroniseServeurPT(void *ctx)
+{
+    ServeurPT *s = ctx;
+    if (s->journal)
+        synchroniseJournal(s->journal);
+}
+
+/**
+ * @private
+ *
+ * @brief Renvoie le trie du serveur, désérialisé depuis le snapshot à la première requête qui en a besoin
+ *
+ */
+static PatriciaNode *trieServeurPT(ServeurPT *s)
+{
+    if (s->snap.buf)
+    {
+        s->pt = parseSnapshotPT(s->snap.buf, s->snap.sz);
+        libereProjection(&s->snap);
+    }
+    return s->pt;
+}
+
+/**
+ * @private
+ *
+ * @brief Répond à une requête sur un Patricia-Trie, voir `TraiteRequete`
+ *
+ */
+static bool traiteRequetePT(void *ctx, const char *requete, Tampon *sortie)
+{
+    ServeurPT *s = ctx;
+    const char *mot;
+    switch (decoupeRequete(requete, &mot))
+    {
+    case 'R':
+        if (s->snap.buf)
+            ajouteEntierTampon(sortie, recherche_snapshot_patricia(s->snap.buf, mot));
+        else
+            ajouteEntierTampon(sortie, recherche_patricia(s->pt, mot));
+        break;
+    case 'P':
+        if (s->snap.buf)
+            ajouteEntierTampon(sortie, nb_prefixe_snapshot_patricia(s->snap.buf, mot));
+        else
+            ajouteEntierTampon(sortie, nb_prefixe_patricia(s->pt, mot));
+        break;
+    case 'A':
+        insert_patricia(trieServeurPT(s), mot);
+        modifieServeurPT(s, 'A', mot);
+        ajouteLigneTampon(sortie, "OK");
+        break;
+    case 'S':
+        delete_word(trieServeurPT(s), mot);
+        modifieServeurPT(s, 'S', mot);
+        ajouteLigneTampon(sortie, "OK");
+        break;
+    case 'L': {
+        ajouteEntierTampon(sortie, comptage_mots_patricia(trieServeurPT(s)));
+        PatriciaCursor *c = cursor_open_patricia(s->pt);
+        for (const char *m = cursor_next_patricia(c); m; m = cursor_next_patricia(c))
+            ajouteLigneTampon(sortie, m);
+        cursor_close_patricia(c);
+        break;
+    }
+    case 'Q':
+        sauveServeurPT(s);
+        ajouteLigneTampon(sortie, "OK");
+        return false;
+    default:
+        ajouteLigneTampon(sortie, "ERR");
+    }
+    return true;
+}
+
+/**
+ * @private
+ *
+ * @brief L'état d'un serveur de Trie Hybride, ou d'un lot de requêtes
+ *
+ */
+typedef struct serveur_th
+{
+    TrieHybride *th;  /**< Le trie, nul tant que les requêtes sont servies par le snapshot (ou s'il est vide) */
+    const char *path; /**< Le fichier d'où vient le trie, réécrit sous la même forme à l'arrêt s'il a changé */
+    bool modifie;
+    Projection snap;  /**< Le snapshot binaire projeté, jusqu'à la première requête qui a besoin du trie entier */
+    bool binaire;     /**< Le fichier est un snapshot binaire plutôt qu'un JSON */
+    bool journalise;  /**< Les modifications vont au journal du fichier au lieu de le réécrire */
+    FILE *journal;    /**< Le journal, ouvert à la première modification et refermé à chaque sauvegarde */
+} ServeurTH;
+
+/**
+ * @private
+ *
+ * @brief Réécrit le fichier du serveur si son trie a changé depuis le chargement ou la dernière sauvegarde, ou écrit
+ * sur le disque les enregistrements en attente de son journal
+ *
+ */
+static void sauveServeurTH(ServeurTH *s)
+{
+    if (!s->modifie)
+        return;
+    if (s->journal)
+    {
+        fermeJournal(s->journal);
+        s->journal = NULL;
+    }
+    else
+        sauveTrieTH(s->path, s->th, s->binaire);
+    s->modifie = false;
+}
+
+/**
+ * @private
+ *
+ * @brief Note que le trie du serveur a changé, et ajoute l'opération donnée à son journal s'il en tient un
+ *
+ */
+static void modifieServeurTH(ServeurTH *s, char op, const char *mot)
+{
+    s->modifie = true;
+    if (!s->journalise)
+        return;
+    if (!s->journal)
+        s->journal = ouvreJournal(s->path);
+    ecritJournal(s->journal, op, mot);
+}
+
+/**
+ * @private
+ *
+ * @brief Écrit sur le disque les enregistrements du journal du serveur, voir `SynchroniseServeur`
+ *
+ */
+static void synchroniseServeurTH(void *ctx)
+{
+    ServeurTH *s = ctx;
+    if (s->journal)
+        synchroniseJournal(s->journal);
+}
+
+/**
+ * @private
+ *
+ * @brief Renvoie le trie du serveur, désérialisé depuis le snapshot à la première requête qui en a besoin
+ *
+ */
+static TrieHybride *trieServeurTH(ServeurTH *s)
+{
+    if (s->snap.buf)
+    {
+        s->th = parseSnapshotTH(s->snap.buf, s->snap.sz);
+        libereProjection(&s->snap);
+    }
+    return s->th;
+}
+
+/**
+ * @private
+ *
+ * @brief Répond à une requête sur un Trie Hybride, voir `TraiteRequete`
+ *
+ */
+static bool traiteRequeteTH(void *ctx, const char *requete, Tampon *sortie)
+{
+    ServeurTH *s = ctx;
+    const char *mot;
+    switch (decoupeRequete(requete, &mot))
+    {
+    case 'R':
+        if (s->snap.buf)
+            ajouteEntierTampon(sortie, rechercheSnapshotTH(s->snap.buf, mot));
+        else
+            ajouteEntierTampon(sortie, rechercheTH(s->th, mot));
+        break;
+    case 'P':
+        if (s->snap.buf)
+            ajouteEntierTampon(sortie, prefixeSnapshotTH(s->snap.buf, mot));
+        else
+            ajouteEntierTampon(sortie, prefixeTH(s->th, mot));
+        break;
+    case 'A':
+        s->th = ajoutTH(trieServeurTH(s), mot, VALFIN);
+        modifieServeurTH(s, 'A', mot);
+        ajouteLigneTampon(sortie, "OK");
+        break;
+    case 'S':
+        s->th = supprTH(trieServeurTH(s), mot);
+        modifieServeurTH(s, 'S', mot);
+        ajouteLigneTampon(sortie, "OK");
+        break;
+    case 'L': {
+        ajouteEntierTampon(sortie, (long)comptageMotsTH(trieServeurTH(s)));
+        CurseurTH *c = newCurseurTH(s->th);
+        for (const char *m = suivantCurseurTH(c); m; m = suivantCurseurTH(c))
+            ajouteLigneTampon(sortie, m);
+        deleteCurseurTH(&c);
+        break;
+    }
+    case 'Q':
+        sauveServeurTH(s);
+        ajouteLigneTampon(sortie, "OK");
+        return false;
+    default:
+        ajouteLigneTampon(sortie, "ERR");
+    }
+    return true;
+}
+
+/**
+ * @private
+ *
+ * @brief Prépare l'état d'un serveur de Patricia-Trie à partir du fichier donné, JSON ou snapshot binaire
+ *
+ */
+static ServeurPT ouvreServeurPT(const char *path)
+{
+    ServeurPT s = {NULL, path, false, {NULL, 0}, false, modeJournal(path), NULL};
+    s.snap = chargePT(path, &s.pt, &s.binaire);
+    return s;
+}
+
+/**
+ * @private
+ *
+ * @brief Libère l'état d'un serveur de Patricia-Trie
+ *
+ */
+static void fermeServeurPT(ServeurPT *s)
+{
+    libereProjection(&s->snap);
+    if (s->pt)
+        free_patricia_node(s->pt);
+}
+
+/**
+ * @private
+ *
+ * @brief Prépare l'état d'un serveur de Trie Hybride à partir du fichier donné, JSON ou snapshot binaire
+ *
+ */
+static ServeurTH ouvreServeurTH(const char *path)
+{
+    ServeurTH s = {NULL, path, false, {NULL, 0}, false, modeJournal(path), NULL};
+    s.snap = chargeTH(path, &s.th, &s.binaire);
+    return s;
+}
+
+/**
+ * @private
+ *
+ * @brief Libère l'état d'un serveur de Trie Hybride
+ *
+ */
+static void fermeServeurTH(ServeurTH *s)
+{
+    libereProjection(&s->snap);
+    deleteTH(&s->th);
+}
+
+void serveurMainPT(const char *path, const char *chemin)
+{
+    ServeurPT serveur = ouvreServeurPT(path);
+    boucleServeur(chemin, traiteRequetePT, synchroniseServeurPT, &serveur);
+    sauveServeurPT(&serveur);
+    fermeServeurPT(&serveur);
+}
+
+void serveurMainTH(const char *path, const char *chemin)
+{
+    ServeurTH serveur = ouvreServeurTH(path);
+    boucleServeur(chemin, traiteRequeteTH, synchroniseServeurTH, &serveur);
+    sauveServeurTH(&serveur);
+    fermeServeurTH(&serveur);
+}
+
+void lotMainPT(const char *path)
+{
+    ServeurPT serveur = ouvreServeurPT(path);
+    traiteFlux(STDIN_FILENO, STDOUT_FILENO, traiteRequetePT, synchroniseServeurPT, &serveur);
+    sauveServeurPT(&serveur);
+    fermeServeurPT(&serveur);
+}
+
+void lotMainTH(const char *path)
+{
+    ServeurTH serveur = ouvreServeurTH(path);
+    traiteFlux(STDIN_FILENO, STDOUT_FILENO, traiteRequeteTH, synchroniseServeurTH, &serveur);
+    sauveServeurTH(&serveur);
+    fermeServeurTH(&serveur);
+}
+
+void clientMain(const char *chemin)
+{
+    struct sockaddr_un adr;
+    adresseSocket(&adr, chemin);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&adr, sizeof(adr)) == -1)
+    {
+        perror("Erreur, connect dans clientMain");
+        exit(1);
+    }
+    /* Non bloquante : le client ne doit jamais rester bloqué à écrire pendant que le serveur attend qu'il lise */
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == -1)
+    {
+        perror("Erreur, fcntl dans clientMain");
+        exit(1);
+    }
+
+    static char envoi[TAILLE_LECTURE], recu[TAILLE_LECTURE];
+    size_t aEnvoyer = 0, envoye = 0;
+    bool finEntree = false, finReponses = false;
+    while (!finReponses)
+    {
+        struct pollfd p[2] = {{fd, POLLIN | (envoye < aEnvoyer ? POLLOUT : 0), 0}, {STDIN_FILENO, POLLIN, 0}};
+        /* L'entrée n'est lue qu'une fois le bloc précédent entièrement envoyé */
+        nfds_t n = !finEntree && envoye == aEnvoyer ? 2 : 1;
+        if (poll(p, n, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Erreur, poll dans clientMain");
+            exit(1);
+        }
+        if (n == 2 && p[1].revents)
+        {
+            ssize_t lu = read(STDIN_FILENO, envoi, sizeof(envoi));
+            if (lu == -1 && errno != EINTR)
+            {
+                perror("Erreur, read dans clientMain");
+                exit(1);
+            }
+            if (lu == 0)
+            {
+                finEntree = true;
+                shutdown(fd, SHUT_WR);
+            }
+            else if (lu > 0)
+            {
+                aEnvoyer = lu;
+                envoye = 0;
+            }
+        }
+        if (p[0].revents & POLLOUT)
+        {
+            ssize_t ecrit = send(fd, envoi + envoye, aEnvoyer - envoye, MSG_NOSIGNAL);
+            if (ecrit == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                perror("Erreur, send dans clientMain");
+                exit(1);
+            }
+            if (ecrit > 0)
+                envoye += ecrit;
+        }
+        if (p[0].revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            ssize_t lu = read(fd, recu, sizeof(recu));
+            if (lu == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                perror("Erreur, read dans clientMain");
+                exit(1);
+            }
+            if (lu == 0)
+                finReponses = true;
+            else if (lu > 0 && fwrite(recu, 1, lu, stdout) < (size_t)lu)
+            {
+                fprintf(stderr, "Erreur, fwrite dans clientMain");
+                exit(1);
+            }
+        }
+    }
+    close(fd);
 }
@@ -10,15 +10,28 @@
  */
 
 #include "hybrid.h"
-#include "cJSON.h"
+#include "fluxjson.h"
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 
+/**
+ * @private
+ *
+ * @def MIN
+ *
+ * @brief Trouve le minimum entre 2 valeurs, avec la même précaution que @c MAX3
+ *
+ */
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
 /**
  * @private
  *
@@ -59,572 +72,3233 @@ size_t lgueur(const char *cle)
     return strlen(cle);
 }
 
+/**
+ * @private
+ *
+ * @def SLAB_INIT
+ *
+ * @brief Le nombre de cases allouées à la création d'une slab, doublé à chaque agrandissement
+ *
+ */
+#define SLAB_INIT 64
+
+/*
+ * Le corps des fonctions est commun aux deux moteurs du Trie Hybride. Un enfant est désigné par un `Lien` : un pointeur
+ * vers un noeud alloué séparément, ou avec `HYBRID_SLAB` un indice dans la slab du trie. Un noeud est toujours atteint
+ * par `NOEUD(sl, l)` où `sl` est la slab du trie (inutilisée sans `HYBRID_SLAB`). Une allocation pouvant déplacer la
+ * slab, un pointeur de noeud n'est jamais gardé à travers un appel qui alloue, il est recalculé après l'appel.
+ */
+#ifdef HYBRID_SLAB
+typedef uint32_t Lien;
+typedef NoeudHybride Noeud;
+typedef TrieHybride Slab;
+#define NIL 0
+#define NOEUD(sl, l) (&(sl)->noeuds[(l)])
+#define LABEL(n) ((char)((n)->label & ~FINMOT))
+#define FIN(n) (((n)->label & FINMOT) != 0)
+#define VALEUR(sl, l) ((sl)->valeurs[(l)])
+#define POSE_FIN(sl, l, v)                                                                                             \
+    (NOEUD(sl, l)->label = (NOEUD(sl, l)->label & ~FINMOT) | ((v) ? FINMOT : 0), VALEUR(sl, l) = (v))
+#define MOTS(sl, l) ((sl)->mots[(l)])
+#define MEILLEUR(sl, l) ((sl)->meilleurs[(l)])
+_Static_assert(sizeof(NoeudHybride) == 16, "Un noeud de la slab doit tenir sur 16 octets");
+#else
+typedef TrieHybride *Lien;
+typedef TrieHybride Noeud;
+typedef void Slab;
+#define NIL NULL
+#define NOEUD(sl, l) ((void)(sl), (l))
+#define LABEL(n) ((n)->label)
+#define FIN(n) ((n)->value)
+#define VALEUR(sl, l) (NOEUD(sl, l)->value)
+#define POSE_FIN(sl, l, v) (VALEUR(sl, l) = (v))
+#define MOTS(sl, l) (NOEUD(sl, l)->mots)
+#define MEILLEUR(sl, l) (NOEUD(sl, l)->meilleur)
+#endif
+
+/*
+ * Chaque opération parcourant le trie existe en deux versions, `f_rec` récursive et `f_iter` par boucle avec une pile
+ * explicite, de même signature. Les fonctions publiques appellent `VERSION(f)` : la version itérative par défaut, qui
+ * ne peut pas déborder la pile d'appels sur un trie dégénéré ou une très longue clé, ou la version récursive avec
+ * `HYBRID_RECURSIF` (`make RECURSIF=1`).
+ */
+#ifdef HYBRID_RECURSIF
+#define VERSION(f) f##_rec
+#else
+#define VERSION(f) f##_iter
+#endif
+
 TrieHybride *newTH(void)
 {
     return NULL;
 }
 
-TrieHybride *allocTH(void)
+/**
+ * @private
+ *
+ * @brief Renvoie la slab où ajouter des noeuds au trie donné, une slab vide est créée si le trie est vide
+ *
+ * @param [in] th Un pointeur vers le Trie Hybride à modifier
+ * @return La slab du trie, toujours nul sans `HYBRID_SLAB`
+ *
+ */
+static Slab *ouvreTH(TrieHybride *th)
 {
-    TrieHybride *newth = malloc(sizeof(*newth));
-    if (!newth)
+#ifdef HYBRID_SLAB
+    if (th)
+        return th;
+    th = malloc(sizeof(*th));
+    NoeudHybride *noeuds = malloc(SLAB_INIT * sizeof(*noeuds));
+    uint32_t *mots = malloc(SLAB_INIT * sizeof(*mots));
+    int *valeurs = malloc(SLAB_INIT * sizeof(*valeurs));
+    int *meilleurs = malloc(SLAB_INIT * sizeof(*meilleurs));
+    if (!th || !noeuds || !mots || !valeurs || !meilleurs)
     {
-        fprintf(stderr, "Erreur, malloc dans allocTH");
+        fprintf(stderr, "Erreur, malloc dans ouvreTH");
         exit(1);
     }
-    return newth;
+    th->noeuds = noeuds;
+    th->mots = mots;
+    th->valeurs = valeurs;
+    th->meilleurs = meilleurs;
+    th->taille = 1;
+    th->cap = SLAB_INIT;
+    th->libre = NIL;
+    th->racine = NIL;
+    return th;
+#else
+    (void)th;
+    return NULL;
+#endif
 }
 
-TrieHybride *ajoutTH(TrieHybride *th, const char *restrict cle, int v)
+/**
+ * @private
+ *
+ * @brief Renvoie le Trie Hybride de racine donnée, la slab est libérée si le trie est devenu vide
+ *
+ * @param [in,out] sl La slab renvoyée par `ouvreTH()`
+ * @param [in] racine Le lien vers la nouvelle racine du trie
+ * @return Un pointeur vers le Trie Hybride, nul s'il est vide
+ *
+ */
+static TrieHybride *fermeTH(Slab *sl, Lien racine)
 {
-    assert(v != 0 && "Valeur donné pour l'insértion doit être non nul");
-    size_t lgr = lgueur(cle);
-    if (lgr == 0)
-        return th;
-    char p = prem(cle);
-    if (!th)
-    {
-        TrieHybride *newth = allocTH();
-        newth->label = p;
-        newth->inf = NULL;
-        newth->sup = NULL;
-        if (lgr == 1)
-        {
-            newth->value = v;
-            newth->eq = NULL;
-        }
-        else
-        {
-            newth->value = VALVIDE;
-            newth->eq = ajoutTH(newTH(), reste(cle), v);
-        }
-        return newth;
-    }
-    if (p < th->label)
-        th->inf = ajoutTH(th->inf, cle, v);
-    else if (p > th->label)
-        th->sup = ajoutTH(th->sup, cle, v);
-    else
-        th->eq = ajoutTH(th->eq, reste(cle), v);
-    if (lgr == 1 && th->label == p && !th->value)
+#ifdef HYBRID_SLAB
+    if (racine == NIL)
     {
-        th->value = v;
+        free(sl->noeuds);
+        free(sl->mots);
+        free(sl->valeurs);
+        free(sl->meilleurs);
+        free(sl);
+        return NULL;
     }
-    return th;
+    sl->racine = racine;
+    return sl;
+#else
+    (void)sl;
+    return racine;
+#endif
 }
 
 /**
  * @private
+ *
+ * @brief Renvoie la slab du trie donné pour un parcours en lecture, toujours nul sans `HYBRID_SLAB`
+ *
  */
-typedef enum presence_enfants
+static const Slab *slabTH(const TrieHybride *th)
 {
-    INF = 1,     /**< Seulement l'enfant Inf est présent */
-    SUP = 2,     /**< Seulement l'enfant Sup est présent */
-    INFSUP = 3,  /**< Les deux enfants Inf et Sup sont présents */
-    AUCUNENF = 0 /**< Aucun des deux enfants Inf et Sup sont présents */
-} PresenceEnfants;
+#ifdef HYBRID_SLAB
+    return th;
+#else
+    (void)th;
+    return NULL;
+#endif
+}
 
 /**
  * @private
  *
- * @brief Calcule une valeur qui indique lesquels des enfants du Trie Hybride sont présents
- *
- * @param [in] th Un pointeur vers le Trie Hybride à calculer les enfants
- * @return Une valeur dans l'intervalle [0; 3] pour indiquer lesquels des enfants sont présents à part l'enfant Eq
- *
- * @pre Le Trie Hybride donné est non vide (non nul)
- *
- * L'enfant Eq n'est pas tenu en compte, il faut vérifier cela à part.
+ * @brief Renvoie le lien vers la racine du trie donné
  *
  */
-PresenceEnfants determine_enfants(const TrieHybride *th)
+static Lien racineTH(const TrieHybride *th)
 {
-    return (!!th->sup << 1) | (!!th->inf);
+#ifdef HYBRID_SLAB
+    return th ? th->racine : NIL;
+#else
+    /* Les appelants avec un trie constant ne font que des parcours en lecture */
+    return (Lien)th;
+#endif
 }
 
 /**
  * @private
  *
- * @brief Supprime le noeud donné si possible et réorganise les sous arbres
- *
- * @param [in,out] th Un pointeur vers le noeud du Trie Hybride à essayer de supprimer
- * @param [out] didDelete Un flag mis à vrai si une supression a bien pu s'effectuer
- * @return Un pointeur vers le Trie Hybride avec potentiellemnt la clé supprimé et reorganisé
+ * @brief Alloue un noeud sans enfants et qui n'est pas une fin de mot
  *
- * @pre didDelete a été alloué par l'appelant
+ * @param [in,out] sl La slab du trie, la case est prise dans la liste des cases libres en priorité
+ * @param [in] label Le caractère du noeud
+ * @return Le lien vers le noeud alloué
  *
- * Cette fonction aide à la suppression d'une clé d'un Trie Hybride avec une manipulation délicate.
- * Il y a plusieurs cas de traitement.
+ * @post Avec `HYBRID_SLAB`, les pointeurs de noeuds obtenus avant l'appel ne sont plus valides
  *
  */
-TrieHybride *supprTH_essaye_delete_reorg(TrieHybride *th, bool *didDelete)
+Lien allocTH(Slab *sl, char label)
 {
-    if (th->eq || th->value)
+#ifdef HYBRID_SLAB
+    assert(!(label & FINMOT) && "Le caractère doit être un caractère ASCII");
+    Lien l = sl->libre;
+    if (l != NIL)
+        sl->libre = sl->noeuds[l].inf;
+    else
     {
-        return th;
+        if (sl->taille == sl->cap)
+        {
+            if (sl->cap > UINT32_MAX / 2)
+            {
+                fprintf(stderr, "Erreur, taille maximale de la slab dépassée dans allocTH");
+                exit(1);
+            }
+            NoeudHybride *noeuds = realloc(sl->noeuds, 2 * (size_t)sl->cap * sizeof(*noeuds));
+            if (noeuds)
+                sl->noeuds = noeuds;
+            uint32_t *mots = realloc(sl->mots, 2 * (size_t)sl->cap * sizeof(*mots));
+            if (mots)
+                sl->mots = mots;
+            int *valeurs = realloc(sl->valeurs, 2 * (size_t)sl->cap * sizeof(*valeurs));
+            if (valeurs)
+                sl->valeurs = valeurs;
+            int *meilleurs = realloc(sl->meilleurs, 2 * (size_t)sl->cap * sizeof(*meilleurs));
+            if (meilleurs)
+                sl->meilleurs = meilleurs;
+            if (!noeuds || !mots || !valeurs || !meilleurs)
+            {
+                fprintf(stderr, "Erreur, realloc dans allocTH");
+                exit(1);
+            }
+            sl->cap *= 2;
+        }
+        l = sl->taille++;
     }
-    TrieHybride *tmp;
-    switch (determine_enfants(th))
+    Noeud *n = NOEUD(sl, l);
+    n->label = (unsigned char)label;
+#else
+    (void)sl;
+    Lien l = malloc(sizeof(*l));
+    if (!l)
     {
-    case INFSUP:
-        tmp = th->inf;
-        while (tmp->sup)
-            tmp = tmp->sup;
-        tmp->sup = th->sup;
-        tmp = th->inf;
-        break;
-    case INF:
-        tmp = th->inf;
-        break;
-    case SUP:
-        tmp = th->sup;
-        break;
-    case AUCUNENF:
-        tmp = NULL;
-        break;
-    default:
-        fprintf(stderr, "Erreur, calcul présence des enfants malheureux");
+        fprintf(stderr, "Erreur, malloc dans allocTH");
         exit(1);
     }
-    free(th);
-    th = tmp;
-    *didDelete = true;
-    return th;
+    Noeud *n = l;
+    n->label = label;
+#endif
+    n->h = 1;
+    POSE_FIN(sl, l, VALVIDE);
+    MOTS(sl, l) = 0;
+    MEILLEUR(sl, l) = INT_MIN;
+    n->inf = NIL;
+    n->eq = NIL;
+    n->sup = NIL;
+    return l;
 }
 
 /**
  * @private
  *
- * @brief Supprime la clé donné avec libération des noeuds si possible et réorganise les sous arbres
- *
- * @param [in,out] th Un pointeur vers le Trie Hybride à traiter
- * @param [in] cle Une chaine de caractères constituant une clé
- * @param [in,out] didDelete Un flag mis à vrai si une supression a bien pu s'effectuer
- * @return Un pointeur vers le Trie Hybride avec potentiellemnt la clé supprimé et reorganisé
- *
- * @pre didDelete a été alloué par l'appelant
+ * @brief Libère un noeud, avec `HYBRID_SLAB` sa case est ajoutée à la liste des cases libres
  *
  */
-TrieHybride *supprTH_rec(TrieHybride *th, const char *restrict cle, bool *didDelete)
+void libereTH(Slab *sl, Lien l)
 {
-    if (!th)
-        return th;
-    char p = prem(cle);
-    if (p == '\0')
-        return th;
-    if (p < th->label)
-    {
-        th->inf = supprTH_rec(th->inf, cle, didDelete);
-    }
-    else if (p > th->label)
-    {
-        th->sup = supprTH_rec(th->sup, cle, didDelete);
-    }
-    else
-    {
-        th->eq = supprTH_rec(th->eq, reste(cle), didDelete);
-    }
-    if (lgueur(cle) == 1)
-    {
-        if (th->value)
-        {
-            th->value = VALVIDE;
-            th = supprTH_essaye_delete_reorg(th, didDelete);
-        }
-    }
-    else if (didDelete)
-    {
-        assert(lgueur(cle) > 1 && "Etat incorrecte, longueur de la clé doit être strictement positif");
-        th = supprTH_essaye_delete_reorg(th, didDelete);
-    }
-    return th;
+#ifdef HYBRID_SLAB
+    sl->noeuds[l].inf = sl->libre;
+    sl->libre = l;
+#else
+    (void)sl;
+    free(l);
+#endif
 }
 
-TrieHybride *supprTH(TrieHybride *th, const char *restrict cle)
+/**
+ * @private
+ *
+ * @brief Une case de la pile explicite des parcours itératifs
+ *
+ */
+typedef struct cadre
 {
-    bool didDelete = false;
-    return supprTH_rec(th, cle, &didDelete);
-}
+    Lien l;   /**< Le noeud à traiter */
+    size_t n; /**< Selon le parcours, la profondeur du noeud ou l'étape atteinte dans son traitement */
+} Cadre;
 
-TrieHybride *deleteTH_rec(TrieHybride *th)
+/**
+ * @private
+ *
+ * @def CADRES_LOCAUX
+ *
+ * @brief Le nombre de cadres d'une pile gardés dans la pile elle-même avant de passer sur le tas
+ *
+ */
+#define CADRES_LOCAUX 64
+
+/**
+ * @private
+ *
+ * @brief Une pile de cadres qui s'agrandit au besoin
+ *
+ * Les parcours courts, comme le chemin d'une insertion ou d'une suppression, restent dans le tableau @c local sans
+ * allocation. La pile doit donc être initialisée en place avec `initCadreStack()`.
+ *
+ */
+typedef struct cadre_stack
 {
-    if (!th)
-        return NULL;
-    th->inf = deleteTH_rec(th->inf);
-    th->eq = deleteTH_rec(th->eq);
-    th->sup = deleteTH_rec(th->sup);
-    free(th);
-    return NULL;
-}
+    size_t cap;
+    size_t sz;
+    Cadre *tab;
+    Cadre local[CADRES_LOCAUX];
+} CadreStack;
 
-void deleteTH(TrieHybride **th)
+void initCadreStack(CadreStack *s)
 {
-    if (!th)
-        return;
-    *th = deleteTH_rec(*th);
+    s->cap = CADRES_LOCAUX;
+    s->sz = 0;
+    s->tab = s->local;
 }
 
-bool rechercheTH(const TrieHybride *th, const char *restrict cle)
+void freeCadreStack(CadreStack *s)
 {
-    if (!th)
-        return false;
-    size_t lgr = lgueur(cle);
-    if (lgr == 0)
-        return false;
-    bool res;
-    char p = prem(cle);
-    if (p < th->label)
-        res = rechercheTH(th->inf, cle);
-    else if (p > th->label)
-        res = rechercheTH(th->sup, cle);
-    else
-        res = rechercheTH(th->eq, reste(cle));
-    if (lgr == 1)
-        return res || (th->label == p && th->value);
-    return res;
+    if (s->tab != s->local)
+        free(s->tab);
 }
 
-size_t comptageMotsTH(const TrieHybride *th)
+void pushCadreStack(CadreStack *s, Lien l, size_t n)
 {
-    if (!th)
-        return 0;
-    if (th->value)
-        return 1 + comptageMotsTH(th->inf) + comptageMotsTH(th->eq) + comptageMotsTH(th->sup);
-    return comptageMotsTH(th->inf) + comptageMotsTH(th->eq) + comptageMotsTH(th->sup);
+    if (s->sz == s->cap)
+    {
+        Cadre *tab = malloc(2 * s->cap * sizeof(*tab));
+        if (!tab)
+        {
+            fprintf(stderr, "Erreur, malloc dans pushCadreStack");
+            exit(1);
+        }
+        memcpy(tab, s->tab, s->sz * sizeof(*tab));
+        freeCadreStack(s);
+        s->tab = tab;
+        s->cap *= 2;
+    }
+    s->tab[s->sz].l = l;
+    s->tab[s->sz].n = n;
+    s->sz++;
 }
 
-typedef struct stack
+Cadre popCadreStack(CadreStack *s)
 {
-    size_t cap;
-    size_t sz;
-    char *tab;
-} Stack;
+    assert(s->sz > 0 && "Tentative de dépilement sur une pile de cadres vide");
+    return s->tab[--s->sz];
+}
 
-Stack newStack(size_t capacity)
+/**
+ * @private
+ *
+ * @brief Remplace par @a nouveau le lien du noeud parent qui désigne @a ancien
+ *
+ * @pre @a ancien est un enfant de @a parent
+ *
+ */
+void remplaceLienTH(Noeud *parent, Lien ancien, Lien nouveau)
 {
-    assert(capacity > 0 && "Capacité donné doit être strictement positive");
-    Stack s;
-    s.cap = capacity;
-    s.sz = 0;
-    s.tab = malloc(capacity * sizeof(*s.tab));
-    if (!s.tab)
+    if (parent->inf == ancien)
+        parent->inf = nouveau;
+    else if (parent->eq == ancien)
+        parent->eq = nouveau;
+    else
     {
-        fprintf(stderr, "Erreur, malloc dans listeMots");
-        exit(1);
+        assert(parent->sup == ancien && "Le noeud remplacé doit être un enfant du parent");
+        parent->sup = nouveau;
     }
-    return s;
 }
 
-void freeStack(Stack s)
+/**
+ * @private
+ *
+ * @brief Hauteur d'un lien dans l'arbre binaire Inf/Sup de son niveau, 0 pour un lien nul
+ *
+ */
+static inline int hauteurLienTH(const Slab *sl, Lien l)
 {
-    free(s.tab);
+    return l ? NOEUD(sl, l)->h : 0;
 }
 
-void pushStack(Stack *s, char c)
+/**
+ * @private
+ *
+ * @brief Recalcule la hauteur d'un noeud à partir de celles de ses enfants Inf et Sup
+ *
+ * @return Vrai si la hauteur du noeud a changé
+ *
+ * L'enfant Eq commence un autre niveau et n'intervient pas dans la hauteur.
+ *
+ */
+static bool majHauteurTH(Slab *sl, Lien l)
 {
-    assert(s->sz + 1 <= s->cap && "Capacité de la pile de caractères dépassé");
-    s->tab[s->sz++] = c;
+    Noeud *n = NOEUD(sl, l);
+    int hi = hauteurLienTH(sl, n->inf), hs = hauteurLienTH(sl, n->sup);
+    unsigned char h = (unsigned char)(1 + (hi > hs ? hi : hs));
+    if (n->h == h)
+        return false;
+    n->h = h;
+    return true;
 }
 
-char popStack(Stack *s)
+/**
+ * @private
+ *
+ * @brief Nombre de mots du sous arbre d'un lien, 0 pour un lien nul
+ *
+ */
+static inline size_t motsLienTH(const Slab *sl, Lien l)
 {
-    assert(s->sz > 0 && "Tentative de dépilement sur une pile de caractères vide");
-    return s->tab[--s->sz];
+    return l ? MOTS(sl, l) : 0;
 }
 
-char *snapshotStack(Stack *s)
+/**
+ * @private
+ *
+ * @brief Plus grande valeur de fin de mot du sous arbre d'un lien, `INT_MIN` pour un lien nul
+ *
+ */
+static inline int meilleurLienTH(const Slab *sl, Lien l)
 {
-    if (!s)
-        return NULL;
-    if (s->sz == 0)
-        return NULL;
-    char *ret = malloc((s->sz + 1) * sizeof(*ret));
-    if (!ret)
-    {
-        fprintf(stderr, "Erreur, malloc dans snapshotStack");
-        exit(1);
-    }
-    memcpy(ret, s->tab, s->sz);
-    ret[s->sz] = '\0';
-    return ret;
+    return l ? MEILLEUR(sl, l) : INT_MIN;
 }
 
-const char *readStack(Stack *s)
+/**
+ * @private
+ *
+ * @brief Recalcule le nombre de mots et la plus grande valeur de fin de mot du sous arbre d'un noeud à partir de
+ * ceux de ses trois enfants
+ *
+ */
+static void majMotsTH(Slab *sl, Lien l)
 {
-    if (!s)
-        return NULL;
-    if (s->sz == 0)
-        return NULL;
-    s->tab[s->sz] = '\0';
-    return s->tab;
+    const Noeud *n = NOEUD(sl, l);
+    MOTS(sl, l) = (uint32_t)(!!FIN(n) + motsLienTH(sl, n->inf) + motsLienTH(sl, n->eq) + motsLienTH(sl, n->sup));
+    int m = FIN(n) ? VALEUR(sl, l) : INT_MIN;
+    int inf = meilleurLienTH(sl, n->inf), eq = meilleurLienTH(sl, n->eq), sup = meilleurLienTH(sl, n->sup);
+    m = inf > m ? inf : m;
+    m = eq > m ? eq : m;
+    MEILLEUR(sl, l) = sup > m ? sup : m;
 }
 
-void listeMotsTH_rec(const TrieHybride *th, Stack *s, char **tab, size_t *idx)
+/**
+ * @private
+ *
+ * @brief Effectue une rotation droite pour équilibrer
+ *
+ * @pre Le Trie Hybride donné est non vide (non nul)
+ *
+ * Seuls les hauteurs et nombres de mots des deux noeuds qui tournent changent, ils sont recalculés en O(1).
+ *
+ */
+Lien rotateRight(Slab *sl, Lien y)
 {
-    if (!th)
+    assert(y && "Given Hybrid Trie can't be NULL");
+    Lien x = NOEUD(sl, y)->inf;
+    Lien T = NOEUD(sl, x)->sup;
+
+    NOEUD(sl, x)->sup = y;
+    NOEUD(sl, y)->inf = T;
+    majHauteurTH(sl, y);
+    majHauteurTH(sl, x);
+    majMotsTH(sl, y);
+    majMotsTH(sl, x);
+
+    return x;
+}
+
+/**
+ * @private
+ *
+ * @brief Effectue une rotation gauche pour équilibrer
+ *
+ * @pre Le Trie Hybride donné est non vide (non nul)
+ *
+ * Seuls les hauteurs et nombres de mots des deux noeuds qui tournent changent, ils sont recalculés en O(1).
+ *
+ */
+Lien rotateLeft(Slab *sl, Lien x)
+{
+    assert(x && "Given Hybrid Trie can't be NULL");
+    Lien y = NOEUD(sl, x)->sup;
+    Lien T = NOEUD(sl, y)->inf;
+
+    NOEUD(sl, y)->inf = x;
+    NOEUD(sl, x)->sup = T;
+    majHauteurTH(sl, x);
+    majHauteurTH(sl, y);
+    majMotsTH(sl, x);
+    majMotsTH(sl, y);
+
+    return y;
+}
+
+/**
+ * @private
+ *
+ * @brief Corps de `rebalance()` sur un lien
+ *
+ * La hauteur et le nombre de mots du noeud sont d'abord recalculés depuis ses enfants, qui doivent être à jour, puis
+ * le facteur d'équilibre est lu sur les hauteurs des enfants en O(1).
+ *
+ */
+Lien rebalance_lien(Slab *sl, Lien l)
+{
+    assert(l && "Given Hybrid Trie can't be NULL");
+    majHauteurTH(sl, l);
+    majMotsTH(sl, l);
+    Noeud *n = NOEUD(sl, l);
+    int balanceFactor = hauteurLienTH(sl, n->inf) - hauteurLienTH(sl, n->sup);
+
+    /* Left heavy */
+    if (balanceFactor > 1)
+    {
+        const Noeud *inf = NOEUD(sl, n->inf);
+        if (hauteurLienTH(sl, inf->inf) >= hauteurLienTH(sl, inf->sup))
+        {
+            /* Single right rotation */
+            return rotateRight(sl, l);
+        }
+        else
+        {
+            /* Left-right rotation */
+            n->inf = rotateLeft(sl, n->inf);
+            return rotateRight(sl, l);
+        }
+    }
+
+    /* Right heavy */
+    if (balanceFactor < -1)
+    {
+        const Noeud *sup = NOEUD(sl, n->sup);
+        if (hauteurLienTH(sl, sup->sup) >= hauteurLienTH(sl, sup->inf))
+        {
+            /* Single left rotation */
+            return rotateLeft(sl, l);
+        }
+        else
+        {
+            /* Right-left rotation */
+            n->sup = rotateRight(sl, n->sup);
+            return rotateLeft(sl, l);
+        }
+    }
+
+    /* Node is balanced */
+    return l;
+}
+
+Lien ajoutTH_rec(Slab *sl, Lien l, const char *restrict cle, int v)
+{
+    char p = prem(cle);
+    if (p == '\0')
+        return l;
+    /* Test du dernier caractère de la clé sans recalculer sa longueur à chaque noeud */
+    bool dernier = cle[1] == '\0';
+    Lien enf;
+    if (!l)
+    {
+        Lien newl = allocTH(sl, p);
+        if (dernier)
+        {
+            POSE_FIN(sl, newl, v);
+        }
+        else
+        {
+            enf = ajoutTH_rec(sl, NIL, reste(cle), v);
+            NOEUD(sl, newl)->eq = enf;
+        }
+        majMotsTH(sl, newl);
+        return newl;
+    }
+    char label = LABEL(NOEUD(sl, l));
+    if (p < label)
+    {
+        enf = ajoutTH_rec(sl, NOEUD(sl, l)->inf, cle, v);
+        NOEUD(sl, l)->inf = enf;
+    }
+    else if (p > label)
+    {
+        enf = ajoutTH_rec(sl, NOEUD(sl, l)->sup, cle, v);
+        NOEUD(sl, l)->sup = enf;
+    }
+    else
+    {
+        enf = ajoutTH_rec(sl, NOEUD(sl, l)->eq, reste(cle), v);
+        NOEUD(sl, l)->eq = enf;
+    }
+    majHauteurTH(sl, l);
+    if (dernier && label == p && !FIN(NOEUD(sl, l)))
+    {
+        POSE_FIN(sl, l, v);
+    }
+    majMotsTH(sl, l);
+    return l;
+}
+
+/**
+ * @private
+ *
+ * @brief Compte sous chacun des noeuds du chemin un nouveau mot de valeur @a v
+ *
+ */
+static void ajouteMotCheminTH(Slab *sl, const CadreStack *chemin, int v)
+{
+    for (size_t k = 0; k < chemin->sz; k++)
+    {
+        Lien l = chemin->tab[k].l;
+        MOTS(sl, l)++;
+        if (MEILLEUR(sl, l) < v)
+            MEILLEUR(sl, l) = v;
+    }
+}
+
+/**
+ * @private
+ *
+ * @brief Insère la clé sans récursion, en gardant éventuellement le chemin parcouru
+ *
+ * @param [in,out] sl La slab du trie
+ * @param [in] l Le lien vers la racine du trie
+ * @param [in] cle Une chaine de caractères constituant une clé
+ * @param [in] v La valeur de fin de mot
+ * @param [out] chemin Reçoit dans l'ordre de la descente les noeuds existants qui ont été traversés, le champ @c n
+ * d'une case vaut 1 si la descente a quitté le noeud par son enfant Inf ou Sup, 0 sinon
+ * @return Le lien vers la racine du trie avec la clé ajoutée
+ *
+ * Les noeuds existants sont parcourus sans allocation. Le reste de la clé, s'il en reste, forme une chaine de noeuds
+ * par leur enfant Eq qui est créée d'un coup puis accrochée au dernier noeud traversé.
+ * Les hauteurs des noeuds traversés ne sont pas mises à jour, c'est à l'appelant de le faire avec @a chemin. Leurs
+ * nombres de mots et plus grandes valeurs le sont, chacun gagnant un mot si la clé n'était pas déjà présente.
+ *
+ */
+Lien ajoutTH_descente(Slab *sl, Lien l, const char *restrict cle, int v, CadreStack *chemin)
+{
+    if (*cle == '\0')
+        return l;
+    Lien parent = NIL, cur = l;
+    int dir = 0;
+    while (cur)
+    {
+        Noeud *n = NOEUD(sl, cur);
+        pushCadreStack(chemin, cur, *cle != LABEL(n));
+        parent = cur;
+        if (*cle < LABEL(n))
+        {
+            cur = n->inf;
+            dir = -1;
+        }
+        else if (*cle > LABEL(n))
+        {
+            cur = n->sup;
+            dir = 1;
+        }
+        else if (cle[1] == '\0')
+        {
+            if (!FIN(n))
+            {
+                POSE_FIN(sl, cur, v);
+                ajouteMotCheminTH(sl, chemin, v);
+            }
+            return l;
+        }
+        else
+        {
+            cur = n->eq;
+            dir = 0;
+            cle++;
+        }
+    }
+
+    Lien chaine = allocTH(sl, *cle);
+    Lien dernier = chaine;
+    MOTS(sl, chaine) = 1;
+    MEILLEUR(sl, chaine) = v;
+    while (*++cle)
+    {
+        Lien newl = allocTH(sl, *cle);
+        MOTS(sl, newl) = 1;
+        MEILLEUR(sl, newl) = v;
+        NOEUD(sl, dernier)->eq = newl;
+        dernier = newl;
+    }
+    POSE_FIN(sl, dernier, v);
+    ajouteMotCheminTH(sl, chemin, v);
+    if (!parent)
+        return chaine;
+    Noeud *n = NOEUD(sl, parent);
+    if (dir < 0)
+        n->inf = chaine;
+    else if (dir > 0)
+        n->sup = chaine;
+    else
+        n->eq = chaine;
+    return l;
+}
+
+/**
+ * @private
+ *
+ * @brief Version itérative de `ajoutTH_rec()`
+ *
+ * Un nouveau noeud ne peut changer que les hauteurs des noeuds traversés par Inf ou Sup depuis le dernier passage par
+ * un enfant Eq, qui sont recalculées en remontant jusqu'à ce qu'une hauteur reste inchangée.
+ *
+ */
+Lien ajoutTH_iter(Slab *sl, Lien l, const char *restrict cle, int v)
+{
+    CadreStack chemin;
+    initCadreStack(&chemin);
+    l = ajoutTH_descente(sl, l, cle, v, &chemin);
+    for (size_t k = chemin.sz; k-- > 0;)
+        if (!majHauteurTH(sl, chemin.tab[k].l) || k == 0 || chemin.tab[k - 1].n == 0)
+            break;
+    freeCadreStack(&chemin);
+    return l;
+}
+
+TrieHybride *ajoutTH(TrieHybride *th, const char *restrict cle, int v)
+{
+    assert(v != 0 && "Valeur donné pour l'insértion doit être non nul");
+    Slab *sl = ouvreTH(th);
+    return fermeTH(sl, VERSION(ajoutTH)(sl, racineTH(th), cle, v));
+}
+
+/**
+ * @private
+ */
+typedef enum presence_enfants
+{
+    INF = 1,     /**< Seulement l'enfant Inf est présent */
+    SUP = 2,     /**< Seulement l'enfant Sup est présent */
+    INFSUP = 3,  /**< Les deux enfants Inf et Sup sont présents */
+    AUCUNENF = 0 /**< Aucun des deux enfants Inf et Sup sont présents */
+} PresenceEnfants;
+
+/**
+ * @private
+ *
+ * @brief Calcule une valeur qui indique lesquels des enfants du noeud sont présents
+ *
+ * @param [in] n Un pointeur vers le noeud à calculer les enfants
+ * @return Une valeur dans l'intervalle [0; 3] pour indiquer lesquels des enfants sont présents à part l'enfant Eq
+ *
+ * @pre Le noeud donné est non nul
+ *
+ * L'enfant Eq n'est pas tenu en compte, il faut vérifier cela à part.
+ *
+ */
+PresenceEnfants determine_enfants(const Noeud *n)
+{
+    return (!!n->sup << 1) | (!!n->inf);
+}
+
+/**
+ * @private
+ *
+ * @brief Accroche @a sup comme enfant Sup du noeud le plus à droite de @a inf
+ *
+ * @return Le lien @a inf
+ *
+ * @pre @a inf est non nul et toutes les clés de @a sup sont plus grandes que celles de @a inf
+ *
+ * Les hauteurs du bord droit de @a inf sont recalculées en remontant, jusqu'à la première inchangée. Les nombres de
+ * mots le sont sur tout le bord, chacun de ses noeuds gagnant les mots de @a sup.
+ *
+ */
+static Lien accrocheSupTH(Slab *sl, Lien inf, Lien sup)
+{
+    CadreStack bord;
+    initCadreStack(&bord);
+    for (Lien cur = inf; cur; cur = NOEUD(sl, cur)->sup)
+        pushCadreStack(&bord, cur, 0);
+    NOEUD(sl, bord.tab[bord.sz - 1].l)->sup = sup;
+    bool change = true;
+    for (size_t k = bord.sz; k-- > 0;)
+    {
+        change = change && majHauteurTH(sl, bord.tab[k].l);
+        majMotsTH(sl, bord.tab[k].l);
+    }
+    freeCadreStack(&bord);
+    return inf;
+}
+
+/**
+ * @private
+ *
+ * @brief Détache le plus petit noeud de l'arbre binaire Inf/Sup @a l en rééquilibrant le chemin
+ *
+ * @param [out] min Reçoit le lien vers le noeud détaché
+ * @return Le lien vers l'arbre binaire privé de son plus petit noeud
+ *
+ * @pre @a l est non nul
+ *
+ */
+static Lien retireMinTH(Slab *sl, Lien l, Lien *min)
+{
+    CadreStack chemin;
+    initCadreStack(&chemin);
+    Lien cur = l;
+    for (; NOEUD(sl, cur)->inf; cur = NOEUD(sl, cur)->inf)
+        pushCadreStack(&chemin, cur, 0);
+    *min = cur;
+    Lien nouveau = NOEUD(sl, cur)->sup;
+    for (size_t k = chemin.sz; k-- > 0;)
+    {
+        Lien parent = chemin.tab[k].l;
+        NOEUD(sl, parent)->inf = nouveau;
+        nouveau = rebalance_lien(sl, parent);
+    }
+    freeCadreStack(&chemin);
+    return nouveau;
+}
+
+/**
+ * @private
+ *
+ * @brief Supprime le noeud donné si possible et réorganise les sous arbres
+ *
+ * @param [in,out] sl La slab du trie
+ * @param [in] l Le lien vers le noeud du Trie Hybride à essayer de supprimer
+ * @param [out] didDelete Un flag mis à vrai si une supression a bien pu s'effectuer
+ * @param [in] reequilibre Vrai pour remplacer un noeud à deux enfants Inf et Sup par son successeur comme dans un AVL
+ * @return Le lien vers le Trie Hybride avec potentiellemnt la clé supprimé et reorganisé
+ *
+ * @pre didDelete a été alloué par l'appelant
+ *
+ * Cette fonction aide à la suppression d'une clé d'un Trie Hybride avec une manipulation délicate.
+ * Il y a plusieurs cas de traitement.
+ *
+ */
+Lien supprTH_essaye_delete_reorg(Slab *sl, Lien l, bool *didDelete, bool reequilibre)
+{
+    Noeud *n = NOEUD(sl, l);
+    if (n->eq || FIN(n))
+    {
+        return l;
+    }
+    Lien tmp;
+    switch (determine_enfants(n))
+    {
+    case INFSUP:
+        if (reequilibre)
+        {
+            Lien succ;
+            Lien sup = retireMinTH(sl, n->sup, &succ);
+            NOEUD(sl, succ)->inf = n->inf;
+            NOEUD(sl, succ)->sup = sup;
+            tmp = rebalance_lien(sl, succ);
+        }
+        else
+            tmp = accrocheSupTH(sl, n->inf, n->sup);
+        break;
+    case INF:
+        tmp = n->inf;
+        break;
+    case SUP:
+        tmp = n->sup;
+        break;
+    case AUCUNENF:
+        tmp = NIL;
+        break;
+    default:
+        fprintf(stderr, "Erreur, calcul présence des enfants malheureux");
+        exit(1);
+    }
+    libereTH(sl, l);
+    *didDelete = true;
+    return tmp;
+}
+
+/**
+ * @private
+ *
+ * @brief Supprime la clé donné avec libération des noeuds si possible et réorganise les sous arbres
+ *
+ * @param [in,out] sl La slab du trie
+ * @param [in] l Le lien vers le Trie Hybride à traiter
+ * @param [in] cle Une chaine de caractères constituant une clé
+ * @param [in,out] didDelete Un flag mis à vrai si une supression a bien pu s'effectuer
+ * @param [in] reequilibre Vrai pour rééquilibrer les noeuds traversés comme dans un AVL
+ * @return Le lien vers le Trie Hybride avec potentiellemnt la clé supprimé et reorganisé
+ *
+ * @pre didDelete a été alloué par l'appelant
+ *
+ */
+Lien supprTH_rec(Slab *sl, Lien l, const char *restrict cle, bool *didDelete, bool reequilibre)
+{
+    if (!l)
+        return l;
+    char p = prem(cle);
+    if (p == '\0')
+        return l;
+    /* La suppression ne fait que libérer des noeuds, la slab n'est jamais déplacée */
+    Noeud *n = NOEUD(sl, l);
+    if (p < LABEL(n))
+    {
+        n->inf = supprTH_rec(sl, n->inf, cle, didDelete, reequilibre);
+    }
+    else if (p > LABEL(n))
+    {
+        n->sup = supprTH_rec(sl, n->sup, cle, didDelete, reequilibre);
+    }
+    else
+    {
+        n->eq = supprTH_rec(sl, n->eq, reste(cle), didDelete, reequilibre);
+    }
+    majHauteurTH(sl, l);
+    bool enleve = cle[1] == '\0' && LABEL(n) == p && FIN(n);
+    if (enleve)
+        POSE_FIN(sl, l, VALVIDE);
+    majMotsTH(sl, l);
+    if (cle[1] == '\0')
+    {
+        if (enleve)
+            l = supprTH_essaye_delete_reorg(sl, l, didDelete, reequilibre);
+    }
+    else if (didDelete)
+    {
+        assert(cle[1] != '\0' && "Etat incorrecte, longueur de la clé doit être strictement positif");
+        l = supprTH_essaye_delete_reorg(sl, l, didDelete, reequilibre);
+    }
+    if (reequilibre && l)
+        l = rebalance_lien(sl, l);
+    return l;
+}
+
+/**
+ * @private
+ *
+ * @brief Version itérative de `supprTH_rec()`
+ *
+ * La descente garde les noeuds traversés, puis la réorganisation est tentée en remontant comme au retour des appels
+ * récursifs : sur tous les noeuds atteints avant le dernier caractère de la clé, et sur le noeud du dernier caractère
+ * si la fin de mot y a été enlevée. Les hauteurs sont recalculées, les nombres de mots et plus grandes valeurs aussi
+ * si la clé était présente, et les noeuds rééquilibrés si demandé, au passage.
+ *
+ */
+Lien supprTH_iter(Slab *sl, Lien l, const char *restrict cle, bool *didDelete, bool reequilibre)
+{
+    if (!l || *cle == '\0')
+        return l;
+    CadreStack chemin;
+    initCadreStack(&chemin);
+    size_t dernierCar = SIZE_MAX;
+    bool enleve = false;
+    Lien cur = l;
+    while (cur)
+    {
+        Noeud *n = NOEUD(sl, cur);
+        pushCadreStack(&chemin, cur, 0);
+        if (cle[1] == '\0' && dernierCar == SIZE_MAX)
+            dernierCar = chemin.sz - 1;
+        if (*cle < LABEL(n))
+            cur = n->inf;
+        else if (*cle > LABEL(n))
+            cur = n->sup;
+        else if (cle[1] == '\0')
+        {
+            if (FIN(n))
+            {
+                POSE_FIN(sl, cur, VALVIDE);
+                enleve = true;
+            }
+            break;
+        }
+        else
+        {
+            cur = n->eq;
+            cle++;
+        }
+    }
+
+    /* Vrai si l'enfant du noeud courant a été remplacé ou a changé de hauteur */
+    bool change = false;
+    for (size_t k = chemin.sz; k-- > 0;)
+    {
+        Lien ancien = chemin.tab[k].l, nouveau = ancien;
+        change = change && majHauteurTH(sl, ancien);
+        if (enleve)
+            majMotsTH(sl, ancien);
+        if (k < dernierCar || (enleve && k == chemin.sz - 1))
+            nouveau = supprTH_essaye_delete_reorg(sl, ancien, didDelete, reequilibre);
+        if (reequilibre && nouveau)
+            nouveau = rebalance_lien(sl, nouveau);
+        change = change || nouveau != ancien;
+        if (k == 0)
+            l = nouveau;
+        else if (nouveau != ancien)
+            remplaceLienTH(NOEUD(sl, chemin.tab[k - 1].l), ancien, nouveau);
+    }
+    freeCadreStack(&chemin);
+    return l;
+}
+
+TrieHybride *supprTH(TrieHybride *th, const char *restrict cle)
+{
+    if (!th)
+        return th;
+    bool didDelete = false;
+    Slab *sl = ouvreTH(th);
+    return fermeTH(sl, VERSION(supprTH)(sl, racineTH(th), cle, &didDelete, false));
+}
+
+TrieHybride *supprReequilibreTH(TrieHybride *th, const char *restrict cle)
+{
+    if (!th)
+        return th;
+    bool didDelete = false;
+    Slab *sl = ouvreTH(th);
+    return fermeTH(sl, VERSION(supprTH)(sl, racineTH(th), cle, &didDelete, true));
+}
+
+#ifndef HYBRID_SLAB
+TrieHybride *deleteTH_rec(TrieHybride *th)
+{
+    if (!th)
+        return NULL;
+    th->inf = deleteTH_rec(th->inf);
+    th->eq = deleteTH_rec(th->eq);
+    th->sup = deleteTH_rec(th->sup);
+    free(th);
+    return NULL;
+}
+
+TrieHybride *deleteTH_iter(TrieHybride *th)
+{
+    CadreStack s;
+    initCadreStack(&s);
+    if (th)
+        pushCadreStack(&s, th, 0);
+    while (s.sz > 0)
+    {
+        TrieHybride *n = popCadreStack(&s).l;
+        if (n->inf)
+            pushCadreStack(&s, n->inf, 0);
+        if (n->eq)
+            pushCadreStack(&s, n->eq, 0);
+        if (n->sup)
+            pushCadreStack(&s, n->sup, 0);
+        free(n);
+    }
+    freeCadreStack(&s);
+    return NULL;
+}
+#endif
+
+void deleteTH(TrieHybride **th)
+{
+    if (!th)
+        return;
+#ifdef HYBRID_SLAB
+    /* Tous les noeuds sont dans la slab, libérés d'un coup */
+    if (*th)
+    {
+        free((*th)->noeuds);
+        free((*th)->mots);
+        free((*th)->valeurs);
+        free((*th)->meilleurs);
+        free(*th);
+    }
+    *th = NULL;
+#else
+    *th = VERSION(deleteTH)(*th);
+#endif
+}
+
+bool rechercheTH_rec(const Slab *sl, Lien l, const char *restrict cle)
+{
+    if (!l)
+        return false;
+    char p = prem(cle);
+    if (p == '\0')
+        return false;
+    const Noeud *n = NOEUD(sl, l);
+    /* Tous les appels sont terminaux, le compilateur peut en faire une boucle */
+    if (p < LABEL(n))
+        return rechercheTH_rec(sl, n->inf, cle);
+    if (p > LABEL(n))
+        return rechercheTH_rec(sl, n->sup, cle);
+    if (cle[1] == '\0')
+        return FIN(n);
+    return rechercheTH_rec(sl, n->eq, reste(cle));
+}
+
+bool rechercheTH_iter(const Slab *sl, Lien l, const char *restrict cle)
+{
+    if (*cle == '\0')
+        return false;
+    while (l)
+    {
+        const Noeud *n = NOEUD(sl, l);
+        if (*cle < LABEL(n))
+            l = n->inf;
+        else if (*cle > LABEL(n))
+            l = n->sup;
+        else if (cle[1] == '\0')
+            return FIN(n);
+        else
+        {
+            l = n->eq;
+            cle++;
+        }
+    }
+    return false;
+}
+
+bool rechercheTH(const TrieHybride *th, const char *restrict cle)
+{
+    return VERSION(rechercheTH)(slabTH(th), racineTH(th), cle);
+}
+
+/**
+ * @private
+ *
+ * @def RECHERCHES_EN_VOL
+ *
+ * @brief Le nombre de recherches de `rechercheBatchTH()` menées de front, assez pour couvrir la latence d'un accès
+ * mémoire par le travail fait sur les autres
+ *
+ */
+#define RECHERCHES_EN_VOL 16
+
+/**
+ * @private
+ *
+ * @brief Une recherche en cours de `rechercheBatchTH()`
+ *
+ */
+typedef struct recherche_en_vol
+{
+    Lien l;          /**< Le prochain noeud à comparer, déjà demandé à la mémoire */
+    const char *cle; /**< Le reste de la clé à chercher */
+    size_t i;        /**< L'indice de la clé dans le lot */
+} RechercheEnVol;
+
+/**
+ * @private
+ *
+ * @brief Démarre la prochaine recherche non triviale du lot sur la place donnée de `rechercheBatchTH()`
+ *
+ * @param [in] racine La racine du Trie Hybride, non nulle
+ * @param [in] cles Les clés du lot
+ * @param [in] n Le nombre de clés
+ * @param [in, out] suivante L'indice de la prochaine clé à chercher, avancé au-delà de la clé prise
+ * @param [out] resultats Les résultats, remplis au passage pour les clés vides
+ * @param [out] r La place à occuper
+ * @return false s'il n'y a plus de clé à chercher
+ *
+ */
+static bool demarreRechercheTH(const Slab *sl, Lien racine, const char *const *cles, size_t n, size_t *suivante,
+                               bool *resultats, RechercheEnVol *r)
+{
+    for (; *suivante < n; (*suivante)++)
+    {
+        if (*cles[*suivante] == '\0')
+        {
+            resultats[*suivante] = false;
+            continue;
+        }
+        __builtin_prefetch(NOEUD(sl, racine));
+        *r = (RechercheEnVol){racine, cles[*suivante], *suivante};
+        (*suivante)++;
+        return true;
+    }
+    return false;
+}
+
+void rechercheBatchTH(const TrieHybride *th, const char *const *cles, size_t n, bool *resultats)
+{
+    const Slab *sl = slabTH(th);
+    Lien racine = racineTH(th);
+    if (!racine)
+    {
+        for (size_t i = 0; i < n; i++)
+            resultats[i] = false;
+        return;
+    }
+    RechercheEnVol vol[RECHERCHES_EN_VOL];
+    size_t actives = 0, suivante = 0;
+    while (actives < RECHERCHES_EN_VOL && demarreRechercheTH(sl, racine, cles, n, &suivante, resultats, &vol[actives]))
+        actives++;
+
+    /* Chaque recherche avance d'un noeud par tour et demande le suivant à la mémoire avant de laisser la main aux
+     * autres : les défauts de cache des différentes recherches se recouvrent au lieu de s'enchaîner. Une place libérée
+     * est aussitôt reprise par la clé suivante. */
+    while (actives > 0)
+    {
+        for (size_t k = 0; k < actives;)
+        {
+            RechercheEnVol *r = &vol[k];
+            const Noeud *nd = NOEUD(sl, r->l);
+            char c = *r->cle, lab = LABEL(nd);
+            /* Choix de l'enfant sans branchement : les comparaisons de recherches différentes se suivent au hasard et
+             * seraient mal prédites, seule la fin d'une recherche coûte un saut */
+            Lien suivant = (Lien)(((uintptr_t)nd->inf & -(uintptr_t)(c < lab)) |
+                                  ((uintptr_t)nd->eq & -(uintptr_t)(c == lab)) |
+                                  ((uintptr_t)nd->sup & -(uintptr_t)(c > lab)));
+            bool trouve = c == lab && r->cle[1] == '\0';
+            if (trouve || !suivant)
+            {
+                resultats[r->i] = trouve && FIN(nd);
+                if (!demarreRechercheTH(sl, racine, cles, n, &suivante, resultats, r))
+                    *r = vol[--actives];
+                else
+                    k++;
+                continue;
+            }
+            r->cle += c == lab;
+            r->l = suivant;
+            __builtin_prefetch(NOEUD(sl, suivant));
+            k++;
+        }
+    }
+}
+
+size_t longestPrefixTH(const TrieHybride *th, const char *restrict texte, int *valeur)
+{
+    const Slab *sl = slabTH(th);
+    Lien l = racineTH(th);
+    size_t lg = 0;
+    int v = VALVIDE;
+    const char *r = texte;
+    while (l && *r != '\0')
+    {
+        const Noeud *n = NOEUD(sl, l);
+        if (*r < LABEL(n))
+            l = n->inf;
+        else if (*r > LABEL(n))
+            l = n->sup;
+        else
+        {
+            r++;
+            if (FIN(n))
+            {
+                lg = (size_t)(r - texte);
+                v = VALEUR(sl, l);
+            }
+            l = n->eq;
+        }
+    }
+    if (valeur)
+        *valeur = v;
+    return lg;
+}
+
+size_t comptageMotsTH(const TrieHybride *th)
+{
+    return motsLienTH(slabTH(th), racineTH(th));
+}
+
+typedef struct stack
+{
+    size_t cap;
+    size_t sz;
+    char *tab;
+} Stack;
+
+Stack newStack(size_t capacity)
+{
+    assert(capacity > 0 && "Capacité donné doit être strictement positive");
+    Stack s;
+    s.cap = capacity;
+    s.sz = 0;
+    s.tab = malloc(capacity * sizeof(*s.tab));
+    if (!s.tab)
+    {
+        fprintf(stderr, "Erreur, malloc dans listeMots");
+        exit(1);
+    }
+    return s;
+}
+
+void freeStack(Stack s)
+{
+    free(s.tab);
+}
+
+void pushStack(Stack *s, char c)
+{
+    assert(s->sz + 1 <= s->cap && "Capacité de la pile de caractères dépassé");
+    s->tab[s->sz++] = c;
+}
+
+char popStack(Stack *s)
+{
+    assert(s->sz > 0 && "Tentative de dépilement sur une pile de caractères vide");
+    return s->tab[--s->sz];
+}
+
+char *snapshotStack(Stack *s)
+{
+    if (!s)
+        return NULL;
+    if (s->sz == 0)
+        return NULL;
+    char *ret = malloc((s->sz + 1) * sizeof(*ret));
+    if (!ret)
+    {
+        fprintf(stderr, "Erreur, malloc dans snapshotStack");
+        exit(1);
+    }
+    memcpy(ret, s->tab, s->sz);
+    ret[s->sz] = '\0';
+    return ret;
+}
+
+const char *readStack(Stack *s)
+{
+    if (!s)
+        return NULL;
+    if (s->sz == 0)
+        return NULL;
+    s->tab[s->sz] = '\0';
+    return s->tab;
+}
+
+void listeMotsTH_rec(const Slab *sl, Lien l, Stack *s, char **tab, size_t *idx)
+{
+    if (!l)
+        return;
+    const Noeud *n = NOEUD(sl, l);
+    listeMotsTH_rec(sl, n->inf, s, tab, idx);
+    pushStack(s, LABEL(n));
+    if (FIN(n))
+    {
+        tab[*idx] = snapshotStack(s);
+        (*idx)++;
+    }
+    listeMotsTH_rec(sl, n->eq, s, tab, idx);
+    popStack(s);
+    listeMotsTH_rec(sl, n->sup, s, tab, idx);
+}
+
+/**
+ * @private
+ *
+ * @brief Avance le parcours en ordre alphabétique jusqu'au mot suivant
+ *
+ * @param [in] sl La slab du trie parcouru
+ * @param [in,out] pile La pile du parcours, initialisée avec le cadre `{racine, 0}`
+ * @param [in,out] s La pile des caractères du chemin courant
+ * @return Vrai si un mot a été atteint, il est alors dans @a s, faux quand le parcours est terminé
+ *
+ * Le champ @c n d'un cadre est l'étape atteinte pour ce noeud : 0 descendre dans Inf, 1 empiler son caractère (et
+ * s'arrêter s'il est une fin de mot), 2 descendre dans Eq, 3 dépiler son caractère et continuer avec Sup à sa place.
+ *
+ */
+bool motSuivantTH(const Slab *sl, CadreStack *pile, Stack *s)
+{
+    while (pile->sz > 0)
+    {
+        Cadre *c = &pile->tab[pile->sz - 1];
+        const Noeud *n = NOEUD(sl, c->l);
+        switch (c->n++)
+        {
+        case 0:
+            if (n->inf)
+                pushCadreStack(pile, n->inf, 0);
+            break;
+        case 1:
+            pushStack(s, LABEL(n));
+            if (FIN(n))
+                return true;
+            break;
+        case 2:
+            if (n->eq)
+                pushCadreStack(pile, n->eq, 0);
+            break;
+        default:
+            popStack(s);
+            pile->sz--;
+            if (n->sup)
+                pushCadreStack(pile, n->sup, 0);
+        }
+    }
+    return false;
+}
+
+void listeMotsTH_iter(const Slab *sl, Lien l, Stack *s, char **tab, size_t *idx)
+{
+    CadreStack pile;
+    initCadreStack(&pile);
+    if (l)
+        pushCadreStack(&pile, l, 0);
+    while (motSuivantTH(sl, &pile, s))
+    {
+        tab[*idx] = snapshotStack(s);
+        (*idx)++;
+    }
+    freeCadreStack(&pile);
+}
+
+char **listeMotsTH(const TrieHybride *th)
+{
+    if (!th)
+        return NULL;
+    size_t sz = comptageMotsTH(th);
+    char **tab = malloc((sz + 1) * sizeof(*tab));
+    if (!tab)
+    {
+        fprintf(stderr, "Erreur, malloc dans listeMots");
+        exit(1);
+    }
+    tab[sz] = NULL;
+    Stack s = newStack(hauteurTH(th) + 1);
+    sz = 0;
+    VERSION(listeMotsTH)(slabTH(th), racineTH(th), &s, tab, &sz);
+    assert(s.sz == 0 && "La pile des caractères doit être vide à cet instant");
+    freeStack(s);
+    return tab;
+}
+
+void deleteListeMotsTH(char **tab)
+{
+    if (!tab)
+        return;
+    for (char **i = tab; *i; i++)
+    {
+        free(*i);
+    }
+    free(tab);
+}
+
+int comptageNilTH_rec(const Slab *sl, Lien l)
+{
+    if (!l)
+        return 1;
+    const Noeud *n = NOEUD(sl, l);
+    return comptageNilTH_rec(sl, n->inf) + comptageNilTH_rec(sl, n->eq) + comptageNilTH_rec(sl, n->sup);
+}
+
+int comptageNilTH_iter(const Slab *sl, Lien l)
+{
+    if (!l)
+        return 1;
+    int count = 0;
+    CadreStack s;
+    initCadreStack(&s);
+    pushCadreStack(&s, l, 0);
+    while (s.sz > 0)
+    {
+        const Noeud *n = NOEUD(sl, popCadreStack(&s).l);
+        const Lien enfants[] = {n->inf, n->eq, n->sup};
+        for (size_t i = 0; i < 3; i++)
+        {
+            if (enfants[i])
+                pushCadreStack(&s, enfants[i], 0);
+            else
+                count++;
+        }
+    }
+    freeCadreStack(&s);
+    return count;
+}
+
+int comptageNilTH(const TrieHybride *th)
+{
+    return VERSION(comptageNilTH)(slabTH(th), racineTH(th));
+}
+
+ssize_t hauteurTH_rec(const Slab *sl, Lien l)
+{
+    if (!l)
+        return -1;
+    const Noeud *n = NOEUD(sl, l);
+    ssize_t inf = hauteurTH_rec(sl, n->inf);
+    ssize_t eq = hauteurTH_rec(sl, n->eq);
+    ssize_t sup = hauteurTH_rec(sl, n->sup);
+    return 1 + MAX3(inf, eq, sup);
+}
+
+ssize_t hauteurTH_iter(const Slab *sl, Lien l)
+{
+    ssize_t hauteur = -1;
+    CadreStack s;
+    initCadreStack(&s);
+    if (l)
+        pushCadreStack(&s, l, 0);
+    while (s.sz > 0)
+    {
+        Cadre c = popCadreStack(&s);
+        const Noeud *n = NOEUD(sl, c.l);
+        if ((ssize_t)c.n > hauteur)
+            hauteur = c.n;
+        if (n->inf)
+            pushCadreStack(&s, n->inf, c.n + 1);
+        if (n->eq)
+            pushCadreStack(&s, n->eq, c.n + 1);
+        if (n->sup)
+            pushCadreStack(&s, n->sup, c.n + 1);
+    }
+    freeCadreStack(&s);
+    return hauteur;
+}
+
+ssize_t hauteurTH(const TrieHybride *th)
+{
+    return VERSION(hauteurTH)(slabTH(th), racineTH(th));
+}
+
+void profondeurMoyenneTH_rec(const Slab *sl, Lien l, int depth, int *sum, int *count)
+{
+    if (!l)
+        return;
+    const Noeud *n = NOEUD(sl, l);
+    if (!n->eq && determine_enfants(n) == AUCUNENF)
+    {
+        (*sum) += depth;
+        (*count)++;
+        return;
+    }
+    profondeurMoyenneTH_rec(sl, n->inf, depth + 1, sum, count);
+    profondeurMoyenneTH_rec(sl, n->eq, depth + 1, sum, count);
+    profondeurMoyenneTH_rec(sl, n->sup, depth + 1, sum, count);
+}
+
+void profondeurMoyenneTH_iter(const Slab *sl, Lien l, int depth, int *sum, int *count)
+{
+    CadreStack s;
+    initCadreStack(&s);
+    if (l)
+        pushCadreStack(&s, l, depth);
+    while (s.sz > 0)
+    {
+        Cadre c = popCadreStack(&s);
+        const Noeud *n = NOEUD(sl, c.l);
+        if (!n->eq && determine_enfants(n) == AUCUNENF)
+        {
+            (*sum) += c.n;
+            (*count)++;
+            continue;
+        }
+        if (n->inf)
+            pushCadreStack(&s, n->inf, c.n + 1);
+        if (n->eq)
+            pushCadreStack(&s, n->eq, c.n + 1);
+        if (n->sup)
+            pushCadreStack(&s, n->sup, c.n + 1);
+    }
+    freeCadreStack(&s);
+}
+
+int profondeurMoyenneEntTH(const TrieHybride *th)
+{
+    int sum = 0, count = 0;
+    VERSION(profondeurMoyenneTH)(slabTH(th), racineTH(th), 0, &sum, &count);
+    if (count == 0)
+        return -1;
+    assert(count > 0 && "Le compte des feuilles doit être strictement positif");
+    assert(sum >= 0 && "La somme des profondeurs doit être positif ou nul");
+    return sum / count;
+}
+
+double profondeurMoyenneTH(const TrieHybride *th)
+{
+    int sum = 0, count = 0;
+    VERSION(profondeurMoyenneTH)(slabTH(th), racineTH(th), 0, &sum, &count);
+    if (count == 0)
+        return -1;
+    assert(count > 0 && "Le compte des feuilles doit être strictement positif");
+    assert(sum >= 0 && "La somme des profondeurs doit être positif ou nul");
+    return (double)sum / count;
+}
+
+int prefixeTH(const TrieHybride *th, const char *cle)
+{
+    if (!th)
+        return 0;
+
+    const Slab *sl = slabTH(th);
+    const Noeud *lastNode = NULL;
+    Lien subtree = racineTH(th);
+    const char *r = cle;
+    char p;
+    /* Advance until the subtree that interests us */
+    while (subtree)
+    {
+        p = prem(r);
+        if (p == '\0')
+            break;
+
+        lastNode = NOEUD(sl, subtree);
+        if (p < LABEL(lastNode))
+            subtree = lastNode->inf;
+        else if (p > LABEL(lastNode))
+            subtree = lastNode->sup;
+        else
+        {
+            subtree = lastNode->eq;
+            r = reste(r);
+        }
+    }
+
+    /* Le sous arbre sous le dernier caractère garde son nombre de mots, seul ce caractère reste à compter */
+    return (!(*r) && lastNode && FIN(lastNode)) + (int)motsLienTH(sl, subtree);
+}
+
+size_t rankTH(const TrieHybride *th, const char *cle)
+{
+    const Slab *sl = slabTH(th);
+    Lien l = racineTH(th);
+    size_t rang = 0;
+    if (*cle == '\0')
+        return 0;
+    while (l)
+    {
+        const Noeud *n = NOEUD(sl, l);
+        if (*cle < LABEL(n))
+            l = n->inf;
+        else if (*cle > LABEL(n))
+        {
+            /* Tout le noeud et ce qui est à sa gauche précède la clé */
+            rang += motsLienTH(sl, n->inf) + !!FIN(n) + motsLienTH(sl, n->eq);
+            l = n->sup;
+        }
+        else
+        {
+            rang += motsLienTH(sl, n->inf);
+            if (cle[1] == '\0')
+                break;
+            /* Un mot qui se termine ici est un préfixe strict de la clé */
+            rang += !!FIN(n);
+            l = n->eq;
+            cle++;
+        }
+    }
+    return rang;
+}
+
+char *selectTH(const TrieHybride *th, size_t k)
+{
+    const Slab *sl = slabTH(th);
+    Lien l = racineTH(th);
+    if (k >= motsLienTH(sl, l))
+        return NULL;
+    size_t sz = 0, cap = 16;
+    char *mot = malloc(cap);
+    if (!mot)
+    {
+        fprintf(stderr, "Erreur, malloc dans selectTH");
+        exit(1);
+    }
+    for (;;)
+    {
+        assert(l && "Le rang donné est inférieur au nombre de mots du sous arbre courant");
+        const Noeud *n = NOEUD(sl, l);
+        size_t inf = motsLienTH(sl, n->inf);
+        if (k < inf)
+        {
+            l = n->inf;
+            continue;
+        }
+        k -= inf;
+        size_t eq = !!FIN(n) + motsLienTH(sl, n->eq);
+        if (k >= eq)
+        {
+            k -= eq;
+            l = n->sup;
+            continue;
+        }
+        if (sz + 2 > cap)
+        {
+            cap *= 2;
+            char *tmp = realloc(mot, cap);
+            if (!tmp)
+            {
+                fprintf(stderr, "Erreur, realloc dans selectTH");
+                exit(1);
+            }
+            mot = tmp;
+        }
+        mot[sz++] = LABEL(n);
+        if (FIN(n) && k-- == 0)
+            break;
+        l = n->eq;
+    }
+    mot[sz] = '\0';
+    return mot;
+}
+
+/**
+ * @private
+ *
+ * @brief Les étapes du parcours d'un noeud par un curseur, dans l'ordre alphabétique
+ *
+ * Le caractère du noeud fait partie du mot courant pendant les étapes @c ETAPE_ICI et @c ETAPE_EQ. Un curseur qui
+ * avance fait passer chaque noeud de @c ETAPE_AVANT à @c ETAPE_APRES, un curseur qui recule dans l'autre sens.
+ *
+ */
+enum etape_curseur
+{
+    ETAPE_AVANT, /**< Le noeud vient d'être atteint en avançant */
+    ETAPE_INF,   /**< Le curseur est dans l'enfant Inf */
+    ETAPE_ICI,   /**< Le curseur est sur le mot qui se termine sur le noeud */
+    ETAPE_EQ,    /**< Le curseur est dans l'enfant Eq */
+    ETAPE_SUP,   /**< Le curseur est dans l'enfant Sup */
+    ETAPE_APRES  /**< Le noeud vient d'être atteint en reculant */
+};
+
+struct curseur_hybride
+{
+    const TrieHybride *th; /**< Le trie parcouru */
+    CadreStack pile;       /**< Le chemin du mot courant, le champ @c n d'un cadre est une @c etape_curseur */
+    char *mot;             /**< Le mot courant, réutilisé d'un mot à l'autre */
+    size_t sz;             /**< Longueur du mot courant */
+    size_t cap;            /**< Capacité de @c mot */
+    const char *lo;        /**< Borne inférieure incluse, nulle si aucune */
+    const char *hi;        /**< Borne supérieure exclue, nulle si aucune */
+    int bout;              /**< -1 avant le premier mot, 1 après le dernier, 0 sinon */
+};
+
+CurseurTH *newCurseurTH(const TrieHybride *th)
+{
+    CurseurTH *c = malloc(sizeof(*c));
+    if (!c)
+    {
+        fprintf(stderr, "Erreur, malloc dans newCurseurTH");
+        exit(1);
+    }
+    c->th = th;
+    initCadreStack(&c->pile);
+    c->cap = 16;
+    c->sz = 0;
+    c->mot = malloc(c->cap);
+    if (!c->mot)
+    {
+        fprintf(stderr, "Erreur, malloc dans newCurseurTH");
+        exit(1);
+    }
+    c->lo = NULL;
+    c->hi = NULL;
+    c->bout = 0;
+    return c;
+}
+
+void deleteCurseurTH(CurseurTH **c)
+{
+    if (!*c)
         return;
-    listeMotsTH_rec(th->inf, s, tab, idx);
-    pushStack(s, th->label);
-    if (th->value)
+    freeCadreStack(&(*c)->pile);
+    free((*c)->mot);
+    free(*c);
+    *c = NULL;
+}
+
+/**
+ * @private
+ *
+ * @brief Ajoute un caractère au mot courant du curseur, en gardant la place du caractère nul
+ *
+ */
+static void ajouteCarCurseurTH(CurseurTH *c, char car)
+{
+    if (c->sz + 2 > c->cap)
+    {
+        c->cap *= 2;
+        char *tmp = realloc(c->mot, c->cap);
+        if (!tmp)
+        {
+            fprintf(stderr, "Erreur, realloc dans ajouteCarCurseurTH");
+            exit(1);
+        }
+        c->mot = tmp;
+    }
+    c->mot[c->sz++] = car;
+}
+
+/**
+ * @private
+ *
+ * @brief Déplace le curseur jusqu'au mot suivant (@a sens à 1) ou précédent (@a sens à -1)
+ *
+ * @return Vrai si un mot a été atteint, faux quand le parcours sort du trie, la pile est alors vide
+ *
+ * Chaque cadre passe à l'étape voisine dans le sens donné. Le caractère du noeud est ajouté au mot courant ou retiré
+ * selon qu'il en fait partie à la nouvelle étape, et un enfant est empilé à l'étape d'entrée du sens donné.
+ *
+ */
+static bool bougeCurseurTH(CurseurTH *c, int sens)
+{
+    const Slab *sl = slabTH(c->th);
+    CadreStack *pile = &c->pile;
+    size_t entree = sens > 0 ? ETAPE_AVANT : ETAPE_APRES;
+    while (pile->sz > 0)
+    {
+        Cadre *f = &pile->tab[pile->sz - 1];
+        const Noeud *n = NOEUD(sl, f->l);
+        size_t etape = sens > 0 ? f->n + 1 : f->n - 1;
+        bool avant = f->n == ETAPE_ICI || f->n == ETAPE_EQ;
+        bool apres = etape == ETAPE_ICI || etape == ETAPE_EQ;
+        if (avant && !apres)
+            c->sz--;
+        else if (!avant && apres)
+            ajouteCarCurseurTH(c, LABEL(n));
+        f->n = etape;
+        switch (etape)
+        {
+        case ETAPE_INF:
+            if (n->inf)
+                pushCadreStack(pile, n->inf, entree);
+            break;
+        case ETAPE_ICI:
+            if (FIN(n))
+                return true;
+            break;
+        case ETAPE_EQ:
+            if (n->eq)
+                pushCadreStack(pile, n->eq, entree);
+            break;
+        case ETAPE_SUP:
+            if (n->sup)
+                pushCadreStack(pile, n->sup, entree);
+            break;
+        default:
+            pile->sz--;
+        }
+    }
+    return false;
+}
+
+/**
+ * @private
+ *
+ * @brief Termine un déplacement du curseur dans le sens donné en tenant compte des bornes
+ *
+ * Un mot hors des bornes n'est pas rendu mais le chemin reste posé dessus, pour que le déplacement inverse retrouve le
+ * dernier mot des bornes.
+ *
+ */
+static const char *termineCurseurTH(CurseurTH *c, bool trouve, int sens)
+{
+    if (trouve)
+    {
+        c->mot[c->sz] = '\0';
+        if (sens > 0 && c->hi && strcmp(c->mot, c->hi) >= 0)
+            trouve = false;
+        else if (sens < 0 && c->lo && strcmp(c->mot, c->lo) < 0)
+            trouve = false;
+    }
+    c->bout = trouve ? 0 : sens;
+    return trouve ? c->mot : NULL;
+}
+
+const char *seekCurseurTH(CurseurTH *c, const char *cle)
+{
+    /* Une clé au delà de la borne supérieure est ramenée sur elle, pour que le mot précédent reste dans les bornes */
+    if (c->lo && strcmp(cle, c->lo) < 0)
+        cle = c->lo;
+    else if (c->hi && strcmp(cle, c->hi) > 0)
+        cle = c->hi;
+    const Slab *sl = slabTH(c->th);
+    Lien l = racineTH(c->th);
+    c->pile.sz = 0;
+    c->sz = 0;
+    if (l && *cle == '\0')
+        pushCadreStack(&c->pile, l, ETAPE_AVANT);
+    /* Le chemin de la clé est posé comme si le curseur était juste avant elle, le premier pas avant trouve le mot */
+    while (l && *cle != '\0')
+    {
+        const Noeud *n = NOEUD(sl, l);
+        if (*cle < LABEL(n))
+        {
+            pushCadreStack(&c->pile, l, ETAPE_INF);
+            l = n->inf;
+        }
+        else if (*cle > LABEL(n))
+        {
+            pushCadreStack(&c->pile, l, ETAPE_SUP);
+            l = n->sup;
+        }
+        else if (cle[1] == '\0')
+        {
+            pushCadreStack(&c->pile, l, ETAPE_INF);
+            break;
+        }
+        else
+        {
+            pushCadreStack(&c->pile, l, ETAPE_EQ);
+            ajouteCarCurseurTH(c, LABEL(n));
+            l = n->eq;
+            cle++;
+        }
+    }
+    return termineCurseurTH(c, bougeCurseurTH(c, 1), 1);
+}
+
+const char *plageCurseurTH(CurseurTH *c, const char *lo, const char *hi)
+{
+    c->lo = lo;
+    c->hi = hi;
+    return seekCurseurTH(c, lo ? lo : "");
+}
+
+const char *suivantCurseurTH(CurseurTH *c)
+{
+    if (c->bout > 0)
+        return NULL;
+    if (c->pile.sz == 0 && racineTH(c->th))
+    {
+        c->sz = 0;
+        pushCadreStack(&c->pile, racineTH(c->th), ETAPE_AVANT);
+    }
+    return termineCurseurTH(c, bougeCurseurTH(c, 1), 1);
+}
+
+const char *precedentCurseurTH(CurseurTH *c)
+{
+    if (c->bout < 0)
+        return NULL;
+    if (c->pile.sz == 0 && racineTH(c->th))
+    {
+        c->sz = 0;
+        pushCadreStack(&c->pile, racineTH(c->th), ETAPE_APRES);
+    }
+    return termineCurseurTH(c, bougeCurseurTH(c, -1), -1);
+}
+
+/**
+ * @private
+ *
+ * @brief Un candidat de la recherche du meilleur d'abord de `completeTH()`
+ *
+ */
+typedef struct candidat
+{
+    int score;        /**< La valeur du mot, ou la plus grande valeur de fin de mot du sous arbre */
+    bool mot;         /**< Vrai si le candidat est un mot complet, faux pour un sous arbre à explorer */
+    Lien l;           /**< Le sous arbre à explorer */
+    uint32_t suffixe; /**< L'indice dans les maillons du dernier caractère après le préfixe, `UINT32_MAX` si aucun */
+} Candidat;
+
+/**
+ * @private
+ *
+ * @brief Un caractère des mots complétés, chaîné vers le caractère qui le précède
+ *
+ */
+typedef struct maillon
+{
+    char c;
+    uint32_t lg;     /**< Nombre de caractères de la chaîne jusqu'à celui-ci compris */
+    uint32_t parent; /**< L'indice du maillon précédent, `UINT32_MAX` si aucun */
+} Maillon;
+
+/**
+ * @private
+ *
+ * @brief Une file de priorité des candidats, tas binaire du plus grand score
+ *
+ * À score égal, un mot passe avant un sous arbre pour être rendu sans explorer davantage.
+ *
+ */
+typedef struct tas_candidats
+{
+    size_t cap;
+    size_t sz;
+    Candidat *tab;
+} TasCandidats;
+
+static inline bool avantCandidatTH(const Candidat *a, const Candidat *b)
+{
+    return a->score > b->score || (a->score == b->score && a->mot && !b->mot);
+}
+
+static void pousseCandidatTH(TasCandidats *tas, Candidat c)
+{
+    if (tas->sz == tas->cap)
+    {
+        tas->cap = tas->cap ? 2 * tas->cap : CADRES_LOCAUX;
+        tas->tab = realloc(tas->tab, tas->cap * sizeof(*tas->tab));
+        if (!tas->tab)
+        {
+            fprintf(stderr, "Erreur, realloc dans pousseCandidatTH");
+            exit(1);
+        }
+    }
+    size_t i = tas->sz++;
+    while (i > 0 && avantCandidatTH(&c, &tas->tab[(i - 1) / 2]))
+    {
+        tas->tab[i] = tas->tab[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    tas->tab[i] = c;
+}
+
+static Candidat retireCandidatTH(TasCandidats *tas)
+{
+    assert(tas->sz > 0 && "Tentative de retrait dans une file de candidats vide");
+    Candidat res = tas->tab[0], dernier = tas->tab[--tas->sz];
+    size_t i = 0;
+    for (size_t enf; (enf = 2 * i + 1) < tas->sz; i = enf)
+    {
+        if (enf + 1 < tas->sz && avantCandidatTH(&tas->tab[enf + 1], &tas->tab[enf]))
+            enf++;
+        if (!avantCandidatTH(&tas->tab[enf], &dernier))
+            break;
+        tas->tab[i] = tas->tab[enf];
+    }
+    tas->tab[i] = dernier;
+    return res;
+}
+
+/**
+ * @private
+ *
+ * @brief Ajoute un caractère après le maillon @a parent et renvoie l'indice du nouveau maillon
+ *
+ */
+static uint32_t ajouteMaillonTH(Maillon **maillons, size_t *sz, size_t *cap, char c, uint32_t parent)
+{
+    if (*sz == *cap)
+    {
+        *cap = *cap ? 2 * *cap : CADRES_LOCAUX;
+        *maillons = realloc(*maillons, *cap * sizeof(**maillons));
+        if (!*maillons)
+        {
+            fprintf(stderr, "Erreur, realloc dans ajouteMaillonTH");
+            exit(1);
+        }
+    }
+    uint32_t lg = parent == UINT32_MAX ? 1 : (*maillons)[parent].lg + 1;
+    (*maillons)[*sz] = (Maillon){c, lg, parent};
+    return (uint32_t)(*sz)++;
+}
+
+char **completeTH(const TrieHybride *th, const char *prefixe, size_t k)
+{
+    const Slab *sl = slabTH(th);
+    Lien l = racineTH(th);
+    size_t lgPrefixe = strlen(prefixe);
+    if (k > motsLienTH(sl, l))
+        k = motsLienTH(sl, l);
+    char **tab = malloc((k + 1) * sizeof(*tab));
+    if (!tab)
+    {
+        fprintf(stderr, "Erreur, malloc dans completeTH");
+        exit(1);
+    }
+
+    /* Descente sur le préfixe, ses mots sont ceux du dernier caractère et de son enfant Eq */
+    TasCandidats tas = {0, 0, NULL};
+    if (*prefixe == '\0')
+    {
+        if (l)
+            pousseCandidatTH(&tas, (Candidat){MEILLEUR(sl, l), false, l, UINT32_MAX});
+    }
+    else
     {
-        tab[*idx] = snapshotStack(s);
-        (*idx)++;
+        const char *r = prefixe;
+        while (l)
+        {
+            const Noeud *n = NOEUD(sl, l);
+            if (*r < LABEL(n))
+                l = n->inf;
+            else if (*r > LABEL(n))
+                l = n->sup;
+            else if (r[1] != '\0')
+            {
+                l = n->eq;
+                r++;
+            }
+            else
+            {
+                if (FIN(n))
+                    pousseCandidatTH(&tas, (Candidat){VALEUR(sl, l), true, NIL, UINT32_MAX});
+                if (n->eq)
+                    pousseCandidatTH(&tas, (Candidat){MEILLEUR(sl, n->eq), false, n->eq, UINT32_MAX});
+                break;
+            }
+        }
     }
-    listeMotsTH_rec(th->eq, s, tab, idx);
-    popStack(s);
-    listeMotsTH_rec(th->sup, s, tab, idx);
+
+    /* Un sous arbre n'est ouvert que si sa plus grande valeur peut encore faire partie des k meilleurs */
+    Maillon *maillons = NULL;
+    size_t nbMaillons = 0, capMaillons = 0, nb = 0;
+    while (nb < k && tas.sz > 0)
+    {
+        Candidat c = retireCandidatTH(&tas);
+        if (c.mot)
+        {
+            size_t lg = lgPrefixe + (c.suffixe == UINT32_MAX ? 0 : maillons[c.suffixe].lg);
+            char *mot = malloc(lg + 1);
+            if (!mot)
+            {
+                fprintf(stderr, "Erreur, malloc dans completeTH");
+                exit(1);
+            }
+            memcpy(mot, prefixe, lgPrefixe);
+            mot[lg] = '\0';
+            for (uint32_t i = c.suffixe; i != UINT32_MAX; i = maillons[i].parent)
+                mot[lgPrefixe + maillons[i].lg - 1] = maillons[i].c;
+            tab[nb++] = mot;
+            continue;
+        }
+        const Noeud *n = NOEUD(sl, c.l);
+        if (n->inf)
+            pousseCandidatTH(&tas, (Candidat){MEILLEUR(sl, n->inf), false, n->inf, c.suffixe});
+        if (n->sup)
+            pousseCandidatTH(&tas, (Candidat){MEILLEUR(sl, n->sup), false, n->sup, c.suffixe});
+        uint32_t suffixe = ajouteMaillonTH(&maillons, &nbMaillons, &capMaillons, LABEL(n), c.suffixe);
+        if (FIN(n))
+            pousseCandidatTH(&tas, (Candidat){VALEUR(sl, c.l), true, NIL, suffixe});
+        if (n->eq)
+            pousseCandidatTH(&tas, (Candidat){MEILLEUR(sl, n->eq), false, n->eq, suffixe});
+    }
+    tab[nb] = NULL;
+    free(maillons);
+    free(tas.tab);
+    return tab;
 }
 
-char **listeMotsTH(const TrieHybride *th)
+/**
+ * @private
+ *
+ * @brief Calcule la ligne @a i de la distance d'édition, celle qui suit @a prec en ajoutant le caractère @a c
+ *
+ * @a ligne[j] est la distance entre le mot du trie de longueur @a i et les @a j premiers caractères de @a mot. Seule la
+ * bande |i - j| <= @a k est calculée : hors d'elle la distance dépasse forcément @a k, ses bords sont mis à @a k + 1
+ * pour la ligne suivante, tout comme @a ligne[m] s'il en sort.
+ *
+ * @return La plus petite valeur de la ligne, aucun prolongement du mot du trie ne peut faire mieux
+ */
+static int ligneLevenshteinTH(const int *prec, int *ligne, const char *mot, size_t m, size_t i, int k, char c)
 {
-    if (!th)
-        return NULL;
-    size_t sz = comptageMotsTH(th);
-    char **tab = malloc((sz + 1) * sizeof(*tab));
-    if (!tab)
+    size_t lo = i > (size_t)k ? i - k : 1, hi = MIN(m, i + k);
+    int min = ligne[lo - 1] = lo == 1 ? (int)i : k + 1;
+    for (size_t j = lo; j <= hi; j++)
     {
-        fprintf(stderr, "Erreur, malloc dans listeMots");
-        exit(1);
+        int d = MIN(prec[j], ligne[j - 1]) + 1;
+        ligne[j] = MIN(d, prec[j - 1] + (mot[j - 1] != c));
+        min = MIN(min, ligne[j]);
     }
-    tab[sz] = NULL;
-    Stack s = newStack(hauteurTH(th) + 1);
-    sz = 0;
-    listeMotsTH_rec(th, &s, tab, &sz);
-    assert(s.sz == 0 && "La pile des caractères doit être vide à cet instant");
-    freeStack(s);
-    return tab;
+    if (hi < m)
+        ligne[hi + 1] = k + 1;
+    if (m > hi || m + 1 < lo)
+        ligne[m] = k + 1;
+    return min;
 }
 
-void deleteListeMotsTH(char **tab)
+size_t fuzzySearchTH(const TrieHybride *th, const char *mot, int maxEdits, RappelDistanceTH rappel, void *ctx)
 {
-    if (!tab)
-        return;
-    for (char **i = tab; *i; i++)
+    const Slab *sl = slabTH(th);
+    Lien racine = racineTH(th);
+    if (!racine || maxEdits < 0)
+        return 0;
+    /* Les bords de la bande valent maxEdits + 1, qui doit tenir dans un int */
+    maxEdits = MIN(maxEdits, INT_MAX - 1);
+
+    /* Une ligne de m + 1 distances par caractère du mot courant, la ligne 0 étant celle du mot vide */
+    size_t m = strlen(mot), cap = CADRES_LOCAUX, nb = 0;
+    int *lignes = malloc(cap * (m + 1) * sizeof(*lignes));
+    char *courant = malloc(cap);
+    if (!lignes || !courant)
     {
-        free(*i);
+        fprintf(stderr, "Erreur, malloc dans fuzzySearchTH");
+        exit(1);
     }
-    free(tab);
+    for (size_t j = 0; j <= m; j++)
+        lignes[j] = (int)j;
+
+    /* Le cadre d'un lien garde 2 * profondeur, + 1 une fois son sous arbre Inf empilé, pour rendre les mots dans
+     * l'ordre : Inf, le noeud, Eq, puis Sup */
+    CadreStack s;
+    initCadreStack(&s);
+    pushCadreStack(&s, racine, 0);
+    while (s.sz > 0)
+    {
+        Cadre c = popCadreStack(&s);
+        const Noeud *n = NOEUD(sl, c.l);
+        size_t d = c.n / 2;
+        if (c.n % 2 == 0)
+        {
+            if (n->sup)
+                pushCadreStack(&s, n->sup, c.n);
+            pushCadreStack(&s, c.l, c.n + 1);
+            if (n->inf)
+                pushCadreStack(&s, n->inf, c.n);
+            continue;
+        }
+
+        if (d + 2 > cap)
+        {
+            cap *= 2;
+            lignes = realloc(lignes, cap * (m + 1) * sizeof(*lignes));
+            courant = realloc(courant, cap);
+            if (!lignes || !courant)
+            {
+                fprintf(stderr, "Erreur, realloc dans fuzzySearchTH");
+                exit(1);
+            }
+        }
+        int *ligne = lignes + (d + 1) * (m + 1);
+        int min = ligneLevenshteinTH(ligne - (m + 1), ligne, mot, m, d + 1, maxEdits, LABEL(n));
+        courant[d] = LABEL(n);
+        if (FIN(n) && ligne[m] <= maxEdits)
+        {
+            courant[d + 1] = '\0';
+            rappel(courant, ligne[m], ctx);
+            nb++;
+        }
+        /* Plus aucun prolongement ne peut revenir sous le seuil, le sous arbre Eq est élagué */
+        if (n->eq && min <= maxEdits)
+            pushCadreStack(&s, n->eq, c.n + 1);
+    }
+    freeCadreStack(&s);
+    free(courant);
+    free(lignes);
+    return nb;
 }
 
-int comptageNilTH(const TrieHybride *th)
+/**
+ * @private
+ *
+ * @brief Un motif compilé pour `rechercheMotifTH()`, un élément par caractère du mot à reconnaître ou par `*`
+ *
+ * Le motif est reconnu par un automate non déterministe : un état @c i signifie que les @c i premiers éléments sont
+ * reconnus, l'état @c n que tout le motif l'est. Les ensembles d'états sont des tableaux de @c w mots de 64 bits.
+ */
+typedef struct motif
 {
-    if (!th)
-        return 1;
-    return comptageNilTH(th->inf) + comptageNilTH(th->eq) + comptageNilTH(th->sup);
+    size_t n;
+    size_t w;
+    uint64_t (*classes)[2]; /**< Les caractères acceptés par chaque élément, sur 128 bits */
+    bool *etoile;           /**< Vrai si l'élément est une `*`, qui reste sur place à chaque caractère */
+} Motif;
+
+static inline bool dansClasseTH(const uint64_t classe[2], unsigned char c)
+{
+    return c < 128 && (classe[c / 64] >> (c % 64) & 1);
 }
 
-ssize_t hauteurTH(const TrieHybride *th)
+static inline void ajouteClasseTH(uint64_t classe[2], unsigned char c)
 {
-    if (!th)
-        return -1;
-    ssize_t inf = hauteurTH(th->inf);
-    ssize_t eq = hauteurTH(th->eq);
-    ssize_t sup = hauteurTH(th->sup);
-    return 1 + MAX3(inf, eq, sup);
+    if (c > 0 && c < 128)
+        classe[c / 64] |= UINT64_C(1) << (c % 64);
+}
+
+/**
+ * @private
+ *
+ * @brief Renvoie le `]` qui ferme la classe dont les caractères commencent en @a debut, pointeur nul s'il n'y en a pas
+ *
+ * Le premier caractère de la classe, même un `]`, et tout caractère protégé par un `\` en font partie.
+ */
+static const char *finClasseTH(const char *debut)
+{
+    const char *q = debut;
+    do
+        q += *q == '\\' && q[1] ? 2 : 1;
+    while (*q && *q != ']');
+    return *q ? q : NULL;
 }
 
-void profondeurMoyenneTH_rec(const TrieHybride *th, int depth, int *sum, int *count)
+/**
+ * @private
+ *
+ * @brief Compile le motif donné : `?` accepte un caractère quelconque, `*` une suite quelconque éventuellement vide,
+ * `[...]` un caractère de la classe (intervalles `a-z`, complément avec `!` ou `^` en tête) et `\` protège le caractère
+ * suivant, y compris dans une classe
+ *
+ * Un `[` sans `]` fermant est pris littéralement et les `*` consécutives n'en font qu'une.
+ */
+static Motif compileMotifTH(const char *motif)
 {
-    if (!th)
-        return;
-    if (!th->eq && determine_enfants(th) == AUCUNENF)
+    size_t lg = strlen(motif);
+    Motif m = {0, lg / 64 + 1, malloc((lg + 1) * sizeof(*m.classes)), malloc(lg + 1)};
+    if (!m.classes || !m.etoile)
     {
-        (*sum) += depth;
-        (*count)++;
-        return;
+        fprintf(stderr, "Erreur, malloc dans compileMotifTH");
+        exit(1);
+    }
+    for (const char *p = motif; *p; p++)
+    {
+        uint64_t *classe = m.classes[m.n];
+        classe[0] = classe[1] = 0;
+        m.etoile[m.n] = *p == '*';
+        const char *debut = p + 1 + (p[1] == '!' || p[1] == '^');
+        const char *fin = *p == '[' && *debut ? finClasseTH(debut) : NULL;
+        if (*p == '*' || *p == '?')
+        {
+            classe[0] = ~UINT64_C(1);
+            classe[1] = ~UINT64_C(0);
+            if (*p == '*' && m.n > 0 && m.etoile[m.n - 1])
+                continue;
+        }
+        else if (fin)
+        {
+            for (const char *q = debut; q < fin; q++)
+            {
+                unsigned char bas = (unsigned char)(*q == '\\' ? *++q : *q), haut = bas;
+                if (q[1] == '-' && q + 2 < fin)
+                {
+                    q += 2;
+                    haut = (unsigned char)(*q == '\\' ? *++q : *q);
+                }
+                for (unsigned c = bas; c <= haut; c++)
+                    ajouteClasseTH(classe, (unsigned char)c);
+            }
+            if (debut > p + 1)
+            {
+                classe[0] = ~classe[0] & ~UINT64_C(1);
+                classe[1] = ~classe[1];
+            }
+            p = fin;
+        }
+        else
+            ajouteClasseTH(classe, (unsigned char)(*p == '\\' && p[1] ? *++p : *p));
+        m.n++;
     }
-    profondeurMoyenneTH_rec(th->inf, depth + 1, sum, count);
-    profondeurMoyenneTH_rec(th->eq, depth + 1, sum, count);
-    profondeurMoyenneTH_rec(th->sup, depth + 1, sum, count);
+    return m;
 }
 
-int profondeurMoyenneEntTH(const TrieHybride *th)
+/**
+ * @private
+ *
+ * @brief Ferme l'ensemble d'états @a e : une `*` peut aussi ne reconnaître aucun caractère
+ *
+ * @return Vrai si l'ensemble n'est pas vide
+ */
+static bool fermeEtatsTH(const Motif *m, uint64_t *e)
 {
-    int sum = 0, count = 0;
-    profondeurMoyenneTH_rec(th, 0, &sum, &count);
-    if (count == 0)
-        return -1;
-    assert(count > 0 && "Le compte des feuilles doit être strictement positif");
-    assert(sum >= 0 && "La somme des profondeurs doit être positif ou nul");
-    return sum / count;
+    for (size_t i = 0; i < m->n; i++)
+        if (m->etoile[i] && (e[i / 64] >> (i % 64) & 1))
+            e[(i + 1) / 64] |= UINT64_C(1) << ((i + 1) % 64);
+    for (size_t k = 0; k < m->w; k++)
+        if (e[k])
+            return true;
+    return false;
 }
 
-double profondeurMoyenneTH(const TrieHybride *th)
+/**
+ * @private
+ *
+ * @brief Calcule dans @a suiv les états atteints depuis @a prec en lisant le caractère @a c
+ *
+ * @return Vrai si l'ensemble atteint n'est pas vide
+ */
+static bool avanceEtatsTH(const Motif *m, const uint64_t *prec, uint64_t *suiv, unsigned char c)
 {
-    int sum = 0, count = 0;
-    profondeurMoyenneTH_rec(th, 0, &sum, &count);
-    if (count == 0)
-        return -1;
-    assert(count > 0 && "Le compte des feuilles doit être strictement positif");
-    assert(sum >= 0 && "La somme des profondeurs doit être positif ou nul");
-    return (double)sum / count;
+    memset(suiv, 0, m->w * sizeof(*suiv));
+    for (size_t k = 0; k < m->w; k++)
+        for (uint64_t bits = prec[k]; bits; bits &= bits - 1)
+        {
+            size_t i = 64 * k + __builtin_ctzll(bits);
+            if (i < m->n && dansClasseTH(m->classes[i], c))
+            {
+                size_t j = m->etoile[i] ? i : i + 1;
+                suiv[j / 64] |= UINT64_C(1) << (j % 64);
+            }
+        }
+    return fermeEtatsTH(m, suiv);
 }
 
-int prefixeTH_rec(const TrieHybride *th)
+/**
+ * @private
+ *
+ * @brief Calcule dans @a classe les caractères qui peuvent suivre depuis l'ensemble d'états @a e
+ */
+static void classeEtatsTH(const Motif *m, const uint64_t *e, uint64_t classe[2])
 {
-    if (!th)
-        return 0;
-    return !!th->value + prefixeTH_rec(th->inf) + prefixeTH_rec(th->eq) + prefixeTH_rec(th->sup);
+    classe[0] = classe[1] = 0;
+    for (size_t k = 0; k < m->w; k++)
+        for (uint64_t bits = e[k]; bits; bits &= bits - 1)
+        {
+            size_t i = 64 * k + __builtin_ctzll(bits);
+            if (i < m->n)
+            {
+                classe[0] |= m->classes[i][0];
+                classe[1] |= m->classes[i][1];
+            }
+        }
 }
 
-int prefixeTH(const TrieHybride *th, const char *cle)
+/* Vrai si la classe contient un caractère strictement inférieur (sens < 0) ou supérieur (sens > 0) à c */
+static bool classeDeCoteTH(const uint64_t classe[2], unsigned char c, int sens)
 {
-    if (!th)
+    uint64_t bas0 = c >= 64 ? ~UINT64_C(0) : (UINT64_C(1) << c) - 1;
+    uint64_t bas1 = c <= 64 ? 0 : (UINT64_C(1) << (c - 64)) - 1;
+    if (sens < 0)
+        return (classe[0] & bas0) || (classe[1] & bas1);
+    uint64_t haut0 = c >= 63 ? 0 : ~UINT64_C(0) << (c + 1);
+    uint64_t haut1 = c < 64 ? ~UINT64_C(0) : c >= 127 ? 0 : ~UINT64_C(0) << (c - 63);
+    return (classe[0] & haut0) || (classe[1] & haut1);
+}
+
+size_t rechercheMotifTH(const TrieHybride *th, const char *motif, RappelMotTH rappel, void *ctx)
+{
+    const Slab *sl = slabTH(th);
+    Lien racine = racineTH(th);
+    if (!racine)
         return 0;
 
-    const TrieHybride *lastNode = NULL;
-    const TrieHybride *subtree = th;
-    const char *r = cle;
-    char p;
-    /* Advance until the subtree that interests us */
-    while (subtree)
+    /* Un ensemble d'états et la classe des caractères qui peuvent le prolonger par caractère du mot courant */
+    Motif m = compileMotifTH(motif);
+    size_t cap = CADRES_LOCAUX, nb = 0;
+    uint64_t *etats = calloc(cap * m.w, sizeof(*etats));
+    uint64_t(*classes)[2] = malloc(cap * sizeof(*classes));
+    char *courant = malloc(cap);
+    if (!etats || !classes || !courant)
     {
-        p = prem(r);
-        if (p == '\0')
+        fprintf(stderr, "Erreur, malloc dans rechercheMotifTH");
+        exit(1);
+    }
+    etats[0] = 1;
+    fermeEtatsTH(&m, etats);
+    classeEtatsTH(&m, etats, classes[0]);
+
+    /* Même parcours que `fuzzySearchTH()` : le cadre d'un lien garde 2 * profondeur, + 1 pour visiter le noeud. Les
+     * sous arbres Inf et Sup ne sont ouverts que si la classe de leur niveau a des caractères de leur côté */
+    CadreStack s;
+    initCadreStack(&s);
+    pushCadreStack(&s, racine, 0);
+    while (s.sz > 0)
+    {
+        Cadre c = popCadreStack(&s);
+        const Noeud *n = NOEUD(sl, c.l);
+        unsigned char label = (unsigned char)LABEL(n);
+        size_t d = c.n / 2;
+        if (c.n % 2 == 0)
+        {
+            if (n->sup && classeDeCoteTH(classes[d], label, 1))
+                pushCadreStack(&s, n->sup, c.n);
+            if (dansClasseTH(classes[d], label))
+                pushCadreStack(&s, c.l, c.n + 1);
+            if (n->inf && classeDeCoteTH(classes[d], label, -1))
+                pushCadreStack(&s, n->inf, c.n);
+            continue;
+        }
+
+        if (d + 2 > cap)
+        {
+            cap *= 2;
+            etats = realloc(etats, cap * m.w * sizeof(*etats));
+            classes = realloc(classes, cap * sizeof(*classes));
+            courant = realloc(courant, cap);
+            if (!etats || !classes || !courant)
+            {
+                fprintf(stderr, "Erreur, realloc dans rechercheMotifTH");
+                exit(1);
+            }
+        }
+        uint64_t *suiv = etats + (d + 1) * m.w;
+        if (!avanceEtatsTH(&m, etats + d * m.w, suiv, label))
+            continue;
+        courant[d] = (char)label;
+        if (FIN(n) && (suiv[m.n / 64] >> (m.n % 64) & 1))
+        {
+            courant[d + 1] = '\0';
+            rappel(courant, ctx);
+            nb++;
+        }
+        if (n->eq)
+        {
+            classeEtatsTH(&m, suiv, classes[d + 1]);
+            if (classes[d + 1][0] || classes[d + 1][1])
+                pushCadreStack(&s, n->eq, c.n + 1);
+        }
+    }
+    freeCadreStack(&s);
+    free(courant);
+    free(classes);
+    free(etats);
+    free(m.classes);
+    free(m.etoile);
+    return nb;
+}
+
+void ecritJSONTH(const TrieHybride *th, SortieJSON *s)
+{
+    const Slab *sl = slabTH(th);
+    if (!racineTH(th))
+    {
+        nulSortieJSON(s);
+        return;
+    }
+    /* n est l'étape atteinte dans l'objet du noeud : 0 à ouvrir, 1 et 2 après "left" et "middle", 3 à fermer */
+    CadreStack pile;
+    initCadreStack(&pile);
+    pushCadreStack(&pile, racineTH(th), 0);
+    while (pile.sz)
+    {
+        Cadre *c = &pile.tab[pile.sz - 1];
+        const Noeud *n = NOEUD(sl, c->l);
+        Lien enf;
+        switch (c->n++)
+        {
+        case 0: {
+            char label = LABEL(n);
+            debutObjetSortieJSON(s);
+            cleSortieJSON(s, "char", 4);
+            chaineSortieJSON(s, &label, label ? 1 : 0);
+            cleSortieJSON(s, "is_end_of_word", 14);
+            boolSortieJSON(s, FIN(n));
+            /* Une valeur autre que VALFIN, un score par exemple, est ajoutée : sans, le texte reste celui de cJSON */
+            if (FIN(n) && VALEUR(sl, c->l) != VALFIN)
+            {
+                cleSortieJSON(s, "value", 5);
+                entierSortieJSON(s, VALEUR(sl, c->l));
+            }
+            cleSortieJSON(s, "left", 4);
+            enf = n->inf;
+            break;
+        }
+        case 1:
+            cleSortieJSON(s, "middle", 6);
+            enf = n->eq;
             break;
+        case 2:
+            cleSortieJSON(s, "right", 5);
+            enf = n->sup;
+            break;
+        default:
+            finObjetSortieJSON(s);
+            popCadreStack(&pile);
+            continue;
+        }
+        if (enf)
+            pushCadreStack(&pile, enf, 0);
+        else
+            nulSortieJSON(s);
+    }
+    freeCadreStack(&pile);
+}
+
+char *printJSONTH(const TrieHybride *th)
+{
+    SortieJSON s;
+    ouvreMemoireSortieJSON(&s, false);
+    ecritJSONTH(th, &s);
+    return rendMemoireSortieJSON(&s);
+}
+
+/**
+ * @private
+ *
+ * @brief Arrête le programme sur un JSON de Trie Hybride invalide, en indiquant l'octet fautif
+ *
+ */
+static void erreurJSONTH(const FluxJSON *f)
+{
+    fprintf(stderr, "Erreur, JSON invalide dans litJSONTH (octet %zu)", positionFluxJSON(f));
+    exit(1);
+}
+
+/**
+ * @private
+ *
+ * @brief Lit le jeton suivant du flux et arrête le programme s'il n'est pas celui attendu
+ *
+ */
+static void attendJSONTH(FluxJSON *f, JetonJSON attendu)
+{
+    if (jetonFluxJSON(f) != attendu)
+        erreurJSONTH(f);
+}
+
+/**
+ * @private
+ *
+ * @brief Lit la valeur de fin de mot d'un noeud, un entier non nul, et arrête le programme sinon
+ *
+ */
+static int valeurJSONTH(FluxJSON *f)
+{
+    attendJSONTH(f, JSON_NOMBRE);
+    char *fin;
+    errno = 0;
+    long v = strtol(f->chaine, &fin, 10);
+    if (*fin || errno || v == VALVIDE || v < INT_MIN || v > INT_MAX)
+        erreurJSONTH(f);
+    return (int)v;
+}
+
+/**
+ * @private
+ *
+ * @brief Change le caractère du noeud donné, sans toucher à sa fin de mot
+ *
+ */
+static void poseLabelTH(Noeud *n, char c)
+{
+#ifdef HYBRID_SLAB
+    assert(!(c & FINMOT) && "Le caractère doit être un caractère ASCII");
+    n->label = (unsigned char)((n->label & FINMOT) | (unsigned char)c);
+#else
+    n->label = c;
+#endif
+}
 
-        lastNode = subtree;
-        if (p < subtree->label)
-            subtree = subtree->inf;
-        else if (p > subtree->label)
-            subtree = subtree->sup;
+/**
+ * @private
+ *
+ * @brief Construit le Trie Hybride au fur et à mesure des jetons du flux donné
+ *
+ * Chaque objet ouvert a son cadre dans la pile, dont @c n garde l'enfant que la prochaine valeur remplira : 0 pour
+ * "left", 1 pour "middle" et 2 pour "right". Un noeud est alloué dès son accolade ouvrante et relié à son parent, sa
+ * hauteur et son nombre de mots sont calculés à son accolade fermante, quand tous ses enfants sont complets. Les clés
+ * inconnues sont ignorées.
+ *
+ */
+static TrieHybride *litJSONTH(FluxJSON *f)
+{
+    Slab *sl = ouvreTH(newTH());
+    Lien racine = NIL;
+    CadreStack pile;
+    initCadreStack(&pile);
+    JetonJSON j = jetonFluxJSON(f);
+    do
+    {
+        /* j commence la valeur attendue par le sommet de la pile, ou la racine */
+        Lien l = NIL;
+        if (j == JSON_DEBUT_OBJET)
+            l = allocTH(sl, '\0');
+        else if (j != JSON_NUL)
+            erreurJSONTH(f);
+        if (!pile.sz)
+            racine = l;
         else
         {
-            subtree = subtree->eq;
-            r = reste(r);
+            const Cadre *c = &pile.tab[pile.sz - 1];
+            Noeud *p = NOEUD(sl, c->l);
+            if (c->n == 0)
+                p->inf = l;
+            else if (c->n == 1)
+                p->eq = l;
+            else
+                p->sup = l;
         }
-    }
+        bool apresValeur = !l;
+        if (l)
+            pushCadreStack(&pile, l, 0);
+        if (pile.sz)
+            j = jetonFluxJSON(f);
+
+        /* Les membres des objets ouverts, jusqu'au prochain enfant à lire */
+        while (pile.sz)
+        {
+            Cadre *c = &pile.tab[pile.sz - 1];
+            if (j == JSON_FIN_OBJET)
+            {
+                majHauteurTH(sl, c->l);
+                majMotsTH(sl, c->l);
+                popCadreStack(&pile);
+                apresValeur = true;
+                if (pile.sz)
+                    j = jetonFluxJSON(f);
+                continue;
+            }
+            if (apresValeur)
+            {
+                if (j != JSON_VIRGULE)
+                    erreurJSONTH(f);
+                j = jetonFluxJSON(f);
+            }
+            if (j != JSON_CHAINE)
+                erreurJSONTH(f);
+            attendJSONTH(f, JSON_DEUX_POINTS);
+            if (!strcmp(f->chaine, "left") || !strcmp(f->chaine, "middle") || !strcmp(f->chaine, "right"))
+            {
+                c->n = f->chaine[0] == 'l' ? 0 : f->chaine[0] == 'm' ? 1 : 2;
+                j = jetonFluxJSON(f);
+                break;
+            }
+            if (!strcmp(f->chaine, "char"))
+            {
+                attendJSONTH(f, JSON_CHAINE);
+                poseLabelTH(NOEUD(sl, c->l), f->chaine[0]);
+            }
+            else if (!strcmp(f->chaine, "is_end_of_word"))
+            {
+                j = jetonFluxJSON(f);
+                if (j != JSON_VRAI && j != JSON_FAUX)
+                    erreurJSONTH(f);
+                /* Une valeur déjà lue est gardée */
+                if (j == JSON_FAUX || !FIN(NOEUD(sl, c->l)))
+                    POSE_FIN(sl, c->l, j == JSON_VRAI ? VALFIN : VALVIDE);
+            }
+            else if (!strcmp(f->chaine, "value"))
+            {
+                int v = valeurJSONTH(f);
+                POSE_FIN(sl, c->l, v);
+            }
+            else if (!sauteValeurFluxJSON(f, jetonFluxJSON(f)))
+                erreurJSONTH(f);
+            apresValeur = true;
+            j = jetonFluxJSON(f);
+        }
+    } while (pile.sz);
+    freeCadreStack(&pile);
+    return fermeTH(sl, racine);
+}
+
+TrieHybride *parseJSONTH(const char *json, size_t sz)
+{
+    FluxJSON f;
+    ouvreMemoireFluxJSON(&f, json, sz);
+    TrieHybride *th = litJSONTH(&f);
+    fermeFluxJSON(&f);
+    return th;
+}
+
+TrieHybride *chargeJSONTH(int fd)
+{
+    FluxJSON f;
+    ouvreFluxJSON(&f, fd);
+    TrieHybride *th = litJSONTH(&f);
+    fermeFluxJSON(&f);
+    return th;
+}
+
+/**
+ * @private
+ *
+ * @brief L'entête d'un snapshot binaire de Trie Hybride, 32 octets
+ *
+ */
+typedef struct entete_snapshot_th
+{
+    char magie[8];    /**< @c SNAPSHOT_TH_MAGIE */
+    uint32_t version; /**< @c SNAPSHOT_TH_VERSION */
+    uint32_t taille;  /**< Nombre de noeuds, case 0 comprise */
+    uint32_t racine;  /**< Indice de la racine, 0 pour un trie vide */
+    uint32_t reserve; /**< Toujours 0 */
+    uint64_t somme;   /**< Somme de contrôle des octets qui suivent l'entête */
+} EnteteSnapshotTH;
+
+/**
+ * @private
+ *
+ * @brief Les tableaux d'un snapshot binaire, vus en place
+ *
+ */
+typedef struct vue_snapshot_th
+{
+    const NoeudHybride *noeuds;
+    const uint32_t *mots;
+    const int32_t *valeurs;
+    const int32_t *meilleurs;
+    uint32_t taille;
+    uint32_t racine;
+} VueSnapshotTH;
+
+/**
+ * @private
+ *
+ * @brief La taille en octets d'un noeud dans un snapshot, tableaux parallèles compris
+ *
+ */
+#define OCTETS_NOEUD_SNAPSHOT (sizeof(NoeudHybride) + sizeof(uint32_t) + 2 * sizeof(int32_t))
+
+/**
+ * @private
+ *
+ * @brief Renvoie la vue sur les tableaux du snapshot donné, dont l'entête est supposée cohérente
+ *
+ */
+static VueSnapshotTH vueSnapshotTH(const void *snap)
+{
+    const EnteteSnapshotTH *e = snap;
+    VueSnapshotTH v;
+    v.noeuds = (const NoeudHybride *)(e + 1);
+    v.mots = (const uint32_t *)(v.noeuds + e->taille);
+    v.valeurs = (const int32_t *)(v.mots + e->taille);
+    v.meilleurs = v.valeurs + e->taille;
+    v.taille = e->taille;
+    v.racine = e->racine;
+    return v;
+}
 
-    /* Yeah not too proud of this one */
-    return (!(*r) && lastNode && lastNode->value) + prefixeTH_rec(subtree);
+/**
+ * @private
+ *
+ * @brief Calcule la somme de contrôle d'une zone mémoire, 8 octets à la fois
+ *
+ * C'est un FNV-1a sur des mots de 64 bits : une multiplication par octet de FNV-1a coûterait plus cher que la lecture
+ * du fichier. La multiplication par un nombre impair étant inversible, toute modification d'un seul mot change la
+ * somme.
+ *
+ */
+static uint64_t sommeSnapshotTH(const unsigned char *p, size_t n)
+{
+    uint64_t h = 0xcbf29ce484222325u;
+    for (; n >= sizeof(uint64_t); p += sizeof(uint64_t), n -= sizeof(uint64_t))
+    {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h = (h ^ w) * 0x100000001b3u;
+    }
+    for (; n; p++, n--)
+        h = (h ^ *p) * 0x100000001b3u;
+    return h;
 }
 
-cJSON *constructJSONTH(const TrieHybride *th)
+void *printSnapshotTH(const TrieHybride *th, size_t *sz)
 {
-    if (!th)
+    const Slab *sl = slabTH(th);
+    /* La file du parcours en largeur : la position d'un noeud dans la file est son indice dans le snapshot */
+    size_t n = 1, cap = SLAB_INIT;
+    Lien *file = malloc(cap * sizeof(*file));
+    if (!file)
+    {
+        fprintf(stderr, "Erreur, malloc dans printSnapshotTH");
+        exit(1);
+    }
+    if (racineTH(th))
+        file[n++] = racineTH(th);
+    for (size_t i = 1; i < n; i++)
     {
-        cJSON *null = cJSON_CreateNull();
-        if (!null)
+        if (n + 3 > cap)
         {
-            fprintf(stderr, "Erreur, cJSON_CreateNull dans constructJSONTH");
-            exit(1);
+            cap *= 2;
+            Lien *tmp = realloc(file, cap * sizeof(*file));
+            if (!tmp)
+            {
+                fprintf(stderr, "Erreur, realloc dans printSnapshotTH");
+                exit(1);
+            }
+            file = tmp;
         }
-        return null;
+        const Noeud *nd = NOEUD(sl, file[i]);
+        if (nd->inf)
+            file[n++] = nd->inf;
+        if (nd->eq)
+            file[n++] = nd->eq;
+        if (nd->sup)
+            file[n++] = nd->sup;
     }
-    cJSON *obj = cJSON_CreateObject();
-    if (!obj)
+    if (n > UINT32_MAX)
     {
-        fprintf(stderr, "Erreur, cJSON_CreateObject dans constructJSONTH");
+        fprintf(stderr, "Erreur, trop de noeuds pour un snapshot dans printSnapshotTH");
         exit(1);
     }
-    char buf[2] = {th->label, 0};
-    if (!cJSON_AddStringToObject(obj, "char", buf))
+
+    *sz = sizeof(EnteteSnapshotTH) + n * OCTETS_NOEUD_SNAPSHOT;
+    /* Mis à zéro pour que les octets de bourrage des noeuds ne changent pas la somme de contrôle */
+    unsigned char *buf = calloc(1, *sz);
+    if (!buf)
     {
-        fprintf(stderr, "Erreur, cJSON_AddStringToObject dans constructJSONTH");
+        fprintf(stderr, "Erreur, calloc dans printSnapshotTH");
         exit(1);
     }
-    if (!cJSON_AddBoolToObject(obj, "is_end_of_word", th->value))
+    EnteteSnapshotTH *e = (EnteteSnapshotTH *)buf;
+    memcpy(e->magie, SNAPSHOT_TH_MAGIE, sizeof(e->magie));
+    e->version = SNAPSHOT_TH_VERSION;
+    e->taille = (uint32_t)n;
+    e->racine = n > 1 ? 1 : 0;
+    NoeudHybride *noeuds = (NoeudHybride *)(e + 1);
+    uint32_t *mots = (uint32_t *)(noeuds + n);
+    int32_t *valeurs = (int32_t *)(mots + n);
+    int32_t *meilleurs = valeurs + n;
+    /* Les enfants sont renumérotés dans l'ordre où ils ont été mis dans la file */
+    uint32_t suivant = 2;
+    for (size_t i = 1; i < n; i++)
     {
-        fprintf(stderr, "Erreur, cJSON_AddBoolToObject dans constructJSONTH");
-        exit(1);
+        const Noeud *nd = NOEUD(sl, file[i]);
+        assert(!(LABEL(nd) & FINMOT) && "Le caractère doit être un caractère ASCII");
+        noeuds[i].inf = nd->inf ? suivant++ : 0;
+        noeuds[i].eq = nd->eq ? suivant++ : 0;
+        noeuds[i].sup = nd->sup ? suivant++ : 0;
+        noeuds[i].label = (unsigned char)LABEL(nd) | (FIN(nd) ? FINMOT : 0);
+        noeuds[i].h = nd->h;
+        mots[i] = MOTS(sl, file[i]);
+        valeurs[i] = VALEUR(sl, file[i]);
+        meilleurs[i] = MEILLEUR(sl, file[i]);
     }
+    free(file);
+    e->somme = sommeSnapshotTH((const unsigned char *)(e + 1), *sz - sizeof(*e));
+    return buf;
+}
 
-    cJSON *child;
-    child = constructJSONTH(th->inf);
-    if (!cJSON_AddItemToObject(obj, "left", child))
+bool verifieSnapshotTH(const void *snap, size_t sz)
+{
+    const EnteteSnapshotTH *e = snap;
+    if (sz < sizeof(*e) || memcmp(e->magie, SNAPSHOT_TH_MAGIE, sizeof(e->magie)) != 0 ||
+        e->version != SNAPSHOT_TH_VERSION || e->taille == 0 ||
+        sz != sizeof(*e) + (size_t)e->taille * OCTETS_NOEUD_SNAPSHOT || e->racine >= e->taille ||
+        (e->racine == 0) != (e->taille == 1))
+        return false;
+    if (sommeSnapshotTH((const unsigned char *)(e + 1), sz - sizeof(*e)) != e->somme)
+        return false;
+    VueSnapshotTH v = vueSnapshotTH(snap);
+    /* Les enfants doivent être numérotés comme le fait `printSnapshotTH()` : chaque noeud a un seul parent, et tous
+     * sont atteints depuis la racine */
+    uint32_t suivant = 2;
+    for (uint32_t i = 1; i < v.taille; i++)
     {
-        fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONTH");
-        exit(1);
+        const NoeudHybride *n = &v.noeuds[i];
+        if ((n->inf && n->inf != suivant++) || (n->eq && n->eq != suivant++) || (n->sup && n->sup != suivant++) ||
+            ((n->label & FINMOT) != 0) != (v.valeurs[i] != 0))
+            return false;
+    }
+    if (v.taille > 1 && (suivant != v.taille || v.racine != 1))
+        return false;
+    /* Les enfants venant après leur parent, les compteurs se vérifient des feuilles à la racine */
+    for (uint32_t i = v.taille - 1; i >= 1; i--)
+    {
+        const NoeudHybride *n = &v.noeuds[i];
+        uint64_t mots = (n->label & FINMOT) != 0;
+        int32_t meilleur = (n->label & FINMOT) ? v.valeurs[i] : INT_MIN;
+        const uint32_t enfants[3] = {n->inf, n->eq, n->sup};
+        for (int k = 0; k < 3; k++)
+        {
+            if (!enfants[k])
+                continue;
+            mots += v.mots[enfants[k]];
+            if (v.meilleurs[enfants[k]] > meilleur)
+                meilleur = v.meilleurs[enfants[k]];
+        }
+        if (mots != v.mots[i] || meilleur != v.meilleurs[i])
+            return false;
     }
-    child = constructJSONTH(th->eq);
-    if (!cJSON_AddItemToObject(obj, "middle", child))
+    return true;
+}
+
+TrieHybride *parseSnapshotTH(const void *snap, size_t sz)
+{
+    if (!verifieSnapshotTH(snap, sz))
     {
-        fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONTH");
+        fprintf(stderr, "Erreur, snapshot invalide dans parseSnapshotTH");
         exit(1);
     }
-    child = constructJSONTH(th->sup);
-    if (!cJSON_AddItemToObject(obj, "right", child))
+    VueSnapshotTH v = vueSnapshotTH(snap);
+    if (!v.racine)
+        return newTH();
+    Lien *liens = malloc(v.taille * sizeof(*liens));
+    if (!liens)
     {
-        fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONTH");
+        fprintf(stderr, "Erreur, malloc dans parseSnapshotTH");
         exit(1);
     }
-
-    return obj;
+    Slab *sl = ouvreTH(newTH());
+    liens[0] = NIL;
+    /* Tous les noeuds sont alloués avant d'être reliés, une allocation pouvant déplacer la slab */
+    for (uint32_t i = 1; i < v.taille; i++)
+        liens[i] = allocTH(sl, (char)(v.noeuds[i].label & ~FINMOT));
+    for (uint32_t i = 1; i < v.taille; i++)
+    {
+        Noeud *n = NOEUD(sl, liens[i]);
+        n->inf = liens[v.noeuds[i].inf];
+        n->eq = liens[v.noeuds[i].eq];
+        n->sup = liens[v.noeuds[i].sup];
+        n->h = v.noeuds[i].h;
+        POSE_FIN(sl, liens[i], v.valeurs[i]);
+        MOTS(sl, liens[i]) = v.mots[i];
+        MEILLEUR(sl, liens[i]) = v.meilleurs[i];
+    }
+    TrieHybride *th = fermeTH(sl, liens[v.racine]);
+    free(liens);
+    return th;
 }
 
-char *printJSONTH(const TrieHybride *th)
+bool rechercheSnapshotTH(const void *snap, const char *cle)
 {
-    cJSON *js = constructJSONTH(th);
-    char *str = cJSON_Print(js);
-    /* TODO: Check if cJSON is null and skip output completely (vanity) */
-    cJSON_Delete(js);
-    return str;
+    VueSnapshotTH v = vueSnapshotTH(snap);
+    if (*cle == '\0')
+        return false;
+    uint32_t l = v.racine;
+    while (l)
+    {
+        const NoeudHybride *n = &v.noeuds[l];
+        char label = (char)(n->label & ~FINMOT);
+        if (*cle < label)
+            l = n->inf;
+        else if (*cle > label)
+            l = n->sup;
+        else if (cle[1] == '\0')
+            return (n->label & FINMOT) != 0;
+        else
+        {
+            l = n->eq;
+            cle++;
+        }
+    }
+    return false;
 }
 
-TrieHybride *parseJSONTH_rec(const cJSON *json)
+int prefixeSnapshotTH(const void *snap, const char *cle)
 {
-    if (cJSON_IsNull(json))
-        return NULL;
-
-    TrieHybride *th = allocTH();
-    cJSON *obj;
+    VueSnapshotTH v = vueSnapshotTH(snap);
+    const NoeudHybride *dernier = NULL;
+    uint32_t l = v.racine;
+    /* La même descente que `prefixeTH()`, sur les indices du snapshot */
+    while (l && *cle)
+    {
+        dernier = &v.noeuds[l];
+        char label = (char)(dernier->label & ~FINMOT);
+        if (*cle < label)
+            l = dernier->inf;
+        else if (*cle > label)
+            l = dernier->sup;
+        else
+        {
+            l = dernier->eq;
+            cle++;
+        }
+    }
+    return (!*cle && dernier && (dernier->label & FINMOT)) + (int)(l ? v.mots[l] : 0);
+}
 
-    obj = cJSON_GetObjectItemCaseSensitive(json, "char");
-    assert(cJSON_IsString(obj) && "'char' element has to be a JSON string element");
-    th->label = obj->valuestring[0];
-    obj = cJSON_GetObjectItemCaseSensitive(json, "is_end_of_word");
-    assert(cJSON_IsBool(obj) && "'is_end_of_word' element has to be a JSON bool element");
-    th->value = cJSON_IsTrue(obj);
+/**
+ * @private
+ *
+ * @brief Une paire de liens, un dans chacun des deux tries parcourus ensemble
+ *
+ */
+typedef struct paire_liens
+{
+    Lien l1; /**< Le noeud du trie modifié */
+    Lien l2; /**< Le noeud du trie lu */
+} PaireLiens;
 
-    obj = cJSON_GetObjectItemCaseSensitive(json, "left");
-    assert((cJSON_IsNull(obj) || cJSON_IsObject(obj)) && "'left' element has to be a JSON null or object element");
-    th->inf = parseJSONTH_rec(obj);
+/**
+ * @private
+ *
+ * @brief Une pile de paires de liens qui s'agrandit au besoin
+ *
+ */
+typedef struct paire_stack
+{
+    size_t cap;
+    size_t sz;
+    PaireLiens *tab;
+} PaireStack;
 
-    obj = cJSON_GetObjectItemCaseSensitive(json, "middle");
-    assert((cJSON_IsNull(obj) || cJSON_IsObject(obj)) && "'middle' element has to be a JSON null or object element");
-    th->eq = parseJSONTH_rec(obj);
+static void pushPaireStack(PaireStack *s, Lien l1, Lien l2)
+{
+    if (s->sz == s->cap)
+    {
+        s->cap = s->cap ? 2 * s->cap : CADRES_LOCAUX;
+        s->tab = realloc(s->tab, s->cap * sizeof(*s->tab));
+        if (!s->tab)
+        {
+            fprintf(stderr, "Erreur, realloc dans pushPaireStack");
+            exit(1);
+        }
+    }
+    s->tab[s->sz].l1 = l1;
+    s->tab[s->sz].l2 = l2;
+    s->sz++;
+}
 
-    obj = cJSON_GetObjectItemCaseSensitive(json, "right");
-    assert((cJSON_IsNull(obj) || cJSON_IsObject(obj)) && "'right' element has to be a JSON null or object element");
-    th->sup = parseJSONTH_rec(obj);
+/**
+ * @private
+ *
+ * @brief Alloue dans @a sl1 une copie sans enfants du noeud @a l2 de @a sl2
+ *
+ * @post Avec `HYBRID_SLAB`, les pointeurs de noeuds de @a sl1 obtenus avant l'appel ne sont plus valides
+ *
+ */
+static Lien copieNoeudTH(Slab *sl1, const Slab *sl2, Lien l2)
+{
+    const Noeud *n2 = NOEUD(sl2, l2);
+    Lien l = allocTH(sl1, LABEL(n2));
+    POSE_FIN(sl1, l, VALEUR(sl2, l2));
+    NOEUD(sl1, l)->h = n2->h;
+    MOTS(sl1, l) = MOTS(sl2, l2);
+    MEILLEUR(sl1, l) = MEILLEUR(sl2, l2);
+    return l;
+}
 
-    return th;
+/**
+ * @private
+ *
+ * @brief Copie dans @a sl1 tout le sous arbre @a l2 de @a sl2, hauteurs et nombres de mots compris
+ *
+ */
+Lien copieTH_rec(Slab *sl1, const Slab *sl2, Lien l2)
+{
+    if (!l2)
+        return NIL;
+    const Noeud *n2 = NOEUD(sl2, l2);
+    Lien l = copieNoeudTH(sl1, sl2, l2);
+    Lien enf = copieTH_rec(sl1, sl2, n2->inf);
+    NOEUD(sl1, l)->inf = enf;
+    enf = copieTH_rec(sl1, sl2, n2->eq);
+    NOEUD(sl1, l)->eq = enf;
+    enf = copieTH_rec(sl1, sl2, n2->sup);
+    NOEUD(sl1, l)->sup = enf;
+    return l;
 }
 
-TrieHybride *parseJSONTH(const char *json, size_t sz)
+/**
+ * @private
+ *
+ * @brief Version itérative de `copieTH_rec()`
+ *
+ */
+Lien copieTH_iter(Slab *sl1, const Slab *sl2, Lien l2)
 {
-    cJSON *obj = cJSON_ParseWithLength(json, sz);
-    if (!obj)
+    if (!l2)
+        return NIL;
+    PaireStack pile = {0, 0, NULL};
+    Lien racine = copieNoeudTH(sl1, sl2, l2);
+    pushPaireStack(&pile, racine, l2);
+    while (pile.sz > 0)
     {
-        fprintf(stderr, "Erreur, cJSON_ParseWithLength dans parseJSONTH");
-        const char *error_ptr = cJSON_GetErrorPtr();
-        if (error_ptr)
+        PaireLiens p = pile.tab[--pile.sz];
+        const Noeud *n2 = NOEUD(sl2, p.l2);
+        Lien enf;
+        if (n2->inf)
         {
-            fprintf(stderr, "Error before: %s\n", error_ptr);
+            enf = copieNoeudTH(sl1, sl2, n2->inf);
+            NOEUD(sl1, p.l1)->inf = enf;
+            pushPaireStack(&pile, enf, n2->inf);
+        }
+        if (n2->eq)
+        {
+            enf = copieNoeudTH(sl1, sl2, n2->eq);
+            NOEUD(sl1, p.l1)->eq = enf;
+            pushPaireStack(&pile, enf, n2->eq);
+        }
+        if (n2->sup)
+        {
+            enf = copieNoeudTH(sl1, sl2, n2->sup);
+            NOEUD(sl1, p.l1)->sup = enf;
+            pushPaireStack(&pile, enf, n2->sup);
         }
-        exit(1);
     }
-    TrieHybride *th = parseJSONTH_rec(obj);
-    cJSON_Delete(obj);
-    return th;
+    free(pile.tab);
+    return racine;
+}
+
+/**
+ * @private
+ *
+ * @brief Trouve le noeud d'un caractère dans un niveau non vide, ou l'y ajoute comme feuille
+ *
+ * @param [in,out] sl La slab du trie
+ * @param [in] l Le lien vers la racine du niveau, qui ne change pas
+ * @param [in] label Le caractère cherché
+ * @param [in,out] touches Reçoit les noeuds du chemin puis le noeud du caractère
+ * @return Le lien vers le noeud du caractère
+ *
+ * @pre @a l est non nul
+ * @post Avec `HYBRID_SLAB`, les pointeurs de noeuds obtenus avant l'appel ne sont plus valides
+ *
+ * Les hauteurs du chemin sont recalculées en remontant si un noeud est ajouté. Les nombres de mots ne le sont pas,
+ * c'est à l'appelant de le faire avec @a touches une fois la fusion finie.
+ *
+ */
+static Lien trouveOuAjouteTH(Slab *sl, Lien l, char label, CadreStack *touches)
+{
+    CadreStack chemin;
+    initCadreStack(&chemin);
+    Lien cur = l;
+    while (cur && LABEL(NOEUD(sl, cur)) != label)
+    {
+        pushCadreStack(&chemin, cur, 0);
+        pushCadreStack(touches, cur, 0);
+        cur = label < LABEL(NOEUD(sl, cur)) ? NOEUD(sl, cur)->inf : NOEUD(sl, cur)->sup;
+    }
+    if (!cur)
+    {
+        cur = allocTH(sl, label);
+        Noeud *parent = NOEUD(sl, chemin.tab[chemin.sz - 1].l);
+        if (label < LABEL(parent))
+            parent->inf = cur;
+        else
+            parent->sup = cur;
+        for (size_t k = chemin.sz; k-- > 0;)
+            if (!majHauteurTH(sl, chemin.tab[k].l))
+                break;
+    }
+    pushCadreStack(touches, cur, 0);
+    freeCadreStack(&chemin);
+    return cur;
+}
+
+/**
+ * @private
+ *
+ * @brief Fusionne le niveau @a l2 du trie lu dans le niveau @a l1 du trie modifié
+ *
+ * @param [in,out] sl1 La slab du trie modifié
+ * @param [in] l1 Le lien vers la racine du niveau modifié
+ * @param [in] sl2 La slab du trie lu
+ * @param [in] l2 Le lien vers la racine du niveau lu
+ * @param [in,out] touches Reçoit dans l'ordre de passage les noeuds existants ou ajoutés du trie modifié
+ * @return Le lien vers la racine du niveau fusionné
+ *
+ * Les noeuds du niveau lu sont pris en préfixe, ce qui garde sa forme quand ils sont nouveaux. Chacun est retrouvé ou
+ * ajouté dans le niveau modifié, puis son enfant Eq est fusionné avec celui du noeud correspondant. Un niveau qui
+ * n'existe pas dans le trie modifié est copié d'un coup avec tout ce qui se trouve en dessous, sans recherche.
+ *
+ * Un noeud est toujours passé avant ses descendants, recalculer les nombres de mots de @a touches en partant de la
+ * fin les remet donc à jour.
+ *
+ */
+Lien fusionTH_rec(Slab *sl1, Lien l1, const Slab *sl2, Lien l2, CadreStack *touches)
+{
+    if (!l2)
+        return l1;
+    if (!l1)
+        return copieTH_rec(sl1, sl2, l2);
+    const Noeud *n2 = NOEUD(sl2, l2);
+    Lien l = trouveOuAjouteTH(sl1, l1, LABEL(n2), touches);
+    if (FIN(n2) && !FIN(NOEUD(sl1, l)))
+        POSE_FIN(sl1, l, VALEUR(sl2, l2));
+    Lien eq = fusionTH_rec(sl1, NOEUD(sl1, l)->eq, sl2, n2->eq, touches);
+    NOEUD(sl1, l)->eq = eq;
+    fusionTH_rec(sl1, l1, sl2, n2->inf, touches);
+    fusionTH_rec(sl1, l1, sl2, n2->sup, touches);
+    return l1;
 }
 
-TrieHybride *fusionTH_rec(TrieHybride *restrict th1, const TrieHybride *restrict th2, Stack *s)
+/**
+ * @private
+ *
+ * @brief Version itérative de `fusionTH_rec()`
+ *
+ * Chaque case de la pile associe un noeud lu au noeud modifié dont l'enfant Eq reçoit son niveau, nul pour la
+ * racine. Les noeuds d'un même niveau sont traités dans le même ordre préfixe que la version récursive.
+ *
+ */
+Lien fusionTH_iter(Slab *sl1, Lien l1, const Slab *sl2, Lien l2, CadreStack *touches)
 {
-    if (!th2)
-        return th1;
-    th1 = fusionTH_rec(th1, th2->inf, s);
-    pushStack(s, th2->label);
-    if (th2->value)
+    if (!l2)
+        return l1;
+    PaireStack pile = {0, 0, NULL};
+    pushPaireStack(&pile, NIL, l2);
+    while (pile.sz > 0)
     {
-        const char *str = readStack(s);
-        assert(str && "La chaine lu ne peut pas être nul ici");
-        th1 = ajoutTH(th1, str, VALFIN);
+        PaireLiens p = pile.tab[--pile.sz];
+        Lien niveau = p.l1 ? NOEUD(sl1, p.l1)->eq : l1;
+        if (!niveau)
+        {
+            Lien copie = copieTH_iter(sl1, sl2, p.l2);
+            if (p.l1)
+                NOEUD(sl1, p.l1)->eq = copie;
+            else
+                l1 = copie;
+            continue;
+        }
+        const Noeud *n2 = NOEUD(sl2, p.l2);
+        Lien l = trouveOuAjouteTH(sl1, niveau, LABEL(n2), touches);
+        if (FIN(n2) && !FIN(NOEUD(sl1, l)))
+            POSE_FIN(sl1, l, VALEUR(sl2, p.l2));
+        if (n2->sup)
+            pushPaireStack(&pile, p.l1, n2->sup);
+        if (n2->inf)
+            pushPaireStack(&pile, p.l1, n2->inf);
+        if (n2->eq)
+            pushPaireStack(&pile, l, n2->eq);
     }
-    th1 = fusionTH_rec(th1, th2->eq, s);
-    popStack(s);
-    th1 = fusionTH_rec(th1, th2->sup, s);
-    return th1;
+    free(pile.tab);
+    return l1;
 }
 
 TrieHybride *fusionTH(TrieHybride **restrict th1, const TrieHybride *restrict th2)
@@ -633,10 +3307,14 @@ TrieHybride *fusionTH(TrieHybride **restrict th1, const TrieHybride *restrict th
     TrieHybride *th = *th1;
     if (th2)
     {
-        Stack s = newStack(hauteurTH(th2) + 1);
-        th = fusionTH_rec(*th1, th2, &s);
-        assert(s.sz == 0 && "La pile des caractères doit être vide à cet instant");
-        freeStack(s);
+        Slab *sl = ouvreTH(*th1);
+        CadreStack touches;
+        initCadreStack(&touches);
+        Lien racine = VERSION(fusionTH)(sl, racineTH(*th1), slabTH(th2), racineTH(th2), &touches);
+        for (size_t k = touches.sz; k-- > 0;)
+            majMotsTH(sl, touches.tab[k].l);
+        freeCadreStack(&touches);
+        th = fermeTH(sl, racine);
     }
     *th1 = NULL;
     return th;
@@ -650,132 +3328,326 @@ TrieHybride *fusionCopieTH(const TrieHybride *restrict th1, const TrieHybride *r
     return th;
 }
 
-int indirectionLevel(TrieHybride *th)
+TrieHybride *rebalance(TrieHybride *th)
 {
-    if (!th)
-        return 0;
-
-    if (determine_enfants(th) == AUCUNENF)
-        return 0;
+    assert(th && "Given Hybrid Trie can't be NULL");
+    Slab *sl = ouvreTH(th);
+    return fermeTH(sl, rebalance_lien(sl, racineTH(th)));
+}
 
-    return 1 + indirectionLevel(th->inf) + indirectionLevel(th->sup);
+Lien ajoutReequilibreTH_rec(Slab *sl, Lien l, const char *restrict cle, int v)
+{
+    char p = prem(cle);
+    if (p == '\0')
+        return l;
+    /* Test du dernier caractère de la clé sans recalculer sa longueur à chaque noeud */
+    bool dernier = cle[1] == '\0';
+    Lien enf;
+    if (!l)
+    {
+        Lien newl = allocTH(sl, p);
+        if (dernier)
+        {
+            POSE_FIN(sl, newl, v);
+        }
+        else
+        {
+            enf = ajoutReequilibreTH_rec(sl, NIL, reste(cle), v);
+            NOEUD(sl, newl)->eq = enf;
+        }
+        majMotsTH(sl, newl);
+        return newl;
+    }
+    char label = LABEL(NOEUD(sl, l));
+    if (p < label)
+    {
+        enf = ajoutReequilibreTH_rec(sl, NOEUD(sl, l)->inf, cle, v);
+        NOEUD(sl, l)->inf = enf;
+    }
+    else if (p > label)
+    {
+        enf = ajoutReequilibreTH_rec(sl, NOEUD(sl, l)->sup, cle, v);
+        NOEUD(sl, l)->sup = enf;
+    }
+    else
+    {
+        enf = ajoutReequilibreTH_rec(sl, NOEUD(sl, l)->eq, reste(cle), v);
+        NOEUD(sl, l)->eq = enf;
+    }
+    if (dernier && label == p && !FIN(NOEUD(sl, l)))
+    {
+        POSE_FIN(sl, l, v);
+    }
+    return rebalance_lien(sl, l);
 }
 
 /**
  * @private
  *
- * @brief Effectue une rotation droite pour équilibrer
+ * @brief Version itérative de `ajoutReequilibreTH_rec()`
  *
- * @pre Le Trie Hybride donné est non vide (non nul)
+ * Comme au retour des appels récursifs, les noeuds existants traversés lors de l'insertion sont rééquilibrés du plus
+ * profond à la racine, chacun étant raccroché à son parent après sa rotation éventuelle. Chaque noeud coûte O(1)
+ * grâce aux hauteurs gardées dans les noeuds.
  *
  */
-TrieHybride *rotateRight(TrieHybride *y)
+Lien ajoutReequilibreTH_iter(Slab *sl, Lien l, const char *restrict cle, int v)
 {
-    assert(y && "Given Hybrid Trie can't be NULL");
-    TrieHybride *x = y->inf;
-    TrieHybride *T = x->sup;
-
-    x->sup = y;
-    y->inf = T;
+    CadreStack chemin;
+    initCadreStack(&chemin);
+    l = ajoutTH_descente(sl, l, cle, v, &chemin);
+    for (size_t k = chemin.sz; k-- > 0;)
+    {
+        Lien ancien = chemin.tab[k].l;
+        Lien nouveau = rebalance_lien(sl, ancien);
+        if (k == 0)
+            l = nouveau;
+        else if (nouveau != ancien)
+            remplaceLienTH(NOEUD(sl, chemin.tab[k - 1].l), ancien, nouveau);
+    }
+    freeCadreStack(&chemin);
+    return l;
+}
 
-    return x;
+TrieHybride *ajoutReequilibreTH(TrieHybride *th, const char *restrict cle, int v)
+{
+    assert(v != 0 && "Valeur donné pour l'insértion doit être non nul");
+    Slab *sl = ouvreTH(th);
+    return fermeTH(sl, VERSION(ajoutReequilibreTH)(sl, racineTH(th), cle, v));
 }
 
 /**
  * @private
  *
- * @brief Effectue une rotation gauche pour équilibrer
+ * @def SEUIL_TRI_INSERTION
  *
- * @pre Le Trie Hybride donné est non vide (non nul)
+ * @brief Le nombre de mots d'une tranche en dessous duquel `construitTH()` la trie par insertion plutôt que de la
+ * répartir par caractère
+ *
+ */
+#define SEUIL_TRI_INSERTION 32
+
+/**
+ * @private
+ *
+ * @brief Compare deux clés dans l'ordre des noeuds du Trie Hybride
+ *
+ * Les caractères sont comparés comme des @c char, comme à la descente dans le trie, et une clé est plus petite que
+ * toutes celles qui la prolongent.
  *
  */
-TrieHybride *rotateLeft(TrieHybride *x)
+static int compareClesTH(const char *s, const char *t)
 {
-    assert(x && "Given Hybrid Trie can't be NULL");
-    TrieHybride *y = x->sup;
-    TrieHybride *T = y->inf;
+    while (*s && *s == *t)
+    {
+        s++;
+        t++;
+    }
+    if (!*s || !*t)
+        return !!*s - !!*t;
+    return (*s > *t) - (*s < *t);
+}
 
-    y->inf = x;
-    x->sup = T;
+/**
+ * @private
+ *
+ * @def RANGS_CAR
+ *
+ * @brief Le nombre de rangs distincts donnés par `rangCarTH()`, le caractère nul compris
+ *
+ */
+#define RANGS_CAR (UCHAR_MAX + 2)
 
-    return y;
+/**
+ * @private
+ *
+ * @brief Rang d'un caractère dans l'ordre de `compareClesTH()`, le caractère nul en premier
+ *
+ */
+static inline size_t rangCarTH(char c)
+{
+    return c ? (size_t)((int)c - CHAR_MIN + 1) : 0;
 }
 
-TrieHybride *rebalance(TrieHybride *th)
+/**
+ * @private
+ *
+ * @brief Un niveau du trie restant à construire par `construitTH()`
+ *
+ */
+typedef struct tache_construction
 {
-    assert(th && "Given Hybrid Trie can't be NULL");
-    int balanceFactor = indirectionLevel(th->inf) - indirectionLevel(th->sup);
+    size_t lo;   /**< Début de la tranche de mots du niveau */
+    size_t hi;   /**< Fin exclue de la tranche de mots du niveau */
+    size_t d;    /**< Profondeur du caractère des mots qui forme le niveau */
+    Lien parent; /**< Le noeud dont l'enfant Eq reçoit le niveau, nul pour la racine */
+    bool trie;   /**< Vrai si la tranche est déjà entièrement triée */
+} TacheConstruction;
 
-    /* Left heavy */
-    if (balanceFactor >= 1)
+/**
+ * @private
+ *
+ * @brief Une pile de niveaux à construire qui s'agrandit au besoin
+ *
+ */
+typedef struct tache_stack
+{
+    size_t cap;
+    size_t sz;
+    TacheConstruction *tab;
+} TacheStack;
+
+static void pushTacheStack(TacheStack *s, TacheConstruction t)
+{
+    if (s->sz == s->cap)
     {
-        if (indirectionLevel(th->inf->inf) >= indirectionLevel(th->inf->sup))
-        {
-            /* Single right rotation */
-            return rotateRight(th);
-        }
-        else
+        s->cap = s->cap ? 2 * s->cap : CADRES_LOCAUX;
+        s->tab = realloc(s->tab, s->cap * sizeof(*s->tab));
+        if (!s->tab)
         {
-            /* Left-right rotation */
-            th->inf = rotateLeft(th->inf);
-            return rotateRight(th);
+            fprintf(stderr, "Erreur, realloc dans pushTacheStack");
+            exit(1);
         }
     }
+    s->tab[s->sz++] = t;
+}
 
-    /* Right heavy */
-    if (balanceFactor <= -1)
+/**
+ * @private
+ *
+ * @brief Ordonne les mots d'une tranche selon leur caractère à la profondeur @a d
+ *
+ * @param [in,out] mots Les mots, dont ceux de la tranche ont les mêmes @a d premiers caractères
+ * @param [in] t La tranche à ordonner
+ * @param [out] tmp Un tableau d'au moins `t->hi - t->lo` cases
+ * @return Vrai si la tranche est entièrement triée, faux si seul son caractère à la profondeur @a d l'est
+ *
+ * Une petite tranche est triée par insertion, ses niveaux suivants n'ont alors plus à être ordonnés. Une grande
+ * tranche est répartie par un tri par dénombrement sur un seul caractère, en O(taille de la tranche).
+ *
+ */
+static bool ordonneTrancheTH(char **mots, const TacheConstruction *t, char **tmp)
+{
+    if (t->trie)
+        return true;
+    if (t->hi - t->lo <= SEUIL_TRI_INSERTION)
     {
-        if (indirectionLevel(th->sup->sup) >= indirectionLevel(th->sup->inf))
-        {
-            /* Single left rotation */
-            return rotateLeft(th);
-        }
-        else
+        for (size_t i = t->lo + 1; i < t->hi; i++)
         {
-            /* Right-left rotation */
-            th->sup = rotateRight(th->sup);
-            return rotateLeft(th);
+            char *mot = mots[i];
+            size_t j = i;
+            for (; j > t->lo && compareClesTH(mots[j - 1] + t->d, mot + t->d) > 0; j--)
+                mots[j] = mots[j - 1];
+            mots[j] = mot;
         }
+        return true;
     }
+    size_t compte[RANGS_CAR + 1] = {0};
+    for (size_t i = t->lo; i < t->hi; i++)
+        compte[rangCarTH(mots[i][t->d]) + 1]++;
+    for (size_t r = 1; r < RANGS_CAR; r++)
+        compte[r] += compte[r - 1];
+    for (size_t i = t->lo; i < t->hi; i++)
+        tmp[compte[rangCarTH(mots[i][t->d])]++] = mots[i];
+    memcpy(mots + t->lo, tmp, (t->hi - t->lo) * sizeof(*mots));
+    return false;
+}
 
-    /* Node is balanced */
-    return th;
+/**
+ * @private
+ *
+ * @brief Une tranche de mots qui ont le même caractère à la profondeur du niveau
+ *
+ */
+typedef struct groupe
+{
+    size_t lo;
+    size_t hi;
+} Groupe;
+
+/**
+ * @private
+ *
+ * @brief Construit l'arbre binaire Inf/Sup d'un niveau en prenant le groupe médian comme racine
+ *
+ * @param [in,out] sl La slab du trie
+ * @param [in] mots Les mots
+ * @param [in] g Les groupes du niveau, dans l'ordre
+ * @param [in] a Début des groupes à placer
+ * @param [in] b Fin exclue des groupes à placer
+ * @param [in] t Le niveau à construire
+ * @param [in] trie Vrai si les mots du niveau sont entièrement triés
+ * @param [in,out] taches Reçoit les niveaux sous les enfants Eq des noeuds créés
+ * @param [in,out] crees Reçoit les noeuds créés, chacun avant ses descendants
+ * @return Le lien vers la racine de l'arbre binaire construit
+ *
+ * La profondeur de récursion est celle de l'arbre binaire, au plus 8 pour 255 caractères.
+ *
+ */
+static Lien construitNiveauTH(Slab *sl, char **mots, const Groupe *g, size_t a, size_t b,
+                              const TacheConstruction *t, bool trie, TacheStack *taches, CadreStack *crees)
+{
+    if (a == b)
+        return NIL;
+    size_t m = a + (b - a - 1) / 2;
+    Lien l = allocTH(sl, mots[g[m].lo][t->d]);
+    pushCadreStack(crees, l, 0);
+    Lien inf = construitNiveauTH(sl, mots, g, a, m, t, trie, taches, crees);
+    Lien sup = construitNiveauTH(sl, mots, g, m + 1, b, t, trie, taches, crees);
+    Noeud *n = NOEUD(sl, l);
+    n->inf = inf;
+    n->sup = sup;
+    majHauteurTH(sl, l);
+    pushTacheStack(taches, (TacheConstruction){g[m].lo, g[m].hi, t->d + 1, l, trie});
+    return l;
 }
 
-TrieHybride *ajoutReequilibreTH(TrieHybride *th, const char *restrict cle, int v)
+TrieHybride *construitTH(char **mots, size_t n, int v)
 {
     assert(v != 0 && "Valeur donné pour l'insértion doit être non nul");
-    size_t lgr = lgueur(cle);
-    if (lgr == 0)
-        return th;
-    char p = prem(cle);
-    if (!th)
+    char **tmp = malloc(n * sizeof(*tmp));
+    if (n && !tmp)
     {
-        TrieHybride *newth = allocTH();
-        newth->label = p;
-        newth->inf = NULL;
-        newth->sup = NULL;
-        if (lgr == 1)
+        fprintf(stderr, "Erreur, malloc dans construitTH");
+        exit(1);
+    }
+    Slab *sl = ouvreTH(newTH());
+    Lien racine = NIL;
+    Groupe g[UCHAR_MAX];
+    TacheStack taches = {0, 0, NULL};
+    CadreStack crees;
+    initCadreStack(&crees);
+    pushTacheStack(&taches, (TacheConstruction){0, n, 0, NIL, false});
+    while (taches.sz > 0)
+    {
+        TacheConstruction t = taches.tab[--taches.sz];
+        bool trie = ordonneTrancheTH(mots, &t, tmp);
+
+        /* Les mots qui se terminent avant ce niveau sont en tête, leur dernier caractère est le parent */
+        size_t i = t.lo;
+        while (i < t.hi && mots[i][t.d] == '\0')
+            i++;
+        if (i > t.lo && t.parent)
+            POSE_FIN(sl, t.parent, v);
+
+        size_t ng = 0;
+        for (size_t j; i < t.hi; i = j)
         {
-            newth->value = v;
-            newth->eq = NULL;
+            for (j = i + 1; j < t.hi && mots[j][t.d] == mots[i][t.d]; j++)
+                ;
+            g[ng++] = (Groupe){i, j};
         }
+        Lien niveau = construitNiveauTH(sl, mots, g, 0, ng, &t, trie, &taches, &crees);
+        if (t.parent)
+            NOEUD(sl, t.parent)->eq = niveau;
         else
-        {
-            newth->value = VALVIDE;
-            newth->eq = ajoutReequilibreTH(newTH(), reste(cle), v);
-        }
-        return newth;
-    }
-    if (p < th->label)
-        th->inf = ajoutReequilibreTH(th->inf, cle, v);
-    else if (p > th->label)
-        th->sup = ajoutReequilibreTH(th->sup, cle, v);
-    else
-        th->eq = ajoutReequilibreTH(th->eq, reste(cle), v);
-    if (lgr == 1 && th->label == p && !th->value)
-    {
-        th->value = v;
+            racine = niveau;
     }
-    return rebalance(th);
+    /* Les doublons empêchent de lire les nombres de mots sur les tranches, ils sont recalculés des feuilles à la racine */
+    for (size_t k = crees.sz; k-- > 0;)
+        majMotsTH(sl, crees.tab[k].l);
+    freeCadreStack(&crees);
+    free(taches.tab);
+    free(tmp);
+    return fermeTH(sl, racine);
 }
@@ -20,7 +20,12 @@ typedef enum
     FUSION = 2,
     LISTEMOTS = 3,
     PROFONDEURMOYENNE = 4,
-    PREFIXE = 5
+    PREFIXE = 5,
+    SERVEUR = 6,
+    CLIENT = 7,
+    LOT = 8,
+    SNAPSHOT = 9,
+    COMPACTION = 10
 } OpType;
 
 typedef enum
@@ -42,13 +47,18 @@ int main(int argc, char *argv[])
     switch (op)
     {
     case INSERER:
-        if (argc != 4)
+        if (argc != 4 && argc != 5)
         {
-            fprintf(stderr, "usage: %s %d <TrieType> <isRebalanced>", argv[0], INSERER);
+            fprintf(stderr, "usage: %s %d <TrieType> <isRebalanced> [arbre.json]", argv[0], INSERER);
             exit(1);
         }
-        if (tt == PATRICIA)
+        /* Avec un fichier, les mots y sont ajoutés au lieu de construire un nouveau trie sur la sortie standard */
+        if (tt == PATRICIA && argc == 5)
+            insererFichierPT(argv[4]);
+        else if (tt == PATRICIA)
             insererPT();
+        else if (tt == HYBRID && argc == 5)
+            insererFichierTH(argv[4]);
         else if (tt == HYBRID)
         {
             int isRebalanced = atoi(argv[3]);
@@ -140,6 +150,79 @@ int main(int argc, char *argv[])
             exit(1);
         }
         break;
+    case SERVEUR:
+        if (argc != 5)
+        {
+            fprintf(stderr, "usage: %s %d <TrieType> <arbre.json> <socket>", argv[0], SERVEUR);
+            exit(1);
+        }
+        if (tt == PATRICIA)
+            serveurMainPT(argv[3], argv[4]);
+        else if (tt == HYBRID)
+            serveurMainTH(argv[3], argv[4]);
+        else
+        {
+            fprintf(stderr, "Erreur, TrieType [%d] inconnu", tt);
+            exit(1);
+        }
+        break;
+    case CLIENT:
+        /* Le client ne dépend pas du type de trie, c'est le serveur qui le connait */
+        if (argc != 3)
+        {
+            fprintf(stderr, "usage: %s %d <socket>", argv[0], CLIENT);
+            exit(1);
+        }
+        clientMain(argv[2]);
+        break;
+    case LOT:
+        if (argc != 4)
+        {
+            fprintf(stderr, "usage: %s %d <TrieType> <arbre.json>", argv[0], LOT);
+            exit(1);
+        }
+        if (tt == PATRICIA)
+            lotMainPT(argv[3]);
+        else if (tt == HYBRID)
+            lotMainTH(argv[3]);
+        else
+        {
+            fprintf(stderr, "Erreur, TrieType [%d] inconnu", tt);
+            exit(1);
+        }
+        break;
+    case SNAPSHOT:
+        if (argc != 5)
+        {
+            fprintf(stderr, "usage: %s %d <TrieType> <arbre.json> <arbre.snap>", argv[0], SNAPSHOT);
+            exit(1);
+        }
+        if (tt == PATRICIA)
+            snapshotMainPT(argv[3], argv[4]);
+        else if (tt == HYBRID)
+            snapshotMainTH(argv[3], argv[4]);
+        else
+        {
+            fprintf(stderr, "Erreur, TrieType [%d] inconnu", tt);
+            exit(1);
+        }
+        break;
+    case COMPACTION:
+        if (argc != 4)
+        {
+            fprintf(stderr, "usage: %s %d <TrieType> <arbre.json>", argv[0], COMPACTION);
+            exit(1);
+        }
+        if (tt == PATRICIA)
+            compactionMainPT(argv[3]);
+        else if (tt == HYBRID)
+            compactionMainTH(argv[3]);
+        else
+        {
+            fprintf(stderr, "Erreur, TrieType [%d] inconnu", tt);
+            exit(1);
+        }
+        break;
     default:
         fprintf(stderr, "Erreur, OpType [%d] inconnu", op);
         exit(1);
@@ -10,528 +10,2351 @@
  */
 #define _DEFAULT_SOURCE 1
 #include "cJSON.h"
+#include "fluxjson.h"
 #include "patricia.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <assert.h>
+#if defined(__SSE2__) && !defined(PATRICIA_NO_SIMD)
+#include <emmintrin.h>
+#define PATRICIA_SSE2 1
+#endif
+#if defined(__AVX2__) && !defined(PATRICIA_NO_SIMD)
+#include <immintrin.h>
+#define PATRICIA_AVX2 1
+#endif
 
+/**
+ * @private
+ *
+ * @brief Nombre maximal d'arêtes pour chaque type de noeud, indexé par @c PatriciaNodeType
+ */
+static const int capacite_patricia[] = {4, NODE_KEYS, 48, ASCII_SIZE};
 
 /**
- * @brief Fonction qui crée un nouveau noeud Patricia
+ * @private
  *
- * @return PatriciaNode*
+ * @brief Nombre d'arêtes en dessous duquel un noeud redescend au type inférieur, indexé par @c PatriciaNodeType
+ *
+ * Les seuils sont plus bas que la capacité du type inférieur pour éviter d'osciller entre deux types lors d'une
+ * alternance d'ajouts et de retraits autour de la même taille.
  */
-PatriciaNode *create_patricia_node(void){
-    PatriciaNode *node = (PatriciaNode *)malloc(sizeof(PatriciaNode));
-    if(node == NULL){
-        fprintf(stderr, "Erreur d'allocation de mémoire: create_patricia_node\n");
+static const int seuil_patricia[] = {0, 3, 12, 37};
+
+/**
+ * @private
+ *
+ * @brief Fonction qui compare un caractère à toutes les clés d'un noeud NODE4/NODE16 en une fois
+ *
+ * Avec SSE2 les 16 octets de @c keys sont chargés dans un registre et comparés par une seule instruction, sinon une
+ * boucle scalaire construit le même masque. Les octets au-delà de @c count ne sont pas significatifs et sont masqués.
+ * AVX2 n'apporterait rien ici, un noeud n'ayant jamais plus de 16 clés triées.
+ *
+ * @param node
+ * @param c
+ * @param cmp le sens de la comparaison de chaque clé à @a c : 0 pour égal, 1 pour supérieur, -1 pour inférieur
+ * @return unsigned un masque dont le bit i est mis si @c keys[i] satisfait la comparaison
+ */
+static inline unsigned masque_keys_patricia(const PatriciaNode *node, int c, int cmp)
+{
+#ifdef PATRICIA_SSE2
+    /* Les clés sont des caractères ASCII, la comparaison signée sur 8 bits est donc exacte, même pour c == -1 */
+    __m128i keys = _mm_loadu_si128((const __m128i *)node->keys);
+    __m128i val = _mm_set1_epi8((char)c);
+    __m128i res;
+    if (cmp == 0)
+        res = _mm_cmpeq_epi8(keys, val);
+    else if (cmp > 0)
+        res = _mm_cmpgt_epi8(keys, val);
+    else
+        res = _mm_cmplt_epi8(keys, val);
+    unsigned mask = (unsigned)_mm_movemask_epi8(res);
+    return mask & ((1u << node->count) - 1);
+#else
+    /* Les clés étant triées, chaque masque est un intervalle trouvé en un seul parcours jusqu'à la première clé >= c */
+    int i = 0;
+    while (i < node->count && node->keys[i] < c)
+        i++;
+    unsigned lower = (1u << i) - 1;
+    unsigned equal = i < node->count && node->keys[i] == c ? 1u << i : 0;
+    if (cmp == 0)
+        return equal;
+    if (cmp < 0)
+        return lower;
+    return ((1u << node->count) - 1) & ~lower & ~equal;
+#endif
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui alloue un tableau de @a n arêtes vides
+ *
+ * @param n
+ * @return PatriciaEdge*
+ */
+static PatriciaEdge *alloc_edges_patricia(int n)
+{
+    PatriciaEdge *edges = calloc(n, sizeof(*edges));
+    if (edges == NULL)
+    {
+        fprintf(stderr, "Erreur d'allocation de mémoire: alloc_edges_patricia\n");
         exit(1);
     }
-    for(int i = 0; i < ASCII_SIZE; i++){
-        node->prefixes[i] = NULL;
-        node->children[i] = NULL;
-    }
-    return node;
+    return edges;
 }
 
 /**
- * @brief Fonction qui retourne le suffixe d'un mot qui est prefixe d'un autre mot
+ * @private
  *
- * @param s1
- * @param s2
- * @return const char*
+ * @brief Fonction qui libère un noeud sans toucher à ses enfants
+ *
+ * @param node
  */
-const char* suffixe(const char* s1, const char* s2){
-    if(s1 == NULL || s2 == NULL){
-        return NULL;
-    }
-    if(est_prefixe(s1, s2)){
-        return s2 += plus_long_pref(s1,s2);
-    }
-    else{
-        return NULL;
-    }
+static void free_shell_patricia(PatriciaNode *node)
+{
+    if (node->edges != node->inline_edges)
+        free(node->edges);
+    free(node->index);
+    free(node);
 }
 
 /**
- * @brief Fonction qui insère un mot dans le Patricia-Trie
+ * @private
  *
- * @param root
- * @param word
+ * @brief Fonction qui convertit un noeud vers un autre type en conservant ses arêtes
+ *
+ * @param node
+ * @param type
  */
-void insert_patricia(PatriciaNode* patricia, const char* word) {
-    if (*word == '\0') {
-        if (patricia->prefixes[EOE_INDEX] == NULL) {
-            patricia->prefixes[EOE_INDEX] = strdup(" ");
+static void change_type_patricia(PatriciaNode *node, PatriciaNodeType type)
+{
+    PatriciaEdge tmp[4];
+    PatriciaEdge *edges = type == NODE4 ? tmp : alloc_edges_patricia(capacite_patricia[type]);
+    unsigned char *index = NULL;
+    if (type == NODE48)
+    {
+        index = calloc(ASCII_SIZE, sizeof(*index));
+        if (index == NULL)
+        {
+            fprintf(stderr, "Erreur d'allocation de mémoire: change_type_patricia\n");
+            exit(1);
         }
-        return;
-    }
-
-    int index = (unsigned char)(*word);
-
-    if (patricia->prefixes[index] == NULL) {
-        patricia->prefixes[index] = strdup(word);
-        patricia->children[index] = NULL;
-        return;
     }
 
-    if (est_prefixe(patricia->prefixes[index], word)) {
-        if (patricia->children[index] == NULL) {
-            patricia->children[index] = create_patricia_node();
-            patricia->children[index]->prefixes[EOE_INDEX] = strdup(" ");
+    int n = 0;
+    int key = -1;
+    PatriciaEdge *edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL)
+    {
+        switch (type)
+        {
+        case NODE4:
+        case NODE16:
+            node->keys[n] = (unsigned char)key;
+            edges[n] = *edge;
+            break;
+        case NODE48:
+            index[key] = (unsigned char)(n + 1);
+            edges[n] = *edge;
+            break;
+        case NODE128:
+            edges[key] = *edge;
+            break;
         }
-        insert_patricia(patricia->children[index], suffixe(patricia->prefixes[index], word));
-        return;
+        n++;
     }
+    assert(n == node->count && "Le nombre d'arêtes doit être conservé");
 
-    int label_len = (int)strlen(patricia->prefixes[index]);
-    int prefix_commun = plus_long_pref(word, patricia->prefixes[index]);
-
-    if (prefix_commun < label_len) {
-        char* copy = strndup(patricia->prefixes[index], prefix_commun);
-        char* copy2 = strdup(patricia->prefixes[index] + prefix_commun);
-
-
-        PatriciaNode* new_child = create_patricia_node();
-
-        new_child->prefixes[(unsigned char)(*copy2)] = copy2;
-        new_child->children[(unsigned char)(*copy2)] = patricia->children[index];
-        patricia->children[index] = new_child;
-
-
-
-        free(patricia->prefixes[index]);
-        patricia->prefixes[index] = copy;
-
-        insert_patricia(patricia->children[index], word + prefix_commun);
+    if (node->edges != node->inline_edges)
+        free(node->edges);
+    free(node->index);
+    if (type == NODE4)
+    {
+        memcpy(node->inline_edges, tmp, sizeof(tmp));
+        edges = node->inline_edges;
     }
+    node->edges = edges;
+    node->index = index;
+    node->type = type;
 }
 
 /**
-* @brief Fonction qui retourne la longueur du plus long prefixe commun entre deux mots
-*
-* @param s1
-* @param s2
-* @return int
+ * @private
+ *
+ * @brief Fonction qui réserve @a len octets à la fin de l'arène
+ *
+ * Le tampon peut être réalloué, ce qui invalide tout pointeur obtenu par @c label_patricia avant l'appel.
+ *
+ * @param arena
+ * @param len
+ * @return uint32_t la position des octets réservés
  */
-int plus_long_pref(const char *s1, const char *s2) {
-    int i = 0;
-    while (s1[i] && s2[i] && s1[i] == s2[i]) i++;
-    return i;
+static uint32_t reserve_arena_patricia(PatriciaArena *arena, size_t len)
+{
+    if (len > UINT32_MAX - arena->size)
+    {
+        fprintf(stderr, "Erreur, arène pleine dans reserve_arena_patricia\n");
+        exit(1);
+    }
+    if (arena->size + len > arena->cap)
+    {
+        size_t cap = arena->cap ? arena->cap : 256;
+        while (cap < arena->size + len)
+            cap *= 2;
+        if (cap > UINT32_MAX)
+            cap = UINT32_MAX;
+        char *buf = realloc(arena->buf, cap);
+        if (buf == NULL)
+        {
+            fprintf(stderr, "Erreur d'allocation de mémoire: reserve_arena_patricia\n");
+            exit(1);
+        }
+        arena->buf = buf;
+        arena->cap = (uint32_t)cap;
+    }
+    uint32_t off = arena->size;
+    arena->size += (uint32_t)len;
+    return off;
 }
 
-
 /**
- * @brief Fonction qui recherche un mot dans le Patricia-Trie
+ * @private
  *
- * @param node
- * @param word
- * @return int
+ * @brief Fonction qui copie @a len octets à la fin de l'arène, @a s ne doit pas pointer dans cette même arène
+ *
+ * @param arena
+ * @param s
+ * @param len
+ * @return uint32_t la position de la copie
  */
-int recherche_patricia(PatriciaNode* node, const char* word) {
-    if (node == NULL) {
-        return 0;
-    }
+static uint32_t append_arena_patricia(PatriciaArena *arena, const char *s, size_t len)
+{
+    uint32_t off = reserve_arena_patricia(arena, len);
+    memcpy(arena->buf + off, s, len);
+    return off;
+}
 
-    if (*word == '\0') {
-        return node->prefixes[EOE_INDEX] != NULL;
-    }
+/**
+ * @private
+ *
+ * @brief Fonction qui donne à une arête un préfixe venu de l'extérieur de l'arène
+ *
+ * @param arena
+ * @param edge
+ * @param s
+ * @param len
+ */
+static void pose_mot_patricia(PatriciaArena *arena, PatriciaEdge *edge, const char *s, size_t len)
+{
+    if (len <= EDGE_INLINE)
+        memcpy(edge->inl, s, len);
+    else
+        edge->off = append_arena_patricia(arena, s, len);
+    edge->len = (uint32_t)len;
+}
 
-    int index = (unsigned char)(*word);
+/**
+ * @private
+ *
+ * @brief Fonction qui compte comme morts les octets d'arène d'une arête dont le préfixe va changer ou disparaître
+ *
+ * @param arena l'arène du noeud de l'arête
+ * @param edge
+ */
+static inline void lache_label_patricia(PatriciaArena *arena, const PatriciaEdge *edge)
+{
+    if (edge->len > EDGE_INLINE)
+        arena->dead += edge->len;
+}
 
-    if (node->prefixes[index] == NULL) {
-        return 0;
+/**
+ * @private
+ *
+ * @brief Fonction qui donne à @a dst le préfixe [@a from, @a from + @a len[ de l'arête @a src du noeud @a src_node
+ *
+ * Dans la même arène, un préfixe trop long pour être en ligne devient une tranche de celui de @a src, sans copie.
+ * @a src doit avoir été lâchée (@c lache_label_patricia) au préalable et peut être @a dst elle-même.
+ *
+ * @param arena l'arène du noeud de @a dst
+ * @param dst
+ * @param src_node
+ * @param src
+ * @param from
+ * @param len
+ */
+static void pose_label_patricia(PatriciaArena *arena, PatriciaEdge *dst, const PatriciaNode *src_node,
+                                const PatriciaEdge *src, uint32_t from, uint32_t len)
+{
+    const char *p = label_patricia(src_node, src) + from;
+    if (len <= EDGE_INLINE)
+        memmove(dst->inl, p, len);
+    else if (src_node->arena == arena)
+    {
+        dst->off = src->off + from;
+        arena->dead -= len;
     }
+    else
+        dst->off = append_arena_patricia(arena, p, len);
+    dst->len = len;
+}
 
-    int prefix_len = (int)strlen(node->prefixes[index]);
-    int common_prefix_len = plus_long_pref(node->prefixes[index], word);
-
-    if (common_prefix_len == prefix_len) {
-        if ((int)strlen(word) == prefix_len) {
-            return node->prefixes[EOE_INDEX] != NULL || node->children[index] == NULL;
-        }
-        return recherche_patricia(node->children[index], word + common_prefix_len);
+/**
+ * @private
+ *
+ * @brief Fonction qui crée un noeud vide dont les préfixes vivront dans l'arène donnée
+ *
+ * @param arena
+ * @return PatriciaNode*
+ */
+static PatriciaNode *new_node_patricia(PatriciaArena *arena)
+{
+    PatriciaNode *node = (PatriciaNode *)malloc(sizeof(PatriciaNode));
+    if (node == NULL)
+    {
+        fprintf(stderr, "Erreur d'allocation de mémoire: new_node_patricia\n");
+        exit(1);
     }
-
-
-    return 0;
+    node->type = NODE4;
+    node->count = 0;
+    node->end = false;
+    node->words = 0;
+    node->arena = arena;
+    node->edges = node->inline_edges;
+    node->index = NULL;
+    return node;
 }
 
-
 /**
- * @brief Fonction qui concatène deux chaînes de caractères
+ * @brief Fonction qui crée un nouveau noeud Patricia
  *
- * @param s1
- * @param s2
- * @return char*
+ * Le noeud est la racine d'un nouveau trie et possède sa propre arène, libérée avec lui par @c free_patricia_node.
+ *
+ * @return PatriciaNode*
  */
-char* string_concat(const char* s1, const char* s2) {
-    size_t len1 = strlen(s1);
-    size_t len2 = strlen(s2);
-    char* res = malloc(len1 + len2 + 1);
-    if (res == NULL) {
-        fprintf(stderr, "Erreur d'allocation de mémoire: string_concat\n");
+PatriciaNode *create_patricia_node(void){
+    PatriciaArena *arena = calloc(1, sizeof(*arena));
+    if(arena == NULL){
+        fprintf(stderr, "Erreur d'allocation de mémoire: create_patricia_node\n");
         exit(1);
     }
-    strcpy(res, s1);
-    strcat(res, s2);
-    return res;
+    arena->root = new_node_patricia(arena);
+    return arena->root;
 }
 
 /**
- * @brief Fonction qui libère la mémoire allouée pour un noeud Patricia
+ * @private
+ *
+ * @brief Corps de @c edge_patricia, forcé en ligne dans les parcours de ce fichier
+ *
+ * Sans cela, l'appel et l'aiguillage sur le type de noeud à chaque niveau coûtent plus cher que la recherche elle-même.
  *
  * @param node
+ * @param c
+ * @return PatriciaEdge* l'arête trouvée, NULL si absente
  */
-void free_patricia_node(PatriciaNode* node) {
-    if (node == NULL) {
-        return;
+static inline __attribute__((always_inline)) PatriciaEdge *trouve_edge_patricia(const PatriciaNode *node,
+                                                                                  unsigned char c)
+{
+    assert(c < ASCII_SIZE && "Seuls les caractères ASCII sont acceptés");
+    switch (node->type)
+    {
+    case NODE4:
+    case NODE16: {
+        unsigned mask = masque_keys_patricia(node, c, 0);
+        return mask ? &node->edges[__builtin_ctz(mask)] : NULL;
     }
-    for (int i = 0; i < ASCII_SIZE; i++) {
-        if (node->prefixes[i] != NULL) {
-            free(node->prefixes[i]);
-        }
-        if (node->children[i] != NULL) {
-            free_patricia_node(node->children[i]);
-        }
+    case NODE48:
+        return node->index[c] ? &node->edges[node->index[c] - 1] : NULL;
+    case NODE128:
+        return node->edges[c].len ? &node->edges[c] : NULL;
     }
-    free(node);
+    return NULL;
 }
 
 /**
- * @brief Fonction qui supprime un mot du Patricia-Trie
+ * @brief Fonction qui retourne l'arête d'un noeud commençant par le caractère donné
  *
  * @param node
- * @param word
- * @return int
+ * @param c
+ * @return PatriciaEdge* l'arête trouvée, NULL si absente
  */
-int delete_word(PatriciaNode* node, const char* word){
-    if (node == NULL) {
-        return 0;
-    }
+PatriciaEdge *edge_patricia(const PatriciaNode *node, unsigned char c)
+{
+    return trouve_edge_patricia(node, c);
+}
 
-    if(*word == '\0'){
-        if(node->prefixes[EOE_INDEX] != NULL){
-            free(node->prefixes[EOE_INDEX]);
-            node->prefixes[EOE_INDEX] = NULL;
-            return 1;
-        }
-        return 0;
-    }
+/**
+ * @brief Fonction qui ajoute une arête vide (préfixe et enfant nuls) pour le caractère donné
+ *
+ * Le noeud grandit vers le type supérieur s'il est plein. L'appelant doit renseigner le préfixe de l'arête retournée,
+ * une tranche non vide de l'arène du noeud.
+ *
+ * @param node
+ * @param c
+ * @return PatriciaEdge* l'arête ajoutée
+ */
+PatriciaEdge *add_edge_patricia(PatriciaNode *node, unsigned char c)
+{
+    assert(c < ASCII_SIZE && "Seuls les caractères ASCII sont acceptés");
+    assert(edge_patricia(node, c) == NULL && "L'arête ne doit pas déjà exister");
+    if (node->count == capacite_patricia[node->type])
+        change_type_patricia(node, node->type + 1);
 
-    int index = (unsigned char)(*word);
-    //printf("Comparing %s and %s\n Result: %d\n",word, node->prefixes[index], strcmp(word, node->prefixes[index]));//debug
-    if(node->prefixes[index] == NULL){
-        return 0;
-    }
-    if((strcmp(word, node->prefixes[index]) == 0) && node->children[index] == NULL){
-        free(node->prefixes[index]);
-        node->prefixes[index] = NULL;
-        return 1;
+    PatriciaEdge *edge;
+    switch (node->type)
+    {
+    case NODE4:
+    case NODE16: {
+        int pos = __builtin_popcount(masque_keys_patricia(node, c, -1));
+        memmove(node->keys + pos + 1, node->keys + pos, node->count - pos);
+        memmove(node->edges + pos + 1, node->edges + pos, (node->count - pos) * sizeof(*node->edges));
+        node->keys[pos] = c;
+        edge = &node->edges[pos];
+        break;
     }
-
-    else{
-        const char* s = suffixe(node->prefixes[index], word);
-        if(s == NULL){
-            return 0;
-        }
-        if(node->children[index] == NULL){
-            return 0;
-        }
-        int i = delete_word(node->children[index], s);
-        if(i == 0){
-            return 0;
-        }
-        int nb_enfant = 0;
-        int index_enfant = 0;
-        for(int i = 0; i < ASCII_SIZE; i++){
-            if(node->children[index]->prefixes[i] != NULL){
-                nb_enfant++;
-                index_enfant = i;
-            }
-        }
-
-        if(nb_enfant == 1){
-            if(index_enfant == EOE_INDEX){
-                free_patricia_node(node->children[index]);
-                node->children[index] = NULL;
-            }
-            else{
-                char* new_prefix = string_concat(node->prefixes[index], node->children[index]->prefixes[index_enfant]);
-                free(node->prefixes[index]);
-                free(node->children[index]->prefixes[index_enfant]);
-                node->prefixes[index] = new_prefix;
-                PatriciaNode* new_child = node->children[index]->children[index_enfant];
-                free(node->children[index]);
-                node->children[index] = new_child;
-            }
-        }
-        return 1;
+    case NODE48:
+        node->index[c] = node->count + 1;
+        edge = &node->edges[node->count];
+        break;
+    default:
+        edge = &node->edges[c];
+        break;
     }
-    return 0;
-
+    edge->off = 0;
+    edge->len = 0;
+    edge->child = NULL;
+    node->count++;
+    return edge;
 }
 
-
 /**
- * @brief Fonction qui compte le nombre de mots dans le Patricia-Trie
+ * @brief Fonction qui retire l'arête du caractère donné, sans libérer son enfant
+ *
+ * Le noeud rétrécit vers le type inférieur lorsqu'il devient suffisamment creux.
  *
  * @param node
- * @return int
+ * @param c
  */
-int comptage_mots_patricia(PatriciaNode* node) {
-    int count = 0;
-    for (int i = 0; i < ASCII_SIZE; i++) {
-        if(i == EOE_INDEX){
-            if(node->prefixes[i] != NULL){
-                count++;
+void remove_edge_patricia(PatriciaNode *node, unsigned char c)
+{
+    PatriciaEdge *edge = edge_patricia(node, c);
+    assert(edge != NULL && "L'arête à retirer doit exister");
+    switch (node->type)
+    {
+    case NODE4:
+    case NODE16: {
+        int pos = (int)(edge - node->edges);
+        memmove(node->keys + pos, node->keys + pos + 1, node->count - pos - 1);
+        memmove(node->edges + pos, node->edges + pos + 1, (node->count - pos - 1) * sizeof(*node->edges));
+        break;
+    }
+    case NODE48: {
+        /* Le dernier emplacement comble le trou pour garder les arêtes contiguës */
+        int slot = node->index[c] - 1;
+        int last = node->count - 1;
+        if (slot != last)
+        {
+            for (int k = 0; k < ASCII_SIZE; k++)
+            {
+                if (node->index[k] == last + 1)
+                {
+                    node->index[k] = slot + 1;
+                    break;
+                }
             }
+            node->edges[slot] = node->edges[last];
         }
-        else if (node->prefixes[i] != NULL && node->children[i] == NULL) {
-            count++;
-        }
-        if (node->children[i] != NULL) {
-            count += comptage_mots_patricia(node->children[i]);
-        }
+        node->index[c] = 0;
+        break;
     }
-    return count;
+    default:
+        edge->len = 0;
+        edge->child = NULL;
+        break;
+    }
+    node->count--;
+
+    if (node->count < seuil_patricia[node->type])
+        change_type_patricia(node, node->type - 1);
 }
 
 /**
- * @brief Fonction qui compte le nombre de pointeurs vers null dans le Patricia-Trie
+ * @brief Fonction qui parcourt les arêtes d'un noeud dans l'ordre croissant des caractères
+ *
+ * Retourne l'arête de plus petit caractère strictement supérieur à @a key et met à jour @a key avec ce caractère.
+ * Un parcours complet commence avec @a key à -1.
  *
  * @param node
- * @return int
+ * @param key
+ * @return PatriciaEdge* l'arête suivante, NULL s'il n'y en a plus
  */
-int comptage_nil_patricia(PatriciaNode* node) {
-    int count = 0;
-    for (int i = 0; i < ASCII_SIZE; i++) {
-        if (node->prefixes[i] == NULL) {
-            count++;
+PatriciaEdge *next_edge_patricia(const PatriciaNode *node, int *key)
+{
+    switch (node->type)
+    {
+    case NODE4:
+    case NODE16: {
+        unsigned mask = masque_keys_patricia(node, *key, 1);
+        if (!mask)
+            return NULL;
+        int i = __builtin_ctz(mask);
+        *key = node->keys[i];
+        return &node->edges[i];
+    }
+    case NODE48:
+        for (int c = *key + 1; c < ASCII_SIZE; c++)
+        {
+            if (node->index[c])
+            {
+                *key = c;
+                return &node->edges[node->index[c] - 1];
+            }
         }
-        if (node->children[i] != NULL) {
-            count += comptage_nil_patricia(node->children[i]);
+        return NULL;
+    case NODE128:
+        for (int c = *key + 1; c < ASCII_SIZE; c++)
+        {
+            if (node->edges[c].len)
+            {
+                *key = c;
+                return &node->edges[c];
+            }
         }
+        return NULL;
     }
-    return count;
+    return NULL;
 }
 
-int max(int a, int b) {
-    return (a > b) ? a : b;
-}
 
 /**
- * @brief Fonction qui retourne la hauteur du Patricia-Trie
+ * @brief Fonction qui retourne le préfixe d'une arête du noeud
+ *
+ * Le préfixe n'est pas terminé par un caractère nul, sa longueur est @c edge->len. Le pointeur n'est valable que
+ * jusqu'à la prochaine modification du trie.
  *
  * @param node
- * @return int
+ * @param edge
+ * @return const char*
  */
-int hauteur_patricia(PatriciaNode* node) {
-    int height = 0;
-    for (int i = 0; i < ASCII_SIZE; i++) {
-        if (node->children[i] != NULL) {
-            height = max(height, hauteur_patricia(node->children[i]));
-        }
-    }
-    return height + 1;
+const char *label_patricia(const PatriciaNode *node, const PatriciaEdge *edge)
+{
+    return edge->len <= EDGE_INLINE ? edge->inl : node->arena->buf + edge->off;
 }
 
 /**
- * @brief Fonction qui compte le nombre de mots dans le Patricia-Trie qui sont préfixes d'un mot donné
+ * @private
  *
- * @param node
- * @param word
- * @return int
+ * @brief Résultat de la comparaison du préfixe d'une arête avec un mot
  */
-int nb_prefixe_patricia(PatriciaNode* node, const char* word) {
-    if (node == NULL || *word == '\0') {
-        return 0;
-    }
+typedef struct LcpPatricia
+{
+    uint32_t len;   /**< Longueur du plus long préfixe commun */
+    bool fin_label; /**< Le préfixe de l'arête est entièrement commun, @c len vaut sa longueur */
+    bool fin_mot;   /**< Le mot se termine juste après la partie commune */
+} LcpPatricia;
 
-    int index = (unsigned char)(*word);
+/**
+ * @private
+ *
+ * @brief Nombre d'octets comparés à la fois par @c lcp_bloc_patricia
+ */
+#if defined(PATRICIA_AVX2)
+#define BLOC_PATRICIA 32u
+#elif defined(PATRICIA_SSE2)
+#define BLOC_PATRICIA 16u
+#else
+#define BLOC_PATRICIA 8u
+#endif
 
-    if (node->prefixes[index] == NULL) {
-    return 0;
-    }
-    int prefix = plus_long_pref(node->prefixes[index], word);
+/**
+ * @private
+ *
+ * @brief Huit octets lus d'un coup, sans contrainte d'alignement
+ */
+typedef uint64_t __attribute__((aligned(1), may_alias)) mot8_patricia;
 
-    if(est_prefixe(word, node->prefixes[index])){
-        if(node->children[index] == NULL){
-            return 1;
-        }
-        else{
-            return comptage_mots_patricia(node->children[index]);
-        }
-    }
-    if(prefix == (int)strlen(node->prefixes[index])){
-        if(node->children[index] == NULL){
-            return 1;
+/**
+ * @private
+ *
+ * @brief Fonction qui retourne vrai si un bloc peut être lu à partir de @a p sans franchir une frontière de page
+ *
+ * @param p
+ * @return bool
+ */
+static inline bool bloc_lisible_patricia(const char *p)
+{
+    return ((uintptr_t)p & 4095) <= 4096 - BLOC_PATRICIA;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui retourne la position du premier octet d'un bloc qui diffère entre @a a et @a b, ou qui est nul
+ * dans @a a si @a nul est vrai
+ *
+ * Avec AVX2 ou SSE2 les blocs sont comparés par une seule instruction qui donne un masque, sinon le ou exclusif de
+ * deux mots de 8 octets en tient lieu. Dans les deux cas le premier bit du masque donne la position cherchée.
+ *
+ * @param a
+ * @param b
+ * @param nul
+ * @return uint32_t la position trouvée, @c BLOC_PATRICIA si tout le bloc est commun
+ */
+static inline __attribute__((no_sanitize_address)) uint32_t diff_bloc_patricia(const char *a, const char *b, bool nul)
+{
+#if defined(PATRICIA_AVX2)
+    __m256i x = _mm256_loadu_si256((const __m256i *)a);
+    __m256i y = _mm256_loadu_si256((const __m256i *)b);
+    uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+    if (nul)
+        mask |= (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_setzero_si256()));
+    return mask ? (uint32_t)__builtin_ctz(mask) : BLOC_PATRICIA;
+#elif defined(PATRICIA_SSE2)
+    __m128i x = _mm_loadu_si128((const __m128i *)a);
+    __m128i y = _mm_loadu_si128((const __m128i *)b);
+    uint32_t mask = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) & 0xFFFF;
+    if (nul)
+        mask |= (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128()));
+    return mask ? (uint32_t)__builtin_ctz(mask) : BLOC_PATRICIA;
+#else
+    const uint64_t bas = 0x7F7F7F7F7F7F7F7Full;
+    uint64_t x = *(const mot8_patricia *)a;
+    uint64_t y = *(const mot8_patricia *)b;
+    uint64_t mask = x ^ y;
+    if (nul)
+        mask |= ~(((x & bas) + bas) | x | bas); /* 0x80 exactement sur les octets nuls de x */
+    if (!mask)
+        return BLOC_PATRICIA;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return (uint32_t)__builtin_ctzll(mask) / 8;
+#else
+    return (uint32_t)__builtin_clzll(mask) / 8;
+#endif
+#endif
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui retourne la longueur du plus long préfixe commun de @a a et @a b, bornée par @a len
+ *
+ * Sans @a nul, la comparaison ne s'arrête que sur une différence ou à @a len : c'est le cas d'un préfixe d'arête, qui
+ * ne contient jamais de caractère nul, comparé à un mot. Avec @a nul elle s'arrête aussi à la fin de @a a.
+ *
+ * Les blocs peuvent être lus au-delà de la fin des chaînes, mais jamais au-delà d'une frontière de page : près d'une
+ * telle frontière le bloc est comparé octet par octet. Ces lectures ne peuvent donc pas fauter, mais elles sortent des
+ * objets et la fonction est soustraite à AddressSanitizer.
+ *
+ * @param a
+ * @param b
+ * @param len
+ * @param nul
+ * @return uint32_t
+ */
+static inline __attribute__((no_sanitize_address)) uint32_t lcp_bloc_patricia(const char *a, const char *b,
+                                                                             uint32_t len, bool nul)
+{
+    uint32_t i = 0;
+    while (i < len)
+    {
+        uint32_t d = 0;
+        if (bloc_lisible_patricia(a + i) && bloc_lisible_patricia(b + i))
+            d = diff_bloc_patricia(a + i, b + i, nul);
+        else
+        {
+            while (d < BLOC_PATRICIA && i + d < len && a[i + d] == b[i + d] && !(nul && a[i + d] == '\0'))
+                d++;
         }
-        return nb_prefixe_patricia(node->children[index], word + prefix);
+        i += d;
+        if (d < BLOC_PATRICIA)
+            break;
     }
+    return i < len ? i : len;
+}
 
-    return 0;
+/**
+ * @private
+ *
+ * @brief Fonction qui compare le préfixe d'une arête, rangé dans l'arène, à un mot
+ *
+ * @param label
+ * @param len
+ * @param word
+ * @return LcpPatricia
+ */
+static inline LcpPatricia lcp_patricia(const char *label, uint32_t len, const char *word)
+{
+    uint32_t i = lcp_bloc_patricia(label, word, len, false);
+    return (LcpPatricia){i, i == len, word[i] == '\0'};
 }
 
 /**
- * @brief Fonction qui retourne vrai si un mot est préfixe d'un autre mot
+ * @private
+ *
+ * @brief Quatre octets lus d'un coup, sans contrainte d'alignement
+ */
+typedef uint32_t __attribute__((aligned(1), may_alias)) mot4_patricia;
+
+/**
+ * @private
+ *
+ * @brief Fonction qui lit les quatre premiers octets d'un mot, même s'il est plus court
+ *
+ * Les octets qui suivent la fin du mot ne servent qu'à remplir le registre, ils sont ignorés par l'appelant. Comme
+ * pour @c lcp_bloc_patricia, la lecture ne franchit jamais une frontière de page et est soustraite à AddressSanitizer.
+ *
+ * @param word
+ * @return uint32_t
+ */
+static inline __attribute__((no_sanitize_address)) uint32_t charge_mot_patricia(const char *word)
+{
+    if (((uintptr_t)word & 4095) <= 4096 - sizeof(uint32_t))
+        return *(const mot4_patricia *)word;
+    char buf[sizeof(uint32_t)] = {0};
+    for (size_t i = 0; i < sizeof(buf) && word[i]; i++)
+        buf[i] = word[i];
+    uint32_t w;
+    memcpy(&w, buf, sizeof(w));
+    return w;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui compare le préfixe d'une arête à un mot
+ *
+ * C'est par ici que passent tous les parcours d'arêtes. Un préfixe en ligne est comparé en une seule fois : le premier
+ * octet différent, au plus tard le caractère nul du mot, est donné par le premier bit non nul du ou exclusif. Un
+ * préfixe plus long est comparé par blocs avec @c lcp_bloc_patricia.
+ *
+ * @param node
+ * @param edge
+ * @param word
+ * @return LcpPatricia
+ */
+static inline LcpPatricia lcp_edge_patricia(const PatriciaNode *node, const PatriciaEdge *edge, const char *word)
+{
+    if (edge->len > EDGE_INLINE)
+        return lcp_patricia(node->arena->buf + edge->off, edge->len, word);
+    uint32_t label;
+    memcpy(&label, edge->inl, sizeof(label));
+    uint32_t diff = label ^ charge_mot_patricia(word);
+    uint32_t i;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (edge->len < sizeof(diff))
+        diff &= (1u << (8 * edge->len)) - 1;
+    i = diff ? (uint32_t)__builtin_ctz(diff) / 8 : edge->len;
+#else
+    if (edge->len < sizeof(diff))
+        diff &= ~0u << (8 * (sizeof(diff) - edge->len));
+    i = diff ? (uint32_t)__builtin_clz(diff) / 8 : edge->len;
+#endif
+    return (LcpPatricia){i, i == edge->len, word[i] == '\0'};
+}
+
+/**
+ * @brief Fonction qui retourne le suffixe d'un mot qui est prefixe d'un autre mot
  *
  * @param s1
  * @param s2
- * @return int
+ * @return const char*
  */
-int est_prefixe(const char* s1, const char* s2){
-    int i = 0;
-    while(s1[i] && s2[i] && s1[i] == s2[i]){
-        i++;
+const char* suffixe(const char* s1, const char* s2){
+    if(s1 == NULL || s2 == NULL){
+        return NULL;
+    }
+    uint32_t i = lcp_bloc_patricia(s1, s2, UINT32_MAX, true);
+    if(s1[i] == '\0'){
+        return s2 + i;
+    }
+    else{
+        return NULL;
     }
-    return s1[i] == '\0';
 }
 
+/**
+ * @private
+ *
+ * @brief Fonction qui renvoie le nombre de mots sous une arête, une feuille comptant pour un mot
+ *
+ * @param edge
+ * @return uint32_t
+ */
+static inline uint32_t mots_edge_patricia(const PatriciaEdge* edge) {
+    return edge->child != NULL ? edge->child->words : 1;
+}
 
 /**
- * @brief Fonction qui retourne la liste des mots dans le Patricia-Trie
+ * @private
+ *
+ * @brief Fonction qui recalcule le nombre de mots d'un noeud à partir de ses arêtes
  *
  * @param node
- * @return char**
  */
-char** liste_mots_patricia(PatriciaNode* node) {
-    static char* res[MAX_WORDS];
-    static int index = 0;
-    index = 0;
-
-    liste_mots_patricia_recursive(node, "", res, &index);
-
-    return res;
+static void recompte_patricia(PatriciaNode* node) {
+    uint32_t words = node->end;
+    int key = -1;
+    const PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        words += mots_edge_patricia(edge);
+    }
+    node->words = words;
 }
 
-void liste_mots_patricia_recursive(PatriciaNode* node, const char* prefix, char** res, int* index) {
-    for (int i = 0; i < ASCII_SIZE; i++) {
-        if (node->prefixes[i] != NULL) {
+/**
+ * @private
+ *
+ * @brief Fonction qui ajoute un mot au nombre de mots des noeuds du chemin d'un mot, jusqu'à @a fin exclu
+ *
+ * @param node
+ * @param word
+ * @param fin le noeud du chemin où le mot vient d'être ajouté
+ */
+static void compte_chemin_patricia(PatriciaNode* node, const char* word, const PatriciaNode* fin) {
+    while (node != fin) {
+        node->words++;
+        PatriciaEdge* edge = trouve_edge_patricia(node, (unsigned char)*word);
+        word += edge->len;
+        node = edge->child;
+    }
+}
 
-            char new_prefix[MAX_WORD_LENGTH];
+/**
+ * @private
+ *
+ * @brief Corps de @c insert_patricia, sans toucher aux nombres de mots des noeuds traversés
+ *
+ * @param patricia
+ * @param word
+ * @return PatriciaNode* le noeud du chemin où le mot a été ajouté, dont le nombre de mots est à jour, NULL si le mot
+ * était déjà présent
+ */
+static PatriciaNode* insere_patricia(PatriciaNode* patricia, const char* word) {
+    if (*word == '\0') {
+        if (patricia->end) {
+            return NULL;
+        }
+        patricia->end = true;
+        patricia->words++;
+        return patricia;
+    }
 
-            if(i != EOE_INDEX){
-                snprintf(new_prefix, MAX_WORD_LENGTH, "%s%s", prefix, node->prefixes[i]);
-            }
-            else{
-                snprintf(new_prefix, MAX_WORD_LENGTH, "%s%c", prefix, '\0');
-            }
+    int index = (unsigned char)(*word);
+    PatriciaEdge* edge = trouve_edge_patricia(patricia, index);
 
-            if (node->children[i] == NULL || node->prefixes[EOE_CHAR] != NULL) {
-                res[*index] = strdup(new_prefix);
-                (*index)++;
-            }
+    if (edge == NULL) {
+        edge = add_edge_patricia(patricia, index);
+        pose_mot_patricia(patricia->arena, edge, word, strlen(word));
+        patricia->words++;
+        return patricia;
+    }
 
-            if (node->children[i] != NULL) {
+    LcpPatricia lcp = lcp_edge_patricia(patricia, edge, word);
+    int prefix_commun = (int)lcp.len;
 
-                liste_mots_patricia_recursive(node->children[i], new_prefix, res, index);
+    if (lcp.fin_label) {
+        if (edge->child == NULL) {
+            if (lcp.fin_mot) {
+                return NULL;
             }
+            edge->child = new_node_patricia(patricia->arena);
+            edge->child->end = true;
+            edge->child->words = 1;
         }
+        return insere_patricia(edge->child, word + prefix_commun);
     }
-}
 
-void print_list_patricia(char** list, int size) {
-    printf("[ ");
-    for (int i = 0; i < size-1; i++) {
-        printf("%s, ", list[i]);
-    }
-    printf("%s ]\n", list[size-1]);
+    PatriciaNode* new_child = new_node_patricia(patricia->arena);
+    new_child->words = mots_edge_patricia(edge);
 
+    lache_label_patricia(patricia->arena, edge);
+    PatriciaEdge* split = add_edge_patricia(new_child, (unsigned char)label_patricia(patricia, edge)[prefix_commun]);
+    pose_label_patricia(patricia->arena, split, patricia, edge, prefix_commun, edge->len - prefix_commun);
+    split->child = edge->child;
+    pose_label_patricia(patricia->arena, edge, patricia, edge, 0, prefix_commun);
+    edge->child = new_child;
+
+    /* Le mot s'arrête sur la coupure ou y bifurque, il est nouveau dans les deux cas */
+    return insere_patricia(new_child, word + prefix_commun);
 }
 
-void free_list_patricia(char** list, int size) {
-    for (int i = 0; i < size; i++) {
-        free(list[i]);
+/**
+ * @brief Fonction qui insère un mot dans le Patricia-Trie
+ *
+ * Seule une nouvelle feuille au préfixe trop long pour être en ligne copie des octets dans l'arène, couper une arête
+ * existante en deux crée deux tranches de son préfixe.
+ *
+ * La descente ne touche pas aux nombres de mots, un mot déjà présent (le cas courant sur un texte) ne coûte donc
+ * qu'une recherche. Quand le mot est nouveau, le chemin est reparcouru pour ajouter un mot à chacun de ses noeuds.
+ *
+ * @param root
+ * @param word
+ */
+void insert_patricia(PatriciaNode* patricia, const char* word) {
+    PatriciaNode* fin = insere_patricia(patricia, word);
+    if (fin != NULL) {
+        compte_chemin_patricia(patricia, word, fin);
     }
 }
 
 /**
- * @brief Fonction qui affiche le Patricia-Trie
+* @brief Fonction qui retourne la longueur du plus long prefixe commun entre deux mots
+*
+* @param s1
+* @param s2
+* @return int
+ */
+int plus_long_pref(const char *s1, const char *s2) {
+    return (int)lcp_bloc_patricia(s1, s2, UINT32_MAX, true);
+}
+
+
+/**
+ * @brief Fonction qui recherche un mot dans le Patricia-Trie
  *
  * @param node
- * @param depth
+ * @param word
+ * @return int
  */
-void print_patricia(PatriciaNode* node, int depth) {
+int recherche_patricia(PatriciaNode* node, const char* word) {
     if (node == NULL) {
-        return;
+        return 0;
     }
 
-    for (int i = 0; i < ASCII_SIZE; i++) {
-        if (node->prefixes[i] != NULL) {
-            for (int j = 0; j < depth; j++) {
-                printf("  ");
-            }
-            if (i == EOE_INDEX) {
-                printf("%c: %s\n", EOE_CHAR, node->prefixes[i]);
-            } else {
-            printf("%c: %s\n", i, node->prefixes[i]);}
-            print_patricia(node->children[i], depth + 1);
+    if (*word == '\0') {
+        return node->end;
+    }
+
+    int index = (unsigned char)(*word);
+    PatriciaEdge* edge = trouve_edge_patricia(node, index);
+
+    if (edge == NULL) {
+        return 0;
+    }
+
+    LcpPatricia lcp = lcp_edge_patricia(node, edge, word);
+
+    if (lcp.fin_label) {
+        if (lcp.fin_mot) {
+            return edge->child == NULL || edge->child->end;
         }
+        return recherche_patricia(edge->child, word + lcp.len);
     }
+
+
+    return 0;
 }
 
 /**
- * @brief Fonction qui retourne la profondeur moyenne des feuilles du Patricia-Trie
+ * @brief Fonction qui retourne la longueur du plus long mot du Patricia-Trie qui est préfixe du texte
+ *
+ * Une seule descente : chaque arête est comparée d'un bloc au texte et la dernière fin de mot rencontrée donne la
+ * réponse. Le mot trouvé est le début du texte, il n'est pas recopié.
  *
  * @param node
- * @return float
+ * @param text
+ * @return int la longueur du mot, -1 si aucun mot n'est préfixe du texte (0 pour le mot vide)
  */
-float profondeur_moyenne_patricia_feuille(PatriciaNode* node){
-    int sum = 0;
-    int nbFeuilles = 0;
-
-    calcule_profondeur_moyenne_patricia_feuille(node, 0, &sum, &nbFeuilles);
-    if(nbFeuilles == 0){
-        return 0;
-    }
-    else {
-        return sum / nbFeuilles;
+int longest_prefix_patricia(const PatriciaNode* node, const char* text) {
+    int best = -1;
+    uint32_t len = 0;
+    while (node != NULL) {
+        if (node->end) {
+            best = (int)len;
+        }
+        if (text[len] == '\0') {
+            break;
+        }
+        PatriciaEdge* edge = trouve_edge_patricia(node, (unsigned char)text[len]);
+        if (edge == NULL) {
+            break;
+        }
+        LcpPatricia lcp = lcp_edge_patricia(node, edge, text + len);
+        if (!lcp.fin_label) {
+            break;
+        }
+        len += lcp.len;
+        if (edge->child == NULL) {
+            best = (int)len;
+        }
+        node = edge->child;
     }
+    return best;
 }
 
-void calcule_profondeur_moyenne_patricia_feuille(PatriciaNode* node, int profondeur, int* sum, int* nbFeuilles){
-    if(node == NULL){
-        return;
-    }
+/**
+ * @private
+ *
+ * @brief Le nombre de recherches de @c recherche_batch_patricia menées de front
+ */
+#define BATCH_PATRICIA 16
 
-    for(int i = 0; i < ASCII_SIZE; i++){
-        if(node->prefixes[i] != NULL){
-            if(node->children[i] == NULL){
-                *sum += profondeur + 1;
-                (*nbFeuilles)++;
+/**
+ * @private
+ *
+ * @brief Une recherche en cours de @c recherche_batch_patricia : le noeud à visiter, déjà demandé à la mémoire, et
+ * le reste du mot
+ */
+typedef struct BatchPatricia {
+    const PatriciaNode *node;
+    const char *word;
+    size_t i;
+} BatchPatricia;
+
+/**
+ * @brief Fonction qui recherche un lot de mots dans le Patricia-Trie
+ *
+ * Les recherches avancent d'une arête chacune à tour de rôle et demandent le noeud suivant à la mémoire
+ * (@c __builtin_prefetch) avant de céder la place : les défauts de cache des différents mots se recouvrent au lieu
+ * de s'additionner. Sur un trie qui tient dans le cache, @c recherche_patricia en boucle reste aussi rapide.
+ *
+ * @param node
+ * @param words un tableau de @c n mots
+ * @param n
+ * @param results un tableau de @c n entiers, @c results[i] reçoit @c recherche_patricia(node, words[i])
+ */
+void recherche_batch_patricia(const PatriciaNode* node, const char* const* words, size_t n, int* results) {
+    BatchPatricia live[BATCH_PATRICIA];
+    size_t active = 0, next = 0;
+    while (active > 0 || next < n) {
+        while (active < BATCH_PATRICIA && next < n) {
+            if (node == NULL) {
+                results[next++] = 0;
+                continue;
             }
-            else{
-                calcule_profondeur_moyenne_patricia_feuille(node->children[i], profondeur + 1, sum, nbFeuilles);
+            __builtin_prefetch(node);
+            live[active++] = (BatchPatricia){node, words[next], next};
+            next++;
+        }
+        for (size_t k = 0; k < active;) {
+            BatchPatricia* b = &live[k];
+            int found = -1;
+            if (*b->word == '\0') {
+                found = b->node->end;
+            } else {
+                PatriciaEdge* edge = trouve_edge_patricia(b->node, (unsigned char)*b->word);
+                LcpPatricia lcp = {0, false, false};
+                if (edge != NULL) {
+                    lcp = lcp_edge_patricia(b->node, edge, b->word);
+                }
+                if (!lcp.fin_label) {
+                    found = 0;
+                } else if (lcp.fin_mot) {
+                    found = edge->child == NULL || edge->child->end;
+                } else if (edge->child == NULL) {
+                    found = 0;
+                } else {
+                    b->node = edge->child;
+                    b->word += lcp.len;
+                }
+            }
+            if (found >= 0) {
+                results[b->i] = found;
+                *b = live[--active];
+            } else {
+                /* L'entête et les arêtes en ligne d'un NODE4 s'étendent sur deux lignes de cache */
+                __builtin_prefetch(b->node);
+                __builtin_prefetch((const char*)b->node + 64);
+                k++;
             }
         }
     }
 }
 
 /**
- * @brief Fonction helper pour fusionner deux Patricia-Tries
+ * @private
  *
- * @param s1
- * @param s2
- * @param x
- * @param y
- * @param z
+ * @brief Fonction qui libère un sous-arbre, sans toucher à l'arène
+ *
+ * @param node
  */
-void prefixe_fusion(const char* s1, const char* s2, char* x, char* y, char* z){
-    int prefix_len = plus_long_pref(s1, s2);
-    strncpy(x, s1, prefix_len);
-    x[prefix_len] = '\0';
-    strcpy(y, s1 + prefix_len);
-    strcpy(z, s2 + prefix_len);
+static void free_subtree_patricia(PatriciaNode* node) {
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        if (edge->child != NULL) {
+            free_subtree_patricia(edge->child);
+        }
+    }
+    free_shell_patricia(node);
 }
+
 /**
- * @brief Fonction creer un nouveau noeud Patricia, word devient le prefixe et node l'enfant
+ * @private
  *
- * @param s1
- * @param s2
- * @return char*
+ * @brief Fonction qui libère une arène et ses préfixes
+ *
+ * @param arena
+ */
+static void free_arena_patricia(PatriciaArena* arena) {
+    free(arena->buf);
+    free(arena);
+}
+
+/**
+ * @brief Fonction qui libère la mémoire allouée pour un noeud Patricia
+ *
+ * L'arène des préfixes est libérée avec la racine du trie.
+ *
+ * @param node
+ */
+void free_patricia_node(PatriciaNode* node) {
+    if (node == NULL) {
+        return;
+    }
+    PatriciaArena* arena = node->arena;
+    free_subtree_patricia(node);
+    if (arena->root == node) {
+        free_arena_patricia(arena);
+    }
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui recopie les préfixes d'un sous-arbre dans l'arène, dans l'ordre du parcours
+ *
+ * @param node
+ * @param old l'ancien tampon de l'arène
+ */
+static void compacte_rec_patricia(PatriciaNode* node, const char* old) {
+    PatriciaArena* arena = node->arena;
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        if (edge->len > EDGE_INLINE) {
+            memcpy(arena->buf + arena->size, old + edge->off, edge->len);
+            edge->off = arena->size;
+            arena->size += edge->len;
+        }
+        if (edge->child != NULL) {
+            compacte_rec_patricia(edge->child, old);
+        }
+    }
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui débarrasse l'arène des octets qui n'appartiennent plus à aucune arête
+ *
+ * Appelée lorsque ces octets sont majoritaires, le coût de la recopie est ainsi amorti sur les suppressions qui les
+ * ont produits.
+ *
+ * @param arena
+ */
+static void compacte_arena_patricia(PatriciaArena* arena) {
+    char* old = arena->buf;
+    uint32_t live = arena->size - arena->dead;
+    arena->buf = NULL;
+    arena->size = arena->cap = arena->dead = 0;
+    if (live > 0) {
+        reserve_arena_patricia(arena, live);
+        arena->size = 0;
+        compacte_rec_patricia(arena->root, old);
+    }
+    assert(arena->size == live && "Tous les préfixes vivants doivent être recopiés");
+    free(old);
+}
+
+/**
+ * @brief Fonction qui supprime un mot du Patricia-Trie
+ *
+ * Chaque noeud traversé perd un mot quand le mot était présent. Recoller une arête à celle de son unique enfant ne
+ * change pas les nombres de mots.
+ *
+ * @param node
+ * @param word
+ * @return int
+ */
+int delete_word(PatriciaNode* node, const char* word){
+    if (node == NULL) {
+        return 0;
+    }
+
+    if(*word == '\0'){
+        if(node->end){
+            node->end = false;
+            node->words--;
+            return 1;
+        }
+        return 0;
+    }
+
+    int index = (unsigned char)(*word);
+    PatriciaEdge* edge = edge_patricia(node, index);
+    if(edge == NULL){
+        return 0;
+    }
+    int prefix_len = (int)edge->len;
+    LcpPatricia lcp = lcp_edge_patricia(node, edge, word);
+    if(!lcp.fin_label){
+        return 0;
+    }
+    if(lcp.fin_mot && edge->child == NULL){
+        lache_label_patricia(node->arena, edge);
+        remove_edge_patricia(node, index);
+    }
+
+    else{
+        if(edge->child == NULL){
+            return 0;
+        }
+        int i = delete_word(edge->child, word + prefix_len);
+        if(i == 0){
+            return 0;
+        }
+        PatriciaNode* child = edge->child;
+
+        if(child->count == 0 && child->end){
+            free_shell_patricia(child);
+            edge->child = NULL;
+        }
+        else if(child->count == 1 && !child->end){
+            int index_enfant = -1;
+            PatriciaEdge* seul = next_edge_patricia(child, &index_enfant);
+            PatriciaArena* arena = node->arena;
+            uint32_t len = edge->len + seul->len;
+            if(len <= EDGE_INLINE){
+                memcpy(edge->inl + edge->len, seul->inl, seul->len);
+            }
+            else if(edge->len <= EDGE_INLINE || seul->len <= EDGE_INLINE || edge->off + edge->len != seul->off){
+                /* Les deux préfixes ne sont pas des tranches voisines, le préfixe recollé est recopié à la fin de
+                   l'arène */
+                lache_label_patricia(arena, edge);
+                lache_label_patricia(arena, seul);
+                uint32_t off = reserve_arena_patricia(arena, len);
+                memcpy(arena->buf + off, label_patricia(node, edge), edge->len);
+                memcpy(arena->buf + off + edge->len, label_patricia(child, seul), seul->len);
+                edge->off = off;
+            }
+            edge->len = len;
+            edge->child = seul->child;
+            free_shell_patricia(child);
+        }
+    }
+
+    node->words--;
+    PatriciaArena* arena = node->arena;
+    if(node == arena->root && arena->dead > arena->size / 2){
+        compacte_arena_patricia(arena);
+    }
+    return 1;
+}
+
+
+/**
+ * @brief Fonction qui compte le nombre de mots dans le Patricia-Trie
+ *
+ * Le nombre de mots est gardé dans chaque noeud, il est lu en O(1).
+ *
+ * @param node
+ * @return int
+ */
+int comptage_mots_patricia(PatriciaNode* node) {
+    return (int)node->words;
+}
+
+/**
+ * @brief Fonction qui compte le nombre de pointeurs vers null dans le Patricia-Trie
+ *
+ * La marque de fin de mot occupe un emplacement, comme le caractère nul d'une table de 128 enfants.
+ *
+ * @param node
+ * @return int
+ */
+int comptage_nil_patricia(PatriciaNode* node) {
+    int count = ASCII_SIZE - node->count - node->end;
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        if (edge->child != NULL) {
+            count += comptage_nil_patricia(edge->child);
+        }
+    }
+    return count;
+}
+
+int max(int a, int b) {
+    return (a > b) ? a : b;
+}
+
+/**
+ * @brief Fonction qui retourne la hauteur du Patricia-Trie
+ *
+ * @param node
+ * @return int
+ */
+int hauteur_patricia(PatriciaNode* node) {
+    int height = 0;
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        if (edge->child != NULL) {
+            height = max(height, hauteur_patricia(edge->child));
+        }
+    }
+    return height + 1;
+}
+
+/**
+ * @brief Fonction qui compte le nombre de mots dans le Patricia-Trie qui sont préfixes d'un mot donné
+ *
+ * Seul le chemin du mot est parcouru, le compte est lu dans le noeud où il s'arrête.
+ *
+ * @param node
+ * @param word
+ * @return int
+ */
+int nb_prefixe_patricia(PatriciaNode* node, const char* word) {
+    if (node == NULL || *word == '\0') {
+        return 0;
+    }
+
+    int index = (unsigned char)(*word);
+    PatriciaEdge* edge = trouve_edge_patricia(node, index);
+
+    if (edge == NULL) {
+    return 0;
+    }
+    LcpPatricia lcp = lcp_edge_patricia(node, edge, word);
+    int prefix = (int)lcp.len;
+
+    if(lcp.fin_mot){
+        if(edge->child == NULL){
+            return 1;
+        }
+        else{
+            return (int)edge->child->words;
+        }
+    }
+    if(lcp.fin_label){
+        if(edge->child == NULL){
+            return 1;
+        }
+        return nb_prefixe_patricia(edge->child, word + prefix);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Fonction qui compte les mots du Patricia-Trie qui précèdent un mot donné dans l'ordre alphabétique
+ *
+ * Seul le chemin du mot est parcouru : à chaque noeud, les arêtes de plus petit caractère sont comptées par le nombre
+ * de mots de leur enfant, en O(σ) pour le noeud, sans descendre dans leurs sous-arbres.
+ *
+ * @param node
+ * @param word un mot, présent ou non dans le trie
+ * @return int le nombre de mots strictement inférieurs à @a word, sa position dans @c liste_mots_patricia s'il est
+ * présent
+ */
+int rank_patricia(PatriciaNode* node, const char* word) {
+    uint32_t rang = 0;
+    while (node != NULL && *word != '\0') {
+        /* Un mot qui se termine sur le noeud est un préfixe strict du mot */
+        rang += node->end;
+        int c = (unsigned char)(*word);
+        int key = -1;
+        const PatriciaEdge* edge;
+        while ((edge = next_edge_patricia(node, &key)) != NULL && key < c) {
+            rang += mots_edge_patricia(edge);
+        }
+        if (edge == NULL || key != c) {
+            break;
+        }
+        LcpPatricia lcp = lcp_edge_patricia(node, edge, word);
+        if (!lcp.fin_label) {
+            /* Le mot s'arrête ou bifurque dans le préfixe de l'arête, qui le précède tout entière ou le suit */
+            if (!lcp.fin_mot && (unsigned char)label_patricia(node, edge)[lcp.len] < (unsigned char)word[lcp.len]) {
+                rang += mots_edge_patricia(edge);
+            }
+            break;
+        }
+        if (edge->child == NULL) {
+            /* La feuille est le mot lui-même ou l'un de ses préfixes stricts */
+            rang += !lcp.fin_mot;
+            break;
+        }
+        node = edge->child;
+        word += lcp.len;
+    }
+    return (int)rang;
+}
+
+/**
+ * @brief Fonction qui retourne le mot de rang donné dans l'ordre alphabétique du Patricia-Trie
+ *
+ * C'est l'inverse de @c rank_patricia. Le chemin du mot est trouvé en comparant @a k aux nombres de mots des arêtes,
+ * en O(σ) par noeud traversé, sans construire la liste de tous les mots.
+ *
+ * @param node
+ * @param k le rang du mot, à partir de 0
+ * @return char* une copie du mot à libérer avec @c free, NULL si le trie a au plus @a k mots
+ */
+char* select_patricia(PatriciaNode* node, int k) {
+    if (k < 0 || (uint32_t)k >= node->words) {
+        return NULL;
+    }
+    uint32_t reste = (uint32_t)k;
+    size_t size = 0, cap = MAX_WORD_LENGTH;
+    char* mot = malloc(cap);
+    if (mot == NULL) {
+        fprintf(stderr, "Erreur d'allocation de mémoire: select_patricia\n");
+        exit(1);
+    }
+    while (node != NULL) {
+        if (node->end) {
+            if (reste == 0) {
+                break;
+            }
+            reste--;
+        }
+        int key = -1;
+        const PatriciaEdge* edge;
+        while ((edge = next_edge_patricia(node, &key)) != NULL && reste >= mots_edge_patricia(edge)) {
+            reste -= mots_edge_patricia(edge);
+        }
+        assert(edge != NULL && "Le rang est inférieur au nombre de mots du noeud");
+        if (size + edge->len + 1 > cap) {
+            cap = 2 * (size + edge->len + 1);
+            char* tmp = realloc(mot, cap);
+            if (tmp == NULL) {
+                fprintf(stderr, "Erreur d'allocation de mémoire: select_patricia\n");
+                exit(1);
+            }
+            mot = tmp;
+        }
+        memcpy(mot + size, label_patricia(node, edge), edge->len);
+        size += edge->len;
+        node = edge->child;
+    }
+    mot[size] = '\0';
+    return mot;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui parcourt les arêtes d'un noeud dans l'ordre décroissant des caractères
+ *
+ * Le pendant de @c next_edge_patricia : retourne l'arête de plus grand caractère strictement inférieur à @a key et
+ * met à jour @a key avec ce caractère. Un parcours complet commence avec @a key à @c ASCII_SIZE.
+ *
+ * @param node
+ * @param key
+ * @return PatriciaEdge* l'arête précédente, NULL s'il n'y en a plus
+ */
+static PatriciaEdge *prev_edge_patricia(const PatriciaNode *node, int *key)
+{
+    switch (node->type)
+    {
+    case NODE4:
+    case NODE16: {
+        /* ASCII_SIZE ne tient pas dans un caractère signé, toutes les clés lui sont inférieures */
+        unsigned mask = *key >= ASCII_SIZE ? (1u << node->count) - 1 : masque_keys_patricia(node, *key, -1);
+        if (!mask)
+            return NULL;
+        int i = 31 - __builtin_clz(mask);
+        *key = node->keys[i];
+        return &node->edges[i];
+    }
+    case NODE48:
+        for (int c = *key - 1; c >= 0; c--)
+        {
+            if (node->index[c])
+            {
+                *key = c;
+                return &node->edges[node->index[c] - 1];
+            }
+        }
+        return NULL;
+    case NODE128:
+        for (int c = *key - 1; c >= 0; c--)
+        {
+            if (node->edges[c].len)
+            {
+                *key = c;
+                return &node->edges[c];
+            }
+        }
+        return NULL;
+    }
+    return NULL;
+}
+
+/**
+ * @private
+ *
+ * @brief Un noeud du chemin du mot courant d'un curseur
+ *
+ * @c key vaut -2 avant la fin de mot du noeud, -1 sur elle, le caractère de l'arête suivie, ou @c ASCII_SIZE après la
+ * dernière arête.
+ */
+typedef struct CadrePatricia {
+    const PatriciaNode *node;
+    int key;
+    uint32_t base; /**< Longueur du mot courant à l'entrée du noeud */
+} CadrePatricia;
+
+struct PatriciaCursor {
+    const PatriciaNode *root;
+    CadrePatricia *frames;   /**< Le chemin du mot courant */
+    size_t depth;
+    size_t frames_cap;
+    char *word;              /**< Le mot courant, réutilisé d'un mot à l'autre */
+    uint32_t len;
+    uint32_t word_cap;
+    const char *lo;          /**< Borne inférieure incluse, NULL si aucune */
+    const char *hi;          /**< Borne supérieure exclue, NULL si aucune */
+    int bout;                /**< -1 avant le premier mot, 1 après le dernier, 0 sinon */
+};
+
+/**
+ * @brief Fonction qui ouvre un curseur sur le Patricia-Trie, sans le parcourir
+ *
+ * Le curseur est hors du trie : @c cursor_next_patricia donne alors le premier mot, @c cursor_prev_patricia le
+ * dernier. Les mots rendus par le curseur sont empruntés à un tampon réutilisé, valables jusqu'au déplacement suivant.
+ * Le curseur est invalidé par toute modification du trie.
+ *
+ * @param root
+ * @return PatriciaCursor* le curseur, à libérer avec @c cursor_close_patricia
+ */
+PatriciaCursor* cursor_open_patricia(const PatriciaNode* root) {
+    PatriciaCursor* cursor = malloc(sizeof(*cursor));
+    if (cursor == NULL) {
+        fprintf(stderr, "Erreur d'allocation de mémoire: cursor_open_patricia\n");
+        exit(1);
+    }
+    cursor->root = root;
+    cursor->depth = 0;
+    cursor->frames_cap = 16;
+    cursor->frames = malloc(cursor->frames_cap * sizeof(*cursor->frames));
+    cursor->len = 0;
+    cursor->word_cap = MAX_WORD_LENGTH;
+    cursor->word = malloc(cursor->word_cap);
+    if (cursor->frames == NULL || cursor->word == NULL) {
+        fprintf(stderr, "Erreur d'allocation de mémoire: cursor_open_patricia\n");
+        exit(1);
+    }
+    cursor->lo = NULL;
+    cursor->hi = NULL;
+    cursor->bout = 0;
+    return cursor;
+}
+
+void cursor_close_patricia(PatriciaCursor* cursor) {
+    if (cursor == NULL) {
+        return;
+    }
+    free(cursor->frames);
+    free(cursor->word);
+    free(cursor);
+}
+
+static void push_cursor_patricia(PatriciaCursor* cursor, const PatriciaNode* node, int key) {
+    if (cursor->depth == cursor->frames_cap) {
+        cursor->frames_cap *= 2;
+        CadrePatricia* tmp = realloc(cursor->frames, cursor->frames_cap * sizeof(*tmp));
+        if (tmp == NULL) {
+            fprintf(stderr, "Erreur d'allocation de mémoire: push_cursor_patricia\n");
+            exit(1);
+        }
+        cursor->frames = tmp;
+    }
+    cursor->frames[cursor->depth++] = (CadrePatricia){node, key, cursor->len};
+}
+
+/* Ajoute le préfixe de l'arête au mot courant, en gardant la place du caractère nul */
+static void append_cursor_patricia(PatriciaCursor* cursor, const PatriciaNode* node, const PatriciaEdge* edge) {
+    if (cursor->len + edge->len + 1 > cursor->word_cap) {
+        cursor->word_cap = 2 * (cursor->len + edge->len + 1);
+        char* tmp = realloc(cursor->word, cursor->word_cap);
+        if (tmp == NULL) {
+            fprintf(stderr, "Erreur d'allocation de mémoire: append_cursor_patricia\n");
+            exit(1);
+        }
+        cursor->word = tmp;
+    }
+    memcpy(cursor->word + cursor->len, label_patricia(node, edge), edge->len);
+    cursor->len += edge->len;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui avance le curseur jusqu'au mot suivant
+ *
+ * Sur chaque noeud, la fin de mot passe avant les arêtes, parcourues dans l'ordre croissant. Une feuille est un mot,
+ * un enfant est empilé avant la fin de mot.
+ *
+ * @param cursor
+ * @return bool vrai si un mot a été atteint, faux quand le parcours sort du trie, la pile est alors vide
+ */
+static bool avance_cursor_patricia(PatriciaCursor* cursor) {
+    while (cursor->depth > 0) {
+        CadrePatricia* frame = &cursor->frames[cursor->depth - 1];
+        cursor->len = frame->base;
+        if (frame->key == -2) {
+            frame->key = -1;
+            if (frame->node->end) {
+                return true;
+            }
+        }
+        const PatriciaEdge* edge = next_edge_patricia(frame->node, &frame->key);
+        if (edge == NULL) {
+            cursor->depth--;
+            continue;
+        }
+        append_cursor_patricia(cursor, frame->node, edge);
+        if (edge->child == NULL) {
+            return true;
+        }
+        push_cursor_patricia(cursor, edge->child, -2);
+    }
+    return false;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui recule le curseur jusqu'au mot précédent, l'exact inverse de @c avance_cursor_patricia
+ *
+ * @param cursor
+ * @return bool vrai si un mot a été atteint, faux quand le parcours sort du trie, la pile est alors vide
+ */
+static bool recule_cursor_patricia(PatriciaCursor* cursor) {
+    while (cursor->depth > 0) {
+        CadrePatricia* frame = &cursor->frames[cursor->depth - 1];
+        cursor->len = frame->base;
+        if (frame->key >= 0) {
+            const PatriciaEdge* edge = prev_edge_patricia(frame->node, &frame->key);
+            if (edge != NULL) {
+                append_cursor_patricia(cursor, frame->node, edge);
+                if (edge->child == NULL) {
+                    return true;
+                }
+                push_cursor_patricia(cursor, edge->child, ASCII_SIZE);
+                continue;
+            }
+            frame->key = -1;
+            if (frame->node->end) {
+                return true;
+            }
+        }
+        cursor->depth--;
+    }
+    return false;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui termine un déplacement du curseur dans le sens donné en tenant compte des bornes
+ *
+ * Un mot hors des bornes n'est pas rendu mais le chemin reste posé dessus, pour que le déplacement inverse retrouve le
+ * dernier mot des bornes.
+ *
+ * @param cursor
+ * @param trouve
+ * @param sens 1 en avançant, -1 en reculant
+ * @return const char* le mot atteint, NULL en sortant du trie ou des bornes
+ */
+static const char* termine_cursor_patricia(PatriciaCursor* cursor, bool trouve, int sens) {
+    if (trouve) {
+        cursor->word[cursor->len] = '\0';
+        if (sens > 0 && cursor->hi != NULL && strcmp(cursor->word, cursor->hi) >= 0) {
+            trouve = false;
+        } else if (sens < 0 && cursor->lo != NULL && strcmp(cursor->word, cursor->lo) < 0) {
+            trouve = false;
+        }
+    }
+    cursor->bout = trouve ? 0 : sens;
+    return trouve ? cursor->word : NULL;
+}
+
+/**
+ * @brief Fonction qui place le curseur sur le premier mot supérieur ou égal à un mot donné
+ *
+ * Seul le chemin du mot est parcouru : il est posé comme si le curseur était juste avant le mot, et le premier pas en
+ * avant trouve le résultat.
+ *
+ * @param cursor
+ * @param word un mot, présent ou non dans le trie
+ * @return const char* le mot atteint, NULL s'il n'y en a pas dans les bornes du curseur
+ */
+const char* cursor_seek_patricia(PatriciaCursor* cursor, const char* word) {
+    /* Un mot au delà de la borne supérieure est ramené sur elle, pour que le mot précédent reste dans les bornes */
+    if (cursor->lo != NULL && strcmp(word, cursor->lo) < 0) {
+        word = cursor->lo;
+    } else if (cursor->hi != NULL && strcmp(word, cursor->hi) > 0) {
+        word = cursor->hi;
+    }
+    const PatriciaNode* node = cursor->root;
+    cursor->depth = 0;
+    cursor->len = 0;
+    for (;;) {
+        if (*word == '\0') {
+            push_cursor_patricia(cursor, node, -2);
+            break;
+        }
+        int c = (unsigned char)(*word);
+        const PatriciaEdge* edge = edge_patricia(node, c);
+        if (edge == NULL) {
+            push_cursor_patricia(cursor, node, c);
+            break;
+        }
+        LcpPatricia lcp = lcp_edge_patricia(node, edge, word);
+        if (lcp.fin_label && edge->child != NULL) {
+            push_cursor_patricia(cursor, node, c);
+            append_cursor_patricia(cursor, node, edge);
+            node = edge->child;
+            word += lcp.len;
+            continue;
+        }
+        /* L'arête est le mot lui-même, ou le suit tout entière, ou le précède tout entière */
+        bool suit;
+        if (lcp.fin_label) {
+            suit = lcp.fin_mot;
+        } else {
+            suit = lcp.fin_mot || (unsigned char)label_patricia(node, edge)[lcp.len] > (unsigned char)word[lcp.len];
+        }
+        push_cursor_patricia(cursor, node, suit ? c - 1 : c);
+        break;
+    }
+    return termine_cursor_patricia(cursor, avance_cursor_patricia(cursor), 1);
+}
+
+/**
+ * @brief Fonction qui restreint le curseur aux mots de [@a lo, @a hi[ et le place sur le premier d'entre eux
+ *
+ * Les bornes ne sont pas copiées et doivent rester valables tant que le curseur s'en sert. @c cursor_next_patricia
+ * et @c cursor_prev_patricia rendent NULL en sortant de l'intervalle.
+ *
+ * @param cursor
+ * @param lo la borne inférieure incluse, NULL pour partir du premier mot
+ * @param hi la borne supérieure exclue, NULL pour aller jusqu'au dernier mot
+ * @return const char* le premier mot de l'intervalle, NULL s'il est vide
+ */
+const char* cursor_range_patricia(PatriciaCursor* cursor, const char* lo, const char* hi) {
+    cursor->lo = lo;
+    cursor->hi = hi;
+    return cursor_seek_patricia(cursor, lo != NULL ? lo : "");
+}
+
+/**
+ * @brief Fonction qui avance le curseur au mot suivant, en temps amorti constant
+ *
+ * @param cursor
+ * @return const char* le mot suivant, NULL après le dernier mot
+ */
+const char* cursor_next_patricia(PatriciaCursor* cursor) {
+    if (cursor->bout > 0) {
+        return NULL;
+    }
+    if (cursor->depth == 0) {
+        cursor->len = 0;
+        push_cursor_patricia(cursor, cursor->root, -2);
+    }
+    return termine_cursor_patricia(cursor, avance_cursor_patricia(cursor), 1);
+}
+
+/**
+ * @brief Fonction qui recule le curseur au mot précédent, en temps amorti constant
+ *
+ * @param cursor
+ * @return const char* le mot précédent, NULL avant le premier mot
+ */
+const char* cursor_prev_patricia(PatriciaCursor* cursor) {
+    if (cursor->bout < 0) {
+        return NULL;
+    }
+    if (cursor->depth == 0) {
+        cursor->len = 0;
+        push_cursor_patricia(cursor, cursor->root, ASCII_SIZE);
+    }
+    return termine_cursor_patricia(cursor, recule_cursor_patricia(cursor), -1);
+}
+
+/**
+ * @private
+ *
+ * @brief L'état d'une recherche approchée : le mot cherché, les lignes de distances et le mot courant
+ *
+ * La ligne @c i (les @c m + 1 entiers à partir de @c rows[i * (m + 1)]) donne la distance d'édition entre les @c i
+ * premiers caractères du mot courant et chaque préfixe du mot cherché.
+ */
+typedef struct FuzzyPatricia {
+    const char *word;
+    size_t m;
+    int max_edits;
+    int *rows;
+    char *buf;                       /**< Le mot courant */
+    size_t cap;                      /**< Nombre de lignes et de caractères alloués */
+    PatriciaFuzzyCallback callback;
+    void *ctx;
+    int found;
+} FuzzyPatricia;
+
+/* Calcule la ligne i + 1 en ajoutant c au mot courant et retourne sa plus petite valeur, aucun prolongement du mot
+ * courant ne peut faire mieux */
+static int fuzzy_row_patricia(FuzzyPatricia* f, size_t i, char c) {
+    if (i + 2 > f->cap) {
+        f->cap *= 2;
+        int* rows = realloc(f->rows, f->cap * (f->m + 1) * sizeof(*rows));
+        char* buf = realloc(f->buf, f->cap);
+        if (rows == NULL || buf == NULL) {
+            fprintf(stderr, "Erreur d'allocation de mémoire: fuzzy_row_patricia\n");
+            exit(1);
+        }
+        f->rows = rows;
+        f->buf = buf;
+    }
+    /* Seule la bande |i + 1 - j| <= max_edits est calculée, ses bords (et row[m] s'il en sort) valent max_edits + 1 */
+    const int* prev = f->rows + i * (f->m + 1);
+    int* row = f->rows + (i + 1) * (f->m + 1);
+    size_t k = (size_t)f->max_edits;
+    size_t lo = i + 1 > k ? i + 1 - k : 1;
+    size_t hi = i + 1 + k < f->m ? i + 1 + k : f->m;
+    int min = row[lo - 1] = lo == 1 ? (int)(i + 1) : f->max_edits + 1;
+    for (size_t j = lo; j <= hi; j++) {
+        int d = (prev[j] < row[j - 1] ? prev[j] : row[j - 1]) + 1;
+        int sub = prev[j - 1] + (f->word[j - 1] != c);
+        row[j] = d < sub ? d : sub;
+        min = row[j] < min ? row[j] : min;
+    }
+    if (hi < f->m) {
+        row[hi + 1] = f->max_edits + 1;
+    }
+    if (f->m > hi || f->m + 1 < lo) {
+        row[f->m] = f->max_edits + 1;
+    }
+    f->buf[i] = c;
+    return min;
+}
+
+/* Signale le mot courant de longueur len s'il est assez proche du mot cherché */
+static void fuzzy_emit_patricia(FuzzyPatricia* f, size_t len) {
+    int dist = f->rows[len * (f->m + 1) + f->m];
+    if (dist <= f->max_edits) {
+        f->buf[len] = '\0';
+        f->callback(f->buf, dist, f->ctx);
+        f->found++;
+    }
+}
+
+static void fuzzy_rec_patricia(FuzzyPatricia* f, const PatriciaNode* node, size_t len) {
+    if (node->end) {
+        fuzzy_emit_patricia(f, len);
+    }
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        /* Toute l'arête est parcourue caractère par caractère, abandonnée dès que la ligne dépasse le seuil */
+        const char* label = label_patricia(node, edge);
+        uint32_t i = 0;
+        while (i < edge->len && fuzzy_row_patricia(f, len + i, label[i]) <= f->max_edits) {
+            i++;
+        }
+        if (i < edge->len) {
+            continue;
+        }
+        if (edge->child == NULL) {
+            fuzzy_emit_patricia(f, len + edge->len);
+        } else {
+            fuzzy_rec_patricia(f, edge->child, len + edge->len);
+        }
+    }
+}
+
+/**
+ * @brief Fonction qui cherche les mots à une distance d'édition au plus max_edits du mot donné
+ *
+ * Les lignes de la distance de Levenshtein sont calculées en descendant le trie et partagées par les mots de même
+ * préfixe. Une arête est abandonnée dès que toute sa ligne dépasse @a max_edits, avec tout son sous-arbre. Les mots
+ * sont rendus à @a callback dans l'ordre alphabétique, empruntés le temps de l'appel.
+ *
+ * @param node
+ * @param word
+ * @param max_edits le nombre maximal d'insertions, suppressions et substitutions d'un caractère
+ * @param callback appelée sur chaque mot trouvé avec sa distance et ctx
+ * @param ctx
+ * @return int le nombre de mots trouvés
+ */
+int fuzzy_search_patricia(const PatriciaNode* node, const char* word, int max_edits, PatriciaFuzzyCallback callback,
+                          void* ctx) {
+    if (node == NULL || max_edits < 0) {
+        return 0;
+    }
+    /* Les bords de la bande valent max_edits + 1, qui doit tenir dans un int */
+    if (max_edits > INT_MAX - 1) {
+        max_edits = INT_MAX - 1;
+    }
+    FuzzyPatricia f = {word, strlen(word), max_edits, NULL, NULL, MAX_WORD_LENGTH, callback, ctx, 0};
+    f.rows = malloc(f.cap * (f.m + 1) * sizeof(*f.rows));
+    f.buf = malloc(f.cap);
+    if (f.rows == NULL || f.buf == NULL) {
+        fprintf(stderr, "Erreur d'allocation de mémoire: fuzzy_search_patricia\n");
+        exit(1);
+    }
+    for (size_t j = 0; j <= f.m; j++) {
+        f.rows[j] = (int)j;
+    }
+    fuzzy_rec_patricia(&f, node, 0);
+    free(f.rows);
+    free(f.buf);
+    return f.found;
+}
+
+/**
+ * @private
+ *
+ * @brief L'état d'une recherche par motif : le motif compilé, les ensembles d'états et le mot courant
+ *
+ * Le motif est reconnu par un automate non déterministe dont l'état @c i signifie que les @c i premiers éléments du
+ * motif sont reconnus. @c sets garde un ensemble d'états (@c w mots de 64 bits) par caractère du mot courant.
+ */
+typedef struct GlobPatricia {
+    size_t n;
+    size_t w;
+    uint64_t (*classes)[2];          /**< Les caractères acceptés par chaque élément du motif, sur 128 bits */
+    bool *star;                      /**< Vrai si l'élément est une `*` */
+    uint64_t *sets;
+    char *buf;                       /**< Le mot courant */
+    size_t cap;                      /**< Nombre d'ensembles et de caractères alloués */
+    PatriciaWordCallback callback;
+    void *ctx;
+    int found;
+} GlobPatricia;
+
+static inline bool in_class_patricia(const uint64_t class[2], unsigned char c) {
+    return c < ASCII_SIZE && (class[c / 64] >> (c % 64) & 1);
+}
+
+static inline void add_class_patricia(uint64_t class[2], unsigned char c) {
+    if (c > 0 && c < ASCII_SIZE) {
+        class[c / 64] |= UINT64_C(1) << (c % 64);
+    }
+}
+
+/* Retourne le `]` qui ferme la classe commençant en start, NULL s'il n'y en a pas. Le premier caractère de la classe,
+ * même un `]`, et tout caractère protégé par un `\` en font partie. */
+static const char* class_end_patricia(const char* start) {
+    const char* q = start;
+    do {
+        q += *q == '\\' && q[1] ? 2 : 1;
+    } while (*q && *q != ']');
+    return *q ? q : NULL;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui compile le motif : `?`, `*`, `[...]` (intervalles, complément par `!` ou `^`) et `\`
+ *
+ * Un `[` sans `]` fermant est pris littéralement et les `*` consécutives n'en font qu'une.
+ */
+static void compile_glob_patricia(GlobPatricia* g, const char* pattern) {
+    size_t len = strlen(pattern);
+    g->n = 0;
+    g->w = len / 64 + 1;
+    g->classes = malloc((len + 1) * sizeof(*g->classes));
+    g->star = malloc(len + 1);
+    if (g->classes == NULL || g->star == NULL) {
+        fprintf(stderr, "Erreur d'allocation de mémoire: compile_glob_patricia\n");
+        exit(1);
+    }
+    for (const char* p = pattern; *p; p++) {
+        uint64_t* class = g->classes[g->n];
+        class[0] = class[1] = 0;
+        g->star[g->n] = *p == '*';
+        const char* start = p + 1 + (p[1] == '!' || p[1] == '^');
+        const char* end = *p == '[' && *start ? class_end_patricia(start) : NULL;
+        if (*p == '*' || *p == '?') {
+            class[0] = ~UINT64_C(1);
+            class[1] = ~UINT64_C(0);
+            if (*p == '*' && g->n > 0 && g->star[g->n - 1]) {
+                continue;
+            }
+        } else if (end != NULL) {
+            for (const char* q = start; q < end; q++) {
+                unsigned char lo = (unsigned char)(*q == '\\' ? *++q : *q), hi = lo;
+                if (q[1] == '-' && q + 2 < end) {
+                    q += 2;
+                    hi = (unsigned char)(*q == '\\' ? *++q : *q);
+                }
+                for (unsigned c = lo; c <= hi; c++) {
+                    add_class_patricia(class, (unsigned char)c);
+                }
+            }
+            if (start > p + 1) {
+                class[0] = ~class[0] & ~UINT64_C(1);
+                class[1] = ~class[1];
+            }
+            p = end;
+        } else {
+            add_class_patricia(class, (unsigned char)(*p == '\\' && p[1] ? *++p : *p));
+        }
+        g->n++;
+    }
+}
+
+/* Une `*` peut aussi ne reconnaître aucun caractère, retourne vrai si l'ensemble n'est pas vide */
+static bool close_set_patricia(const GlobPatricia* g, uint64_t* set) {
+    for (size_t i = 0; i < g->n; i++) {
+        if (g->star[i] && (set[i / 64] >> (i % 64) & 1)) {
+            set[(i + 1) / 64] |= UINT64_C(1) << ((i + 1) % 64);
+        }
+    }
+    for (size_t k = 0; k < g->w; k++) {
+        if (set[k]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Calcule l'ensemble i + 1 en ajoutant c au mot courant, retourne faux s'il est vide */
+static bool step_glob_patricia(GlobPatricia* g, size_t i, char c) {
+    if (i + 2 > g->cap) {
+        g->cap *= 2;
+        uint64_t* sets = realloc(g->sets, g->cap * g->w * sizeof(*sets));
+        char* buf = realloc(g->buf, g->cap);
+        if (sets == NULL || buf == NULL) {
+            fprintf(stderr, "Erreur d'allocation de mémoire: step_glob_patricia\n");
+            exit(1);
+        }
+        g->sets = sets;
+        g->buf = buf;
+    }
+    const uint64_t* prev = g->sets + i * g->w;
+    uint64_t* next = g->sets + (i + 1) * g->w;
+    memset(next, 0, g->w * sizeof(*next));
+    for (size_t k = 0; k < g->w; k++) {
+        for (uint64_t bits = prev[k]; bits; bits &= bits - 1) {
+            size_t s = 64 * k + __builtin_ctzll(bits);
+            if (s < g->n && in_class_patricia(g->classes[s], (unsigned char)c)) {
+                size_t t = g->star[s] ? s : s + 1;
+                next[t / 64] |= UINT64_C(1) << (t % 64);
+            }
+        }
+    }
+    g->buf[i] = c;
+    return close_set_patricia(g, next);
+}
+
+/* Signale le mot courant de longueur len si tout le motif est reconnu */
+static void glob_emit_patricia(GlobPatricia* g, size_t len) {
+    if (g->sets[len * g->w + g->n / 64] >> (g->n % 64) & 1) {
+        g->buf[len] = '\0';
+        g->callback(g->buf, g->ctx);
+        g->found++;
+    }
+}
+
+static void glob_rec_patricia(GlobPatricia* g, const PatriciaNode* node, size_t len) {
+    if (node->end) {
+        glob_emit_patricia(g, len);
+    }
+    /* Les caractères qui peuvent suivre : seules les arêtes qui commencent par l'un d'eux sont suivies */
+    uint64_t next[2] = {0, 0};
+    const uint64_t* set = g->sets + len * g->w;
+    for (size_t k = 0; k < g->w; k++) {
+        for (uint64_t bits = set[k]; bits; bits &= bits - 1) {
+            size_t s = 64 * k + __builtin_ctzll(bits);
+            if (s < g->n) {
+                next[0] |= g->classes[s][0];
+                next[1] |= g->classes[s][1];
+            }
+        }
+    }
+    if (!next[0] && !next[1]) {
+        return;
+    }
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+        if (!in_class_patricia(next, (unsigned char)key)) {
+            continue;
+        }
+        const char* label = label_patricia(node, edge);
+        uint32_t i = 0;
+        while (i < edge->len && step_glob_patricia(g, len + i, label[i])) {
+            i++;
+        }
+        if (i < edge->len) {
+            continue;
+        }
+        if (edge->child == NULL) {
+            glob_emit_patricia(g, len + edge->len);
+        } else {
+            glob_rec_patricia(g, edge->child, len + edge->len);
+        }
+    }
+}
+
+/**
+ * @brief Fonction qui cherche les mots reconnus par un motif façon glob
+ *
+ * `?` reconnaît un caractère quelconque, `*` une suite quelconque éventuellement vide, `[bc]` un caractère entre les
+ * crochets (intervalles `[a-z]`, complément `[!bc]` ou `[^bc]`) et `\` prend le caractère suivant littéralement.
+ * L'ensemble des états de l'automate du motif est calculé une fois par caractère en descendant le trie, une `*` ne
+ * fait donc jamais repartir le parcours en arrière. Seules les arêtes dont le premier caractère peut suivre sont
+ * parcourues, et une arête est abandonnée dès que plus aucun état n'est actif. Les mots sont rendus à @a callback dans
+ * l'ordre alphabétique, empruntés le temps de l'appel.
+ *
+ * @param node
+ * @param pattern
+ * @param callback appelée sur chaque mot reconnu avec ctx
+ * @param ctx
+ * @return int le nombre de mots reconnus
+ */
+int glob_patricia(const PatriciaNode* node, const char* pattern, PatriciaWordCallback callback, void* ctx) {
+    if (node == NULL) {
+        return 0;
+    }
+    GlobPatricia g;
+    compile_glob_patricia(&g, pattern);
+    g.cap = MAX_WORD_LENGTH;
+    g.sets = calloc(g.cap * g.w, sizeof(*g.sets));
+    g.buf = malloc(g.cap);
+    if (g.sets == NULL || g.buf == NULL) {
+        fprintf(stderr, "Erreur d'allocation de mémoire: glob_patricia\n");
+        exit(1);
+    }
+    g.callback = callback;
+    g.ctx = ctx;
+    g.found = 0;
+    g.sets[0] = 1;
+    close_set_patricia(&g, g.sets);
+    glob_rec_patricia(&g, node, 0);
+    free(g.sets);
+    free(g.buf);
+    free(g.classes);
+    free(g.star);
+    return g.found;
+}
+
+/**
+ * @brief Fonction qui retourne vrai si un mot est préfixe d'un autre mot
+ *
+ * @param s1
+ * @param s2
+ * @return int
+ */
+int est_prefixe(const char* s1, const char* s2){
+    return s1[lcp_bloc_patricia(s1, s2, UINT32_MAX, true)] == '\0';
+}
+
+
+/**
+ * @brief Fonction qui retourne la liste des mots dans le Patricia-Trie
+ *
+ * @param node
+ * @return char**
+ */
+char** liste_mots_patricia(PatriciaNode* node) {
+    static char* res[MAX_WORDS];
+    static int index = 0;
+    index = 0;
+
+    liste_mots_patricia_recursive(node, "", res, &index);
+
+    return res;
+}
+
+void liste_mots_patricia_recursive(PatriciaNode* node, const char* prefix, char** res, int* index) {
+    if (node->end) {
+        res[*index] = strdup(prefix);
+        (*index)++;
+    }
+
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+
+            char new_prefix[MAX_WORD_LENGTH];
+
+            snprintf(new_prefix, MAX_WORD_LENGTH, "%s%.*s", prefix, (int)edge->len, label_patricia(node, edge));
+
+            if (edge->child == NULL) {
+                res[*index] = strdup(new_prefix);
+                (*index)++;
+            }
+
+            if (edge->child != NULL) {
+
+                liste_mots_patricia_recursive(edge->child, new_prefix, res, index);
+            }
+    }
+}
+
+void print_list_patricia(char** list, int size) {
+    printf("[ ");
+    for (int i = 0; i < size-1; i++) {
+        printf("%s, ", list[i]);
+    }
+    printf("%s ]\n", list[size-1]);
+
+}
+
+void free_list_patricia(char** list, int size) {
+    for (int i = 0; i < size; i++) {
+        free(list[i]);
+    }
+}
+
+/**
+ * @brief Fonction qui affiche le Patricia-Trie
+ *
+ * @param node
+ * @param depth
+ */
+void print_patricia(PatriciaNode* node, int depth) {
+    if (node == NULL) {
+        return;
+    }
+
+    if (node->end) {
+        for (int j = 0; j < depth; j++) {
+            printf("  ");
+        }
+        printf("%c: %s\n", EOE_CHAR, " ");
+    }
+
+    int key = -1;
+    PatriciaEdge* edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL) {
+            for (int j = 0; j < depth; j++) {
+                printf("  ");
+            }
+            printf("%c: %.*s\n", key, (int)edge->len, label_patricia(node, edge));
+            print_patricia(edge->child, depth + 1);
+    }
+}
+
+/**
+ * @brief Fonction qui retourne la profondeur moyenne des feuilles du Patricia-Trie
+ *
+ * @param node
+ * @return float
+ */
+float profondeur_moyenne_patricia_feuille(PatriciaNode* node){
+    int sum = 0;
+    int nbFeuilles = 0;
+
+    calcule_profondeur_moyenne_patricia_feuille(node, 0, &sum, &nbFeuilles);
+    if(nbFeuilles == 0){
+        return 0;
+    }
+    else {
+        return sum / nbFeuilles;
+    }
+}
+
+void calcule_profondeur_moyenne_patricia_feuille(PatriciaNode* node, int profondeur, int* sum, int* nbFeuilles){
+    if(node == NULL){
+        return;
+    }
+
+    /* La marque de fin de mot compte comme une feuille sous le noeud */
+    if(node->end){
+        *sum += profondeur + 1;
+        (*nbFeuilles)++;
+    }
+
+    int key = -1;
+    PatriciaEdge* edge;
+    while((edge = next_edge_patricia(node, &key)) != NULL){
+            if(edge->child == NULL){
+                *sum += profondeur + 1;
+                (*nbFeuilles)++;
+            }
+            else{
+                calcule_profondeur_moyenne_patricia_feuille(edge->child, profondeur + 1, sum, nbFeuilles);
+            }
+    }
+}
+
+/**
+ * @brief Fonction helper pour fusionner deux Patricia-Tries
+ *
+ * @param s1
+ * @param s2
+ * @param x
+ * @param y
+ * @param z
+ */
+void prefixe_fusion(const char* s1, const char* s2, char* x, char* y, char* z){
+    int prefix_len = plus_long_pref(s1, s2);
+    strncpy(x, s1, prefix_len);
+    x[prefix_len] = '\0';
+    strcpy(y, s1 + prefix_len);
+    strcpy(z, s2 + prefix_len);
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui fait passer un sous-arbre dans une autre arène, en y recopiant ses préfixes
+ *
+ * @param node
+ * @param arena
+ */
+static void rehome_patricia(PatriciaNode* node, PatriciaArena* arena){
+    if(node == NULL || node->arena == arena){
+        return;
+    }
+    int key = -1;
+    PatriciaEdge* edge;
+    while((edge = next_edge_patricia(node, &key)) != NULL){
+        if(edge->len > EDGE_INLINE){
+            lache_label_patricia(node->arena, edge);
+            edge->off = append_arena_patricia(arena, label_patricia(node, edge), edge->len);
+        }
+        rehome_patricia(edge->child, arena);
+    }
+    node->arena = arena;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui crée un noeud dont la seule arête a pour préfixe celui de @a src à partir de @a from et pour
+ * enfant @a node
+ *
+ * Le noeud créé vit dans l'arène de @a src_node, comme @a node. @a src doit avoir été lâchée au préalable.
+ *
+ * @param src_node
+ * @param src
+ * @param from
+ * @param node
+ * @return PatriciaNode*
+ */
+static PatriciaNode* cons_patricia(const PatriciaNode* src_node, const PatriciaEdge* src, uint32_t from,
+                                   PatriciaNode* node){
+    assert(from < src->len && "Le préfixe d'une arête ne peut pas être vide");
+    assert((node == NULL || node->arena == src_node->arena) && "L'enfant doit vivre dans l'arène du préfixe");
+    PatriciaNode* new_node = new_node_patricia(src_node->arena);
+    PatriciaEdge* edge = add_edge_patricia(new_node, (unsigned char)label_patricia(src_node, src)[from]);
+    pose_label_patricia(new_node->arena, edge, src_node, src, from, src->len - from);
+    edge->child = node;
+    new_node->words = node != NULL ? node->words : 1;
+    return new_node;
+}
+
+/**
+ * @brief Fonction creer un nouveau noeud Patricia, word devient le prefixe et node l'enfant
+ *
+ * Le nouveau noeud est la racine d'un nouveau trie, les préfixes de @a node sont recopiés dans son arène.
+ *
+ * @param s1
+ * @param s2
+ * @return char*
  */
 PatriciaNode* pat_cons(PatriciaNode* node, const char* word){
     PatriciaNode* new_node = create_patricia_node();
@@ -539,253 +2362,976 @@ PatriciaNode* pat_cons(PatriciaNode* node, const char* word){
     if(node == NULL){
         return new_node;
     }
-    int index = (unsigned char)(*word);
-    new_node->children[index] = node;
+    PatriciaArena* old = node->arena;
+    rehome_patricia(node, new_node->arena);
+    if(old->root == node){
+        free_arena_patricia(old);
+    }
+    int index = (unsigned char)(*word);
+    edge_patricia(new_node, index)->child = node;
+    new_node->words = node->words;
+
+    return new_node;
+}
+
+/**
+ * @private
+ *
+ * @brief Corps de @c pat_fusion, le résultat vit dans l'arène donnée
+ *
+ * Les noeuds de @a node2 sont libérés ou rattachés au résultat, leurs préfixes étant alors recopiés dans @a arena.
+ * Les sous-arbres rattachés tels quels gardent leur nombre de mots, celui des autres est recalculé au retour.
+ *
+ * @param arena
+ * @param node1
+ * @param node2
+ * @return PatriciaNode*
+ */
+static PatriciaNode* fusion_rec_patricia(PatriciaArena* arena, PatriciaNode* node1, PatriciaNode* node2){
+    if(node1 == NULL){
+        rehome_patricia(node2, arena);
+        return node2;
+    }
+    if(node2 == NULL){
+        /* La fin de mot de node1 a pu être posée par l'appelant */
+        rehome_patricia(node1, arena);
+        recompte_patricia(node1);
+        return node1;
+    }
+    rehome_patricia(node1, arena);
+
+    node1->end = node1->end || node2->end;
+
+    int i = -1;
+    PatriciaEdge* e2;
+    while((e2 = next_edge_patricia(node2, &i)) != NULL){
+        PatriciaEdge* e1 = edge_patricia(node1, i);
+        lache_label_patricia(node2->arena, e2);
+        if(e1 == NULL){
+
+           e1 = add_edge_patricia(node1, i);
+           pose_label_patricia(arena, e1, node2, e2, 0, e2->len);
+           e1->child = e2->child;
+           rehome_patricia(e1->child, arena);
+           e2->child = NULL;
+        }
+        else{
+           const char* p1 = label_patricia(node1, e1);
+           const char* p2 = label_patricia(node2, e2);
+           uint32_t commun = lcp_bloc_patricia(p1, p2, e1->len < e2->len ? e1->len : e2->len, false);
+           if(commun == e1->len && commun == e2->len){
+                if (e1->child == NULL){
+                    if(e2->child != NULL){
+                        e1->child = new_node_patricia(arena);
+                        e1->child->end = true;
+                    }
+                }
+                else if(e2->child == NULL){
+                    e1->child->end = true;
+                }
+
+                e1->child = fusion_rec_patricia(arena, e1->child, e2->child);
+                e2->child = NULL;
+           }
+           else if(commun == e1->len){
+                /* Le préfixe de e1 est préfixe de celui de e2 */
+                PatriciaNode* new_node = cons_patricia(node2, e2, commun, e2->child);
+                if(e1->child == NULL){
+                    e1->child = new_node_patricia(arena);
+                    e1->child->end = true;
+                }
+                e1->child = fusion_rec_patricia(arena, e1->child, new_node);
+                e2->child = NULL;
+
+           }
+           else if(commun == e2->len){
+                /* Le préfixe de e2 est préfixe de celui de e1 */
+                lache_label_patricia(arena, e1);
+                PatriciaNode* new_node = cons_patricia(node1, e1, commun, e1->child);
+                pose_label_patricia(arena, e1, node1, e1, 0, commun);
+                if(e2->child == NULL ){
+                    e2->child = new_node_patricia(node2->arena);
+                    e2->child->end = true;
+                }
+                e1->child = fusion_rec_patricia(arena, new_node, e2->child);
+                e2->child = NULL;
+           }
+           else{
+                lache_label_patricia(arena, e1);
+                PatriciaNode* PT1 = cons_patricia(node1, e1, commun, e1->child);
+                pose_label_patricia(arena, e1, node1, e1, 0, commun);
+                PatriciaNode* PT2 = cons_patricia(node2, e2, commun, e2->child);
+                e1->child = fusion_rec_patricia(arena, PT1, PT2);
+                e2->child = NULL;
+           }
+        }
+    }
+    free_shell_patricia(node2);
+    recompte_patricia(node1);
+    return node1;
+}
+
+/**
+ * @brief Fonction qui fusionne deux Patricia-Tries
+ *
+ * Le résultat garde l'arène de @a node1, celle de @a node2 est libérée avec lui.
+ *
+ * @param node1
+ * @param node2
+ * @return PatriciaNode*
+ */
+PatriciaNode* pat_fusion(PatriciaNode* node1, PatriciaNode* node2){
+    if(node1 == NULL){
+        return node2;
+    }
+    if(node2 == NULL){
+        return node1;
+    }
+
+    PatriciaArena* arena2 = node2->arena;
+    bool owner = arena2->root == node2 && arena2 != node1->arena;
+    PatriciaNode* res = fusion_rec_patricia(node1->arena, node1, node2);
+    if(owner){
+        free_arena_patricia(arena2);
+    }
+    return res;
+}
+
+cJSON *constructJSONPT(const PatriciaNode *node, const char *label)
+{
+    cJSON *obj = cJSON_CreateObject();
+    if (!obj)
+    {
+        fprintf(stderr, "Erreur, cJSON_CreateObject dans constructJSONPT");
+        exit(1);
+    }
+    if (!cJSON_AddStringToObject(obj, "label", label))
+    {
+        fprintf(stderr, "Erreur, cJSON_AddStringToObject dans constructJSONPT");
+        exit(1);
+    }
+    bool isEnd = node ? node->end : true;
+    if (!cJSON_AddBoolToObject(obj, "is_end_of_word", isEnd))
+    {
+        fprintf(stderr, "Erreur, cJSON_AddBoolToObject dans constructJSONPT");
+        exit(1);
+    }
+    cJSON *children = cJSON_CreateObject();
+    if (!children)
+    {
+        fprintf(stderr, "Erreur, cJSON_CreateObject dans constructJSONPT");
+        exit(1);
+    }
+    if (node)
+    {
+        int i = -1;
+        const PatriciaEdge *edge;
+        while ((edge = next_edge_patricia(node, &i)) != NULL)
+        {
+            char *prefix = strndup(label_patricia(node, edge), edge->len);
+            if (!prefix)
+            {
+                fprintf(stderr, "Erreur, strndup dans constructJSONPT");
+                exit(1);
+            }
+            cJSON *offspring = constructJSONPT(edge->child, prefix);
+            free(prefix);
+            char buf[2] = {(char)i, 0};
+            if (!cJSON_AddItemToObject(children, buf, offspring))
+            {
+                fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONPT");
+                exit(1);
+            }
+        }
+    }
+    if (!cJSON_AddItemToObject(obj, "children", children))
+    {
+        fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONPT");
+        exit(1);
+    }
+    return obj;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui écrit le début de l'objet d'un élément, jusqu'à l'accolade ouvrante de ses "children"
+ *
+ * @param s
+ * @param label
+ * @param len
+ * @param end
+ */
+static void ecrit_element_patricia(SortieJSON *s, const char *label, size_t len, bool end)
+{
+    debutObjetSortieJSON(s);
+    cleSortieJSON(s, "label", 5);
+    chaineSortieJSON(s, label, len);
+    cleSortieJSON(s, "is_end_of_word", 14);
+    boolSortieJSON(s, end);
+    cleSortieJSON(s, "children", 8);
+    debutObjetSortieJSON(s);
+}
+
+/**
+ * @private
+ *
+ * @brief Un noeud dont les arêtes sont en cours d'écriture, avec le caractère de la dernière arête écrite
+ */
+typedef struct CadreEcriturePatricia
+{
+    const PatriciaNode *node;
+    int key;
+} CadreEcriturePatricia;
+
+/**
+ * @brief Fonction qui écrit le Patricia-Trie donné sous format JSON dans la sortie donnée
+ *
+ * Même texte que @c constructJSONPT suivi de @c cJSON_Print (ou @c cJSON_PrintUnformatted pour une sortie compacte),
+ * mais chaque arête est écrite dès qu'elle est atteinte par un parcours itératif, sans arbre cJSON intermédiaire. Les
+ * erreurs d'écriture sont rendues par @c fermeSortieJSON.
+ *
+ * @param node
+ * @param s
+ */
+void ecritJSONPT(const PatriciaNode *node, SortieJSON *s)
+{
+    assert(node && "Given Patricia-Trie can't be null here");
+    size_t cap = 64, sz = 1;
+    CadreEcriturePatricia *pile = malloc(cap * sizeof(*pile));
+    if (!pile)
+    {
+        fprintf(stderr, "Erreur, malloc dans ecritJSONPT");
+        exit(1);
+    }
+    pile[0] = (CadreEcriturePatricia){node, -1};
+    ecrit_element_patricia(s, "", 0, node->end);
+    while (sz)
+    {
+        CadreEcriturePatricia *c = &pile[sz - 1];
+        const PatriciaEdge *edge = next_edge_patricia(c->node, &c->key);
+        if (!edge)
+        {
+            finObjetSortieJSON(s);
+            finObjetSortieJSON(s);
+            sz--;
+            continue;
+        }
+        char key = (char)c->key;
+        cleSortieJSON(s, &key, key ? 1 : 0);
+        /* Une feuille n'a pas de noeud, sa marque de fin de mot est implicite */
+        ecrit_element_patricia(s, label_patricia(c->node, edge), edge->len, edge->child ? edge->child->end : true);
+        if (!edge->child)
+        {
+            finObjetSortieJSON(s);
+            finObjetSortieJSON(s);
+            continue;
+        }
+        if (sz == cap)
+        {
+            cap *= 2;
+            CadreEcriturePatricia *tmp = realloc(pile, cap * sizeof(*pile));
+            if (!tmp)
+            {
+                fprintf(stderr, "Erreur, realloc dans ecritJSONPT");
+                exit(1);
+            }
+            pile = tmp;
+        }
+        pile[sz++] = (CadreEcriturePatricia){edge->child, -1};
+    }
+    free(pile);
+}
+
+char *printJSONPT(const PatriciaNode *node)
+{
+    SortieJSON s;
+    ouvreMemoireSortieJSON(&s, false);
+    ecritJSONPT(node, &s);
+    return rendMemoireSortieJSON(&s);
+}
+
+bool parseJSONPT_hasChildren(const cJSON *json)
+{
+    int count = 0;
+    const cJSON *elem;
+    cJSON_ArrayForEach(elem, json)
+    {
+        count++;
+    }
+    return !!count;
+}
+
+void parseJSONPT_rec(const cJSON *json, PatriciaNode *node)
+{
+    const cJSON *obj;
+
+    obj = cJSON_GetObjectItemCaseSensitive(json, "is_end_of_word");
+    assert(cJSON_IsBool(obj) && "'is_end_of_word' element has to be a JSON bool element");
+    node->end = cJSON_IsTrue(obj);
+
+    const cJSON *children;
+    children = cJSON_GetObjectItemCaseSensitive(json, "children");
+    assert(cJSON_IsObject(children) && "'children' element has to be a JSON object element");
+
+    const cJSON *elem;
+    cJSON_ArrayForEach(elem, children)
+    {
+        unsigned char index = elem->string[0];
+        obj = cJSON_GetObjectItemCaseSensitive(elem, "label");
+        assert(cJSON_IsString(obj) && "'label' element has to be a JSON string element");
+        size_t len = strlen(obj->valuestring);
+        assert(len > 0 && "'label' element can't be empty");
+
+        PatriciaEdge *edge = add_edge_patricia(node, index);
+        pose_mot_patricia(node->arena, edge, obj->valuestring, len);
+        /* Une feuille n'a pas de noeud, sa marque de fin de mot est implicite */
+        if (parseJSONPT_hasChildren(cJSON_GetObjectItemCaseSensitive(elem, "children")))
+        {
+            edge->child = new_node_patricia(node->arena);
+            parseJSONPT_rec(elem, edge->child);
+        }
+    }
+    recompte_patricia(node);
+}
 
-    return new_node;
+/**
+ * @private
+ *
+ * @brief Un élément ouvert pendant la lecture au fil de l'eau d'un JSON de Patricia-Trie
+ */
+typedef struct CadreJSONPatricia
+{
+    PatriciaNode *node; /**< Le noeud de l'élément, créé à la lecture de son premier enfant (la racine existe déjà) */
+    unsigned char cle;  /**< La clé de l'élément dans les "children" de son parent */
+    bool end;           /**< La valeur lue de "is_end_of_word" */
+    bool enfants;       /**< Les membres en cours de lecture sont ceux de "children" */
+    size_t base;        /**< La taille de la pile des labels à l'ouverture de l'élément */
+    size_t off;         /**< Le label de l'élément, dans la pile des labels */
+    size_t len;
+} CadreJSONPatricia;
+
+/**
+ * @private
+ *
+ * @brief Fonction qui arrête le programme sur un JSON de Patricia-Trie invalide, en indiquant l'octet fautif
+ *
+ * @param f
+ */
+static void erreur_json_patricia(const FluxJSON *f)
+{
+    fprintf(stderr, "Erreur, JSON invalide dans lit_json_patricia (octet %zu)", positionFluxJSON(f));
+    exit(1);
 }
 
+/**
+ * @private
+ *
+ * @brief Fonction qui lit le jeton suivant et arrête le programme s'il n'est pas celui attendu
+ *
+ * @param f
+ * @param attendu
+ */
+static void attend_json_patricia(FluxJSON *f, JetonJSON attendu)
+{
+    if (jetonFluxJSON(f) != attendu)
+        erreur_json_patricia(f);
+}
 
 /**
- * @brief Fonction qui fusionne deux Patricia-Tries
+ * @private
  *
- * @param node1
- * @param node2
+ * @brief Fonction qui construit un Patricia-Trie au fur et à mesure des jetons du flux donné
+ *
+ * Chaque élément ouvert a son cadre dans une pile. Son label est gardé dans une pile de caractères partagée, et son
+ * arête n'est ajoutée au noeud du parent qu'à son accolade fermante, quand son fils est complet et peut être recompté.
+ * Un élément sans enfant reste une feuille, sans noeud. Les clés inconnues sont ignorées.
+ *
+ * @param f
  * @return PatriciaNode*
  */
-PatriciaNode* pat_fusion(PatriciaNode* node1, PatriciaNode* node2){
-    if(node1 == NULL){
-        return node2;
-    }
-    if(node2 == NULL){
-        return node1;
+static PatriciaNode *lit_json_patricia(FluxJSON *f)
+{
+    PatriciaNode *root = create_patricia_node();
+    size_t cap = 64, sz = 1;
+    CadreJSONPatricia *pile = malloc(cap * sizeof(*pile));
+    size_t cap_labels = 256, nb_labels = 0;
+    char *labels = malloc(cap_labels);
+    if (!pile || !labels)
+    {
+        fprintf(stderr, "Erreur, malloc dans lit_json_patricia");
+        exit(1);
     }
-
-    for(int i = 0; i < ASCII_SIZE; i++){
-        if(node1->prefixes[i] == NULL && node2->prefixes[i] != NULL){
-
-           node1->prefixes[i] = strdup(node2->prefixes[i]);
-           free(node2->prefixes[i]);
-           node2->prefixes[i] = NULL;
-           node1->children[i] = node2->children[i];
-           node2->children[i] = NULL;
-        }
-        else if(node1->prefixes[i] != NULL && node2->prefixes[i] != NULL){
-           if(strcmp(node1->prefixes[i], node2->prefixes[i]) == 0){
-                if(i == EOE_INDEX){
-                    
-                }
-                else if (node1->children[i] == NULL){
-                    if(node2->children[i] != NULL){
-                        node1->children[i] = create_patricia_node();
-                        node1->children[i]->prefixes[EOE_INDEX] = strdup(" ");
-                    }
-                }
-                else if(node2->children[i] == NULL){
-                    if(node1->children[i]->prefixes[EOE_INDEX] == NULL){
-                        node1->children[i]->prefixes[EOE_INDEX] = strdup(" ");
-                    }
+    attend_json_patricia(f, JSON_DEBUT_OBJET);
+    pile[0] = (CadreJSONPatricia){.node = root};
+    bool apres_valeur = false;
+    JetonJSON j = jetonFluxJSON(f);
+    while (sz)
+    {
+        CadreJSONPatricia *c = &pile[sz - 1];
+        if (j == JSON_FIN_OBJET)
+        {
+            if (c->enfants)
+                c->enfants = false;
+            else
+            {
+                if (sz > 1)
+                {
+                    if (!c->len)
+                        erreur_json_patricia(f);
+                    PatriciaEdge *edge = add_edge_patricia(pile[sz - 2].node, c->cle);
+                    pose_mot_patricia(root->arena, edge, labels + c->off, c->len);
+                    edge->child = c->node;
                 }
-
-                free(node2->prefixes[i]);
-                node1->children[i] = pat_fusion(node1->children[i], node2->children[i]);
-                node2->children[i] = NULL;
-                //free_patricia_node(node2->children[i]);
-           }
-           else{
-                const char* suf = suffixe(node1->prefixes[i], node2->prefixes[i]);
-                const char* suf2 = suffixe(node2->prefixes[i], node1->prefixes[i]);
-                if(suf){
-                    PatriciaNode* new_node = pat_cons(node2->children[i], suf);
-                    if(node1->children[i] == NULL){
-                        node1->children[i] = create_patricia_node();
-                        node1->children[i]->prefixes[EOE_INDEX] = strdup(" ");
-                    }
-                    free(node2->prefixes[i]);
-                    node1->children[i] = pat_fusion(node1->children[i], new_node);
-                    node2->children[i] = NULL;
-
+                if (c->node)
+                {
+                    c->node->end = c->end;
+                    recompte_patricia(c->node);
                 }
-                else if(suf2){
-                    PatriciaNode* new_node = pat_cons(node1->children[i], suf2);
-                    if(node2->children[i] == NULL ){
-                        node2->children[i] = create_patricia_node();
-                        node2->children[i]->prefixes[EOE_INDEX] = strdup(" ");
-                    }
-                    free(node1->prefixes[i]);
-                    node1->prefixes[i] = strdup(node2->prefixes[i]);
-                    free(node2->prefixes[i]);
-                    node1->children[i] = pat_fusion(new_node, node2->children[i]);
-                    node2->children[i] = NULL;
+                nb_labels = c->base;
+                sz--;
+            }
+            apres_valeur = true;
+            if (sz)
+                j = jetonFluxJSON(f);
+            continue;
+        }
+        if (apres_valeur)
+        {
+            if (j != JSON_VIRGULE)
+                erreur_json_patricia(f);
+            j = jetonFluxJSON(f);
+        }
+        if (j != JSON_CHAINE)
+            erreur_json_patricia(f);
+        if (c->enfants)
+        {
+            /* Un enfant : le noeud du parent n'existe qu'à partir de là */
+            unsigned char cle = (unsigned char)f->chaine[0];
+            attend_json_patricia(f, JSON_DEUX_POINTS);
+            attend_json_patricia(f, JSON_DEBUT_OBJET);
+            if (!c->node)
+                c->node = new_node_patricia(root->arena);
+            if (sz == cap)
+            {
+                cap *= 2;
+                CadreJSONPatricia *tmp = realloc(pile, cap * sizeof(*pile));
+                if (!tmp)
+                {
+                    fprintf(stderr, "Erreur, realloc dans lit_json_patricia");
+                    exit(1);
                 }
-                else{
-                    char* x = malloc(sizeof(char) * MAX_WORD_LENGTH);
-                    char* y = malloc(sizeof(char) * MAX_WORD_LENGTH);
-                    char* z = malloc(sizeof(char) * MAX_WORD_LENGTH);
-                    prefixe_fusion(node1->prefixes[i], node2->prefixes[i], x, y, z);
-                    PatriciaNode* PT1 = pat_cons(node1->children[i], y);
-                    PatriciaNode* PT2 = pat_cons(node2->children[i], z);
-                    PatriciaNode* A_prim= pat_fusion(PT1, PT2);
-                    free(node1->prefixes[i]);
-                    node1->prefixes[i] = strdup(x);
-                    node1->children[i] = A_prim;
-                    free(node2->prefixes[i]);
-                    node2->prefixes[i] = NULL;
-                    node2->children[i] = NULL;
-                    free(x);
-                    free(y);
-                    free(z);
+                pile = tmp;
+            }
+            pile[sz++] = (CadreJSONPatricia){.cle = cle, .base = nb_labels, .off = nb_labels};
+            apres_valeur = false;
+            j = jetonFluxJSON(f);
+            continue;
+        }
+        attend_json_patricia(f, JSON_DEUX_POINTS);
+        if (!strcmp(f->chaine, "label"))
+        {
+            attend_json_patricia(f, JSON_CHAINE);
+            if (nb_labels + f->lg > cap_labels)
+            {
+                while (nb_labels + f->lg > cap_labels)
+                    cap_labels *= 2;
+                char *tmp = realloc(labels, cap_labels);
+                if (!tmp)
+                {
+                    fprintf(stderr, "Erreur, realloc dans lit_json_patricia");
+                    exit(1);
                 }
-           }
+                labels = tmp;
+            }
+            memcpy(labels + nb_labels, f->chaine, f->lg);
+            c->off = nb_labels;
+            c->len = f->lg;
+            nb_labels += f->lg;
         }
-        else{
-
-           }
+        else if (!strcmp(f->chaine, "is_end_of_word"))
+        {
+            j = jetonFluxJSON(f);
+            if (j != JSON_VRAI && j != JSON_FAUX)
+                erreur_json_patricia(f);
+            c->end = j == JSON_VRAI;
+        }
+        else if (!strcmp(f->chaine, "children"))
+        {
+            attend_json_patricia(f, JSON_DEBUT_OBJET);
+            c->enfants = true;
+            apres_valeur = false;
+            j = jetonFluxJSON(f);
+            continue;
+        }
+        else if (!sauteValeurFluxJSON(f, jetonFluxJSON(f)))
+            erreur_json_patricia(f);
+        apres_valeur = true;
+        j = jetonFluxJSON(f);
     }
-    free(node2);
-    return node1;
+    free(pile);
+    free(labels);
+    return root;
 }
 
-cJSON *constructJSONPT(const PatriciaNode *node, const char *label)
+PatriciaNode *parseJSONPT(const char *json, size_t sz)
 {
-    cJSON *obj = cJSON_CreateObject();
-    if (!obj)
-    {
-        fprintf(stderr, "Erreur, cJSON_CreateObject dans constructJSONPT");
-        exit(1);
-    }
-    if (!cJSON_AddStringToObject(obj, "label", label))
-    {
-        fprintf(stderr, "Erreur, cJSON_AddStringToObject dans constructJSONPT");
-        exit(1);
-    }
-    bool isEnd = node ? !!node->prefixes[EOE_INDEX] : true;
-    if (!cJSON_AddBoolToObject(obj, "is_end_of_word", isEnd))
+    FluxJSON f;
+    ouvreMemoireFluxJSON(&f, json, sz);
+    PatriciaNode *root = lit_json_patricia(&f);
+    fermeFluxJSON(&f);
+    return root;
+}
+
+/**
+ * @brief Fonction qui désérialise le Patricia-Trie JSON lu depuis le descripteur de fichier donné
+ *
+ * Le JSON est lu par blocs de @c TAILLE_FLUX_JSON octets, sans arbre cJSON intermédiaire : en dehors du trie
+ * construit, la mémoire utilisée ne dépend que de sa profondeur. Le descripteur peut être un tube, il n'est pas fermé.
+ *
+ * @param fd
+ * @return PatriciaNode*
+ */
+PatriciaNode *chargeJSONPT(int fd)
+{
+    FluxJSON f;
+    ouvreFluxJSON(&f, fd);
+    PatriciaNode *root = lit_json_patricia(&f);
+    fermeFluxJSON(&f);
+    return root;
+}
+
+/**
+ * @private
+ *
+ * @brief L'entête d'un snapshot binaire de Patricia-Trie, 32 octets
+ */
+typedef struct EnteteSnapshotPatricia
+{
+    char magie[8];     /**< @c SNAPSHOT_PT_MAGIE */
+    uint32_t version;  /**< @c SNAPSHOT_PT_VERSION */
+    uint32_t noeuds;   /**< Nombre de noeuds, la racine est le noeud 0 */
+    uint32_t aretes;   /**< Nombre d'arêtes */
+    uint32_t labels;   /**< Nombre d'octets des préfixes des arêtes, mis bout à bout */
+    uint64_t somme;    /**< Somme de contrôle des octets qui suivent l'entête */
+} EnteteSnapshotPatricia;
+
+/**
+ * @private
+ *
+ * @brief Un noeud d'un snapshot binaire, ses arêtes sont les @c count arêtes à partir de @c arete
+ */
+typedef struct NoeudSnapshotPatricia
+{
+    uint32_t arete;
+    uint32_t words;
+    unsigned char count;
+    unsigned char end;
+} NoeudSnapshotPatricia;
+
+/**
+ * @private
+ *
+ * @brief Une arête d'un snapshot binaire : son préfixe est la tranche [@c off, @c off + @c len[ des préfixes et son
+ * enfant est désigné par son indice, 0 pour une feuille. Les arêtes d'un noeud sont triées par premier caractère.
+ *
+ * Comme dans @c PatriciaEdge, les @c EDGE_INLINE premiers octets du préfixe sont aussi rangés dans l'arête : un
+ * préfixe court est comparé sans aller lire les préfixes.
+ */
+typedef struct AreteSnapshotPatricia
+{
+    uint32_t off;
+    uint32_t len;
+    uint32_t child;
+    char inl[EDGE_INLINE]; /**< Le début du préfixe, complété par des octets nuls */
+} AreteSnapshotPatricia;
+
+/**
+ * @private
+ *
+ * @brief Les tableaux d'un snapshot binaire, vus en place
+ */
+typedef struct VueSnapshotPatricia
+{
+    const NoeudSnapshotPatricia *noeuds;
+    const AreteSnapshotPatricia *aretes;
+    const char *labels;
+    uint32_t nb_noeuds;
+    uint32_t nb_aretes;
+    uint32_t nb_labels;
+} VueSnapshotPatricia;
+
+/**
+ * @private
+ *
+ * @brief Fonction qui renvoie la vue sur les tableaux du snapshot donné, dont l'entête est supposée cohérente
+ *
+ * @param snap
+ * @return VueSnapshotPatricia
+ */
+static VueSnapshotPatricia vue_snapshot_patricia(const void *snap)
+{
+    const EnteteSnapshotPatricia *e = snap;
+    VueSnapshotPatricia v;
+    v.noeuds = (const NoeudSnapshotPatricia *)(e + 1);
+    v.aretes = (const AreteSnapshotPatricia *)(v.noeuds + e->noeuds);
+    v.labels = (const char *)(v.aretes + e->aretes);
+    v.nb_noeuds = e->noeuds;
+    v.nb_aretes = e->aretes;
+    v.nb_labels = e->labels;
+    return v;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui calcule la somme de contrôle d'une zone mémoire, un FNV-1a sur des mots de 8 octets
+ *
+ * @param p
+ * @param n
+ * @return uint64_t
+ */
+static uint64_t somme_snapshot_patricia(const unsigned char *p, size_t n)
+{
+    uint64_t h = 0xcbf29ce484222325u;
+    for (; n >= sizeof(uint64_t); p += sizeof(uint64_t), n -= sizeof(uint64_t))
     {
-        fprintf(stderr, "Erreur, cJSON_AddBoolToObject dans constructJSONPT");
-        exit(1);
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h = (h ^ w) * 0x100000001b3u;
     }
-    cJSON *children = cJSON_CreateObject();
-    if (!children)
+    for (; n; p++, n--)
+        h = (h ^ *p) * 0x100000001b3u;
+    return h;
+}
+
+/**
+ * @brief Fonction qui sérialise le Patricia-Trie sous forme de snapshot binaire
+ *
+ * Après une entête de 32 octets (@c SNAPSHOT_PT_MAGIE, version, nombres de noeuds, d'arêtes et d'octets de préfixes,
+ * somme de contrôle de ce qui suit) viennent trois tableaux plats : les noeuds, numérotés en largeur à partir de la
+ * racine 0, les arêtes, contiguës pour un même noeud, et les préfixes mis bout à bout. Les pointeurs sont remplacés
+ * par des indices, le tout dans l'ordre des octets de la machine.
+ *
+ * @param node
+ * @param sz la taille en octets du snapshot
+ * @return void* le snapshot, à désallouer par l'appelant
+ */
+void *printSnapshotPT(const PatriciaNode *node, size_t *sz)
+{
+    assert(node && "Given Patricia-Trie can't be null here");
+    /* La file du parcours en largeur : la position d'un noeud dans la file est son indice dans le snapshot */
+    size_t n = 0, cap = 64, nb_aretes = 0, nb_labels = 0;
+    const PatriciaNode **file = malloc(cap * sizeof(*file));
+    if (!file)
     {
-        fprintf(stderr, "Erreur, cJSON_CreateObject dans constructJSONPT");
+        fprintf(stderr, "Erreur, malloc dans printSnapshotPT");
         exit(1);
     }
-    if (node)
+    file[n++] = node;
+    for (size_t i = 0; i < n; i++)
     {
-        for (int i = 1; i < ASCII_SIZE; i++)
+        int key = -1;
+        const PatriciaEdge *edge;
+        while ((edge = next_edge_patricia(file[i], &key)) != NULL)
         {
-            if (node->prefixes[i])
+            nb_aretes++;
+            nb_labels += edge->len;
+            if (!edge->child)
+                continue;
+            if (n == cap)
             {
-                cJSON *offspring = constructJSONPT(node->children[i], node->prefixes[i]);
-                char buf[2] = {(char)i, 0};
-                if (!cJSON_AddItemToObject(children, buf, offspring))
+                cap *= 2;
+                const PatriciaNode **tmp = realloc(file, cap * sizeof(*file));
+                if (!tmp)
                 {
-                    fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONPT");
+                    fprintf(stderr, "Erreur, realloc dans printSnapshotPT");
                     exit(1);
                 }
+                file = tmp;
             }
+            file[n++] = edge->child;
         }
     }
-    if (!cJSON_AddItemToObject(obj, "children", children))
+    if (n > UINT32_MAX || nb_aretes > UINT32_MAX || nb_labels > UINT32_MAX)
     {
-        fprintf(stderr, "Erreur, cJSON_AddItemToObject dans constructJSONPT");
+        fprintf(stderr, "Erreur, trie trop grand pour un snapshot dans printSnapshotPT");
         exit(1);
     }
-    return obj;
+
+    *sz = sizeof(EnteteSnapshotPatricia) + n * sizeof(NoeudSnapshotPatricia) +
+          nb_aretes * sizeof(AreteSnapshotPatricia) + nb_labels;
+    /* Mis à zéro pour que les octets de bourrage ne changent pas la somme de contrôle */
+    unsigned char *buf = calloc(1, *sz);
+    if (!buf)
+    {
+        fprintf(stderr, "Erreur, calloc dans printSnapshotPT");
+        exit(1);
+    }
+    EnteteSnapshotPatricia *e = (EnteteSnapshotPatricia *)buf;
+    memcpy(e->magie, SNAPSHOT_PT_MAGIE, sizeof(e->magie));
+    e->version = SNAPSHOT_PT_VERSION;
+    e->noeuds = (uint32_t)n;
+    e->aretes = (uint32_t)nb_aretes;
+    e->labels = (uint32_t)nb_labels;
+    NoeudSnapshotPatricia *noeuds = (NoeudSnapshotPatricia *)(e + 1);
+    AreteSnapshotPatricia *aretes = (AreteSnapshotPatricia *)(noeuds + n);
+    char *labels = (char *)(aretes + nb_aretes);
+    /* Les enfants sont renumérotés dans l'ordre où ils ont été mis dans la file */
+    uint32_t suivant = 1, a = 0, off = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        noeuds[i].arete = a;
+        noeuds[i].words = file[i]->words;
+        noeuds[i].count = file[i]->count;
+        noeuds[i].end = file[i]->end;
+        int key = -1;
+        const PatriciaEdge *edge;
+        while ((edge = next_edge_patricia(file[i], &key)) != NULL)
+        {
+            memcpy(labels + off, label_patricia(file[i], edge), edge->len);
+            aretes[a].off = off;
+            aretes[a].len = edge->len;
+            aretes[a].child = edge->child ? suivant++ : 0;
+            memcpy(aretes[a].inl, labels + off, edge->len < EDGE_INLINE ? edge->len : EDGE_INLINE);
+            off += edge->len;
+            a++;
+        }
+    }
+    free(file);
+    e->somme = somme_snapshot_patricia((const unsigned char *)(e + 1), *sz - sizeof(*e));
+    return buf;
 }
 
-char *printJSONPT(const PatriciaNode *node)
+/**
+ * @brief Fonction qui vérifie qu'une zone mémoire contient un snapshot de Patricia-Trie intègre
+ *
+ * Au-delà de l'entête et de la somme de contrôle, chaque arête doit rester dans les tableaux, commencer par un
+ * caractère ASCII, garder ses arêtes sœurs triées, et arêtes, préfixes et enfants doivent se suivre dans l'ordre où `printSnapshotPT()` les numérote : les
+ * recherches sur un snapshot vérifié restent dans la zone et terminent toujours, et il se désérialise en un arbre
+ * dont aucun sous-arbre n'est partagé. Les nombres de mots des noeuds doivent aussi être cohérents.
+ *
+ * @param snap la zone, alignée sur 8 octets, par exemple un fichier projeté avec `mmap()`
+ * @param sz sa taille en octets
+ * @return bool
+ */
+bool verifieSnapshotPT(const void *snap, size_t sz)
 {
-    assert(node && "Given Patricia-Trie can't be null here");
-    cJSON *json = constructJSONPT(node, "");
-    char *res = cJSON_Print(json);
-    cJSON_Delete(json);
-    return res;
+    const EnteteSnapshotPatricia *e = snap;
+    if (sz < sizeof(*e) || memcmp(e->magie, SNAPSHOT_PT_MAGIE, sizeof(e->magie)) != 0 ||
+        e->version != SNAPSHOT_PT_VERSION || e->noeuds == 0 ||
+        sz != sizeof(*e) + (size_t)e->noeuds * sizeof(NoeudSnapshotPatricia) +
+                  (size_t)e->aretes * sizeof(AreteSnapshotPatricia) + e->labels)
+        return false;
+    if (somme_snapshot_patricia((const unsigned char *)(e + 1), sz - sizeof(*e)) != e->somme)
+        return false;
+    VueSnapshotPatricia v = vue_snapshot_patricia(snap);
+    if (memchr(v.labels, '\0', v.nb_labels))
+        return false;
+    /* Arêtes, préfixes et enfants doivent être numérotés comme le fait `printSnapshotPT()` : chaque arête et chaque
+     * noeud a un seul parent, et tous sont atteints depuis la racine */
+    uint32_t suivant = 1, arete = 0, off = 0;
+    for (uint32_t i = 0; i < v.nb_noeuds; i++)
+    {
+        const NoeudSnapshotPatricia *n = &v.noeuds[i];
+        if (n->end > 1 || n->count > ASCII_SIZE || n->arete != arete || (uint64_t)n->arete + n->count > v.nb_aretes)
+            return false;
+        arete += n->count;
+        for (uint32_t k = n->arete; k < n->arete + n->count; k++)
+        {
+            const AreteSnapshotPatricia *a = &v.aretes[k];
+            /* Le premier caractère indexe les tables de 128 cases du noeud reconstruit */
+            if (a->len == 0 || (unsigned char)a->inl[0] >= ASCII_SIZE || a->off != off ||
+                (uint64_t)a->off + a->len > v.nb_labels ||
+                memcmp(a->inl, v.labels + a->off, a->len < EDGE_INLINE ? a->len : EDGE_INLINE) != 0 ||
+                (a->len < EDGE_INLINE && a->inl[a->len] != '\0') ||
+                (k > n->arete && (unsigned char)a[-1].inl[0] >= (unsigned char)a->inl[0]) ||
+                (a->child && a->child != suivant++))
+                return false;
+            off += a->len;
+        }
+    }
+    if (suivant != v.nb_noeuds || arete != v.nb_aretes || off != v.nb_labels)
+        return false;
+    /* Les enfants venant après leur parent, les nombres de mots se vérifient des feuilles à la racine */
+    for (uint32_t i = v.nb_noeuds; i-- > 0;)
+    {
+        const NoeudSnapshotPatricia *n = &v.noeuds[i];
+        uint64_t words = n->end;
+        for (uint32_t k = n->arete; k < n->arete + n->count; k++)
+            words += v.aretes[k].child ? v.noeuds[v.aretes[k].child].words : 1;
+        if (words != n->words)
+            return false;
+    }
+    return true;
 }
 
-bool parseJSONPT_hasChildren(const cJSON *json)
+/**
+ * @private
+ *
+ * @brief Fonction qui recrée sous @a node les arêtes du noeud @a i du snapshot, récursivement
+ *
+ * @param v
+ * @param i
+ * @param node
+ */
+static void parse_snapshot_rec_patricia(const VueSnapshotPatricia *v, uint32_t i, PatriciaNode *node)
 {
-    int count = 0;
-    const cJSON *elem;
-    cJSON_ArrayForEach(elem, json)
+    const NoeudSnapshotPatricia *n = &v->noeuds[i];
+    node->end = n->end;
+    for (uint32_t k = n->arete; k < n->arete + n->count; k++)
     {
-        count++;
+        const AreteSnapshotPatricia *a = &v->aretes[k];
+        PatriciaEdge *edge = add_edge_patricia(node, (unsigned char)a->inl[0]);
+        pose_mot_patricia(node->arena, edge, v->labels + a->off, a->len);
+        if (a->child)
+        {
+            edge->child = new_node_patricia(node->arena);
+            parse_snapshot_rec_patricia(v, a->child, edge->child);
+        }
     }
-    return !!count;
+    recompte_patricia(node);
 }
 
-PatriciaNode *parseJSONPT_rec(const cJSON *json, char **label)
+/**
+ * @brief Fonction qui désérialise un snapshot binaire en Patricia-Trie modifiable
+ *
+ * Comme @c parseJSONPT, la forme du trie est reprise telle quelle. Un snapshot qui ne passe pas
+ * @c verifieSnapshotPT arrête le programme.
+ *
+ * @param snap
+ * @param sz
+ * @return PatriciaNode*
+ */
+PatriciaNode *parseSnapshotPT(const void *snap, size_t sz)
 {
-    const cJSON *obj;
-
-    obj = cJSON_GetObjectItemCaseSensitive(json, "label");
-    assert(cJSON_IsString(obj) && "'label' element has to be a JSON string element");
-    *label = strdup(obj->valuestring);
-    if (!*label)
+    if (!verifieSnapshotPT(snap, sz))
     {
-        fprintf(stderr, "Erreur, strdup dans parseJSONPT_rec");
+        fprintf(stderr, "Erreur, snapshot invalide dans parseSnapshotPT");
         exit(1);
     }
+    VueSnapshotPatricia v = vue_snapshot_patricia(snap);
+    PatriciaNode *node = create_patricia_node();
+    parse_snapshot_rec_patricia(&v, 0, node);
+    return node;
+}
 
-    const cJSON *children;
-    children = cJSON_GetObjectItemCaseSensitive(json, "children");
-    assert(cJSON_IsObject(children) && "'children' element has to be a JSON object element");
-    bool hasChildren = parseJSONPT_hasChildren(children);
-    if (!hasChildren)
+/**
+ * @private
+ *
+ * @brief Fonction qui cherche par dichotomie l'arête d'un noeud du snapshot qui commence par @a c
+ *
+ * La dichotomie est sans branchement : à chaque pas la moitié gardée est choisie par une sélection conditionnelle,
+ * les comparaisons sur des caractères de mots n'étant pas prévisibles.
+ *
+ * @param v
+ * @param n
+ * @param c
+ * @return const AreteSnapshotPatricia* l'arête, NULL si absente
+ */
+static inline const AreteSnapshotPatricia *trouve_arete_snapshot_patricia(const VueSnapshotPatricia *v,
+                                                                         const NoeudSnapshotPatricia *n,
+                                                                         unsigned char c)
+{
+    const AreteSnapshotPatricia *a = v->aretes + n->arete;
+    uint32_t count = n->count;
+    if (count == 0)
         return NULL;
-
-    obj = cJSON_GetObjectItemCaseSensitive(json, "is_end_of_word");
-    assert(cJSON_IsBool(obj) && "'is_end_of_word' element has to be a JSON bool element");
-    bool isEnd = cJSON_IsTrue(obj);
-
-    PatriciaNode *node = create_patricia_node();
-    char *rec_label;
-    const cJSON *elem;
-    cJSON_ArrayForEach(elem, children)
+    while (count > 1)
     {
-        unsigned char index = elem->string[0];
-        node->children[index] = parseJSONPT_rec(elem, &rec_label);
-        node->prefixes[index] = rec_label;
+        uint32_t moitie = count / 2;
+        a = (unsigned char)a[moitie].inl[0] <= c ? a + moitie : a;
+        count -= moitie;
     }
+    return (unsigned char)a->inl[0] == c ? a : NULL;
+}
+
+/**
+ * @private
+ *
+ * @brief Fonction qui compare le préfixe d'une arête du snapshot à un mot, comme @c lcp_edge_patricia
+ *
+ * @param v
+ * @param a
+ * @param word
+ * @return LcpPatricia
+ */
+static inline LcpPatricia lcp_arete_snapshot_patricia(const VueSnapshotPatricia *v, const AreteSnapshotPatricia *a,
+                                                      const char *word)
+{
+    if (a->len > EDGE_INLINE)
+        return lcp_patricia(v->labels + a->off, a->len, word);
+    uint32_t label;
+    memcpy(&label, a->inl, sizeof(label));
+    uint32_t diff = label ^ charge_mot_patricia(word);
+    uint32_t i;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (a->len < sizeof(diff))
+        diff &= (1u << (8 * a->len)) - 1;
+    i = diff ? (uint32_t)__builtin_ctz(diff) / 8 : a->len;
+#else
+    if (a->len < sizeof(diff))
+        diff &= ~0u << (8 * (sizeof(diff) - a->len));
+    i = diff ? (uint32_t)__builtin_clz(diff) / 8 : a->len;
+#endif
+    return (LcpPatricia){i, i == a->len, word[i] == '\0'};
+}
 
-    if (hasChildren)
+/**
+ * @brief Fonction qui recherche un mot directement dans un snapshot binaire, sans le désérialiser
+ *
+ * @param snap un snapshot qui a passé @c verifieSnapshotPT
+ * @param word
+ * @return int le même résultat que @c recherche_patricia sur le trie du snapshot
+ */
+int recherche_snapshot_patricia(const void *snap, const char *word)
+{
+    VueSnapshotPatricia v = vue_snapshot_patricia(snap);
+    const NoeudSnapshotPatricia *n = &v.noeuds[0];
+    while (*word != '\0')
     {
-        if (isEnd)
-        {
-            char *end_str = strdup(" ");
-            if (!end_str)
-            {
-                fprintf(stderr, "Erreur, strdup dans parseJSONPT_rec");
-                exit(1);
-            }
-            node->prefixes[EOE_INDEX] = end_str;
-        }
-        else
-        {
-            node->prefixes[EOE_INDEX] = NULL;
-        }
+        const AreteSnapshotPatricia *a = trouve_arete_snapshot_patricia(&v, n, (unsigned char)*word);
+        if (a == NULL)
+            return 0;
+        LcpPatricia lcp = lcp_arete_snapshot_patricia(&v, a, word);
+        if (!lcp.fin_label)
+            return 0;
+        if (lcp.fin_mot)
+            return a->child == 0 || v.noeuds[a->child].end;
+        if (a->child == 0)
+            return 0;
+        word += lcp.len;
+        n = &v.noeuds[a->child];
     }
-
-    return node;
+    return n->end;
 }
 
-PatriciaNode *parseJSONPT(const char *json, size_t sz)
+/**
+ * @brief Fonction qui compte les mots ayant @a word pour préfixe directement dans un snapshot binaire
+ *
+ * @param snap un snapshot qui a passé @c verifieSnapshotPT
+ * @param word
+ * @return int le même résultat que @c nb_prefixe_patricia sur le trie du snapshot
+ */
+int nb_prefixe_snapshot_patricia(const void *snap, const char *word)
 {
-    cJSON *obj = cJSON_ParseWithLength(json, sz);
-    if (!obj)
+    VueSnapshotPatricia v = vue_snapshot_patricia(snap);
+    const NoeudSnapshotPatricia *n = &v.noeuds[0];
+    if (*word == '\0')
+        return 0;
+    for (;;)
     {
-        fprintf(stderr, "Erreur, cJSON_ParseWithLength dans parseJSONPT");
-        const char *error_ptr = cJSON_GetErrorPtr();
-        if (error_ptr)
-        {
-            fprintf(stderr, "Error before: %s\n", error_ptr);
-        }
-        exit(1);
+        const AreteSnapshotPatricia *a = trouve_arete_snapshot_patricia(&v, n, (unsigned char)*word);
+        if (a == NULL)
+            return 0;
+        LcpPatricia lcp = lcp_arete_snapshot_patricia(&v, a, word);
+        if (lcp.fin_mot)
+            return a->child ? (int)v.noeuds[a->child].words : 1;
+        if (!lcp.fin_label)
+            return 0;
+        if (a->child == 0)
+            return 1;
+        word += lcp.len;
+        n = &v.noeuds[a->child];
     }
-    char *label;
-    PatriciaNode *th = parseJSONPT_rec(obj, &label);
-    free(label);
-    cJSON_Delete(obj);
-    return th;
 }
@@ -0,0 +1,284 @@
+#define _POSIX_C_SOURCE 200809L /* for `fileno()` */
+#include "fluxjson.h"
+#include "unity.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+/* Ouvre un flux en mémoire sur une chaine nul terminée */
+static void ouvre(FluxJSON *f, const char *json)
+{
+    ouvreMemoireFluxJSON(f, json, strlen(json));
+}
+
+void test_jetons(void)
+{
+    const char *json = " {\"a\" :\t[true,false,\r\nnull, -1.5e3, 0]}";
+    FluxJSON f;
+    ouvre(&f, json);
+    const JetonJSON attendus[] = {JSON_DEBUT_OBJET, JSON_CHAINE, JSON_DEUX_POINTS, JSON_DEBUT_TABLEAU, JSON_VRAI,
+                                  JSON_VIRGULE, JSON_FAUX, JSON_VIRGULE, JSON_NUL, JSON_VIRGULE, JSON_NOMBRE,
+                                  JSON_VIRGULE, JSON_NOMBRE, JSON_FIN_TABLEAU, JSON_FIN_OBJET, JSON_FIN, JSON_FIN};
+    for (size_t i = 0; i < sizeof(attendus) / sizeof(attendus[0]); i++)
+    {
+        TEST_ASSERT_EQUAL_INT(attendus[i], jetonFluxJSON(&f));
+        if (attendus[i] == JSON_CHAINE)
+            TEST_ASSERT_EQUAL_STRING("a", f.chaine);
+        if (i == 10)
+            TEST_ASSERT_EQUAL_STRING("-1.5e3", f.chaine);
+    }
+    TEST_ASSERT_EQUAL_size_t(strlen(json), positionFluxJSON(&f));
+    fermeFluxJSON(&f);
+}
+
+void test_echappements(void)
+{
+    FluxJSON f;
+    ouvre(&f, "\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u0041\\u00e9\\u20ac\\ud83d\\ude00\" \"\\u0000x\"");
+    TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_STRING("a\"b\\c/d\b\f\n\r\tA\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", f.chaine);
+    TEST_ASSERT_EQUAL_size_t(strlen(f.chaine), f.lg);
+    /* Un caractère nul échappé est gardé, la longueur fait foi */
+    TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_size_t(2, f.lg);
+    TEST_ASSERT_EQUAL_CHAR('x', f.chaine[1]);
+    fermeFluxJSON(&f);
+}
+
+void test_erreurs(void)
+{
+    const char *invalides[] = {"\"abc", "\"a\nb\"", "\"\\x\"", "\"\\u12g4\"", "\"\\udc00\"", "\"\\ud83d\\u0041\"",
+                               "tru", "nul", "falsy", "-", "1.2.3", "@"};
+    for (size_t i = 0; i < sizeof(invalides) / sizeof(invalides[0]); i++)
+    {
+        FluxJSON f;
+        ouvre(&f, invalides[i]);
+        TEST_ASSERT_EQUAL_INT(JSON_ERREUR, jetonFluxJSON(&f));
+        fermeFluxJSON(&f);
+    }
+}
+
+void test_saute_valeur(void)
+{
+    FluxJSON f;
+    ouvre(&f, "{\"a\":[1,{\"b\":[]}],\"c\":\"d\"} 7 ] ,");
+    TEST_ASSERT_TRUE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+    TEST_ASSERT_TRUE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+    TEST_ASSERT_EQUAL_STRING("7", f.chaine);
+    TEST_ASSERT_FALSE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+    TEST_ASSERT_FALSE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+    fermeFluxJSON(&f);
+
+    ouvre(&f, "[[1,2]");
+    TEST_ASSERT_FALSE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+    fermeFluxJSON(&f);
+}
+
+/* Des chaines et des nombres à cheval sur deux blocs, lus depuis un tube */
+void test_blocs(void)
+{
+    const size_t n = 3 * TAILLE_FLUX_JSON + 17;
+    char *json = malloc(n + 1);
+    if (!json)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    for (size_t i = 0; i < n; i++)
+        json[i] = ' ';
+    json[n] = '\0';
+    /* Une chaine longue qui traverse le premier bloc, un échappement coupé au second, un nombre coupé au troisième */
+    json[10] = '"';
+    memset(json + 11, 'x', TAILLE_FLUX_JSON);
+    json[TAILLE_FLUX_JSON + 11] = '"';
+    memcpy(json + 2 * TAILLE_FLUX_JSON - 3, "\"\\u00e9\"", 8);
+    memcpy(json + 3 * TAILLE_FLUX_JSON - 2, "12345", 5);
+
+    FILE *fichier = tmpfile();
+    if (!fichier)
+        TEST_FAIL_MESSAGE("Erreur, tmpfile");
+    TEST_ASSERT_EQUAL_size_t(n, fwrite(json, 1, n, fichier));
+    fflush(fichier);
+    rewind(fichier);
+
+    FluxJSON f;
+    ouvreFluxJSON(&f, fileno(fichier));
+    TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_size_t(TAILLE_FLUX_JSON, f.lg);
+    TEST_ASSERT_EQUAL_CHAR('x', f.chaine[TAILLE_FLUX_JSON - 1]);
+    TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_STRING("\xc3\xa9", f.chaine);
+    TEST_ASSERT_EQUAL_INT(JSON_NOMBRE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_STRING("12345", f.chaine);
+    TEST_ASSERT_EQUAL_INT(JSON_FIN, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_size_t(n, positionFluxJSON(&f));
+    fermeFluxJSON(&f);
+    fclose(fichier);
+
+    /* Un tube rend des lectures plus courtes qu'un bloc */
+    int tube[2];
+    TEST_ASSERT_EQUAL_INT(0, pipe(tube));
+    TEST_ASSERT_EQUAL_INT(7, write(tube[1], "[\"ab\", ", 7));
+    TEST_ASSERT_EQUAL_INT(4, write(tube[1], "\"c\"]", 4));
+    close(tube[1]);
+    ouvreFluxJSON(&f, tube[0]);
+    TEST_ASSERT_TRUE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+    TEST_ASSERT_EQUAL_STRING("c", f.chaine);
+    TEST_ASSERT_EQUAL_INT(JSON_FIN, jetonFluxJSON(&f));
+    fermeFluxJSON(&f);
+    close(tube[0]);
+    free(json);
+}
+
+/* Écrit un objet qui couvre tous les cas de la sortie : membre vide, objet vide, imbrication, échappements et entier */
+static void ecritExemple(SortieJSON *s)
+{
+    debutObjetSortieJSON(s);
+    cleSortieJSON(s, "a", 1);
+    chaineSortieJSON(s, "x\"\\/\b\f\n\r\t\x01\x7f\xc3\xa9", 13);
+    cleSortieJSON(s, "", 0);
+    debutObjetSortieJSON(s);
+    finObjetSortieJSON(s);
+    cleSortieJSON(s, "c", 1);
+    debutObjetSortieJSON(s);
+    cleSortieJSON(s, "d", 1);
+    nulSortieJSON(s);
+    cleSortieJSON(s, "e", 1);
+    boolSortieJSON(s, true);
+    cleSortieJSON(s, "f", 1);
+    boolSortieJSON(s, false);
+    cleSortieJSON(s, "g", 1);
+    entierSortieJSON(s, -42);
+    finObjetSortieJSON(s);
+    finObjetSortieJSON(s);
+}
+
+void test_sortie(void)
+{
+    /* Le texte de cJSON_Print() et de cJSON_PrintUnformatted() */
+    SortieJSON s;
+    ouvreMemoireSortieJSON(&s, false);
+    ecritExemple(&s);
+    char *str = rendMemoireSortieJSON(&s);
+    TEST_ASSERT_EQUAL_STRING("{\n\t\"a\":\t\"x\\\"\\\\/\\b\\f\\n\\r\\t\\u0001\x7f\xc3\xa9\",\n\t\"\":\t{\n\t},\n"
+                             "\t\"c\":\t{\n\t\t\"d\":\tnull,\n\t\t\"e\":\ttrue,\n\t\t\"f\":\tfalse,\n"
+                             "\t\t\"g\":\t-42\n\t}\n}",
+                             str);
+    free(str);
+    ouvreMemoireSortieJSON(&s, true);
+    ecritExemple(&s);
+    str = rendMemoireSortieJSON(&s);
+    TEST_ASSERT_EQUAL_STRING("{\"a\":\"x\\\"\\\\/\\b\\f\\n\\r\\t\\u0001\x7f\xc3\xa9\",\"\":{},"
+                             "\"c\":{\"d\":null,\"e\":true,\"f\":false,\"g\":-42}}",
+                             str);
+
+    /* Le texte écrit se relit tel quel */
+    FluxJSON f;
+    ouvre(&f, str);
+    TEST_ASSERT_EQUAL_INT(JSON_DEBUT_OBJET, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_INT(JSON_DEUX_POINTS, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+    TEST_ASSERT_EQUAL_size_t(13, f.lg);
+    TEST_ASSERT_EQUAL_MEMORY("x\"\\/\b\f\n\r\t\x01\x7f\xc3\xa9", f.chaine, 13);
+    fermeFluxJSON(&f);
+    free(str);
+}
+
+/* Écrit beaucoup de petits membres puis une chaine plus grande que plusieurs blocs */
+static void ecritGrand(SortieJSON *s, const char *grand, size_t n)
+{
+    debutObjetSortieJSON(s);
+    for (int i = 0; i < 5000; i++)
+    {
+        cleSortieJSON(s, "k", 1);
+        chaineSortieJSON(s, "\n", 1);
+    }
+    cleSortieJSON(s, "grand", 5);
+    chaineSortieJSON(s, grand, n);
+    finObjetSortieJSON(s);
+}
+
+/* Une sortie bien plus grande qu'un bloc, vers un FILE puis vers un descripteur, identique à la sortie en mémoire */
+void test_sortie_blocs(void)
+{
+    const size_t n = 3 * TAILLE_FLUX_JSON;
+    char *grand = malloc(n);
+    if (!grand)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    for (size_t i = 0; i < n; i++)
+        grand[i] = (char)('a' + i % 26);
+    SortieJSON s;
+    ouvreMemoireSortieJSON(&s, false);
+    ecritGrand(&s, grand, n);
+    char *attendu = rendMemoireSortieJSON(&s);
+    size_t lg = strlen(attendu);
+    char *relu = malloc(lg + 1);
+    if (!relu)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        FILE *fichier = tmpfile();
+        if (!fichier)
+            TEST_FAIL_MESSAGE("Erreur, tmpfile");
+        if (mode)
+            ouvreSortieJSON(&s, fileno(fichier), false);
+        else
+            ouvreFichierSortieJSON(&s, fichier, false);
+        ecritGrand(&s, grand, n);
+        TEST_ASSERT_TRUE(fermeSortieJSON(&s));
+        rewind(fichier);
+        TEST_ASSERT_EQUAL_size_t(lg, fread(relu, 1, lg + 1, fichier));
+        TEST_ASSERT_EQUAL_MEMORY(attendu, relu, lg);
+        rewind(fichier);
+
+        FluxJSON f;
+        ouvreFluxJSON(&f, fileno(fichier));
+        TEST_ASSERT_EQUAL_INT(JSON_DEBUT_OBJET, jetonFluxJSON(&f));
+        TEST_ASSERT_TRUE(sauteValeurFluxJSON(&f, jetonFluxJSON(&f)));
+        for (int i = 0; i < 5000; i++)
+        {
+            TEST_ASSERT_EQUAL_INT(JSON_DEUX_POINTS, jetonFluxJSON(&f));
+            TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+            TEST_ASSERT_EQUAL_STRING("\n", f.chaine);
+            TEST_ASSERT_EQUAL_INT(JSON_VIRGULE, jetonFluxJSON(&f));
+            TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+        }
+        TEST_ASSERT_EQUAL_STRING("grand", f.chaine);
+        TEST_ASSERT_EQUAL_INT(JSON_DEUX_POINTS, jetonFluxJSON(&f));
+        TEST_ASSERT_EQUAL_INT(JSON_CHAINE, jetonFluxJSON(&f));
+        TEST_ASSERT_EQUAL_size_t(n, f.lg);
+        TEST_ASSERT_EQUAL_MEMORY(grand, f.chaine, n);
+        TEST_ASSERT_EQUAL_INT(JSON_FIN_OBJET, jetonFluxJSON(&f));
+        TEST_ASSERT_EQUAL_INT(JSON_FIN, jetonFluxJSON(&f));
+        fermeFluxJSON(&f);
+        fclose(fichier);
+    }
+    free(relu);
+    free(attendu);
+    free(grand);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_jetons);
+    RUN_TEST(test_echappements);
+    RUN_TEST(test_erreurs);
+    RUN_TEST(test_saute_valeur);
+    RUN_TEST(test_blocs);
+    RUN_TEST(test_sortie);
+    RUN_TEST(test_sortie_blocs);
+
+    return UNITY_END();
+}
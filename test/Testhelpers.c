@@ -0,0 +1,187 @@
+#define _POSIX_C_SOURCE 200809L /* for `mkdtemp()` */
+#include "helpers.h"
+#include "hybrid.h"
+#include "patricia.h"
+#include "unity.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Un dossier temporaire par test, avec le fichier de trie et son journal */
+static char dossier[64];
+static char trie[96];
+static char journal[112];
+
+void setUp(void)
+{
+    snprintf(dossier, sizeof(dossier), "/tmp/Testhelpers.XXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(dossier));
+    snprintf(trie, sizeof(trie), "%s/trie.json", dossier);
+    snprintf(journal, sizeof(journal), "%s.journal", trie);
+}
+
+void tearDown(void)
+{
+    unlink(journal);
+    unlink(trie);
+    rmdir(dossier);
+}
+
+/* Écrit le texte donné dans le fichier donné, en remplaçant son contenu */
+static void ecrit(const char *path, const char *texte)
+{
+    FILE *f = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_size_t(strlen(texte), fwrite(texte, 1, strlen(texte), f));
+    TEST_ASSERT_EQUAL_INT(0, fclose(f));
+}
+
+/* Renvoie le contenu du fichier donné, à libérer */
+static char *lit(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    char *texte = calloc(4096, 1);
+    TEST_ASSERT_NOT_NULL(texte);
+    fread(texte, 1, 4095, f);
+    fclose(f);
+    return texte;
+}
+
+/* Écrit le Patricia-Trie des mots donnés dans le fichier de trie */
+static void ecritPT(const char *const *mots, size_t n)
+{
+    PatriciaNode *pt = create_patricia_node();
+    for (size_t i = 0; i < n; i++)
+        insert_patricia(pt, mots[i]);
+    char *json = printJSONPT(pt);
+    ecrit(trie, json);
+    free(json);
+    free_patricia_node(pt);
+}
+
+/* Relit le Patricia-Trie du fichier de trie, sans son journal */
+static PatriciaNode *relitPT(void)
+{
+    int fd = open(trie, O_RDONLY);
+    TEST_ASSERT_TRUE(fd != -1);
+    PatriciaNode *pt = chargeJSONPT(fd);
+    close(fd);
+    return pt;
+}
+
+void test_compaction_rejoue_journal(void)
+{
+    const char *const mots[] = {"chat", "chien"};
+    ecritPT(mots, 2);
+    /* Dans l'ordre : "chat" supprimé puis rajouté, et une dernière ligne interrompue qui n'a jamais été confirmée */
+    ecrit(journal, "A chaton\nS chien\nS chat\nA chat\nA demi");
+    compactionMainPT(trie);
+
+    TEST_ASSERT_EQUAL_INT(-1, access(journal, F_OK));
+    PatriciaNode *pt = relitPT();
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(pt, "chat"));
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(pt, "chaton"));
+    TEST_ASSERT_EQUAL_INT(0, recherche_patricia(pt, "chien"));
+    TEST_ASSERT_EQUAL_INT(0, recherche_patricia(pt, "demi"));
+    TEST_ASSERT_EQUAL_INT(2, comptage_mots_patricia(pt));
+    free_patricia_node(pt);
+
+    /* Sans journal, le fichier n'est pas touché */
+    char *avant = lit(trie);
+    compactionMainPT(trie);
+    char *apres = lit(trie);
+    TEST_ASSERT_EQUAL_STRING(avant, apres);
+    free(avant);
+    free(apres);
+}
+
+void test_compaction_rejoue_journal_TH(void)
+{
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, "chat", VALFIN);
+    th = ajoutTH(th, "chien", VALFIN);
+    char *json = printJSONTH(th);
+    ecrit(trie, json);
+    free(json);
+    deleteTH(&th);
+    ecrit(journal, "A chaton\nS chien\nA dem");
+    compactionMainTH(trie);
+
+    TEST_ASSERT_EQUAL_INT(-1, access(journal, F_OK));
+    int fd = open(trie, O_RDONLY);
+    TEST_ASSERT_TRUE(fd != -1);
+    th = chargeJSONTH(fd);
+    close(fd);
+    TEST_ASSERT_TRUE(rechercheTH(th, "chat"));
+    TEST_ASSERT_TRUE(rechercheTH(th, "chaton"));
+    TEST_ASSERT_FALSE(rechercheTH(th, "chien"));
+    TEST_ASSERT_FALSE(rechercheTH(th, "dem"));
+    deleteTH(&th);
+}
+
+void test_journal_tronque(void)
+{
+    const char *const mots[] = {"chat"};
+    ecritPT(mots, 1);
+    /* La ligne interrompue est tronquée avant l'ajout, pour que le nouvel enregistrement ne s'y colle pas */
+    ecrit(journal, "A un\nA deu");
+    char entree[128];
+    snprintf(entree, sizeof(entree), "%s/mots.txt", dossier);
+    ecrit(entree, "trois\nquatre");
+    TEST_ASSERT_NOT_NULL(freopen(entree, "r", stdin));
+    insererFichierPT(trie);
+    unlink(entree);
+
+    char *texte = lit(journal);
+    TEST_ASSERT_EQUAL_STRING("A un\nA trois\nA quatre\n", texte);
+    free(texte);
+}
+
+void test_compaction_refusee_pendant_ecriture(void)
+{
+    const char *const mots[] = {"chat"};
+    ecritPT(mots, 1);
+    ecrit(journal, "A chaton\n");
+    /* Un écrivain, comme un serveur en mode journal, tient le journal sous verrou partagé */
+    int fd = open(journal, O_RDONLY);
+    TEST_ASSERT_TRUE(fd != -1);
+    TEST_ASSERT_EQUAL_INT(0, flock(fd, LOCK_SH));
+
+    fflush(stdout);
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid != -1);
+    if (pid == 0)
+    {
+        fclose(stderr);
+        compactionMainPT(trie);
+        _exit(0);
+    }
+    int statut;
+    TEST_ASSERT_EQUAL_INT(pid, waitpid(pid, &statut, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(statut));
+    TEST_ASSERT_EQUAL_INT(1, WEXITSTATUS(statut));
+    TEST_ASSERT_EQUAL_INT(0, access(journal, F_OK));
+
+    /* Le verrou rendu, la compaction passe */
+    close(fd);
+    compactionMainPT(trie);
+    TEST_ASSERT_EQUAL_INT(-1, access(journal, F_OK));
+    PatriciaNode *pt = relitPT();
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(pt, "chaton"));
+    free_patricia_node(pt);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_compaction_rejoue_journal);
+    RUN_TEST(test_compaction_rejoue_journal_TH);
+    RUN_TEST(test_journal_tronque);
+    RUN_TEST(test_compaction_refusee_pendant_ecriture);
+    return UNITY_END();
+}
@@ -1,9 +1,13 @@
+#define _POSIX_C_SOURCE 200809L /* for `fileno()` */
+#include "fluxjson.h"
 #include "hybrid.h"
 #include "unity.h"
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,7 +15,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifndef PATH_MAX
 #define PATH_MAX 1024
+#endif
 
 const char *const basic_example =
     "A quel genial professeur de dactylographie sommes nous redevables de la superbe phrase ci "
@@ -1670,6 +1676,34 @@ void test_f_supprTH_23(void)
     TEST_ASSERT_NULL(th);
 }
 
+/* White box test
+ *
+ * case #24:
+ * delete a missing one-letter key next to an existing one-letter key
+ */
+void test_f_supprTH_24(void)
+{
+    TrieHybride *th = newTH();
+    TEST_ASSERT_NULL(th);
+
+    th = ajoutTH(th, "b", VALFIN);
+    th = ajoutTH(th, "c", VALFIN);
+    TEST_ASSERT_NOT_NULL(th);
+
+    th = supprTH(th, "a");
+    TEST_ASSERT_NOT_NULL(th);
+    TEST_ASSERT_EQUAL_CHAR('b', th->label);
+    TEST_ASSERT(th->value == VALFIN);
+    th = supprTH(th, "d");
+    TEST_ASSERT_NOT_NULL(th->sup);
+    TEST_ASSERT_EQUAL_CHAR('c', th->sup->label);
+    TEST_ASSERT(th->sup->value == VALFIN);
+    TEST_ASSERT_EQUAL_size_t(2, comptageMotsTH(th));
+
+    deleteTH(&th);
+    TEST_ASSERT_NULL(th);
+}
+
 /* Black box test, results on valgrind */
 void test_tiny(void)
 {
@@ -2929,6 +2963,871 @@ void test_f_ajoutReequilibreTH_1(void)
     deleteTH(&th2);
 }
 
+/* Vérifie la hauteur gardée dans chaque noeud, et l'équilibre AVL de chaque niveau si demandé */
+static int verifie_hauteurs(const TrieHybride *th, bool avl)
+{
+    if (!th)
+        return 0;
+    int hi = verifie_hauteurs(th->inf, avl);
+    int hs = verifie_hauteurs(th->sup, avl);
+    verifie_hauteurs(th->eq, avl);
+    int h = 1 + (hi > hs ? hi : hs);
+    TEST_ASSERT_EQUAL_INT(h, th->h);
+    if (avl)
+        TEST_ASSERT(hi - hs <= 1 && hs - hi <= 1);
+    return h;
+}
+
+/* White box test */
+void test_f_ajoutReequilibreTH_2(void)
+{
+    TrieHybride *th = newTH();
+    char cle[3] = {0};
+    for (char c = 'a'; c <= 'z'; c++)
+    {
+        cle[0] = c;
+        cle[1] = '\0';
+        th = ajoutReequilibreTH(th, cle, VALFIN);
+        cle[1] = 'z' - (c - 'a');
+        th = ajoutReequilibreTH(th, cle, VALFIN);
+    }
+    verifie_hauteurs(th, true);
+    TEST_ASSERT_EQUAL_INT(5, th->h); /* 26 noeuds dans le premier niveau */
+    TEST_ASSERT_EQUAL_size_t(52, comptageMotsTH(th));
+    deleteTH(&th);
+}
+
+/* White box test */
+void test_f_supprReequilibreTH_1(void)
+{
+    TrieHybride *th = newTH();
+    char cle[3] = {0};
+    for (char c = 'a'; c <= 'z'; c++)
+    {
+        cle[0] = c;
+        cle[1] = c;
+        th = ajoutReequilibreTH(th, cle, VALFIN);
+    }
+    th = ajoutReequilibreTH(th, "mz", VALFIN);
+
+    /* Les suppressions d'un côté déséquilibreraient le niveau sans rotation */
+    for (char c = 'a'; c <= 'p'; c++)
+    {
+        cle[0] = c;
+        cle[1] = c;
+        th = supprReequilibreTH(th, cle);
+        verifie_hauteurs(th, true);
+    }
+    TEST_ASSERT_EQUAL_size_t(11, comptageMotsTH(th));
+    TEST_ASSERT_TRUE(rechercheTH(th, "mz"));
+    TEST_ASSERT_FALSE(rechercheTH(th, "mm"));
+    TEST_ASSERT_TRUE(rechercheTH(th, "qq"));
+
+    for (char c = 'q'; c <= 'z'; c++)
+    {
+        cle[0] = c;
+        cle[1] = c;
+        th = supprReequilibreTH(th, cle);
+    }
+    th = supprReequilibreTH(th, "mz");
+    TEST_ASSERT_NULL(th);
+}
+
+/* White box test */
+void test_f_construitTH_1(void)
+{
+    char cles[26 + 26 + 3][3] = {{0}};
+    char *mots[26 + 26 + 3];
+    size_t n = 0;
+    for (char c = 'z'; c >= 'a'; c--)
+    {
+        cles[n][0] = c;
+        mots[n] = cles[n];
+        n++;
+        cles[n][0] = c;
+        cles[n][1] = 'z' - (c - 'a');
+        mots[n] = cles[n];
+        n++;
+    }
+    mots[n++] = cles[0];  /* Doublon */
+    mots[n++] = cles[52]; /* Mot vide */
+    mots[n++] = cles[1];  /* Doublon */
+
+    TrieHybride *th = construitTH(mots, n, VALFIN);
+    TEST_ASSERT_NOT_NULL(th);
+    verifie_hauteurs(th, true);
+    TEST_ASSERT_EQUAL_INT(5, th->h); /* 26 noeuds dans le premier niveau */
+    TEST_ASSERT_EQUAL_size_t(52, comptageMotsTH(th));
+    for (size_t i = 1; i < n; i++)
+        TEST_ASSERT(strcmp(mots[i - 1], mots[i]) <= 0);
+
+    TrieHybride *th2 = newTH();
+    for (size_t i = 0; i < n; i++)
+        th2 = ajoutTH(th2, mots[i], VALFIN);
+    char **l1 = listeMotsTH(th);
+    char **l2 = listeMotsTH(th2);
+    for (size_t i = 0; l1[i] || l2[i]; i++)
+        TEST_ASSERT_EQUAL_STRING(l2[i], l1[i]);
+    deleteListeMotsTH(l1);
+    deleteListeMotsTH(l2);
+    TEST_ASSERT(profondeurMoyenneTH(th) < profondeurMoyenneTH(th2));
+
+    deleteTH(&th);
+    deleteTH(&th2);
+}
+
+/* Black box test */
+void test_f_construitTH_2(void)
+{
+    TEST_ASSERT_NULL(construitTH(NULL, 0, VALFIN));
+    char vide[] = "";
+    char *mots[] = {vide, vide};
+    TEST_ASSERT_NULL(construitTH(mots, 2, VALFIN));
+
+    char a[] = "a";
+    mots[1] = a;
+    TrieHybride *th = construitTH(mots, 2, VALFIN);
+    TEST_ASSERT_TRUE(rechercheTH(th, "a"));
+    TEST_ASSERT_EQUAL_size_t(1, comptageMotsTH(th));
+    TEST_ASSERT_EQUAL_INT(1, th->h);
+    deleteTH(&th);
+}
+
+/* White box test */
+void test_f_fusionTH_6(void)
+{
+    TrieHybride *th1 = newTH();
+    th1 = ajoutTH(th1, "q", VALFIN);
+    th1 = ajoutTH(th1, "car", VALFIN);
+    TrieHybride *th2 = newTH();
+    char cle[3] = {'q', '\0', '\0'};
+    for (char c = 'a'; c <= 'z'; c++)
+    {
+        cle[1] = c;
+        th2 = ajoutReequilibreTH(th2, cle, VALFIN);
+    }
+    th2 = ajoutTH(th2, "ca", VALFIN);
+    char *json = printJSONTH(th2);
+
+    th1 = fusionTH(&th1, th2);
+    verifie_hauteurs(th1, false);
+    TEST_ASSERT_EQUAL_size_t(29, comptageMotsTH(th1));
+    TEST_ASSERT_TRUE(rechercheTH(th1, "ca"));
+    TEST_ASSERT_TRUE(rechercheTH(th1, "car"));
+    TEST_ASSERT_TRUE(rechercheTH(th1, "qz"));
+
+    /* Le niveau sous "q" n'existait pas dans th1, il est copié tel quel depuis th2 */
+    const TrieHybride *q = th1;
+    while (q->label != 'q')
+        q = 'q' < q->label ? q->inf : q->sup;
+    TEST_ASSERT_EQUAL_INT(5, q->eq->h);
+    verifie_hauteurs(q->eq, true);
+
+    /* th2 n'est accédé qu'en lecture */
+    char *json2 = printJSONTH(th2);
+    TEST_ASSERT_EQUAL_STRING(json, json2);
+    free(json);
+    free(json2);
+    deleteTH(&th1);
+    deleteTH(&th2);
+}
+
+/* White box test */
+void test_f_hauteurs_ajoutTH(void)
+{
+    TrieHybride *th = newTH();
+    char cle[2] = {0};
+    for (char c = 'a'; c <= 'z'; c++)
+    {
+        cle[0] = c;
+        th = ajoutTH(th, cle, VALFIN);
+    }
+    TEST_ASSERT_EQUAL_INT(26, th->h); /* Sans rééquilibrage le niveau est une liste */
+    verifie_hauteurs(th, false);
+
+    th = supprTH(th, "a");
+    th = supprTH(th, "m");
+    th = rebalance(th);
+    verifie_hauteurs(th, false);
+    TEST_ASSERT_EQUAL_INT(23, th->h);
+    deleteTH(&th);
+}
+
+/* Vérifie le nombre de mots gardé dans chaque noeud et renvoie celui du sous arbre */
+static uint32_t verifie_mots(const TrieHybride *th)
+{
+    if (!th)
+        return 0;
+    uint32_t mots = !!th->value + verifie_mots(th->inf) + verifie_mots(th->eq) + verifie_mots(th->sup);
+    TEST_ASSERT_EQUAL_UINT32(mots, th->mots);
+    return mots;
+}
+
+/* White box test */
+void test_f_mots_operations(void)
+{
+    const char *const cles[] = {"car", "cart", "cat", "bat", "dog", "do", "a", "car"};
+    const size_t n = sizeof(cles) / sizeof(*cles);
+    TrieHybride *th1 = newTH(), *th2 = newTH();
+    for (size_t i = 0; i < n; i++)
+    {
+        th1 = ajoutTH(th1, cles[i], VALFIN);
+        th2 = ajoutReequilibreTH(th2, cles[n - 1 - i], VALFIN);
+        verifie_mots(th1);
+        verifie_mots(th2);
+    }
+    TEST_ASSERT_EQUAL_UINT32(7, th1->mots);
+    TEST_ASSERT_EQUAL_INT(3, prefixeTH(th2, "ca"));
+    TEST_ASSERT_EQUAL_INT(2, prefixeTH(th2, "car"));
+    TEST_ASSERT_EQUAL_INT(2, prefixeTH(th2, "do"));
+    TEST_ASSERT_EQUAL_INT(7, prefixeTH(th2, ""));
+
+    th1 = supprTH(th1, "car");
+    th1 = supprTH(th1, "cow");
+    verifie_mots(th1);
+    th2 = supprReequilibreTH(th2, "do");
+    verifie_mots(th2);
+    TEST_ASSERT_EQUAL_size_t(6, comptageMotsTH(th1));
+    TEST_ASSERT_EQUAL_size_t(6, comptageMotsTH(th2));
+
+    TrieHybride *th3 = newTH();
+    th3 = ajoutTH(th3, "cab", VALFIN);
+    th3 = ajoutTH(th3, "do", VALFIN);
+    th1 = fusionTH(&th1, th3);
+    verifie_mots(th1);
+    TEST_ASSERT_EQUAL_size_t(7, comptageMotsTH(th1));
+
+    char *json = printJSONTH(th1);
+    TrieHybride *copie = parseJSONTH(json, strlen(json));
+    free(json);
+    TEST_ASSERT_EQUAL_UINT32(7, verifie_mots(copie));
+
+    char *mots[] = {"cab", "car", "a", "car", "cart", ""};
+    TrieHybride *bloc = construitTH(mots, sizeof(mots) / sizeof(*mots), VALFIN);
+    TEST_ASSERT_EQUAL_UINT32(4, verifie_mots(bloc));
+
+    deleteTH(&th1);
+    deleteTH(&th2);
+    deleteTH(&th3);
+    deleteTH(&copie);
+    deleteTH(&bloc);
+}
+
+/* Black box test */
+void test_f_rankTH_selectTH(void)
+{
+    TrieHybride *th = newTH();
+    TEST_ASSERT_EQUAL_size_t(0, rankTH(th, "a"));
+    TEST_ASSERT_NULL(selectTH(th, 0));
+
+    const char *const cles[] = {"lune", "la", "le", "les", "lapin", "zebre", "arbre", "l"};
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+        th = ajoutReequilibreTH(th, cles[i], VALFIN);
+    char **l = listeMotsTH(th);
+    for (size_t k = 0; l[k]; k++)
+    {
+        TEST_ASSERT_EQUAL_size_t(k, rankTH(th, l[k]));
+        char *mot = selectTH(th, k);
+        TEST_ASSERT_EQUAL_STRING(l[k], mot);
+        free(mot);
+    }
+    deleteListeMotsTH(l);
+    TEST_ASSERT_NULL(selectTH(th, 8));
+
+    /* Clés absentes : avant tout, entre deux mots, préfixe et prolongement d'un mot, après tout */
+    TEST_ASSERT_EQUAL_size_t(0, rankTH(th, ""));
+    TEST_ASSERT_EQUAL_size_t(0, rankTH(th, "a"));
+    TEST_ASSERT_EQUAL_size_t(1, rankTH(th, "b"));
+    TEST_ASSERT_EQUAL_size_t(3, rankTH(th, "lap"));
+    TEST_ASSERT_EQUAL_size_t(4, rankTH(th, "lapins"));
+    TEST_ASSERT_EQUAL_size_t(6, rankTH(th, "lesa"));
+    TEST_ASSERT_EQUAL_size_t(8, rankTH(th, "zz"));
+
+    th = supprTH(th, "la");
+    TEST_ASSERT_EQUAL_size_t(2, rankTH(th, "lapin"));
+    char *mot = selectTH(th, 2);
+    TEST_ASSERT_EQUAL_STRING("lapin", mot);
+    free(mot);
+    deleteTH(&th);
+}
+
+/* Black box test */
+void test_f_curseurTH(void)
+{
+    CurseurTH *c = newCurseurTH(NULL);
+    TEST_ASSERT_NULL(suivantCurseurTH(c));
+    TEST_ASSERT_NULL(seekCurseurTH(c, "a"));
+    deleteCurseurTH(&c);
+    TEST_ASSERT_NULL(c);
+
+    TrieHybride *th = newTH();
+    const char *const cles[] = {"lune", "la", "le", "les", "lapin", "zebre", "arbre", "l"};
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+        th = ajoutReequilibreTH(th, cles[i], VALFIN);
+    char **l = listeMotsTH(th);
+
+    /* Parcours complet dans les deux sens, le curseur repart de l'autre bout une fois sorti */
+    c = newCurseurTH(th);
+    size_t k = 0;
+    for (const char *mot = suivantCurseurTH(c); mot; mot = suivantCurseurTH(c))
+        TEST_ASSERT_EQUAL_STRING(l[k++], mot);
+    TEST_ASSERT_EQUAL_size_t(8, k);
+    TEST_ASSERT_NULL(suivantCurseurTH(c));
+    while (k > 0)
+        TEST_ASSERT_EQUAL_STRING(l[--k], precedentCurseurTH(c));
+    TEST_ASSERT_NULL(precedentCurseurTH(c));
+    TEST_ASSERT_EQUAL_STRING("arbre", suivantCurseurTH(c));
+
+    /* Clés présentes et absentes, préfixe et prolongement d'un mot */
+    TEST_ASSERT_EQUAL_STRING("la", seekCurseurTH(c, "la"));
+    TEST_ASSERT_EQUAL_STRING("l", precedentCurseurTH(c));
+    TEST_ASSERT_EQUAL_STRING("lapin", seekCurseurTH(c, "lap"));
+    TEST_ASSERT_EQUAL_STRING("le", seekCurseurTH(c, "lapins"));
+    TEST_ASSERT_EQUAL_STRING("les", suivantCurseurTH(c));
+    TEST_ASSERT_EQUAL_STRING("arbre", seekCurseurTH(c, ""));
+    TEST_ASSERT_NULL(seekCurseurTH(c, "zz"));
+    TEST_ASSERT_EQUAL_STRING("zebre", precedentCurseurTH(c));
+
+    /* Intervalle [la, lu[ */
+    const char *const plage[] = {"la", "lapin", "le", "les"};
+    k = 0;
+    for (const char *mot = plageCurseurTH(c, "la", "lu"); mot; mot = suivantCurseurTH(c))
+        TEST_ASSERT_EQUAL_STRING(plage[k++], mot);
+    TEST_ASSERT_EQUAL_size_t(4, k);
+    TEST_ASSERT_EQUAL_STRING("les", precedentCurseurTH(c));
+    TEST_ASSERT_EQUAL_STRING("la", seekCurseurTH(c, "a"));
+    TEST_ASSERT_NULL(precedentCurseurTH(c));
+    TEST_ASSERT_NULL(seekCurseurTH(c, "m"));
+    TEST_ASSERT_EQUAL_STRING("les", precedentCurseurTH(c));
+    TEST_ASSERT_NULL(plageCurseurTH(c, "lz", "m"));
+    deleteCurseurTH(&c);
+
+    deleteListeMotsTH(l);
+    deleteTH(&th);
+}
+
+/* Black box test */
+void test_f_completeTH(void)
+{
+    char **l = completeTH(NULL, "", 3);
+    TEST_ASSERT_NULL(l[0]);
+    deleteListeMotsTH(l);
+
+    TrieHybride *th = newTH();
+    const char *const cles[] = {"car", "cat", "cart", "care", "dog", "ca", "do"};
+    const int valeurs[] = {50, 10, 40, 30, 70, 20, 60};
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+        th = ajoutTH(th, cles[i], valeurs[i]);
+    th = ajoutTH(th, "car", 1); /* Un mot déjà présent garde sa valeur */
+    TEST_ASSERT_EQUAL_INT(70, th->meilleur);
+
+    /* Meilleurs scores d'abord, le préfixe lui même compris */
+    l = completeTH(th, "ca", 3);
+    TEST_ASSERT_EQUAL_STRING("car", l[0]);
+    TEST_ASSERT_EQUAL_STRING("cart", l[1]);
+    TEST_ASSERT_EQUAL_STRING("care", l[2]);
+    TEST_ASSERT_NULL(l[3]);
+    deleteListeMotsTH(l);
+
+    /* k plus grand que le nombre de mots du préfixe */
+    const char *const tous[] = {"car", "cart", "care", "ca", "cat"};
+    l = completeTH(th, "c", 100);
+    for (size_t i = 0; i < sizeof(tous) / sizeof(*tous); i++)
+        TEST_ASSERT_EQUAL_STRING(tous[i], l[i]);
+    TEST_ASSERT_NULL(l[5]);
+    deleteListeMotsTH(l);
+
+    l = completeTH(th, "", 2);
+    TEST_ASSERT_EQUAL_STRING("dog", l[0]);
+    TEST_ASSERT_EQUAL_STRING("do", l[1]);
+    TEST_ASSERT_NULL(l[2]);
+    deleteListeMotsTH(l);
+
+    l = completeTH(th, "cx", 3);
+    TEST_ASSERT_NULL(l[0]);
+    deleteListeMotsTH(l);
+    l = completeTH(th, "car", 0);
+    TEST_ASSERT_NULL(l[0]);
+    deleteListeMotsTH(l);
+
+    /* Les scores suivent la suppression et la fusion */
+    th = supprTH(th, "dog");
+    TEST_ASSERT_EQUAL_INT(60, th->meilleur);
+    TrieHybride *th2 = newTH();
+    th2 = ajoutTH(th2, "cab", 90);
+    th2 = ajoutTH(th2, "do", 5);
+    th = fusionTH(&th, th2);
+    l = completeTH(th, "", 3);
+    TEST_ASSERT_EQUAL_STRING("cab", l[0]);
+    TEST_ASSERT_EQUAL_STRING("do", l[1]);
+    TEST_ASSERT_EQUAL_STRING("car", l[2]);
+    TEST_ASSERT_NULL(l[3]);
+    deleteListeMotsTH(l);
+
+    /* Les scores survivent au JSON */
+    char *js = printJSONTH(th);
+    TEST_ASSERT_NOT_NULL(strstr(js, "\"value\":\t90"));
+    TrieHybride *copie = parseJSONTH(js, strlen(js));
+    TEST_ASSERT_EQUAL_INT(90, copie->meilleur);
+    l = completeTH(copie, "", 3);
+    TEST_ASSERT_EQUAL_STRING("cab", l[0]);
+    TEST_ASSERT_EQUAL_STRING("do", l[1]);
+    TEST_ASSERT_EQUAL_STRING("car", l[2]);
+    deleteListeMotsTH(l);
+    char *js2 = printJSONTH(copie);
+    TEST_ASSERT_EQUAL_STRING(js, js2);
+    free(js);
+    free(js2);
+    deleteTH(&copie);
+
+    deleteTH(&th2);
+    deleteTH(&th);
+}
+
+/* Garde les mots rendus par fuzzySearchTH() avec leur distance */
+typedef struct trouves
+{
+    char mots[8][160];
+    int distances[8];
+    size_t n;
+} Trouves;
+
+static void trouve(const char *mot, int distance, void *ctx)
+{
+    Trouves *t = ctx;
+    TEST_ASSERT(t->n < 8);
+    snprintf(t->mots[t->n], sizeof(t->mots[t->n]), "%s", mot);
+    t->distances[t->n++] = distance;
+}
+
+/* Black box test */
+void test_f_fuzzySearchTH(void)
+{
+    Trouves t = {.n = 0};
+    TEST_ASSERT_EQUAL_size_t(0, fuzzySearchTH(NULL, "chat", 2, trouve, &t));
+
+    TrieHybride *th = newTH();
+    const char *const cles[] = {"chat", "chats", "chien", "char", "cat", "achat", "hat", "chateau"};
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+        th = ajoutTH(th, cles[i], VALFIN);
+
+    const char *const proches[] = {"achat", "cat", "char", "chat", "chats", "hat"};
+    const int distances[] = {1, 1, 1, 0, 1, 1};
+    TEST_ASSERT_EQUAL_size_t(6, fuzzySearchTH(th, "chat", 1, trouve, &t));
+    for (size_t i = 0; i < 6; i++)
+    {
+        TEST_ASSERT_EQUAL_STRING(proches[i], t.mots[i]);
+        TEST_ASSERT_EQUAL_INT(distances[i], t.distances[i]);
+    }
+
+    t.n = 0;
+    TEST_ASSERT_EQUAL_size_t(1, fuzzySearchTH(th, "chat", 0, trouve, &t));
+    TEST_ASSERT_EQUAL_STRING("chat", t.mots[0]);
+    TEST_ASSERT_EQUAL_size_t(0, fuzzySearchTH(th, "chat", -1, trouve, &t));
+    t.n = 0;
+    TEST_ASSERT_EQUAL_size_t(2, fuzzySearchTH(th, "", 3, trouve, &t));
+    TEST_ASSERT_EQUAL_STRING("cat", t.mots[0]);
+    TEST_ASSERT_EQUAL_STRING("hat", t.mots[1]);
+    /* Sans borne, tous les mots, sans débordement sur maxEdits + 1 */
+    t.n = 0;
+    TEST_ASSERT_EQUAL_size_t(8, fuzzySearchTH(th, "chat", INT_MAX, trouve, &t));
+    TEST_ASSERT_EQUAL_STRING("chateau", t.mots[4]);
+    TEST_ASSERT_EQUAL_INT(3, t.distances[4]);
+
+    /* Un mot plus profond que la réserve initiale de lignes */
+    char cle[151];
+    memset(cle, 'a', 150);
+    cle[150] = '\0';
+    th = ajoutTH(th, cle, VALFIN);
+    cle[75] = 'b';
+    t.n = 0;
+    TEST_ASSERT_EQUAL_size_t(1, fuzzySearchTH(th, cle, 1, trouve, &t));
+    TEST_ASSERT_EQUAL_INT(1, t.distances[0]);
+    TEST_ASSERT_EQUAL_size_t(150, strlen(t.mots[0]));
+    deleteTH(&th);
+}
+
+/* Garde les mots rendus par rechercheMotifTH() */
+static void trouveMotif(const char *mot, void *ctx)
+{
+    trouve(mot, 0, ctx);
+}
+
+/* Black box test */
+void test_f_rechercheMotifTH(void)
+{
+    Trouves t = {.n = 0};
+    TEST_ASSERT_EQUAL_size_t(0, rechercheMotifTH(NULL, "*", trouveMotif, &t));
+
+    TrieHybride *th = newTH();
+    const char *const cles[] = {"cat", "cut", "cot", "coat", "bat", "cart", "chat", "c"};
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+        th = ajoutTH(th, cles[i], VALFIN);
+
+    const char *const motifs[] = {"c?t", "c*t", "[bc]at", "[!c]*", "c[a-h]*", "c", "*", "\\*", "[c", ""};
+    const char *const attendus[] = {"cat cot cut", "cart cat chat coat cot cut", "bat cat", "bat", "cart cat chat", "c",
+                                    "bat c cart cat chat coat cot cut", "", "", ""};
+    for (size_t i = 0; i < sizeof(motifs) / sizeof(*motifs); i++)
+    {
+        t.n = 0;
+        size_t nb = rechercheMotifTH(th, motifs[i], trouveMotif, &t);
+        TEST_ASSERT_EQUAL_size_t(t.n, nb);
+        char liste[160] = "";
+        for (size_t k = 0; k < t.n; k++)
+            snprintf(liste + strlen(liste), sizeof(liste) - strlen(liste), k ? " %s" : "%s", t.mots[k]);
+        TEST_ASSERT_EQUAL_STRING(attendus[i], liste);
+    }
+
+    /* Plus de 64 éléments dans le motif */
+    char cle[101], motif[101];
+    memset(cle, 'a', 100);
+    memset(motif, '?', 100);
+    cle[100] = motif[100] = '\0';
+    th = ajoutTH(th, cle, VALFIN);
+    motif[50] = '*';
+    t.n = 0;
+    TEST_ASSERT_EQUAL_size_t(1, rechercheMotifTH(th, motif, trouveMotif, &t));
+    motif[50] = 'b';
+    TEST_ASSERT_EQUAL_size_t(0, rechercheMotifTH(th, motif, trouveMotif, &t));
+    deleteTH(&th);
+}
+
+/* Black box test */
+void test_f_longestPrefixTH(void)
+{
+    int v = 42;
+    TEST_ASSERT_EQUAL_size_t(0, longestPrefixTH(NULL, "10.1", &v));
+    TEST_ASSERT_EQUAL_INT(VALVIDE, v);
+
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, "10", 1);
+    th = ajoutTH(th, "10.1", 2);
+    th = ajoutTH(th, "10.1.2", 3);
+    th = ajoutTH(th, "192", 4);
+
+    TEST_ASSERT_EQUAL_size_t(6, longestPrefixTH(th, "10.1.2.3", &v));
+    TEST_ASSERT_EQUAL_INT(3, v);
+    TEST_ASSERT_EQUAL_size_t(6, longestPrefixTH(th, "10.1.2", &v));
+    TEST_ASSERT_EQUAL_size_t(4, longestPrefixTH(th, "10.1.9", &v));
+    TEST_ASSERT_EQUAL_INT(2, v);
+    TEST_ASSERT_EQUAL_size_t(2, longestPrefixTH(th, "10.9", NULL));
+    TEST_ASSERT_EQUAL_size_t(0, longestPrefixTH(th, "1", &v));
+    TEST_ASSERT_EQUAL_INT(VALVIDE, v);
+    TEST_ASSERT_EQUAL_size_t(0, longestPrefixTH(th, "", &v));
+    TEST_ASSERT_EQUAL_size_t(3, longestPrefixTH(th, "192.168", &v));
+    TEST_ASSERT_EQUAL_INT(4, v);
+
+    th = supprTH(th, "10.1");
+    TEST_ASSERT_EQUAL_size_t(2, longestPrefixTH(th, "10.1.9", &v));
+    TEST_ASSERT_EQUAL_INT(1, v);
+    deleteTH(&th);
+}
+
+/* Black box test */
+void test_f_rechercheBatchTH(void)
+{
+    /* Plus de clés que de recherches menées de front, pour que les places libérées soient reprises */
+    char cles[100][8];
+    const char *lot[102];
+    bool res[102];
+    TrieHybride *th = newTH();
+    for (int i = 0; i < 100; i++)
+    {
+        snprintf(cles[i], sizeof(cles[i]), "k%d", i * 7);
+        lot[i] = cles[i];
+        if (i % 3)
+            th = ajoutTH(th, cles[i], VALFIN);
+    }
+    lot[100] = "";
+    lot[101] = "k";
+
+    rechercheBatchTH(NULL, lot, 102, res);
+    for (size_t i = 0; i < 102; i++)
+        TEST_ASSERT_FALSE(res[i]);
+    rechercheBatchTH(th, lot, 102, res);
+    for (size_t i = 0; i < 102; i++)
+        TEST_ASSERT_EQUAL(rechercheTH(th, lot[i]), res[i]);
+    TEST_ASSERT_TRUE(res[1]);
+    TEST_ASSERT_FALSE(res[3]);
+    rechercheBatchTH(th, lot, 0, res);
+    deleteTH(&th);
+}
+
+/* Recalcule la somme de contrôle d'un snapshot modifié, rangée après 24 octets d'entête : un FNV-1a sur des mots de
+ * 8 octets des octets qui suivent l'entête de 32 octets */
+static void resigneSnapshot(void *snap, size_t sz)
+{
+    const unsigned char *p = (const unsigned char *)snap + 32;
+    size_t n = sz - 32;
+    uint64_t h = 0xcbf29ce484222325u;
+    for (; n >= sizeof(uint64_t); p += sizeof(uint64_t), n -= sizeof(uint64_t))
+    {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h = (h ^ w) * 0x100000001b3u;
+    }
+    for (; n; p++, n--)
+        h = (h ^ *p) * 0x100000001b3u;
+    memcpy((unsigned char *)snap + 24, &h, sizeof(h));
+}
+
+void test_f_snapshotTH(void)
+{
+    const char *lot[] = {"", "k", "k0", "k7", "k70", "k700", "k7000", "z", "k14x"};
+    size_t sz;
+    TrieHybride *th = newTH();
+    for (int i = 0; i < 100; i++)
+    {
+        char cle[8];
+        snprintf(cle, sizeof(cle), "k%d", i * 7);
+        th = ajoutReequilibreTH(th, cle, i + 1);
+    }
+
+    void *snap = printSnapshotTH(th, &sz);
+    TEST_ASSERT_TRUE(verifieSnapshotTH(snap, sz));
+    for (size_t i = 0; i < sizeof(lot) / sizeof(lot[0]); i++)
+    {
+        TEST_ASSERT_EQUAL(rechercheTH(th, lot[i]), rechercheSnapshotTH(snap, lot[i]));
+        TEST_ASSERT_EQUAL_INT(prefixeTH(th, lot[i]), prefixeSnapshotTH(snap, lot[i]));
+    }
+
+    /* Même disposition et mêmes valeurs après un aller-retour */
+    TrieHybride *copie = parseSnapshotTH(snap, sz);
+    char *js1 = printJSONTH(th), *js2 = printJSONTH(copie);
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    char **c1 = completeTH(th, "k", 5), **c2 = completeTH(copie, "k", 5);
+    for (size_t i = 0; c1[i] || c2[i]; i++)
+        TEST_ASSERT_EQUAL_STRING(c1[i], c2[i]);
+    TEST_ASSERT_EQUAL(hauteurTH(th), hauteurTH(copie));
+    deleteListeMotsTH(c1);
+    deleteListeMotsTH(c2);
+    free(js1);
+    free(js2);
+    deleteTH(&copie);
+
+    /* Un octet modifié ou manquant est détecté */
+    ((unsigned char *)snap)[sz - 5] ^= 1;
+    TEST_ASSERT_FALSE(verifieSnapshotTH(snap, sz));
+    ((unsigned char *)snap)[sz - 5] ^= 1;
+    TEST_ASSERT_FALSE(verifieSnapshotTH(snap, sz - 1));
+    TEST_ASSERT_FALSE(verifieSnapshotTH(snap, 4));
+
+    /* Un enfant partagé par deux parents est refusé, même avec une somme de contrôle juste */
+    NoeudHybride *noeuds = (NoeudHybride *)((unsigned char *)snap + 32);
+    uint32_t taille;
+    memcpy(&taille, (unsigned char *)snap + 12, sizeof(taille));
+    resigneSnapshot(snap, sz);
+    TEST_ASSERT_TRUE(verifieSnapshotTH(snap, sz));
+    uint32_t p = 1;
+    while (noeuds[p].sup)
+        p++;
+    TEST_ASSERT_TRUE(p < taille - 1);
+    noeuds[p].sup = taille - 1;
+    resigneSnapshot(snap, sz);
+    TEST_ASSERT_FALSE(verifieSnapshotTH(snap, sz));
+    noeuds[p].sup = 0;
+
+    /* Comme un nombre de mots faux */
+    uint32_t *mots = (uint32_t *)(noeuds + taille);
+    mots[1]++;
+    resigneSnapshot(snap, sz);
+    TEST_ASSERT_FALSE(verifieSnapshotTH(snap, sz));
+    mots[1]--;
+    resigneSnapshot(snap, sz);
+    TEST_ASSERT_TRUE(verifieSnapshotTH(snap, sz));
+    free(snap);
+    deleteTH(&th);
+
+    /* Des mots supprimés ne laissent pas de compteurs que la vérification refuserait */
+    th = ajoutTH(newTH(), "chat", 3);
+    th = ajoutTH(th, "chien", 9);
+    th = ajoutTH(th, "chaton", 5);
+    th = supprTH(th, "chien");
+    snap = printSnapshotTH(th, &sz);
+    TEST_ASSERT_TRUE(verifieSnapshotTH(snap, sz));
+    free(snap);
+    deleteTH(&th);
+
+    snap = printSnapshotTH(NULL, &sz);
+    TEST_ASSERT_TRUE(verifieSnapshotTH(snap, sz));
+    TEST_ASSERT_FALSE(rechercheSnapshotTH(snap, "k"));
+    TEST_ASSERT_EQUAL_INT(0, prefixeSnapshotTH(snap, ""));
+    TEST_ASSERT_NULL(parseSnapshotTH(snap, sz));
+    free(snap);
+}
+
+void test_f_chargeJSONTH(void)
+{
+    TrieHybride *th = newTH();
+    for (int i = 0; i < 3000; i++)
+    {
+        char cle[16];
+        snprintf(cle, sizeof(cle), "mot%d", i * 13);
+        th = ajoutTH(th, cle, VALFIN);
+    }
+
+    /* Un JSON de plusieurs blocs, lu depuis un fichier, redonne la même disposition */
+    char *js1 = printJSONTH(th);
+    TEST_ASSERT_TRUE(strlen(js1) > 2 * TAILLE_FLUX_JSON);
+    FILE *fichier = tmpfile();
+    if (!fichier)
+        TEST_FAIL_MESSAGE("Erreur, tmpfile");
+    fputs(js1, fichier);
+    fflush(fichier);
+    rewind(fichier);
+    TrieHybride *copie = chargeJSONTH(fileno(fichier));
+    fclose(fichier);
+    char *js2 = printJSONTH(copie);
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    TEST_ASSERT_EQUAL(hauteurTH(th), hauteurTH(copie));
+    TEST_ASSERT_EQUAL(comptageMotsTH(th), comptageMotsTH(copie));
+    TEST_ASSERT_EQUAL_INT(prefixeTH(th, "mot1"), prefixeTH(copie, "mot1"));
+    free(js1);
+    free(js2);
+    deleteTH(&copie);
+    deleteTH(&th);
+
+    /* Clés dans le désordre ou absentes, clé inconnue et caractère échappé */
+    const char *js = "{\"right\":null,\"extra\":[1,{\"a\":true}],\"char\":\"\\u0061\",\"is_end_of_word\":true,"
+                     "\"left\":null,\"middle\":{\"middle\":null,\"char\":\"b\",\"is_end_of_word\":true}}";
+    th = parseJSONTH(js, strlen(js));
+    TEST_ASSERT_TRUE(rechercheTH(th, "a"));
+    TEST_ASSERT_TRUE(rechercheTH(th, "ab"));
+    TEST_ASSERT_EQUAL(2, comptageMotsTH(th));
+    TEST_ASSERT_EQUAL_INT(2, prefixeTH(th, "a"));
+    deleteTH(&th);
+
+    /* La valeur de fin de mot, avant ou après "is_end_of_word" */
+    js = "{\"char\":\"a\",\"value\":7,\"is_end_of_word\":true,\"left\":null,\"right\":null,"
+         "\"middle\":{\"char\":\"b\",\"is_end_of_word\":true,\"value\":-3,\"left\":null,\"middle\":null,"
+         "\"right\":null}}";
+    th = parseJSONTH(js, strlen(js));
+    int v;
+    TEST_ASSERT_EQUAL_size_t(1, longestPrefixTH(th, "a", &v));
+    TEST_ASSERT_EQUAL_INT(7, v);
+    TEST_ASSERT_EQUAL_size_t(2, longestPrefixTH(th, "ab", &v));
+    TEST_ASSERT_EQUAL_INT(-3, v);
+    TEST_ASSERT_EQUAL_INT(7, th->meilleur);
+    deleteTH(&th);
+
+    th = parseJSONTH("null", 4);
+    TEST_ASSERT_EQUAL(0, comptageMotsTH(th));
+    deleteTH(&th);
+}
+
+void test_f_ecritJSONTH(void)
+{
+    /* La sortie compacte est celle de cJSON_PrintUnformatted() */
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, "ab", VALFIN);
+    th = ajoutTH(th, "\"", VALFIN);
+    SortieJSON s;
+    ouvreMemoireSortieJSON(&s, true);
+    ecritJSONTH(th, &s);
+    char *js = rendMemoireSortieJSON(&s);
+    TEST_ASSERT_EQUAL_STRING("{\"char\":\"a\",\"is_end_of_word\":false,\"left\":{\"char\":\"\\\"\","
+                             "\"is_end_of_word\":true,\"left\":null,\"middle\":null,\"right\":null},\"middle\":{\"char\":\"b\","
+                             "\"is_end_of_word\":true,\"left\":null,\"middle\":null,\"right\":null},\"right\":null}",
+                             js);
+    free(js);
+    deleteTH(&th);
+
+    ouvreMemoireSortieJSON(&s, true);
+    ecritJSONTH(th, &s);
+    js = rendMemoireSortieJSON(&s);
+    TEST_ASSERT_EQUAL_STRING("null", js);
+    free(js);
+
+    /* Vers un descripteur, en plusieurs blocs, la sortie formatée est celle de printJSONTH() */
+    for (int i = 0; i < 3000; i++)
+    {
+        char cle[16];
+        snprintf(cle, sizeof(cle), "ecrit%d", i * 7);
+        th = ajoutTH(th, cle, VALFIN);
+    }
+    char *js1 = printJSONTH(th);
+    FILE *fichier = tmpfile();
+    if (!fichier)
+        TEST_FAIL_MESSAGE("Erreur, tmpfile");
+    ouvreSortieJSON(&s, fileno(fichier), false);
+    ecritJSONTH(th, &s);
+    TEST_ASSERT_TRUE(fermeSortieJSON(&s));
+    TEST_ASSERT_EQUAL_size_t(strlen(js1), (size_t)lseek(fileno(fichier), 0, SEEK_CUR));
+    char *js2 = malloc(strlen(js1) + 1);
+    if (!js2)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    TEST_ASSERT_EQUAL_size_t(strlen(js1), pread(fileno(fichier), js2, strlen(js1), 0));
+    js2[strlen(js1)] = '\0';
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    free(js2);
+
+    /* Relue, la sortie compacte redonne la même disposition */
+    rewind(fichier);
+    if (ftruncate(fileno(fichier), 0) != 0)
+        TEST_FAIL_MESSAGE("Erreur, ftruncate");
+    ouvreFichierSortieJSON(&s, fichier, true);
+    ecritJSONTH(th, &s);
+    TEST_ASSERT_TRUE(fermeSortieJSON(&s));
+    rewind(fichier);
+    TrieHybride *copie = chargeJSONTH(fileno(fichier));
+    fclose(fichier);
+    js2 = printJSONTH(copie);
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    free(js1);
+    free(js2);
+    deleteTH(&copie);
+    deleteTH(&th);
+}
+
+#ifndef HYBRID_RECURSIF
+/* Black box test, trop profond pour les versions récursives */
+void test_cle_profonde(void)
+{
+    const size_t lgr = 1000000;
+    char *cle = malloc(lgr + 1);
+    if (!cle)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    memset(cle, 'a', lgr);
+    cle[lgr] = '\0';
+
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, cle, VALFIN);
+    cle[lgr / 2] = '\0';
+    th = ajoutTH(th, cle, VALFIN);
+    th = ajoutReequilibreTH(th, "b", VALFIN);
+    TEST_ASSERT_TRUE(rechercheTH(th, cle));
+    cle[lgr / 2] = 'a';
+    TEST_ASSERT_TRUE(rechercheTH(th, cle));
+    TEST_ASSERT_EQUAL_size_t(3, comptageMotsTH(th));
+    TEST_ASSERT_EQUAL(lgr - 1, hauteurTH(th));
+    TEST_ASSERT_EQUAL_INT(3, prefixeTH(th, ""));
+
+    char **l = listeMotsTH(th);
+    TEST_ASSERT_EQUAL_size_t(lgr / 2, strlen(l[0]));
+    TEST_ASSERT_EQUAL_STRING(cle, l[1]);
+    TEST_ASSERT_EQUAL_STRING("b", l[2]);
+    deleteListeMotsTH(l);
+
+    TrieHybride *copie = fusionCopieTH(th, NULL);
+    TEST_ASSERT_EQUAL_size_t(3, comptageMotsTH(copie));
+    deleteTH(&copie);
+
+    char b[] = "b";
+    char *mots[] = {cle, b};
+    copie = construitTH(mots, 2, VALFIN);
+    TEST_ASSERT_TRUE(rechercheTH(copie, cle));
+    TEST_ASSERT_EQUAL(lgr - 1, hauteurTH(copie));
+    deleteTH(&copie);
+
+    th = supprTH(th, cle);
+    TEST_ASSERT_FALSE(rechercheTH(th, cle));
+    TEST_ASSERT_EQUAL(lgr / 2 - 1, hauteurTH(th));
+    deleteTH(&th);
+    TEST_ASSERT_NULL(th);
+    free(cle);
+}
+#endif
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -2968,6 +3867,7 @@ int main(void)
     RUN_TEST(test_f_supprTH_21);
     RUN_TEST(test_f_supprTH_22);
     RUN_TEST(test_f_supprTH_23);
+    RUN_TEST(test_f_supprTH_24);
     RUN_TEST(test_tiny);
     RUN_TEST(test_base);
     RUN_TEST(test_base_suppr);
@@ -3013,5 +3913,25 @@ int main(void)
     RUN_TEST(test_f_fusionTH_5);
     RUN_TEST(test_f_fusionCopieTH_1);
     RUN_TEST(test_f_ajoutReequilibreTH_1);
+    RUN_TEST(test_f_ajoutReequilibreTH_2);
+    RUN_TEST(test_f_supprReequilibreTH_1);
+    RUN_TEST(test_f_hauteurs_ajoutTH);
+    RUN_TEST(test_f_mots_operations);
+    RUN_TEST(test_f_rankTH_selectTH);
+    RUN_TEST(test_f_curseurTH);
+    RUN_TEST(test_f_completeTH);
+    RUN_TEST(test_f_fuzzySearchTH);
+    RUN_TEST(test_f_rechercheMotifTH);
+    RUN_TEST(test_f_longestPrefixTH);
+    RUN_TEST(test_f_rechercheBatchTH);
+    RUN_TEST(test_f_snapshotTH);
+    RUN_TEST(test_f_chargeJSONTH);
+    RUN_TEST(test_f_ecritJSONTH);
+    RUN_TEST(test_f_fusionTH_6);
+    RUN_TEST(test_f_construitTH_1);
+    RUN_TEST(test_f_construitTH_2);
+#ifndef HYBRID_RECURSIF
+    RUN_TEST(test_cle_profonde);
+#endif
     return UNITY_END();
 }
@@ -0,0 +1,354 @@
+#define HYBRID_SLAB
+#include "hybrid.h"
+#include "unity.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define PATH_MAX 1024
+
+void setUp(void)
+{
+    // set stuff up here
+}
+
+void tearDown(void)
+{
+    // clean stuff up here
+}
+
+/* Charge les mots de test/Shakespeare dans un tableau terminé par nul, les chaines pointent dans *bufs */
+static char **load_shakespeare(char ***bufs)
+{
+    const char *const dir_path = "test/Shakespeare/";
+    size_t sz = 0, cap = 1024, nbufs = 0;
+    char **tab = malloc(cap * sizeof(*tab));
+    *bufs = NULL;
+    if (!tab)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+
+    DIR *dir;
+    if ((dir = opendir(dir_path)) == NULL)
+        TEST_FAIL_MESSAGE("Erreur, opendir");
+    struct dirent *dirent;
+    char path_buf[PATH_MAX];
+    while ((dirent = readdir(dir)) != NULL)
+    {
+        if (strstr(dirent->d_name, ".txt") == NULL)
+            continue;
+        snprintf(path_buf, PATH_MAX, "%s%s", dir_path, dirent->d_name);
+
+        struct stat stat_buf;
+        int fd;
+        if ((fd = open(path_buf, O_RDONLY)) == -1 || fstat(fd, &stat_buf) == -1)
+            TEST_FAIL_MESSAGE("Erreur, open");
+        char *buf = malloc(stat_buf.st_size + 1);
+        *bufs = realloc(*bufs, (nbufs + 2) * sizeof(**bufs));
+        if (!buf || !*bufs || read(fd, buf, stat_buf.st_size) < stat_buf.st_size)
+            TEST_FAIL_MESSAGE("Erreur, read");
+        buf[stat_buf.st_size] = '\0';
+        (*bufs)[nbufs++] = buf;
+        (*bufs)[nbufs] = NULL;
+        close(fd);
+
+        for (char *curr = strtok(buf, "\n"); curr; curr = strtok(NULL, "\n"))
+        {
+            if (sz + 1 == cap)
+            {
+                cap *= 2;
+                tab = realloc(tab, cap * sizeof(*tab));
+                if (!tab)
+                    TEST_FAIL_MESSAGE("Erreur, realloc");
+            }
+            tab[sz++] = curr;
+        }
+    }
+    closedir(dir);
+    tab[sz] = NULL;
+    return tab;
+}
+
+static void free_shakespeare(char **tab, char **bufs)
+{
+    for (char **b = bufs; b && *b; b++)
+        free(*b);
+    free(bufs);
+    free(tab);
+}
+
+/* White box test */
+void test_slab_noeud(void)
+{
+    TEST_ASSERT_EQUAL_size_t(16, sizeof(NoeudHybride));
+}
+
+/* Black box test */
+void test_slab_vide(void)
+{
+    TrieHybride *th = newTH();
+    TEST_ASSERT_NULL(th);
+    th = ajoutTH(th, "", VALFIN);
+    TEST_ASSERT_NULL(th);
+    th = supprTH(th, "hello");
+    TEST_ASSERT_NULL(th);
+    TEST_ASSERT_FALSE(rechercheTH(th, "hello"));
+    TEST_ASSERT_EQUAL_size_t(0, comptageMotsTH(th));
+    TEST_ASSERT_NULL(listeMotsTH(th));
+    deleteTH(&th);
+    TEST_ASSERT_NULL(th);
+}
+
+/* White box test */
+void test_slab_ajout(void)
+{
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, "hip", VALFIN);
+    th = ajoutTH(th, "hi", VALFIN);
+    TEST_ASSERT_NOT_NULL(th);
+    TEST_ASSERT_EQUAL_UINT32(4, th->taille); /* La case 0 et les 3 noeuds */
+
+    const NoeudHybride *h = &th->noeuds[th->racine];
+    TEST_ASSERT_EQUAL_CHAR('h', h->label);
+    TEST_ASSERT_EQUAL_UINT32(0, h->inf);
+    TEST_ASSERT_EQUAL_UINT32(0, h->sup);
+    const NoeudHybride *i = &th->noeuds[h->eq];
+    TEST_ASSERT_EQUAL_CHAR('i' | FINMOT, i->label);
+    const NoeudHybride *p = &th->noeuds[i->eq];
+    TEST_ASSERT_EQUAL_CHAR('p' | FINMOT, p->label);
+    TEST_ASSERT_EQUAL_UINT32(0, p->eq);
+
+    TEST_ASSERT_TRUE(rechercheTH(th, "hi"));
+    TEST_ASSERT_TRUE(rechercheTH(th, "hip"));
+    TEST_ASSERT_FALSE(rechercheTH(th, "h"));
+    deleteTH(&th);
+    TEST_ASSERT_NULL(th);
+}
+
+/* White box test */
+void test_slab_libre(void)
+{
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, "her", VALFIN);
+    th = ajoutTH(th, "hit", VALFIN);
+    th = ajoutTH(th, "ho", VALFIN);
+    uint32_t taille = th->taille;
+
+    th = supprTH(th, "hit");
+    TEST_ASSERT_NOT_NULL(th);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, th->libre);
+    TEST_ASSERT_FALSE(rechercheTH(th, "hit"));
+
+    /* Les cases libérées sont réutilisées avant d'entamer la slab */
+    th = ajoutTH(th, "hut", VALFIN);
+    TEST_ASSERT_EQUAL_UINT32(taille, th->taille);
+    TEST_ASSERT_EQUAL_UINT32(0, th->libre);
+    TEST_ASSERT_EQUAL_size_t(3, comptageMotsTH(th));
+    TEST_ASSERT_EQUAL_UINT32(3, th->mots[th->racine]); /* Le nombre de mots suit la case réutilisée */
+
+    /* Le meilleur score du sous arbre aussi */
+    th = ajoutTH(th, "hop", 7);
+    TEST_ASSERT_EQUAL_INT(7, th->meilleurs[th->racine]);
+    char **l = completeTH(th, "h", 2);
+    TEST_ASSERT_EQUAL_STRING("hop", l[0]);
+    TEST_ASSERT_NOT_NULL(l[1]);
+    TEST_ASSERT_NULL(l[2]);
+    deleteListeMotsTH(l);
+    th = supprTH(th, "hop");
+    TEST_ASSERT_EQUAL_INT(VALFIN, th->meilleurs[th->racine]);
+
+    th = supprTH(th, "her");
+    th = supprTH(th, "ho");
+    th = supprTH(th, "hut");
+    TEST_ASSERT_NULL(th);
+}
+
+/* Black box test */
+void test_slab_shakespeare(void)
+{
+    char **bufs;
+    char **words = load_shakespeare(&bufs);
+
+    TrieHybride *th = newTH();
+    for (char **w = words; *w; w++)
+        th = ajoutTH(th, *w, VALFIN);
+    for (char **w = words; *w; w++)
+        TEST_ASSERT_TRUE(rechercheTH(th, *w));
+
+    char **l = listeMotsTH(th);
+    size_t n = 0;
+    for (; l[n]; n++)
+        if (n > 0)
+            TEST_ASSERT(strcmp(l[n - 1], l[n]) < 0);
+    TEST_ASSERT_EQUAL_size_t(comptageMotsTH(th), n);
+    CurseurTH *c = newCurseurTH(th);
+    for (size_t k = n; k > 0; k--)
+        TEST_ASSERT_EQUAL_STRING(l[k - 1], precedentCurseurTH(c));
+    TEST_ASSERT_NULL(precedentCurseurTH(c));
+    TEST_ASSERT_EQUAL_STRING(l[n / 2], seekCurseurTH(c, l[n / 2]));
+    TEST_ASSERT_EQUAL_STRING(l[n / 2 + 1], suivantCurseurTH(c));
+    deleteCurseurTH(&c);
+    deleteListeMotsTH(l);
+
+    size_t nmots = 0;
+    while (words[nmots])
+        nmots++;
+    char **copieMots = malloc(nmots * sizeof(*copieMots));
+    if (!copieMots)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    memcpy(copieMots, words, nmots * sizeof(*copieMots));
+    TrieHybride *bloc = construitTH(copieMots, nmots, VALFIN);
+    free(copieMots);
+    l = listeMotsTH(bloc);
+    char **l2 = listeMotsTH(th);
+    for (size_t k = 0; l[k] || l2[k]; k++)
+        TEST_ASSERT_EQUAL_STRING(l2[k], l[k]);
+    deleteListeMotsTH(l);
+    deleteListeMotsTH(l2);
+    TEST_ASSERT(profondeurMoyenneTH(bloc) < profondeurMoyenneTH(th));
+    deleteTH(&bloc);
+
+    char *json = printJSONTH(th);
+    TrieHybride *copie = parseJSONTH(json, strlen(json));
+    char *json2 = printJSONTH(copie);
+    TEST_ASSERT_EQUAL_STRING(json, json2);
+    free(json);
+    free(json2);
+    deleteTH(&copie);
+
+    size_t i = 0;
+    for (char **w = words; *w; w++, i++)
+        if (i % 2)
+            th = supprTH(th, *w);
+    i = 0;
+    for (char **w = words; *w; w++, i++)
+        if (i % 2)
+            TEST_ASSERT_FALSE(rechercheTH(th, *w));
+    bool *res = malloc(nmots * sizeof(*res));
+    if (!res)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    rechercheBatchTH(th, (const char *const *)words, nmots, res);
+    for (i = 0; i < nmots; i++)
+        TEST_ASSERT_EQUAL(rechercheTH(th, words[i]), res[i]);
+    free(res);
+    /* La slab a des cases libres, le snapshot n'en garde que les noeuds atteints */
+    size_t sz;
+    void *snap = printSnapshotTH(th, &sz);
+    TEST_ASSERT_TRUE(verifieSnapshotTH(snap, sz));
+    TrieHybride *relu = parseSnapshotTH(snap, sz);
+    TEST_ASSERT_TRUE(relu->taille <= th->taille);
+    for (i = 0; i < nmots; i += 7)
+    {
+        TEST_ASSERT_EQUAL(rechercheTH(th, words[i]), rechercheSnapshotTH(snap, words[i]));
+        TEST_ASSERT_EQUAL_INT(prefixeTH(th, words[i]), prefixeSnapshotTH(snap, words[i]));
+        TEST_ASSERT_EQUAL(rechercheTH(th, words[i]), rechercheTH(relu, words[i]));
+    }
+    TEST_ASSERT_EQUAL_size_t(comptageMotsTH(th), comptageMotsTH(relu));
+    deleteTH(&relu);
+    free(snap);
+    for (char **w = words; *w; w++)
+        th = supprTH(th, *w);
+    TEST_ASSERT_NULL(th);
+
+    free_shakespeare(words, bufs);
+}
+
+/* Black box test */
+void test_slab_fusion(void)
+{
+    TrieHybride *th1 = newTH();
+    th1 = ajoutTH(th1, "cat", VALFIN);
+    th1 = ajoutTH(th1, "car", VALFIN);
+    TrieHybride *th2 = newTH();
+    th2 = ajoutTH(th2, "art", VALFIN);
+    th2 = ajoutTH(th2, "cart", VALFIN);
+
+    TrieHybride *tf = fusionCopieTH(th1, th2);
+    th1 = fusionTH(&th1, th2);
+    TEST_ASSERT_EQUAL_size_t(4, comptageMotsTH(th1));
+    TEST_ASSERT_EQUAL_size_t(4, comptageMotsTH(tf));
+
+    char **l = listeMotsTH(th1);
+    TEST_ASSERT_EQUAL_STRING("art", l[0]);
+    TEST_ASSERT_EQUAL_STRING("car", l[1]);
+    TEST_ASSERT_EQUAL_STRING("cart", l[2]);
+    TEST_ASSERT_EQUAL_STRING("cat", l[3]);
+    TEST_ASSERT_NULL(l[4]);
+    deleteListeMotsTH(l);
+
+    deleteTH(&th1);
+    deleteTH(&th2);
+    deleteTH(&tf);
+}
+
+/* Black box test */
+void test_slab_ajoutReequilibre(void)
+{
+    TrieHybride *th1 = newTH();
+    TrieHybride *th2 = newTH();
+    const char *const cles[] = {"bat", "car", "cat", "cart", "dog"};
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+    {
+        th1 = ajoutTH(th1, cles[i], VALFIN);
+        th2 = ajoutReequilibreTH(th2, cles[i], VALFIN);
+    }
+
+    TEST_ASSERT(profondeurMoyenneTH(th1) > 3.2); /* Profondeur moyenne : 3,5 */
+    TEST_ASSERT(profondeurMoyenneTH(th2) < 3.2); /* Profondeur moyenne : 3,0 */
+    TEST_ASSERT_EQUAL_INT(3, prefixeTH(th2, "ca"));
+    TEST_ASSERT_EQUAL_INT(comptageNilTH(th1), comptageNilTH(th2));
+
+    for (size_t i = 0; i < sizeof(cles) / sizeof(*cles); i++)
+    {
+        th2 = supprReequilibreTH(th2, cles[i]);
+        TEST_ASSERT_FALSE(rechercheTH(th2, cles[i]));
+    }
+    TEST_ASSERT_NULL(th2);
+
+    deleteTH(&th1);
+}
+
+/* Black box test, les valeurs de la slab sont relues à part des noeuds */
+void test_slab_json_scores(void)
+{
+    TrieHybride *th = newTH();
+    th = ajoutTH(th, "car", 50);
+    th = ajoutTH(th, "cab", 90);
+    th = ajoutTH(th, "do", VALFIN);
+
+    char *json = printJSONTH(th);
+    TrieHybride *copie = parseJSONTH(json, strlen(json));
+    char **l = completeTH(copie, "", 3);
+    TEST_ASSERT_EQUAL_STRING("cab", l[0]);
+    TEST_ASSERT_EQUAL_STRING("car", l[1]);
+    TEST_ASSERT_EQUAL_STRING("do", l[2]);
+    TEST_ASSERT_NULL(l[3]);
+    deleteListeMotsTH(l);
+    char *json2 = printJSONTH(copie);
+    TEST_ASSERT_EQUAL_STRING(json, json2);
+
+    free(json);
+    free(json2);
+    deleteTH(&copie);
+    deleteTH(&th);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_slab_noeud);
+    RUN_TEST(test_slab_vide);
+    RUN_TEST(test_slab_ajout);
+    RUN_TEST(test_slab_libre);
+    RUN_TEST(test_slab_shakespeare);
+    RUN_TEST(test_slab_fusion);
+    RUN_TEST(test_slab_ajoutReequilibre);
+    RUN_TEST(test_slab_json_scores);
+    return UNITY_END();
+}
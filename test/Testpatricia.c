@@ -1,8 +1,32 @@
+#define _POSIX_C_SOURCE 200809L /* for `fileno()` */
+#include "fluxjson.h"
 #include "patricia.h"
 #include "unity.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <unistd.h>
+
+/* Renvoie une copie terminée par '\0' du préfixe de l'arête de node commençant par c, NULL si absente */
+static const char *pref(const PatriciaNode *node, unsigned char c)
+{
+    static char buf[MAX_WORD_LENGTH];
+    const PatriciaEdge *edge = edge_patricia(node, c);
+    if (edge == NULL)
+        return NULL;
+    snprintf(buf, sizeof(buf), "%.*s", (int)edge->len, label_patricia(node, edge));
+    return buf;
+}
+
+/* Renvoie l'enfant de l'arête de node commençant par c, NULL si absente ou feuille */
+static PatriciaNode *child(const PatriciaNode *node, unsigned char c)
+{
+    const PatriciaEdge *edge = edge_patricia(node, c);
+    return edge ? edge->child : NULL;
+}
 
 void setUp(void)
 {
@@ -19,7 +43,7 @@ void test_create(void)
     PatriciaNode *node = create_patricia_node();
     TEST_ASSERT_NOT_NULL(node);
     TEST_ASSERT_TRUE(0 == comptage_mots_patricia(node));
-    free(node);
+    free_patricia_node(node);
 }
 
 void test_insert(void)
@@ -28,10 +52,10 @@ void test_insert(void)
     insert_patricia(node, "test");
     insert_patricia(node, "toto");
 
-    TEST_ASSERT_EQUAL_STRING("t", node->prefixes[(unsigned char)'t']);
-    TEST_ASSERT_EQUAL_STRING("est", node->children[(unsigned char)'t']->prefixes[(unsigned char)'e']);
-    TEST_ASSERT_EQUAL_STRING("oto", node->children[(unsigned char)'t']->prefixes[(unsigned char)'o']);
-    TEST_ASSERT_NULL(node->children[(unsigned char)'t']->children[(unsigned char)'e']);
+    TEST_ASSERT_EQUAL_STRING("t", pref(node, 't'));
+    TEST_ASSERT_EQUAL_STRING("est", pref(child(node, 't'), 'e'));
+    TEST_ASSERT_EQUAL_STRING("oto", pref(child(node, 't'), 'o'));
+    TEST_ASSERT_NULL(child(child(node, 't'), 'e'));
 
 
     char *json = printJSONPT(node);
@@ -49,8 +73,8 @@ void test_insert(void)
     insert_patricia(node2, "appetizer");
 
     node = pat_fusion(node, node2);
-    TEST_ASSERT_EQUAL_STRING("t", node->prefixes[(unsigned char)'t']);
-    TEST_ASSERT_EQUAL_STRING("est", node->children[(unsigned char)'t']->prefixes[(unsigned char)'e']);
+    TEST_ASSERT_EQUAL_STRING("t", pref(node, 't'));
+    TEST_ASSERT_EQUAL_STRING("est", pref(child(node, 't'), 'e'));
     TEST_ASSERT_TRUE(5 == comptage_mots_patricia(node));
 
     TEST_ASSERT_TRUE(5 == comptage_mots_patricia(node));
@@ -68,20 +92,20 @@ void test_insert2(void)
     insert_patricia(node, "the");
     insert_patricia(node, "they");
     TEST_ASSERT_TRUE(2 == comptage_mots_patricia(node));
-    TEST_ASSERT_EQUAL_STRING("the", node->prefixes[(unsigned char)'t']);
-    TEST_ASSERT_EQUAL_STRING("y", node->children[(unsigned char)'t']->prefixes[(unsigned char)'y']);
-    TEST_ASSERT_NULL(node->children[(unsigned char)'t']->children[(unsigned char)'y']);
-    TEST_ASSERT_EQUAL_STRING(" ", node->children[(unsigned char)'t']->prefixes[EOE_INDEX]);
+    TEST_ASSERT_EQUAL_STRING("the", pref(node, 't'));
+    TEST_ASSERT_EQUAL_STRING("y", pref(child(node, 't'), 'y'));
+    TEST_ASSERT_NULL(child(child(node, 't'), 'y'));
+    TEST_ASSERT_TRUE(child(node, 't')->end);
     free_patricia_node(node);
     node = create_patricia_node();
     insert_patricia(node, "they");
     insert_patricia(node, "the");
-    TEST_ASSERT_EQUAL_STRING("the", node->prefixes[(unsigned char)'t']);
-    TEST_ASSERT_EQUAL_STRING("y", node->children[(unsigned char)'t']->prefixes[(unsigned char)'y']);
-    TEST_ASSERT_EQUAL_STRING(" ", node->children[(unsigned char)'t']->prefixes[EOE_INDEX]);
+    TEST_ASSERT_EQUAL_STRING("the", pref(node, 't'));
+    TEST_ASSERT_EQUAL_STRING("y", pref(child(node, 't'), 'y'));
+    TEST_ASSERT_TRUE(child(node, 't')->end);
     TEST_ASSERT_TRUE(2 == comptage_mots_patricia(node));
     int i = delete_word(node, "the");
-    TEST_ASSERT_NULL(node->children[(unsigned char)'t']);
+    TEST_ASSERT_NULL(child(node, 't'));
     TEST_ASSERT_TRUE(1 == i);
     print_patricia(node, 0);
 
@@ -89,7 +113,7 @@ void test_insert2(void)
     i = delete_word(node, "they");
     TEST_ASSERT_TRUE(1 == i);
     TEST_ASSERT_TRUE(0 == comptage_mots_patricia(node));
-    TEST_ASSERT_NULL(node->prefixes[(unsigned char)'t']);
+    TEST_ASSERT_NULL(pref(node, 't'));
     free_patricia_node(node);
 }
 
@@ -101,18 +125,18 @@ void test_insert3(void)
     insert_patricia(node, "them");
     insert_patricia(node, "toto");
     insert_patricia(node, "there");
-    TEST_ASSERT_EQUAL_STRING("t", node->prefixes[(unsigned char)'t']);
+    TEST_ASSERT_EQUAL_STRING("t", pref(node, 't'));
     TEST_ASSERT_TRUE(5 == comptage_mots_patricia(node));
     insert_patricia(node, "apple");
     insert_patricia(node, "application");
     insert_patricia(node, "appetizer");
-    TEST_ASSERT_EQUAL_STRING("app", node->prefixes[(unsigned char)'a']);
-    TEST_ASSERT_EQUAL_STRING("l", node->children[(unsigned char)'a']->prefixes[(unsigned char)'l']);
+    TEST_ASSERT_EQUAL_STRING("app", pref(node, 'a'));
+    TEST_ASSERT_EQUAL_STRING("l", pref(child(node, 'a'), 'l'));
     TEST_ASSERT_EQUAL_STRING(
-        "ication", node->children[(unsigned char)'a']->children[(unsigned char)'l']->prefixes[(unsigned char)'i']);
-    TEST_ASSERT_EQUAL_STRING("etizer", node->children[(unsigned char)'a']->prefixes[(unsigned char)'e']);
+        "ication", pref(child(child(node, 'a'), 'l'), 'i'));
+    TEST_ASSERT_EQUAL_STRING("etizer", pref(child(node, 'a'), 'e'));
     TEST_ASSERT_EQUAL_STRING(
-        "e", node->children[(unsigned char)'a']->children[(unsigned char)'l']->prefixes[(unsigned char)'e']);
+        "e", pref(child(child(node, 'a'), 'l'), 'e'));
     TEST_ASSERT_TRUE(8 == comptage_mots_patricia(node));
     insert_patricia(node, "app");
     TEST_ASSERT_TRUE(9 == comptage_mots_patricia(node));
@@ -127,22 +151,80 @@ void test_insert3(void)
     print_list_patricia(liste, 9);
     free_list_patricia(liste, 9);
 
-    TEST_ASSERT_EQUAL_STRING(" ", node->children[(unsigned char)'a']->prefixes[EOE_INDEX]);
+    TEST_ASSERT_TRUE(child(node, 'a')->end);
     int i = delete_word(node, "app");
     TEST_ASSERT_TRUE(1 == i);
     i = delete_word(node, "appetizer");
     TEST_ASSERT_TRUE(1 == i);
     TEST_ASSERT_TRUE(7 == comptage_mots_patricia(node));
-    TEST_ASSERT_EQUAL_STRING("appl", node->prefixes[(unsigned char)'a']);
+    TEST_ASSERT_EQUAL_STRING("appl", pref(node, 'a'));
 
     free_patricia_node(node);
 }
 
+void test_recherche_long(void)
+{
+    const char *urls[] = {
+        "https://example.org/projects/tries/src/patricia.c",
+        "https://example.org/projects/tries/src/hybrid.c",
+        "https://example.org/projects/tries/include/patricia.h",
+        "https://example.org/projects/tries",
+        "https://example.org/",
+    };
+    int n = sizeof(urls) / sizeof(*urls);
+    PatriciaNode *node = create_patricia_node();
+    for (int i = 0; i < n; i++)
+        insert_patricia(node, urls[i]);
+    TEST_ASSERT_TRUE(n == comptage_mots_patricia(node));
+    for (int i = 0; i < n; i++)
+        TEST_ASSERT_TRUE(1 == recherche_patricia(node, urls[i]));
+    TEST_ASSERT_TRUE(0 == recherche_patricia(node, "https://example.org/projects/tries/src/"));
+    TEST_ASSERT_TRUE(0 == recherche_patricia(node, "https://example.org/projects/tries/src/patricia.o"));
+    TEST_ASSERT_TRUE(0 == recherche_patricia(node, "https://example.org/projects/tries/src/patricia.c/"));
+    TEST_ASSERT_TRUE(3 == nb_prefixe_patricia(node, "https://example.org/projects/tries/"));
+    TEST_ASSERT_TRUE(1 == delete_word(node, "https://example.org/projects/tries"));
+    TEST_ASSERT_TRUE(0 == recherche_patricia(node, "https://example.org/projects/tries"));
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, urls[0]));
+    free_patricia_node(node);
+
+    /* Un mot qui se termine sur un noeud interne, et non sur une feuille, est trouvé */
+    node = create_patricia_node();
+    insert_patricia(node, "the");
+    insert_patricia(node, "they");
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, "the"));
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, "they"));
+    TEST_ASSERT_TRUE(0 == recherche_patricia(node, "th"));
+    free_patricia_node(node);
+}
+
 void test_suffixe(void)
 {
     const char *s1 = "pref";
     const char *s2 = "prefix";
     TEST_ASSERT_EQUAL_STRING("ix", suffixe(s1, s2));
+    TEST_ASSERT_NULL(suffixe(s2, s1));
+    TEST_ASSERT_TRUE(0 == plus_long_pref("", "abc"));
+    TEST_ASSERT_TRUE(4 == plus_long_pref("pref", "pref"));
+    TEST_ASSERT_TRUE(est_prefixe("pref", "pref"));
+    TEST_ASSERT_FALSE(est_prefixe("prefix", "pref"));
+
+    const char *l1 = "a long common prefix spanning more than one 32 byte block: 1";
+    const char *l2 = "a long common prefix spanning more than one 32 byte block: 2";
+    TEST_ASSERT_TRUE((int)strlen(l1) - 1 == plus_long_pref(l1, l2));
+    TEST_ASSERT_FALSE(est_prefixe(l1, l2));
+
+    /* Des chaînes qui se terminent juste avant une frontière de page sont comparées octet par octet */
+    char *page = aligned_alloc(4096, 8192);
+    TEST_ASSERT_NOT_NULL(page);
+    for (int end = 4090; end <= 4100; end++)
+    {
+        char *w = page + end - 6;
+        memcpy(w, "abcdef", 7);
+        TEST_ASSERT_TRUE(6 == plus_long_pref(w, "abcdef"));
+        TEST_ASSERT_TRUE(3 == plus_long_pref(w, "abcxyz"));
+        TEST_ASSERT_EQUAL_STRING("def", suffixe("abc", w));
+    }
+    free(page);
 }
 
 void test_fusion(void)
@@ -201,7 +283,7 @@ void test_deleted_word(void){
     insert_patricia(node, "them");
     insert_patricia(node, "toto");
     insert_patricia(node, "there");
-    TEST_ASSERT_EQUAL_STRING("t", node->prefixes[(unsigned char)'t']);
+    TEST_ASSERT_EQUAL_STRING("t", pref(node, 't'));
     TEST_ASSERT_TRUE(5 == comptage_mots_patricia(node));
     insert_patricia(node, "apple");
     insert_patricia(node, "application");
@@ -210,6 +292,628 @@ void test_deleted_word(void){
     TEST_ASSERT_TRUE(0 == delete_word(node, "the"));
 }
 
+void test_adaptive_nodes(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    TEST_ASSERT_TRUE(NODE4 == node->type);
+    char word[3] = {0, 'x', '\0'};
+    int n = 0;
+    for (char c = '!'; c <= '~'; c++)
+    {
+        word[0] = c;
+        insert_patricia(node, word);
+        n++;
+        if (n == 5)
+            TEST_ASSERT_TRUE(NODE16 == node->type);
+        if (n == 17)
+            TEST_ASSERT_TRUE(NODE48 == node->type);
+        if (n == 49)
+            TEST_ASSERT_TRUE(NODE128 == node->type);
+    }
+    TEST_ASSERT_TRUE(n == node->count);
+    TEST_ASSERT_TRUE(n == comptage_mots_patricia(node));
+    for (char c = '!'; c <= '~'; c++)
+    {
+        word[0] = c;
+        TEST_ASSERT_TRUE(1 == recherche_patricia(node, word));
+    }
+
+    char **liste = liste_mots_patricia(node);
+    TEST_ASSERT_EQUAL_STRING("!x", liste[0]);
+    TEST_ASSERT_EQUAL_STRING("~x", liste[n - 1]);
+    free_list_patricia(liste, n);
+
+    for (char c = '~'; c >= '!'; c--)
+    {
+        word[0] = c;
+        TEST_ASSERT_TRUE(1 == delete_word(node, word));
+        if (c == '!' + 36)
+            TEST_ASSERT_TRUE(NODE48 == node->type);
+        if (c == '!' + 11)
+            TEST_ASSERT_TRUE(NODE16 == node->type);
+        if (c == '!' + 2)
+            TEST_ASSERT_TRUE(NODE4 == node->type);
+    }
+    TEST_ASSERT_TRUE(0 == node->count);
+    TEST_ASSERT_TRUE(0 == comptage_mots_patricia(node));
+    free_patricia_node(node);
+}
+
+void test_insert_duplicate(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    insert_patricia(node, "the");
+    insert_patricia(node, "the");
+    TEST_ASSERT_NULL(child(node, 't'));
+    TEST_ASSERT_TRUE(1 == comptage_mots_patricia(node));
+    TEST_ASSERT_TRUE(1 == delete_word(node, "the"));
+    TEST_ASSERT_TRUE(0 == node->count);
+    TEST_ASSERT_TRUE(0 == comptage_mots_patricia(node));
+    free_patricia_node(node);
+}
+
+void test_arena(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    insert_patricia(node, "application");
+    insert_patricia(node, "apple");
+    /* La coupure de "application" ne recopie rien, "appl" et "e" sont rangés dans leurs arêtes */
+    TEST_ASSERT_TRUE(11 == node->arena->size);
+    TEST_ASSERT_TRUE(4 == node->arena->dead);
+    TEST_ASSERT_EQUAL_STRING("appl", pref(node, 'a'));
+    TEST_ASSERT_EQUAL_STRING("ication", pref(child(node, 'a'), 'i'));
+    TEST_ASSERT_EQUAL_STRING("e", pref(child(node, 'a'), 'e'));
+
+    TEST_ASSERT_TRUE(1 == delete_word(node, "apple"));
+    TEST_ASSERT_EQUAL_STRING("application", pref(node, 'a'));
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, "application"));
+
+    /* Une suppression qui rend les octets morts majoritaires compacte l'arène */
+    insert_patricia(node, "bandwidth");
+    TEST_ASSERT_TRUE(1 == delete_word(node, "application"));
+    TEST_ASSERT_TRUE(0 == node->arena->dead);
+    TEST_ASSERT_TRUE(strlen("bandwidth") == node->arena->size);
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, "bandwidth"));
+    TEST_ASSERT_TRUE(0 == recherche_patricia(node, "application"));
+
+    PatriciaNode *node2 = create_patricia_node();
+    insert_patricia(node2, "band");
+    insert_patricia(node2, "cherry");
+    insert_patricia(node2, "bandwagon");
+    node = pat_fusion(node, node2);
+    TEST_ASSERT_TRUE(4 == comptage_mots_patricia(node));
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, "cherry"));
+    TEST_ASSERT_TRUE(1 == recherche_patricia(node, "bandwagon"));
+    TEST_ASSERT_EQUAL_STRING("band", pref(node, 'b'));
+    TEST_ASSERT_EQUAL_STRING("w", pref(child(node, 'b'), 'w'));
+    TEST_ASSERT_EQUAL_STRING("idth", pref(child(child(node, 'b'), 'w'), 'i'));
+    TEST_ASSERT_EQUAL_STRING("agon", pref(child(child(node, 'b'), 'w'), 'a'));
+    free_patricia_node(node);
+}
+
+/* Vérifie le nombre de mots gardé dans chaque noeud et renvoie celui du sous-arbre */
+static uint32_t verifie_mots(PatriciaNode *node)
+{
+    uint32_t words = node->end;
+    int key = -1;
+    PatriciaEdge *edge;
+    while ((edge = next_edge_patricia(node, &key)) != NULL)
+        words += edge->child ? verifie_mots(edge->child) : 1;
+    TEST_ASSERT_EQUAL_UINT32(words, node->words);
+    return words;
+}
+
+void test_comptage_mots(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    const char *const mots[] = {"romane", "romanus", "romulus", "rubens", "ruber", "rubicon", "rubicundus", "rom"};
+    for (size_t i = 0; i < sizeof(mots) / sizeof(*mots); i++)
+    {
+        insert_patricia(node, mots[i]);
+        insert_patricia(node, mots[i]);
+        verifie_mots(node);
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, node->words);
+    TEST_ASSERT_EQUAL_UINT32(4, child(child(node, 'r'), 'o')->words);
+    TEST_ASSERT_TRUE(4 == nb_prefixe_patricia(node, "rom"));
+    TEST_ASSERT_TRUE(3 == nb_prefixe_patricia(node, "rubi") + nb_prefixe_patricia(node, "rubens"));
+
+    TEST_ASSERT_TRUE(1 == delete_word(node, "romane"));
+    TEST_ASSERT_TRUE(0 == delete_word(node, "romane"));
+    TEST_ASSERT_TRUE(1 == delete_word(node, "rom"));
+    verifie_mots(node);
+    TEST_ASSERT_TRUE(6 == comptage_mots_patricia(node));
+
+    PatriciaNode *node2 = create_patricia_node();
+    insert_patricia(node2, "rom");
+    insert_patricia(node2, "rubicon");
+    insert_patricia(node2, "ru");
+    node = pat_fusion(node, node2);
+    verifie_mots(node);
+    TEST_ASSERT_TRUE(8 == comptage_mots_patricia(node));
+
+    char *json = printJSONPT(node);
+    PatriciaNode *copie = parseJSONPT(json, strlen(json));
+    free(json);
+    TEST_ASSERT_EQUAL_UINT32(8, verifie_mots(copie));
+    free_patricia_node(copie);
+    free_patricia_node(node);
+}
+
+void test_rank_select(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    TEST_ASSERT_TRUE(0 == rank_patricia(node, "a"));
+    TEST_ASSERT_NULL(select_patricia(node, 0));
+
+    const char *const mots[] = {"lune", "la", "le", "les", "lapin", "zebre", "arbre", "l"};
+    for (size_t i = 0; i < sizeof(mots) / sizeof(*mots); i++)
+        insert_patricia(node, mots[i]);
+    const char *const ordre[] = {"arbre", "l", "la", "lapin", "le", "les", "lune", "zebre"};
+    for (int k = 0; k < 8; k++)
+    {
+        TEST_ASSERT_EQUAL_INT(k, rank_patricia(node, ordre[k]));
+        char *mot = select_patricia(node, k);
+        TEST_ASSERT_EQUAL_STRING(ordre[k], mot);
+        free(mot);
+    }
+    TEST_ASSERT_NULL(select_patricia(node, 8));
+    TEST_ASSERT_NULL(select_patricia(node, -1));
+
+    /* Mots absents qui s'arrêtent ou bifurquent au milieu d'une arête, ou la prolongent */
+    TEST_ASSERT_EQUAL_INT(0, rank_patricia(node, "a"));
+    TEST_ASSERT_EQUAL_INT(1, rank_patricia(node, "arbres"));
+    TEST_ASSERT_EQUAL_INT(1, rank_patricia(node, "b"));
+    TEST_ASSERT_EQUAL_INT(3, rank_patricia(node, "lap"));
+    TEST_ASSERT_EQUAL_INT(4, rank_patricia(node, "lapins"));
+    TEST_ASSERT_EQUAL_INT(6, rank_patricia(node, "lesa"));
+    TEST_ASSERT_EQUAL_INT(7, rank_patricia(node, "lz"));
+    TEST_ASSERT_EQUAL_INT(8, rank_patricia(node, "zz"));
+    free_patricia_node(node);
+}
+
+void test_cursor(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    PatriciaCursor *cursor = cursor_open_patricia(node);
+    TEST_ASSERT_NULL(cursor_next_patricia(cursor));
+    TEST_ASSERT_NULL(cursor_seek_patricia(cursor, "a"));
+    cursor_close_patricia(cursor);
+
+    const char *const mots[] = {"lune", "la", "le", "les", "lapin", "zebre", "arbre", "l"};
+    for (size_t i = 0; i < sizeof(mots) / sizeof(*mots); i++)
+        insert_patricia(node, mots[i]);
+    const char *const ordre[] = {"arbre", "l", "la", "lapin", "le", "les", "lune", "zebre"};
+
+    /* Parcours complet dans les deux sens, le curseur repart de l'autre bout une fois sorti */
+    cursor = cursor_open_patricia(node);
+    int k = 0;
+    for (const char *mot = cursor_next_patricia(cursor); mot; mot = cursor_next_patricia(cursor))
+        TEST_ASSERT_EQUAL_STRING(ordre[k++], mot);
+    TEST_ASSERT_EQUAL_INT(8, k);
+    TEST_ASSERT_NULL(cursor_next_patricia(cursor));
+    while (k > 0)
+        TEST_ASSERT_EQUAL_STRING(ordre[--k], cursor_prev_patricia(cursor));
+    TEST_ASSERT_NULL(cursor_prev_patricia(cursor));
+    TEST_ASSERT_EQUAL_STRING("arbre", cursor_next_patricia(cursor));
+
+    /* Mots qui s'arrêtent ou bifurquent au milieu d'une arête, ou la prolongent */
+    TEST_ASSERT_EQUAL_STRING("la", cursor_seek_patricia(cursor, "la"));
+    TEST_ASSERT_EQUAL_STRING("l", cursor_prev_patricia(cursor));
+    TEST_ASSERT_EQUAL_STRING("l", cursor_seek_patricia(cursor, "b"));
+    TEST_ASSERT_EQUAL_STRING("lapin", cursor_seek_patricia(cursor, "lap"));
+    TEST_ASSERT_EQUAL_STRING("le", cursor_seek_patricia(cursor, "lapins"));
+    TEST_ASSERT_EQUAL_STRING("les", cursor_next_patricia(cursor));
+    TEST_ASSERT_EQUAL_STRING("lune", cursor_seek_patricia(cursor, "lesa"));
+    TEST_ASSERT_NULL(cursor_seek_patricia(cursor, "zz"));
+    TEST_ASSERT_EQUAL_STRING("zebre", cursor_prev_patricia(cursor));
+
+    /* Intervalle [la, lu[ */
+    const char *const plage[] = {"la", "lapin", "le", "les"};
+    k = 0;
+    for (const char *mot = cursor_range_patricia(cursor, "la", "lu"); mot; mot = cursor_next_patricia(cursor))
+        TEST_ASSERT_EQUAL_STRING(plage[k++], mot);
+    TEST_ASSERT_EQUAL_INT(4, k);
+    TEST_ASSERT_EQUAL_STRING("les", cursor_prev_patricia(cursor));
+    TEST_ASSERT_EQUAL_STRING("la", cursor_seek_patricia(cursor, "a"));
+    TEST_ASSERT_NULL(cursor_prev_patricia(cursor));
+    TEST_ASSERT_NULL(cursor_seek_patricia(cursor, "m"));
+    TEST_ASSERT_EQUAL_STRING("les", cursor_prev_patricia(cursor));
+
+    /* Le mot vide précède tous les autres */
+    insert_patricia(node, "");
+    TEST_ASSERT_EQUAL_STRING("", cursor_range_patricia(cursor, NULL, "b"));
+    TEST_ASSERT_EQUAL_STRING("arbre", cursor_next_patricia(cursor));
+    TEST_ASSERT_NULL(cursor_next_patricia(cursor));
+    cursor_close_patricia(cursor);
+    free_patricia_node(node);
+}
+
+/* Garde les mots rendus par fuzzy_search_patricia avec leur distance */
+typedef struct Trouves {
+    char mots[8][160];
+    int distances[8];
+    int n;
+} Trouves;
+
+static void trouve(const char *word, int distance, void *ctx)
+{
+    Trouves *t = ctx;
+    TEST_ASSERT(t->n < 8);
+    snprintf(t->mots[t->n], sizeof(t->mots[t->n]), "%s", word);
+    t->distances[t->n++] = distance;
+}
+
+void test_fuzzy_search(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    Trouves t = {.n = 0};
+    TEST_ASSERT_EQUAL_INT(0, fuzzy_search_patricia(node, "chat", 2, trouve, &t));
+
+    const char *const mots[] = {"chat", "chats", "chien", "char", "cat", "achat", "hat", "chateau"};
+    for (size_t i = 0; i < sizeof(mots) / sizeof(*mots); i++)
+        insert_patricia(node, mots[i]);
+
+    /* Dans l'ordre alphabétique, les mots qui s'arrêtent au milieu d'une arête compris */
+    const char *const proches[] = {"achat", "cat", "char", "chat", "chats", "hat"};
+    const int distances[] = {1, 1, 1, 0, 1, 1};
+    TEST_ASSERT_EQUAL_INT(6, fuzzy_search_patricia(node, "chat", 1, trouve, &t));
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_STRING(proches[i], t.mots[i]);
+        TEST_ASSERT_EQUAL_INT(distances[i], t.distances[i]);
+    }
+
+    t.n = 0;
+    TEST_ASSERT_EQUAL_INT(1, fuzzy_search_patricia(node, "chat", 0, trouve, &t));
+    TEST_ASSERT_EQUAL_STRING("chat", t.mots[0]);
+    TEST_ASSERT_EQUAL_INT(0, fuzzy_search_patricia(node, "chat", -1, trouve, &t));
+    t.n = 0;
+    TEST_ASSERT_EQUAL_INT(2, fuzzy_search_patricia(node, "", 3, trouve, &t));
+    TEST_ASSERT_EQUAL_STRING("cat", t.mots[0]);
+    TEST_ASSERT_EQUAL_STRING("hat", t.mots[1]);
+    /* Sans borne, tous les mots, sans débordement sur max_edits + 1 */
+    t.n = 0;
+    TEST_ASSERT_EQUAL_INT(8, fuzzy_search_patricia(node, "chat", INT_MAX, trouve, &t));
+    TEST_ASSERT_EQUAL_STRING("chateau", t.mots[4]);
+    TEST_ASSERT_EQUAL_INT(3, t.distances[4]);
+
+    /* Un mot plus long que MAX_WORD_LENGTH */
+    char long_mot[151];
+    memset(long_mot, 'a', 150);
+    long_mot[150] = '\0';
+    insert_patricia(node, long_mot);
+    long_mot[75] = 'b';
+    t.n = 0;
+    TEST_ASSERT_EQUAL_INT(1, fuzzy_search_patricia(node, long_mot, 1, trouve, &t));
+    TEST_ASSERT_EQUAL_INT(1, t.distances[0]);
+    TEST_ASSERT_EQUAL_size_t(150, strlen(t.mots[0]));
+    free_patricia_node(node);
+}
+
+/* Garde les mots rendus par glob_patricia */
+static void trouve_glob(const char *word, void *ctx)
+{
+    trouve(word, 0, ctx);
+}
+
+void test_glob(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    Trouves t = {.n = 0};
+    TEST_ASSERT_EQUAL_INT(0, glob_patricia(node, "*", trouve_glob, &t));
+
+    const char *const mots[] = {"cat", "cut", "cot", "coat", "bat", "cart", "chat", "c"};
+    for (size_t i = 0; i < sizeof(mots) / sizeof(*mots); i++)
+        insert_patricia(node, mots[i]);
+
+    /* Les motifs s'arrêtent ou échouent aussi au milieu des arêtes */
+    const char *const motifs[] = {"c?t", "c*t", "[bc]at", "[!c]*", "c[a-h]*", "c", "*", "\\*", "[c", "ca"};
+    const char *const attendus[] = {"cat cot cut", "cart cat chat coat cot cut", "bat cat", "bat", "cart cat chat", "c",
+                                    "bat c cart cat chat coat cot cut", "", "", ""};
+    for (size_t i = 0; i < sizeof(motifs) / sizeof(*motifs); i++) {
+        t.n = 0;
+        int nb = glob_patricia(node, motifs[i], trouve_glob, &t);
+        TEST_ASSERT_EQUAL_INT(t.n, nb);
+        char liste[160] = "";
+        for (int k = 0; k < t.n; k++)
+            snprintf(liste + strlen(liste), sizeof(liste) - strlen(liste), k ? " %s" : "%s", t.mots[k]);
+        TEST_ASSERT_EQUAL_STRING(attendus[i], liste);
+    }
+
+    /* Le mot vide est reconnu par un motif vide, pas par `?` */
+    insert_patricia(node, "");
+    t.n = 0;
+    TEST_ASSERT_EQUAL_INT(1, glob_patricia(node, "", trouve_glob, &t));
+    TEST_ASSERT_EQUAL_STRING("", t.mots[0]);
+    TEST_ASSERT_EQUAL_INT(1, glob_patricia(node, "?", trouve_glob, &t));
+    TEST_ASSERT_EQUAL_STRING("c", t.mots[1]);
+    free_patricia_node(node);
+}
+
+void test_longest_prefix(void)
+{
+    PatriciaNode *node = create_patricia_node();
+    TEST_ASSERT_EQUAL_INT(-1, longest_prefix_patricia(node, "10.1"));
+
+    insert_patricia(node, "10");
+    insert_patricia(node, "10.1.2");
+    insert_patricia(node, "10.1.25");
+    insert_patricia(node, "192");
+
+    /* Le texte s'arrête ou bifurque au milieu d'une arête, ou prolonge une feuille */
+    TEST_ASSERT_EQUAL_INT(6, longest_prefix_patricia(node, "10.1.2.3"));
+    TEST_ASSERT_EQUAL_INT(7, longest_prefix_patricia(node, "10.1.256"));
+    TEST_ASSERT_EQUAL_INT(2, longest_prefix_patricia(node, "10.1"));
+    TEST_ASSERT_EQUAL_INT(2, longest_prefix_patricia(node, "10.1.3"));
+    TEST_ASSERT_EQUAL_INT(3, longest_prefix_patricia(node, "192.168"));
+    TEST_ASSERT_EQUAL_INT(-1, longest_prefix_patricia(node, "19"));
+    TEST_ASSERT_EQUAL_INT(-1, longest_prefix_patricia(node, ""));
+
+    insert_patricia(node, "");
+    TEST_ASSERT_EQUAL_INT(0, longest_prefix_patricia(node, "19"));
+    free_patricia_node(node);
+}
+
+void test_recherche_batch(void)
+{
+    /* Plus de mots que de recherches menées de front, et des mots qui s'arrêtent au milieu d'une arête ou
+     * prolongent une feuille */
+    char words[100][12];
+    const char *batch[103];
+    int results[103];
+    PatriciaNode *node = create_patricia_node();
+    for (int i = 0; i < 100; i++) {
+        snprintf(words[i], sizeof(words[i]), "word%d", i * 7);
+        batch[i] = words[i];
+        if (i % 3) {
+            insert_patricia(node, words[i]);
+        }
+    }
+    batch[100] = "";
+    batch[101] = "wo";
+    batch[102] = "word77x";
+
+    recherche_batch_patricia(node, batch, 103, results);
+    for (int i = 0; i < 103; i++) {
+        TEST_ASSERT_EQUAL_INT(recherche_patricia(node, batch[i]), results[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(1, results[1]);
+    TEST_ASSERT_EQUAL_INT(0, results[3]);
+    TEST_ASSERT_EQUAL_INT(0, results[100]);
+
+    insert_patricia(node, "");
+    recherche_batch_patricia(node, batch + 100, 1, results);
+    TEST_ASSERT_EQUAL_INT(1, results[0]);
+    recherche_batch_patricia(NULL, batch, 3, results);
+    TEST_ASSERT_EQUAL_INT(0, results[1]);
+    free_patricia_node(node);
+}
+
+/* Recalcule la somme de contrôle d'un snapshot modifié, rangée après 24 octets d'entête : un FNV-1a sur des mots de
+ * 8 octets des octets qui suivent l'entête de 32 octets */
+static void resigne_snapshot(void *snap, size_t sz)
+{
+    const unsigned char *p = (const unsigned char *)snap + 32;
+    size_t n = sz - 32;
+    uint64_t h = 0xcbf29ce484222325u;
+    for (; n >= sizeof(uint64_t); p += sizeof(uint64_t), n -= sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h = (h ^ w) * 0x100000001b3u;
+    }
+    for (; n; p++, n--)
+        h = (h ^ *p) * 0x100000001b3u;
+    memcpy((unsigned char *)snap + 24, &h, sizeof(h));
+}
+
+/* La disposition des noeuds et des arêtes d'un snapshot, après l'entête */
+typedef struct {
+    uint32_t arete, words;
+    unsigned char count, end;
+} NoeudSnap;
+typedef struct {
+    uint32_t off, len, child;
+    char inl[EDGE_INLINE];
+} AreteSnap;
+
+void test_snapshot(void)
+{
+    /* Des mots qui s'arrêtent au milieu d'une arête, prolongent une feuille ou forcent de grands noeuds */
+    const char *batch[] = {"", "wo", "word", "word7", "word77", "word77x", "word700", "x", "/srv/data/a"};
+    char words[300][24];
+    size_t sz;
+    PatriciaNode *node = create_patricia_node();
+    for (int i = 0; i < 300; i++) {
+        snprintf(words[i], sizeof(words[i]), i % 2 ? "word%d" : "%c/srv/data/%d", i % 2 ? i * 7 : 33 + i % 90, i);
+        insert_patricia(node, words[i]);
+    }
+
+    void *snap = printSnapshotPT(node, &sz);
+    TEST_ASSERT_TRUE(verifieSnapshotPT(snap, sz));
+    for (int i = 0; i < 300; i++) {
+        TEST_ASSERT_EQUAL_INT(1, recherche_snapshot_patricia(snap, words[i]));
+        TEST_ASSERT_EQUAL_INT(nb_prefixe_patricia(node, words[i]), nb_prefixe_snapshot_patricia(snap, words[i]));
+    }
+    for (size_t i = 0; i < sizeof(batch) / sizeof(batch[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(recherche_patricia(node, batch[i]), recherche_snapshot_patricia(snap, batch[i]));
+        TEST_ASSERT_EQUAL_INT(nb_prefixe_patricia(node, batch[i]), nb_prefixe_snapshot_patricia(snap, batch[i]));
+    }
+
+    /* Même forme après un aller-retour */
+    PatriciaNode *copy = parseSnapshotPT(snap, sz);
+    char *js1 = printJSONPT(node), *js2 = printJSONPT(copy);
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    TEST_ASSERT_EQUAL_INT(comptage_mots_patricia(node), comptage_mots_patricia(copy));
+    free(js1);
+    free(js2);
+    free_patricia_node(copy);
+
+    /* Un octet modifié ou manquant est détecté */
+    ((unsigned char *)snap)[sz - 1] ^= 1;
+    TEST_ASSERT_FALSE(verifieSnapshotPT(snap, sz));
+    ((unsigned char *)snap)[sz - 1] ^= 1;
+    TEST_ASSERT_FALSE(verifieSnapshotPT(snap, sz - 1));
+
+    /* Une feuille qui désigne l'enfant d'une autre arête est refusée, même avec une somme de contrôle juste */
+    uint32_t nb_noeuds;
+    memcpy(&nb_noeuds, (unsigned char *)snap + 12, sizeof(nb_noeuds));
+    NoeudSnap *noeuds = (NoeudSnap *)((unsigned char *)snap + 32);
+    AreteSnap *aretes = (AreteSnap *)(noeuds + nb_noeuds);
+    resigne_snapshot(snap, sz);
+    TEST_ASSERT_TRUE(verifieSnapshotPT(snap, sz));
+    AreteSnap *feuille = NULL;
+    for (uint32_t i = 0; i < nb_noeuds - 1 && !feuille; i++)
+        for (uint32_t k = noeuds[i].arete; k < noeuds[i].arete + noeuds[i].count && !feuille; k++)
+            if (!aretes[k].child)
+                feuille = &aretes[k];
+    TEST_ASSERT_NOT_NULL(feuille);
+    feuille->child = nb_noeuds - 1;
+    resigne_snapshot(snap, sz);
+    TEST_ASSERT_FALSE(verifieSnapshotPT(snap, sz));
+    feuille->child = 0;
+
+    /* Comme une arête dont le premier caractère n'est pas ASCII, qui déborderait des tables du noeud reconstruit */
+    uint32_t nb_aretes;
+    memcpy(&nb_aretes, (unsigned char *)snap + 16, sizeof(nb_aretes));
+    AreteSnap *derniere = &aretes[noeuds[0].arete + noeuds[0].count - 1];
+    char *premier = (char *)(aretes + nb_aretes) + derniere->off, ancien = *premier;
+    *premier = derniere->inl[0] = (char)0xF0;
+    resigne_snapshot(snap, sz);
+    TEST_ASSERT_FALSE(verifieSnapshotPT(snap, sz));
+    *premier = derniere->inl[0] = ancien;
+
+    /* Comme un nombre de mots faux */
+    noeuds[0].words++;
+    resigne_snapshot(snap, sz);
+    TEST_ASSERT_FALSE(verifieSnapshotPT(snap, sz));
+    noeuds[0].words--;
+    resigne_snapshot(snap, sz);
+    TEST_ASSERT_TRUE(verifieSnapshotPT(snap, sz));
+    free(snap);
+    free_patricia_node(node);
+
+    node = create_patricia_node();
+    snap = printSnapshotPT(node, &sz);
+    TEST_ASSERT_TRUE(verifieSnapshotPT(snap, sz));
+    TEST_ASSERT_EQUAL_INT(0, recherche_snapshot_patricia(snap, ""));
+    insert_patricia(node, "");
+    free(snap);
+    snap = printSnapshotPT(node, &sz);
+    TEST_ASSERT_EQUAL_INT(1, recherche_snapshot_patricia(snap, ""));
+    free(snap);
+    free_patricia_node(node);
+}
+
+void test_json_flux(void)
+{
+    char words[2000][24];
+    PatriciaNode *node = create_patricia_node();
+    insert_patricia(node, "");
+    for (int i = 0; i < 2000; i++) {
+        snprintf(words[i], sizeof(words[i]), i % 3 ? "flux%d" : "/srv/%d/flux", i * 11);
+        insert_patricia(node, words[i]);
+    }
+
+    /* Un JSON de plusieurs blocs, lu depuis un fichier, redonne la même forme */
+    char *js1 = printJSONPT(node);
+    TEST_ASSERT_TRUE(strlen(js1) > 2 * TAILLE_FLUX_JSON);
+    FILE *file = tmpfile();
+    if (file == NULL)
+        TEST_FAIL_MESSAGE("Erreur, tmpfile");
+    fputs(js1, file);
+    fflush(file);
+    rewind(file);
+    PatriciaNode *copy = chargeJSONPT(fileno(file));
+    fclose(file);
+    char *js2 = printJSONPT(copy);
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    TEST_ASSERT_EQUAL_INT(comptage_mots_patricia(node), comptage_mots_patricia(copy));
+    for (int i = 0; i < 2000; i += 7)
+        TEST_ASSERT_EQUAL_INT(nb_prefixe_patricia(node, words[i]), nb_prefixe_patricia(copy, words[i]));
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(copy, ""));
+    free(js1);
+    free(js2);
+    free_patricia_node(copy);
+    free_patricia_node(node);
+
+    /* Clés dans le désordre ou absentes, clé inconnue, label échappé et "children" vide sur une feuille */
+    const char *js = "{\"children\":{\"a\":{\"children\":{\"x\":{\"label\":\"x\\u00e9\",\"children\":{}}},"
+                     "\"extra\":[true,{}],\"is_end_of_word\":true,\"label\":\"ab\"},\"q\":{\"label\":\"q\"}},"
+                     "\"label\":\"\"}";
+    node = parseJSONPT(js, strlen(js));
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(node, "ab"));
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(node, "abx\xc3\xa9"));
+    TEST_ASSERT_EQUAL_INT(1, recherche_patricia(node, "q"));
+    TEST_ASSERT_EQUAL_INT(0, recherche_patricia(node, ""));
+    TEST_ASSERT_EQUAL_INT(3, comptage_mots_patricia(node));
+    TEST_ASSERT_NULL(child(node, 'q'));
+    TEST_ASSERT_EQUAL_STRING("ab", pref(node, 'a'));
+    free_patricia_node(node);
+}
+
+void test_json_ecriture(void)
+{
+    /* La sortie compacte est celle de cJSON_PrintUnformatted(), mot vide et échappement compris */
+    PatriciaNode *node = create_patricia_node();
+    insert_patricia(node, "");
+    insert_patricia(node, "ab");
+    insert_patricia(node, "ac\n");
+    SortieJSON s;
+    ouvreMemoireSortieJSON(&s, true);
+    ecritJSONPT(node, &s);
+    char *js = rendMemoireSortieJSON(&s);
+    TEST_ASSERT_EQUAL_STRING("{\"label\":\"\",\"is_end_of_word\":true,\"children\":{\"a\":{\"label\":\"a\","
+                             "\"is_end_of_word\":false,"
+                             "\"children\":{\"b\":{\"label\":\"b\",\"is_end_of_word\":true,\"children\":{}},"
+                             "\"c\":{\"label\":\"c\\n\",\"is_end_of_word\":true,\"children\":{}}}}}}",
+                             js);
+    free(js);
+    free_patricia_node(node);
+
+    /* Vers un descripteur, en plusieurs blocs, la sortie formatée est celle de printJSONPT() */
+    char words[2000][24];
+    node = create_patricia_node();
+    for (int i = 0; i < 2000; i++) {
+        snprintf(words[i], sizeof(words[i]), i % 3 ? "ecrit%d" : "/srv/%d/ecrit", i * 13);
+        insert_patricia(node, words[i]);
+    }
+    char *js1 = printJSONPT(node);
+    size_t lg = strlen(js1);
+    FILE *file = tmpfile();
+    if (file == NULL)
+        TEST_FAIL_MESSAGE("Erreur, tmpfile");
+    ouvreSortieJSON(&s, fileno(file), false);
+    ecritJSONPT(node, &s);
+    TEST_ASSERT_TRUE(fermeSortieJSON(&s));
+    char *js2 = malloc(lg + 1);
+    if (js2 == NULL)
+        TEST_FAIL_MESSAGE("Erreur, malloc");
+    TEST_ASSERT_EQUAL_size_t(lg, (size_t)lseek(fileno(file), 0, SEEK_CUR));
+    TEST_ASSERT_EQUAL_size_t(lg, pread(fileno(file), js2, lg, 0));
+    js2[lg] = '\0';
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    free(js2);
+
+    /* Relue, la sortie compacte redonne la même forme */
+    rewind(file);
+    if (ftruncate(fileno(file), 0) != 0)
+        TEST_FAIL_MESSAGE("Erreur, ftruncate");
+    ouvreFichierSortieJSON(&s, file, true);
+    ecritJSONPT(node, &s);
+    TEST_ASSERT_TRUE(fermeSortieJSON(&s));
+    rewind(file);
+    PatriciaNode *copy = chargeJSONPT(fileno(file));
+    fclose(file);
+    js2 = printJSONPT(copy);
+    TEST_ASSERT_EQUAL_STRING(js1, js2);
+    for (int i = 0; i < 2000; i += 7)
+        TEST_ASSERT_EQUAL_INT(1, recherche_patricia(copy, words[i]));
+    free(js1);
+    free(js2);
+    free_patricia_node(copy);
+    free_patricia_node(node);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -219,6 +923,20 @@ int main(void)
     RUN_TEST(test_insert2);
     RUN_TEST(test_insert3);
     RUN_TEST(test_fusion);
+    RUN_TEST(test_adaptive_nodes);
+    RUN_TEST(test_insert_duplicate);
+    RUN_TEST(test_arena);
+    RUN_TEST(test_recherche_long);
+    RUN_TEST(test_comptage_mots);
+    RUN_TEST(test_rank_select);
+    RUN_TEST(test_cursor);
+    RUN_TEST(test_fuzzy_search);
+    RUN_TEST(test_glob);
+    RUN_TEST(test_longest_prefix);
+    RUN_TEST(test_recherche_batch);
+    RUN_TEST(test_snapshot);
+    RUN_TEST(test_json_flux);
+    RUN_TEST(test_json_ecriture);
 
     RUN_TEST(test_suffixe);
 